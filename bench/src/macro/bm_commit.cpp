@@ -0,0 +1,69 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <repo/core/handler/fileservice/repo_file_manager.h>
+#include <repo/lib/repo_config.h>
+#include <repo/manipulator/modelutility/repo_scene_manager.h>
+#include "../repo_bench.h"
+#include "../repo_bench_database_handler.h"
+#include "../repo_bench_scenes.h"
+
+using namespace repo::core::model;
+
+/**
+* Commit a new scene end to end (scene graph, stash, selection tree and SRC),
+* against the in-memory database and a temporary file store
+*/
+REPO_BENCHMARK(SceneManager, CommitScene)
+{
+	const uint32_t nMeshes = 1000;
+
+	auto fsDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("3drepobench-%%%%-%%%%");
+	boost::filesystem::create_directories(fsDir);
+
+	repo::bench::MemoryDatabaseHandler handler;
+	repo::lib::RepoConfig config("localhost", 27017, "", "");
+	config.configureFS(fsDir.string());
+	auto fileManager = repo::core::handler::fileservice::FileManager::instantiateManager(config, &handler);
+
+	size_t databaseBytes = 0;
+	for (auto _ : state)
+	{
+		state.pauseTiming();
+		handler.clear();
+		std::unique_ptr<RepoScene> scene(repo::bench::createGridScene(nMeshes, 500));
+		scene->setDatabaseAndProjectName("bench", "grid");
+		state.resumeTiming();
+
+		repo::manipulator::modelutility::SceneManager().commitScene(
+			scene.get(), "bench", "", "", repo::lib::RepoUUID::createUUID(), &handler, fileManager);
+
+		state.pauseTiming();
+		databaseBytes = handler.getStoredBytes();
+		scene.reset();
+		state.resumeTiming();
+	}
+
+	repo::core::handler::fileservice::FileManager::disconnect();
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(fsDir, ec);
+
+	state.setItemsProcessed(state.getIterations() * nMeshes);
+	state.setCounter("databaseBytes", databaseBytes);
+}
@@ -0,0 +1,117 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <repo/manipulator/modelconvertor/export/repo_model_export_gltf.h>
+#include <repo/manipulator/modelconvertor/export/repo_model_export_src.h>
+#include <repo/manipulator/modeloptimizer/repo_optimizer_multipart.h>
+#include <repo/manipulator/modelutility/repo_maker_selection_tree.h>
+#include "../repo_bench.h"
+#include "../repo_bench_scenes.h"
+
+using namespace repo::core::model;
+using namespace repo::manipulator;
+
+static const uint32_t N_MESHES = 2000;
+static const uint32_t N_TRIANGLES = 500;
+
+template <class Map>
+static size_t getTotalSize(const Map &files)
+{
+	size_t size = 0;
+	for (const auto &file : files)
+		size += file.second.size();
+	return size;
+}
+
+/**
+* Grid scene with its stash graph generated, as the exporters expect
+*/
+static std::unique_ptr<RepoScene> createOptimizedScene()
+{
+	std::unique_ptr<RepoScene> scene(repo::bench::createGridScene(N_MESHES, N_TRIANGLES));
+	modeloptimizer::MultipartOptimizer().apply(scene.get());
+	return scene;
+}
+
+REPO_BENCHMARK(MultipartOptimizer, Apply)
+{
+	for (auto _ : state)
+	{
+		state.pauseTiming();
+		std::unique_ptr<RepoScene> scene(repo::bench::createGridScene(N_MESHES, N_TRIANGLES));
+		state.resumeTiming();
+
+		modeloptimizer::MultipartOptimizer().apply(scene.get());
+
+		state.pauseTiming();
+		scene.reset();
+		state.resumeTiming();
+	}
+
+	state.setItemsProcessed(state.getIterations() * N_MESHES);
+}
+
+REPO_BENCHMARK(Export, SRC)
+{
+	auto scene = createOptimizedScene();
+
+	size_t size = 0;
+	for (auto _ : state)
+	{
+		modelconvertor::SRCModelExport exporter(scene.get());
+		auto buffers = exporter.getAllFilesExportedAsBuffer();
+		size = getTotalSize(buffers.geoFiles) + getTotalSize(buffers.jsonFiles);
+	}
+
+	state.setItemsProcessed(state.getIterations() * N_MESHES);
+	state.setCounter("outputBytes", size);
+}
+
+/**
+* Also covers GLTFModelExport::reorderFaces, which is private
+*/
+REPO_BENCHMARK(Export, GLTF)
+{
+	auto scene = createOptimizedScene();
+
+	size_t size = 0;
+	for (auto _ : state)
+	{
+		modelconvertor::GLTFModelExport exporter(scene.get());
+		auto buffers = exporter.getAllFilesExportedAsBuffer();
+		size = getTotalSize(buffers.geoFiles) + getTotalSize(buffers.jsonFiles);
+	}
+
+	state.setItemsProcessed(state.getIterations() * N_MESHES);
+	state.setCounter("outputBytes", size);
+}
+
+REPO_BENCHMARK(Export, SelectionTree)
+{
+	auto scene = createOptimizedScene();
+
+	size_t size = 0;
+	for (auto _ : state)
+	{
+		modelutility::SelectionTreeMaker treeMaker(scene.get());
+		size = getTotalSize(treeMaker.getSelectionTreeAsBuffer());
+	}
+
+	state.setItemsProcessed(state.getIterations() * N_MESHES);
+	state.setCounter("outputBytes", size);
+}
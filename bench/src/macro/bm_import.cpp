@@ -0,0 +1,73 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/filesystem.hpp>
+#include <repo/manipulator/modelconvertor/import/repo_model_import_manager.h>
+#include "../repo_bench.h"
+
+using namespace repo::manipulator::modelconvertor;
+
+/**
+* Time ModelImportManager::ImportFromFile (import, scene generation, reorientation
+* and transformation reduction) on one of the test models
+*/
+static void benchmarkImport(repo::bench::State &state, const std::string &model)
+{
+	auto path = repo::bench::getDataPath(model);
+	if (!boost::filesystem::exists(path))
+	{
+		state.skip(model + " not found, set --data or REPO_MODEL_PATH");
+		return;
+	}
+
+	size_t nMeshes = 0;
+	for (auto _ : state)
+	{
+		uint8_t err;
+		auto scene = ModelImportManager().ImportFromFile(path, ModelImportConfig(), err);
+		state.pauseTiming();
+		if (scene)
+		{
+			nMeshes = scene->getAllMeshes(repo::core::model::RepoScene::GraphType::DEFAULT).size();
+			delete scene;
+		}
+		state.resumeTiming();
+	}
+
+	state.setBytesProcessed(state.getIterations() * boost::filesystem::file_size(path));
+	state.setCounter("meshes", nMeshes);
+}
+
+REPO_BENCHMARK(Import, Obj)
+{
+	benchmarkImport(state, "cube.obj");
+}
+
+REPO_BENCHMARK(Import, Collada)
+{
+	benchmarkImport(state, "texturedPlane.dae");
+}
+
+REPO_BENCHMARK(Import, Ifc)
+{
+	benchmarkImport(state, "duplex.ifc");
+}
+
+REPO_BENCHMARK(Import, Ifc4)
+{
+	benchmarkImport(state, "ifc4Test.ifc");
+}
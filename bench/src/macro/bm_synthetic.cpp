@@ -0,0 +1,94 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <repo/manipulator/modeloptimizer/repo_optimizer_multipart.h>
+#include <repo/manipulator/modelutility/repo_maker_selection_tree.h>
+#include <repo/manipulator/modelutility/repo_scene_generator.h>
+#include "../repo_bench.h"
+
+using namespace repo::core::model;
+using namespace repo::manipulator;
+
+/**
+* A deep, instanced, metadata heavy scene, closer to large BIM models than
+* the test models are
+*/
+static modelutility::SceneGeneratorConfig getLargeSceneConfig()
+{
+	modelutility::SceneGeneratorConfig config;
+	config.seed = 1;
+	config.depth = 5;
+	config.fanOut = 6;
+	config.meshCount = 20000;
+	config.trianglesPerMesh = 200;
+	config.instancingRatio = 0.5;
+	config.metadataDensity = 20;
+	config.textureCount = 4;
+	config.materialCount = 32;
+	return config;
+}
+
+REPO_BENCHMARK(Synthetic, Generate)
+{
+	modelutility::SceneGenerator generator(getLargeSceneConfig());
+
+	for (auto _ : state)
+	{
+		std::unique_ptr<RepoScene> scene(generator.generate());
+		state.pauseTiming();
+		scene.reset();
+		state.resumeTiming();
+	}
+
+	state.setItemsProcessed(state.getIterations() * generator.getTriangleCount());
+}
+
+REPO_BENCHMARK(Synthetic, MultipartOptimizer)
+{
+	modelutility::SceneGenerator generator(getLargeSceneConfig());
+
+	for (auto _ : state)
+	{
+		state.pauseTiming();
+		std::unique_ptr<RepoScene> scene(generator.generate());
+		state.resumeTiming();
+
+		modeloptimizer::MultipartOptimizer().apply(scene.get());
+
+		state.pauseTiming();
+		scene.reset();
+		state.resumeTiming();
+	}
+
+	state.setItemsProcessed(state.getIterations() * generator.getTriangleCount());
+}
+
+REPO_BENCHMARK(Synthetic, SelectionTree)
+{
+	std::unique_ptr<RepoScene> scene(modelutility::SceneGenerator(getLargeSceneConfig()).generate());
+	auto nNodes = scene->getItemsInCurrentGraph(RepoScene::GraphType::DEFAULT);
+
+	for (auto _ : state)
+	{
+		modelutility::SelectionTreeMaker treeMaker(scene.get());
+		auto buffers = treeMaker.getSelectionTreeAsBuffer();
+		repo::bench::doNotOptimize(buffers);
+	}
+
+	state.setItemsProcessed(state.getIterations() * nNodes);
+}
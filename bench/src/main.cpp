@@ -0,0 +1,92 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <repo/lib/repo_log.h>
+#include "repo_bench.h"
+
+static void printUsage(const std::string &exe)
+{
+	std::cout << "Usage: " << exe << " [options]" << std::endl;
+	std::cout << "\t--list                 list the benchmarks and exit" << std::endl;
+	std::cout << "\t--filter=<substring>   only run benchmarks containing the substring" << std::endl;
+	std::cout << "\t--min_time=<seconds>   minimum time of each measurement (default 0.5)" << std::endl;
+	std::cout << "\t--repetitions=<n>      number of measurements per benchmark (default 3)" << std::endl;
+	std::cout << "\t--out=<file>           write the results as JSON to the file" << std::endl;
+	std::cout << "\t--data=<directory>     directory of the test models (default $REPO_MODEL_PATH)" << std::endl;
+}
+
+static bool getOption(const std::string &arg, const std::string &name, std::string &value)
+{
+	auto prefix = "--" + name + "=";
+	if (arg.compare(0, prefix.size(), prefix))
+		return false;
+	value = arg.substr(prefix.size());
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	repo::bench::RunOptions options;
+	std::string outFile, value;
+	bool listOnly = false;
+
+	if (auto dataDir = getenv("REPO_MODEL_PATH"))
+		repo::bench::setDataDirectory(dataDir);
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--list")
+			listOnly = true;
+		else if (getOption(arg, "filter", value))
+			options.filter = value;
+		else if (getOption(arg, "min_time", value))
+			options.minTime = std::atof(value.c_str());
+		else if (getOption(arg, "repetitions", value))
+			options.repetitions = std::atoi(value.c_str());
+		else if (getOption(arg, "out", value))
+			outFile = value;
+		else if (getOption(arg, "data", value))
+			repo::bench::setDataDirectory(value);
+		else
+		{
+			printUsage(argv[0]);
+			return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (listOnly)
+	{
+		for (const auto &name : repo::bench::getBenchmarkNames())
+			std::cout << name << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	//Logging within the library would otherwise dominate the output (and the timings)
+	repo::lib::RepoLog::getInstance().setLoggingLevel(repo::lib::RepoLog::RepoLogLevel::ERR);
+
+	auto results = repo::bench::runBenchmarks(options);
+
+	if (outFile.size() && !repo::bench::writeResultsAsJSON(results, options, outFile))
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
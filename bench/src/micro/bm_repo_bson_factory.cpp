@@ -0,0 +1,63 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <repo/core/model/bson/repo_bson_factory.h>
+#include "../repo_bench.h"
+#include "../repo_bench_scenes.h"
+
+using namespace repo::core::model;
+
+REPO_BENCHMARK(BSONFactory, MakeMetaDataNode)
+{
+	//Typical of a BIM element: a few dozen properties
+	std::unordered_map<std::string, std::string> values;
+	for (int i = 0; i < 50; ++i)
+		values["Property Set::Property " + std::to_string(i)] = "Value of property " + std::to_string(i * 37);
+	std::vector<repo::lib::RepoUUID> parents = { repo::lib::RepoUUID::createUUID() };
+
+	for (auto _ : state)
+	{
+		auto node = RepoBSONFactory::makeMetaDataNode(values, "Element", parents);
+		repo::bench::doNotOptimize(node);
+	}
+
+	state.setItemsProcessed(state.getIterations() * values.size());
+}
+
+REPO_BENCHMARK(BSONFactory, MakeMeshNode)
+{
+	//Build the mesh once to get representative input buffers
+	auto reference = repo::bench::createGridMesh(20000, 0, {});
+	auto vertices = reference.getVertices();
+	auto normals = reference.getNormals();
+	auto faces = reference.getFaces();
+	auto uvs = reference.getUVChannelsSeparated();
+	std::vector<std::vector<float>> bbox = { { 0, 0, 0 }, { 1, 1, 1 } };
+	std::vector<repo::lib::RepoUUID> parents = { repo::lib::RepoUUID::createUUID() };
+
+	for (auto _ : state)
+	{
+		auto node = RepoBSONFactory::makeMeshNode(vertices, faces, normals, bbox, uvs, {}, {}, "mesh", parents);
+		repo::bench::doNotOptimize(node);
+	}
+
+	state.setItemsProcessed(state.getIterations() * faces.size());
+	size_t bytes = vertices.size() * sizeof(vertices[0]) * 2 + faces.size() * 3 * sizeof(uint32_t);
+	for (const auto &channel : uvs)
+		bytes += channel.size() * sizeof(channel[0]);
+	state.setBytesProcessed(state.getIterations() * bytes);
+}
@@ -0,0 +1,108 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <random>
+#include <repo/lib/datastructure/repo_matrix.h>
+#include "../repo_bench.h"
+
+using repo::lib::RepoMatrix;
+using repo::lib::RepoVector3D;
+using repo::lib::RepoVector3D64;
+
+static const size_t N_VERTICES = 10000;
+
+static RepoMatrix createTransform()
+{
+	return RepoMatrix(std::vector<float>({
+		0.8f, -0.6f, 0, 10,
+		0.6f, 0.8f, 0, -5,
+		0, 0, 1, 2.5f,
+		0, 0, 0, 1 }));
+}
+
+template <class T>
+static std::vector<T> createVertices()
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> dist(-100, 100);
+	std::vector<T> vertices;
+	vertices.reserve(N_VERTICES);
+	for (size_t i = 0; i < N_VERTICES; ++i)
+		vertices.push_back(T(dist(rng), dist(rng), dist(rng)));
+	return vertices;
+}
+
+REPO_BENCHMARK(Matrix, TransformVertices)
+{
+	auto matrix = createTransform();
+	auto vertices = createVertices<RepoVector3D>();
+	std::vector<RepoVector3D> transformed(vertices.size());
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < vertices.size(); ++i)
+			transformed[i] = matrix * vertices[i];
+		repo::bench::doNotOptimize(transformed);
+	}
+
+	state.setItemsProcessed(state.getIterations() * vertices.size());
+}
+
+REPO_BENCHMARK(Matrix, TransformVertices64)
+{
+	auto matrix = createTransform();
+	auto vertices = createVertices<RepoVector3D64>();
+	std::vector<RepoVector3D64> transformed(vertices.size());
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < vertices.size(); ++i)
+			transformed[i] = matrix * vertices[i];
+		repo::bench::doNotOptimize(transformed);
+	}
+
+	state.setItemsProcessed(state.getIterations() * vertices.size());
+}
+
+REPO_BENCHMARK(Matrix, Multiply)
+{
+	auto a = createTransform();
+	auto b = createTransform().invert();
+	RepoMatrix result;
+
+	for (auto _ : state)
+	{
+		result = a * b;
+		repo::bench::doNotOptimize(result);
+	}
+
+	state.setItemsProcessed(state.getIterations());
+}
+
+REPO_BENCHMARK(Matrix, Invert)
+{
+	auto matrix = createTransform();
+	RepoMatrix result;
+
+	for (auto _ : state)
+	{
+		result = matrix.invert();
+		repo::bench::doNotOptimize(result);
+	}
+
+	state.setItemsProcessed(state.getIterations());
+}
@@ -0,0 +1,55 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <repo/manipulator/modeloptimizer/repo_optimizer_multipart.h>
+#include <repo/manipulator/modelutility/repo_mesh_map_reorganiser.h>
+#include "../repo_bench.h"
+#include "../repo_bench_scenes.h"
+
+using namespace repo::core::model;
+
+//Limits used by the SRC and glTF exporters
+static const size_t WEB_MAX_VERTEX_LIMIT = 65535;
+static const size_t WEB_MAX_TRIANGLE_LIMIT = SIZE_MAX;
+
+REPO_BENCHMARK(MeshMapReorganiser, SplitForWeb)
+{
+	//Supermeshes of ~200k vertices, so each is split into several sub meshes
+	std::unique_ptr<RepoScene> scene(repo::bench::createGridScene(200, 2000));
+	repo::manipulator::modeloptimizer::MultipartOptimizer().apply(scene.get());
+
+	std::vector<MeshNode*> meshes;
+	size_t nVertices = 0;
+	for (const auto &node : scene->getAllMeshes(RepoScene::GraphType::OPTIMIZED))
+	{
+		auto mesh = dynamic_cast<MeshNode*>(node);
+		meshes.push_back(mesh);
+		nVertices += mesh->getVertices().size();
+	}
+
+	for (auto _ : state)
+	{
+		for (const auto &mesh : meshes)
+		{
+			repo::manipulator::modelutility::MeshMapReorganiser reorganiser(mesh, WEB_MAX_VERTEX_LIMIT, WEB_MAX_TRIANGLE_LIMIT);
+		}
+	}
+
+	state.setItemsProcessed(state.getIterations() * nVertices);
+	state.setCounter("supermeshes", meshes.size());
+}
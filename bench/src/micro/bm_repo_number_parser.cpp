@@ -0,0 +1,71 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/lexical_cast.hpp>
+#include <repo/lib/repo_number_parser.h>
+#include "../repo_bench.h"
+
+/**
+* Typical metadata: mostly strings, which lexical_cast rejects by throwing
+*/
+static std::vector<std::string> createMetadataValues()
+{
+	std::vector<std::string> values;
+	for (int i = 0; i < 20000; ++i)
+	{
+		values.push_back("Basic Wall: Generic - " + std::to_string(i));
+		values.push_back(std::to_string(i));
+		values.push_back(std::to_string(i) + ".25");
+	}
+	return values;
+}
+
+REPO_BENCHMARK(NumberParser, LexicalCast)
+{
+	auto values = createMetadataValues();
+	for (auto _ : state)
+	{
+		for (const auto &value : values)
+		{
+			try {
+				repo::bench::doNotOptimize(boost::lexical_cast<long long>(value));
+			}
+			catch (boost::bad_lexical_cast &) {
+				try {
+					repo::bench::doNotOptimize(boost::lexical_cast<double>(value));
+				}
+				catch (boost::bad_lexical_cast &) {}
+			}
+		}
+	}
+	state.setItemsProcessed(state.getIterations() * values.size());
+}
+
+REPO_BENCHMARK(NumberParser, Parse)
+{
+	auto values = createMetadataValues();
+	for (auto _ : state)
+	{
+		for (const auto &value : values)
+		{
+			long long intValue;
+			double doubleValue;
+			repo::bench::doNotOptimize(repo::lib::parseInteger(value, intValue) || repo::lib::parseDouble(value, doubleValue));
+		}
+	}
+	state.setItemsProcessed(state.getIterations() * values.size());
+}
@@ -0,0 +1,96 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <repo/core/model/bson/repo_bson_factory.h>
+#include <repo/core/model/collection/repo_scene.h>
+#include "../repo_bench.h"
+
+using namespace repo::core::model;
+
+static const size_t N_CHILDREN = 20000;
+
+/**
+* A scene with a root, a level under the root and N_CHILDREN transformations
+* under the root, to be attached to the level as a Revit import would
+*/
+struct LevelScene
+{
+	std::unique_ptr<RepoScene> scene;
+	RepoNode *level;
+	std::vector<RepoNode*> children;
+};
+
+static LevelScene createLevelScene()
+{
+	LevelScene result;
+	RepoNodeSet transformations;
+	auto root = new TransformationNode(RepoBSONFactory::makeTransformationNode(repo::lib::RepoMatrix(), "root"));
+	transformations.insert(root);
+	result.level = new TransformationNode(RepoBSONFactory::makeTransformationNode(repo::lib::RepoMatrix(), "level", { root->getSharedID() }));
+	transformations.insert(result.level);
+	for (size_t i = 0; i < N_CHILDREN; ++i)
+	{
+		auto child = new TransformationNode(RepoBSONFactory::makeTransformationNode(repo::lib::RepoMatrix(), "element", { root->getSharedID() }));
+		transformations.insert(child);
+		result.children.push_back(child);
+	}
+
+	RepoNodeSet empty;
+	result.scene.reset(new RepoScene(std::vector<std::string>(), empty, empty, empty, empty, empty, transformations));
+	return result;
+}
+
+REPO_BENCHMARK(Scene, AddInheritance)
+{
+	for (auto _ : state)
+	{
+		state.pauseTiming();
+		auto levelScene = createLevelScene();
+		state.resumeTiming();
+
+		for (const auto &child : levelScene.children)
+			levelScene.scene->addInheritance(RepoScene::GraphType::DEFAULT, levelScene.level, child, true);
+
+		state.pauseTiming();
+		levelScene.scene.reset();
+		state.resumeTiming();
+	}
+
+	state.setItemsProcessed(state.getIterations() * N_CHILDREN);
+}
+
+REPO_BENCHMARK(Scene, AddInheritances)
+{
+	for (auto _ : state)
+	{
+		state.pauseTiming();
+		auto levelScene = createLevelScene();
+		std::vector<std::pair<const RepoNode*, RepoNode*>> edges;
+		for (const auto &child : levelScene.children)
+			edges.push_back(std::make_pair(levelScene.level, child));
+		state.resumeTiming();
+
+		levelScene.scene->addInheritances(RepoScene::GraphType::DEFAULT, edges, true);
+
+		state.pauseTiming();
+		levelScene.scene.reset();
+		state.resumeTiming();
+	}
+
+	state.setItemsProcessed(state.getIterations() * N_CHILDREN);
+}
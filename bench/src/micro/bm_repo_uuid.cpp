@@ -0,0 +1,65 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <repo/lib/datastructure/repo_uuid.h>
+#include "../repo_bench.h"
+
+using repo::lib::RepoUUID;
+
+static const size_t N_UUIDS = 10000;
+
+REPO_BENCHMARK(UUID, Create)
+{
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < N_UUIDS; ++i)
+			repo::bench::doNotOptimize(RepoUUID::createUUID());
+	}
+	state.setItemsProcessed(state.getIterations() * N_UUIDS);
+}
+
+REPO_BENCHMARK(UUID, CreateBulk)
+{
+	for (auto _ : state)
+		repo::bench::doNotOptimize(RepoUUID::createUUIDs(N_UUIDS));
+	state.setItemsProcessed(state.getIterations() * N_UUIDS);
+}
+
+REPO_BENCHMARK(UUID, ToString)
+{
+	auto ids = RepoUUID::createUUIDs(N_UUIDS);
+	for (auto _ : state)
+	{
+		for (const auto &id : ids)
+			repo::bench::doNotOptimize(id.toString());
+	}
+	state.setItemsProcessed(state.getIterations() * N_UUIDS);
+}
+
+REPO_BENCHMARK(UUID, Parse)
+{
+	std::vector<std::string> strings;
+	for (const auto &id : RepoUUID::createUUIDs(N_UUIDS))
+		strings.push_back(id.toString());
+
+	for (auto _ : state)
+	{
+		for (const auto &str : strings)
+			repo::bench::doNotOptimize(RepoUUID(str));
+	}
+	state.setItemsProcessed(state.getIterations() * N_UUIDS);
+}
@@ -0,0 +1,107 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <random>
+#include <repo/manipulator/modelconvertor/import/repo_vertex_map.h>
+#include "../repo_bench.h"
+
+using repo::manipulator::modelconvertor::VertexMap;
+using repo::lib::RepoVector2D;
+using repo::lib::RepoVector3D64;
+
+/**
+* Unindexed triangles of a grid, as the ODA importers receive them: each
+* vertex is shared by up to six triangles
+*/
+static std::vector<RepoVector3D64> createTriangleSoup(const uint32_t &side)
+{
+	std::vector<RepoVector3D64> soup;
+	soup.reserve(side * side * 6);
+	for (uint32_t y = 0; y < side; ++y)
+	{
+		for (uint32_t x = 0; x < side; ++x)
+		{
+			RepoVector3D64 a(x, y, 0), b(x + 1, y, 0), c(x, y + 1, 0), d(x + 1, y + 1, 0);
+			soup.insert(soup.end(), { a, b, c, b, d, c });
+		}
+	}
+	return soup;
+}
+
+REPO_BENCHMARK(VertexMap, WeldPositions)
+{
+	auto soup = createTriangleSoup(300);
+
+	for (auto _ : state)
+	{
+		VertexMap map;
+		for (const auto &vertex : soup)
+			map.find(vertex);
+	}
+
+	state.setItemsProcessed(state.getIterations() * soup.size());
+}
+
+REPO_BENCHMARK(VertexMap, WeldPositionsNormalsUvs)
+{
+	auto soup = createTriangleSoup(300);
+	RepoVector3D64 normal(0, 0, 1);
+
+	for (auto _ : state)
+	{
+		VertexMap map;
+		for (const auto &vertex : soup)
+			map.find(vertex, normal, RepoVector2D(vertex.x / 300, vertex.y / 300));
+	}
+
+	state.setItemsProcessed(state.getIterations() * soup.size());
+}
+
+REPO_BENCHMARK(VertexMap, WeldWithTolerance)
+{
+	auto soup = createTriangleSoup(300);
+
+	//Jitter the vertices below the tolerance, so only the quantisation welds them
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> jitter(-1e-5, 1e-5);
+	for (auto &vertex : soup)
+		vertex = RepoVector3D64(vertex.x + jitter(rng), vertex.y + jitter(rng), vertex.z);
+
+	for (auto _ : state)
+	{
+		VertexMap map(1e-3);
+		for (const auto &vertex : soup)
+			map.find(vertex);
+	}
+
+	state.setItemsProcessed(state.getIterations() * soup.size());
+}
+
+REPO_BENCHMARK(VertexMap, WeldReserved)
+{
+	auto soup = createTriangleSoup(300);
+
+	for (auto _ : state)
+	{
+		VertexMap map;
+		map.reserve(301 * 301);
+		for (const auto &vertex : soup)
+			map.find(vertex);
+	}
+
+	state.setItemsProcessed(state.getIterations() * soup.size());
+}
@@ -0,0 +1,355 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+using namespace repo::bench;
+
+const void * volatile repo::bench::optimizationSink = nullptr;
+
+struct RegisteredBenchmark
+{
+	std::string name;
+	BenchmarkFunction function;
+};
+
+static std::vector<RegisteredBenchmark>& getRegistry()
+{
+	//Function local, so it is initialised before the first static registration
+	static std::vector<RegisteredBenchmark> registry;
+	return registry;
+}
+
+static std::string& getDataDirectory()
+{
+	static std::string directory;
+	return directory;
+}
+
+State::Iterator State::begin()
+{
+	if (skipped)
+		return end();
+	running = true;
+	start = Clock::now();
+	return { this, iterations };
+}
+
+void State::pauseTiming()
+{
+	if (running)
+	{
+		elapsed += Clock::now() - start;
+		running = false;
+	}
+}
+
+void State::resumeTiming()
+{
+	if (!running)
+	{
+		running = true;
+		start = Clock::now();
+	}
+}
+
+void State::finishTiming()
+{
+	pauseTiming();
+}
+
+void State::skip(const std::string &reason)
+{
+	skipped = true;
+	skipReason = reason;
+}
+
+bool repo::bench::registerBenchmark(
+	const std::string       &group,
+	const std::string       &name,
+	const BenchmarkFunction &function)
+{
+	getRegistry().push_back({ group + "/" + name, function });
+	return true;
+}
+
+std::vector<std::string> repo::bench::getBenchmarkNames()
+{
+	std::vector<std::string> names;
+	for (const auto &benchmark : getRegistry())
+		names.push_back(benchmark.name);
+	return names;
+}
+
+static std::string formatTime(const double &ns)
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(ns < 10 ? 2 : 0);
+	if (ns < 1e4)
+		ss << ns << " ns";
+	else if (ns < 1e7)
+		ss << ns / 1e3 << " us";
+	else if (ns < 1e10)
+		ss << ns / 1e6 << " ms";
+	else
+		ss << ns / 1e9 << " s";
+	return ss.str();
+}
+
+static std::string formatRate(const double &rate, const std::string &unit)
+{
+	const char* prefixes[] = { "", "k", "M", "G", "T" };
+	double value = rate;
+	int prefix = 0;
+	while (value >= 1000 && prefix < 4)
+	{
+		value /= 1000;
+		++prefix;
+	}
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2) << value << " " << prefixes[prefix] << unit << "/s";
+	return ss.str();
+}
+
+/**
+* Run the benchmark once with the given number of iterations
+*/
+static State runOnce(const BenchmarkFunction &function, const uint64_t &iterations)
+{
+	State state(iterations);
+	function(state);
+	return state;
+}
+
+static BenchmarkResult runBenchmark(
+	const RegisteredBenchmark &benchmark,
+	const RunOptions          &options)
+{
+	BenchmarkResult result;
+	result.name = benchmark.name;
+
+	//Grow the number of iterations until a run takes long enough to be measured reliably
+	uint64_t iterations = 1;
+	State state = runOnce(benchmark.function, iterations);
+	while (!state.isSkipped() && state.getElapsedSeconds() < options.minTime && iterations < 1000000000)
+	{
+		double predicted = state.getElapsedSeconds() > 0 ?
+			iterations * options.minTime * 1.4 / state.getElapsedSeconds() : iterations * 10.0;
+		iterations = std::max(iterations + 1, std::min((uint64_t)predicted, iterations * 10));
+		state = runOnce(benchmark.function, iterations);
+	}
+
+	if (state.isSkipped())
+	{
+		result.skipReason = state.getSkipReason();
+		return result;
+	}
+
+	//The calibration run counts as the first repetition
+	result.iterations = iterations;
+	double totalSeconds = 0;
+	for (uint32_t rep = 0; rep < std::max(1u, options.repetitions); ++rep)
+	{
+		if (rep)
+			state = runOnce(benchmark.function, iterations);
+		result.nsPerIteration.push_back(state.getElapsedSeconds() * 1e9 / iterations);
+		totalSeconds += state.getElapsedSeconds();
+		result.itemsPerSecond += state.getItemsProcessed();
+		result.bytesPerSecond += state.getBytesProcessed();
+	}
+
+	if (totalSeconds > 0)
+	{
+		result.itemsPerSecond /= totalSeconds;
+		result.bytesPerSecond /= totalSeconds;
+	}
+	result.counters = state.getCounters();
+
+	return result;
+}
+
+static double getMean(const std::vector<double> &values)
+{
+	double sum = 0;
+	for (const auto &value : values)
+		sum += value;
+	return values.size() ? sum / values.size() : 0;
+}
+
+static double getStdDev(const std::vector<double> &values)
+{
+	if (values.size() < 2)
+		return 0;
+	double mean = getMean(values);
+	double sum = 0;
+	for (const auto &value : values)
+		sum += (value - mean) * (value - mean);
+	return std::sqrt(sum / (values.size() - 1));
+}
+
+std::vector<BenchmarkResult> repo::bench::runBenchmarks(const RunOptions &options)
+{
+	std::vector<BenchmarkResult> results;
+
+	std::cout << std::left << std::setw(48) << "Benchmark"
+		<< std::right << std::setw(14) << "Time"
+		<< std::setw(12) << "StdDev"
+		<< std::setw(14) << "Iterations"
+		<< "  Throughput" << std::endl;
+	std::cout << std::string(110, '-') << std::endl;
+
+	for (const auto &benchmark : getRegistry())
+	{
+		if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos)
+			continue;
+
+		auto result = runBenchmark(benchmark, options);
+
+		std::cout << std::left << std::setw(48) << result.name << std::right;
+		if (result.skipReason.size())
+		{
+			std::cout << "  skipped: " << result.skipReason << std::endl;
+		}
+		else
+		{
+			std::cout << std::setw(14) << formatTime(getMean(result.nsPerIteration))
+				<< std::setw(12) << formatTime(getStdDev(result.nsPerIteration))
+				<< std::setw(14) << result.iterations;
+			if (result.itemsPerSecond > 0)
+				std::cout << "  " << formatRate(result.itemsPerSecond, "items");
+			if (result.bytesPerSecond > 0)
+				std::cout << "  " << formatRate(result.bytesPerSecond, "B");
+			for (const auto &counter : result.counters)
+				std::cout << "  " << counter.first << "=" << counter.second;
+			std::cout << std::endl;
+		}
+
+		results.push_back(result);
+	}
+
+	return results;
+}
+
+static std::string escapeJSON(const std::string &str)
+{
+	std::stringstream ss;
+	for (const auto &c : str)
+	{
+		switch (c)
+		{
+		case '"': ss << "\\\""; break;
+		case '\\': ss << "\\\\"; break;
+		case '\n': ss << "\\n"; break;
+		case '\t': ss << "\\t"; break;
+		default:
+			if ((unsigned char)c < 0x20)
+				ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+			else
+				ss << c;
+		}
+	}
+	return ss.str();
+}
+
+bool repo::bench::writeResultsAsJSON(
+	const std::vector<BenchmarkResult> &results,
+	const RunOptions                   &options,
+	const std::string                  &filePath)
+{
+	std::ofstream file(filePath);
+	if (!file.is_open())
+	{
+		std::cerr << "Failed to open " << filePath << " for writing" << std::endl;
+		return false;
+	}
+
+	char date[32];
+	auto now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+	file << std::setprecision(17);
+	file << "{\n";
+	file << "\t\"context\": {\n";
+	file << "\t\t\"date\": \"" << date << "\",\n";
+	file << "\t\t\"minTime\": " << options.minTime << ",\n";
+	file << "\t\t\"repetitions\": " << options.repetitions << ",\n";
+	file << "\t\t\"filter\": \"" << escapeJSON(options.filter) << "\"\n";
+	file << "\t},\n";
+	file << "\t\"benchmarks\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const auto &result = results[i];
+		file << (i ? ",\n" : "\n") << "\t\t{\n";
+		file << "\t\t\t\"name\": \"" << escapeJSON(result.name) << "\"";
+		if (result.skipReason.size())
+		{
+			file << ",\n\t\t\t\"skipped\": \"" << escapeJSON(result.skipReason) << "\"\n";
+		}
+		else
+		{
+			file << ",\n\t\t\t\"iterations\": " << result.iterations;
+			file << ",\n\t\t\t\"meanNs\": " << getMean(result.nsPerIteration);
+			file << ",\n\t\t\t\"minNs\": " << *std::min_element(result.nsPerIteration.begin(), result.nsPerIteration.end());
+			file << ",\n\t\t\t\"stddevNs\": " << getStdDev(result.nsPerIteration);
+			file << ",\n\t\t\t\"repetitionsNs\": [";
+			for (size_t rep = 0; rep < result.nsPerIteration.size(); ++rep)
+				file << (rep ? ", " : "") << result.nsPerIteration[rep];
+			file << "]";
+			if (result.itemsPerSecond > 0)
+				file << ",\n\t\t\t\"itemsPerSecond\": " << result.itemsPerSecond;
+			if (result.bytesPerSecond > 0)
+				file << ",\n\t\t\t\"bytesPerSecond\": " << result.bytesPerSecond;
+			if (result.counters.size())
+			{
+				file << ",\n\t\t\t\"counters\": {";
+				bool first = true;
+				for (const auto &counter : result.counters)
+				{
+					file << (first ? "" : ", ") << "\"" << escapeJSON(counter.first) << "\": " << counter.second;
+					first = false;
+				}
+				file << "}";
+			}
+			file << "\n";
+		}
+		file << "\t\t}";
+	}
+
+	file << "\n\t]\n}\n";
+	return file.good();
+}
+
+void repo::bench::setDataDirectory(const std::string &directory)
+{
+	getDataDirectory() = directory;
+}
+
+std::string repo::bench::getDataPath(const std::string &file)
+{
+	return (boost::filesystem::path(getDataDirectory()) / file).string();
+}
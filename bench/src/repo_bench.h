@@ -0,0 +1,212 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Minimal benchmarking framework for the bouncer core.
+* Benchmarks are registered with REPO_BENCHMARK and time the body of a
+* range-for over the State, e.g.
+*
+*	REPO_BENCHMARK(Matrix, Multiply)
+*	{
+*		auto a = ...; //set up, not timed
+*		for (auto _ : state)
+*			a = a * a;
+*	}
+*
+* The runner picks the number of iterations so each measurement takes at
+* least the configured minimum time, and repeats the measurement to give
+* an idea of the noise.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace repo {
+	namespace bench {
+		class State
+		{
+		public:
+			struct Iterator
+			{
+				State *state;
+				uint64_t remaining;
+
+				int operator*() const { return 0; }
+				void operator++() { --remaining; }
+				bool operator!=(const Iterator &other) const
+				{
+					if (remaining != other.remaining) return true;
+					//Reaching end() stops the clock
+					state->finishTiming();
+					return false;
+				}
+			};
+
+			State(const uint64_t &iterations) : iterations(iterations) {}
+
+			Iterator begin();
+			Iterator end() { return { this, 0 }; }
+
+			/**
+			* Stop the clock, e.g. to reset state between iterations
+			*/
+			void pauseTiming();
+
+			/**
+			* Restart the clock after pauseTiming()
+			*/
+			void resumeTiming();
+
+			/**
+			* Report how many items (e.g. vertices, nodes) have been processed
+			* in total over all iterations, to get a throughput figure
+			*/
+			void setItemsProcessed(const uint64_t &items) { itemsProcessed = items; }
+
+			/**
+			* Report how many bytes have been processed in total over all iterations
+			*/
+			void setBytesProcessed(const uint64_t &bytes) { bytesProcessed = bytes; }
+
+			/**
+			* Report an arbitrary value alongside the timings (e.g. output size)
+			*/
+			void setCounter(const std::string &name, const double &value) { counters[name] = value; }
+
+			/**
+			* Skip the benchmark, e.g. because the test data is not available.
+			* Must be called before the timing loop.
+			* @param reason reason to report
+			*/
+			void skip(const std::string &reason);
+
+			uint64_t getIterations() const { return iterations; }
+			double getElapsedSeconds() const { return elapsed.count(); }
+			uint64_t getItemsProcessed() const { return itemsProcessed; }
+			uint64_t getBytesProcessed() const { return bytesProcessed; }
+			const std::map<std::string, double>& getCounters() const { return counters; }
+			bool isSkipped() const { return skipped; }
+			const std::string& getSkipReason() const { return skipReason; }
+
+		private:
+			void finishTiming();
+
+			typedef std::chrono::steady_clock Clock;
+
+			uint64_t iterations;
+			uint64_t itemsProcessed = 0;
+			uint64_t bytesProcessed = 0;
+			std::map<std::string, double> counters;
+			bool skipped = false;
+			bool running = false;
+			std::string skipReason;
+			Clock::time_point start;
+			std::chrono::duration<double> elapsed = std::chrono::duration<double>::zero();
+		};
+
+		typedef void(*BenchmarkFunction)(State &state);
+
+		extern const void * volatile optimizationSink;
+
+		/**
+		* Stop the compiler from optimising away the computation of value
+		*/
+		template <class T>
+		inline void doNotOptimize(const T &value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			asm volatile("" : : "r,m"(value) : "memory");
+#else
+			optimizationSink = &value;
+#endif
+		}
+
+		struct BenchmarkResult
+		{
+			std::string name;
+			uint64_t iterations = 0;
+			std::vector<double> nsPerIteration; //one per repetition
+			double itemsPerSecond = 0;
+			double bytesPerSecond = 0;
+			std::map<std::string, double> counters;
+			std::string skipReason;
+		};
+
+		struct RunOptions
+		{
+			std::string filter; //only run benchmarks with this substring in their name
+			double minTime = 0.5; //minimum time per measurement, in seconds
+			uint32_t repetitions = 3;
+		};
+
+		/**
+		* Register a benchmark, normally through REPO_BENCHMARK
+		* @return returns true so it can initialise a static
+		*/
+		bool registerBenchmark(
+			const std::string       &group,
+			const std::string       &name,
+			const BenchmarkFunction &function);
+
+		/**
+		* Get the names of all registered benchmarks, in registration order
+		*/
+		std::vector<std::string> getBenchmarkNames();
+
+		/**
+		* Run all registered benchmarks matching the filter
+		* @param options run options
+		* @return returns the results of each benchmark run
+		*/
+		std::vector<BenchmarkResult> runBenchmarks(const RunOptions &options);
+
+		/**
+		* Write the results as a JSON document
+		* @param results results of runBenchmarks
+		* @param options options the results were obtained with
+		* @param filePath path of the file to write
+		* @return returns true upon success
+		*/
+		bool writeResultsAsJSON(
+			const std::vector<BenchmarkResult> &results,
+			const RunOptions                   &options,
+			const std::string                  &filePath);
+
+		/**
+		* Set the directory containing the test models
+		*/
+		void setDataDirectory(const std::string &directory);
+
+		/**
+		* Get the full path of a test model
+		* @param file name of the model (e.g. cube.obj)
+		* @return returns the path within the data directory
+		*/
+		std::string getDataPath(const std::string &file);
+	}
+}
+
+#define REPO_BENCHMARK(group, name) \
+	static void repoBench_##group##_##name(repo::bench::State &state); \
+	static const bool repoBenchRegistered_##group##_##name = \
+		repo::bench::registerBenchmark(#group, #name, repoBench_##group##_##name); \
+	static void repoBench_##group##_##name(repo::bench::State &state)
@@ -0,0 +1,366 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_bench_database_handler.h"
+
+#include <algorithm>
+#include <repo/core/model/bson/repo_bson_builder.h>
+#include <repo/core/model/repo_model_global.h>
+
+using namespace repo::bench;
+using namespace repo::core::model;
+
+//Mongo's limit on document sizes
+static const uint64_t MAX_DOCUMENT_SIZE = 16 * 1024 * 1024;
+
+MemoryDatabaseHandler::MemoryDatabaseHandler() :
+	AbstractDatabaseHandler(MAX_DOCUMENT_SIZE)
+{
+}
+
+void MemoryDatabaseHandler::clear()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	collections.clear();
+	files.clear();
+}
+
+size_t MemoryDatabaseHandler::getStoredBytes() const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	size_t bytes = 0;
+	for (const auto &collection : collections)
+	{
+		for (const auto &document : collection.second)
+		{
+			bytes += document.objsize();
+			for (const auto &file : document.getFilesMapping())
+				bytes += file.second.second.size();
+		}
+	}
+	for (const auto &file : files)
+		bytes += file.second.size();
+	return bytes;
+}
+
+bool MemoryDatabaseHandler::matches(
+	const RepoBSON &document,
+	const RepoBSON &criteria)
+{
+	for (const auto &field : criteria.getFieldNames())
+	{
+		if (!document.hasField(field) || document.getField(field) != criteria.getField(field))
+			return false;
+	}
+	return true;
+}
+
+int64_t MemoryDatabaseHandler::findById(
+	const Collection &documents,
+	const RepoBSON   &obj)
+{
+	if (!obj.hasField(REPO_LABEL_ID))
+		return -1;
+	auto id = obj.getField(REPO_LABEL_ID);
+	for (size_t i = 0; i < documents.size(); ++i)
+	{
+		if (documents[i].hasField(REPO_LABEL_ID) && documents[i].getField(REPO_LABEL_ID) == id)
+			return i;
+	}
+	return -1;
+}
+
+uint64_t MemoryDatabaseHandler::countItemsInCollection(
+	const std::string &database,
+	const std::string &collection,
+	std::string &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto it = collections.find(getNamespace(database, collection));
+	return it == collections.end() ? 0 : it->second.size();
+}
+
+std::vector<RepoBSON> MemoryDatabaseHandler::getAllFromCollectionTailable(
+	const std::string             &database,
+	const std::string             &collection,
+	const uint64_t                &skip,
+	const uint32_t                &limit,
+	const std::list<std::string>  &fields,
+	const std::string             &sortField,
+	const int                     &sortOrder)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	std::vector<RepoBSON> results;
+	auto it = collections.find(getNamespace(database, collection));
+	if (it != collections.end() && skip < it->second.size())
+	{
+		auto end = limit ? std::min<size_t>(it->second.size(), skip + limit) : it->second.size();
+		results.insert(results.end(), it->second.begin() + skip, it->second.begin() + end);
+	}
+	return results;
+}
+
+std::list<std::string> MemoryDatabaseHandler::getCollections(const std::string &database)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	std::list<std::string> results;
+	auto prefix = database + ".";
+	for (const auto &collection : collections)
+	{
+		if (!collection.first.compare(0, prefix.size(), prefix))
+			results.push_back(collection.first.substr(prefix.size()));
+	}
+	return results;
+}
+
+std::list<std::string> MemoryDatabaseHandler::getDatabases(const bool &sorted)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	std::list<std::string> results;
+	for (const auto &collection : collections)
+	{
+		auto database = collection.first.substr(0, collection.first.find('.'));
+		if (std::find(results.begin(), results.end(), database) == results.end())
+			results.push_back(database);
+	}
+	if (sorted)
+		results.sort();
+	return results;
+}
+
+std::map<std::string, std::list<std::string> > MemoryDatabaseHandler::getDatabasesWithProjects(
+	const std::list<std::string> &databases,
+	const std::string &projectExt)
+{
+	std::map<std::string, std::list<std::string> > results;
+	for (const auto &database : databases)
+		results[database] = getProjects(database, projectExt);
+	return results;
+}
+
+std::list<std::string> MemoryDatabaseHandler::getProjects(const std::string &database, const std::string &projectExt)
+{
+	std::list<std::string> results;
+	auto suffix = "." + projectExt;
+	for (const auto &collection : getCollections(database))
+	{
+		if (collection.size() > suffix.size() &&
+			!collection.compare(collection.size() - suffix.size(), suffix.size(), suffix))
+			results.push_back(collection.substr(0, collection.size() - suffix.size()));
+	}
+	return results;
+}
+
+void MemoryDatabaseHandler::createCollection(const std::string &database, const std::string &name)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	collections[getNamespace(database, name)];
+}
+
+bool MemoryDatabaseHandler::insertDocument(
+	const std::string &database,
+	const std::string &collection,
+	const RepoBSON    &obj,
+	std::string       &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	collections[getNamespace(database, collection)].push_back(obj);
+	return true;
+}
+
+bool MemoryDatabaseHandler::insertRawFile(
+	const std::string          &database,
+	const std::string          &collection,
+	const std::string          &fileName,
+	const std::vector<uint8_t> &bin,
+	std::string                &errMsg,
+	const std::string          &contentType)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	files[getNamespace(database, collection) + "/" + fileName] = bin;
+	return true;
+}
+
+bool MemoryDatabaseHandler::upsertDocument(
+	const std::string &database,
+	const std::string &collection,
+	const RepoBSON    &obj,
+	const bool        &overwrite,
+	std::string       &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto &documents = collections[getNamespace(database, collection)];
+	auto index = findById(documents, obj);
+	if (index < 0)
+		documents.push_back(obj);
+	else if (overwrite)
+		documents[index] = obj;
+	else
+		documents[index] = documents[index].cloneAndAddFields(&obj);
+	return true;
+}
+
+bool MemoryDatabaseHandler::dropCollection(
+	const std::string &database,
+	const std::string &collection,
+	std::string &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	collections.erase(getNamespace(database, collection));
+	return true;
+}
+
+bool MemoryDatabaseHandler::dropDatabase(
+	const std::string &database,
+	std::string &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto prefix = database + ".";
+	for (auto it = collections.begin(); it != collections.end();)
+	{
+		if (!it->first.compare(0, prefix.size(), prefix))
+			it = collections.erase(it);
+		else
+			++it;
+	}
+	return true;
+}
+
+bool MemoryDatabaseHandler::dropDocument(
+	const RepoBSON    bson,
+	const std::string &database,
+	const std::string &collection,
+	std::string &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto &documents = collections[getNamespace(database, collection)];
+	auto index = findById(documents, bson);
+	if (index >= 0)
+		documents.erase(documents.begin() + index);
+	return true;
+}
+
+bool MemoryDatabaseHandler::dropDocuments(
+	const RepoBSON    criteria,
+	const std::string &database,
+	const std::string &collection,
+	std::string &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto &documents = collections[getNamespace(database, collection)];
+	documents.erase(std::remove_if(documents.begin(), documents.end(),
+		[&criteria](const RepoBSON &document) { return matches(document, criteria); }),
+		documents.end());
+	return true;
+}
+
+bool MemoryDatabaseHandler::dropRawFile(
+	const std::string &database,
+	const std::string &collection,
+	const std::string &fileName,
+	std::string &errMsg)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	files.erase(getNamespace(database, collection) + "/" + fileName);
+	return true;
+}
+
+std::vector<RepoBSON> MemoryDatabaseHandler::findAllByCriteria(
+	const std::string &database,
+	const std::string &collection,
+	const RepoBSON    &criteria)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	std::vector<RepoBSON> results;
+	auto it = collections.find(getNamespace(database, collection));
+	if (it != collections.end())
+	{
+		for (const auto &document : it->second)
+		{
+			if (matches(document, criteria))
+				results.push_back(document);
+		}
+	}
+	return results;
+}
+
+RepoBSON MemoryDatabaseHandler::findOneByCriteria(
+	const std::string &database,
+	const std::string &collection,
+	const RepoBSON    &criteria,
+	const std::string &sortField)
+{
+	auto results = findAllByCriteria(database, collection, criteria);
+	if (results.empty())
+		return RepoBSON();
+
+	if (sortField.empty())
+		return results.front();
+
+	//Descending, as with the mongo handler
+	return *std::max_element(results.begin(), results.end(),
+		[&sortField](const RepoBSON &a, const RepoBSON &b) {
+		return a.getField(sortField).toMongoElement().woCompare(b.getField(sortField).toMongoElement(), false) < 0;
+	});
+}
+
+std::vector<RepoBSON> MemoryDatabaseHandler::findAllByUniqueIDs(
+	const std::string &database,
+	const std::string &collection,
+	const RepoBSON    &uuid,
+	const bool        ignoreExtFiles)
+{
+	std::vector<RepoBSON> results;
+	for (const auto &field : uuid.getFieldNames())
+	{
+		auto document = findOneByUniqueID(database, collection, uuid.getUUIDField(field));
+		if (!document.isEmpty())
+			results.push_back(document);
+	}
+	return results;
+}
+
+RepoBSON MemoryDatabaseHandler::findOneBySharedID(
+	const std::string         &database,
+	const std::string         &collection,
+	const repo::lib::RepoUUID &uuid,
+	const std::string         &sortField)
+{
+	RepoBSONBuilder builder;
+	builder.append(REPO_NODE_LABEL_SHARED_ID, uuid);
+	return findOneByCriteria(database, collection, builder.obj(), sortField);
+}
+
+RepoBSON MemoryDatabaseHandler::findOneByUniqueID(
+	const std::string         &database,
+	const std::string         &collection,
+	const repo::lib::RepoUUID &uuid)
+{
+	RepoBSONBuilder builder;
+	builder.append(REPO_LABEL_ID, uuid);
+	return findOneByCriteria(database, collection, builder.obj());
+}
+
+std::vector<uint8_t> MemoryDatabaseHandler::getRawFile(
+	const std::string &database,
+	const std::string &collection,
+	const std::string &fname)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto it = files.find(getNamespace(database, collection) + "/" + fname);
+	return it == files.end() ? std::vector<uint8_t>() : it->second;
+}
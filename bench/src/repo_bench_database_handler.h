@@ -0,0 +1,215 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* In-process stand-in for the database, so benchmarks that commit or load
+* scenes measure the bouncer rather than the network and the database.
+* Documents are kept in memory per collection; queries only support plain
+* equality on top level fields, which covers what the scene commit does.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <boost/thread/mutex.hpp>
+
+#include <repo/core/handler/repo_database_handler_abstract.h>
+
+namespace repo {
+	namespace bench {
+		class MemoryDatabaseHandler : public repo::core::handler::AbstractDatabaseHandler
+		{
+		public:
+			MemoryDatabaseHandler();
+			virtual ~MemoryDatabaseHandler() {}
+
+			/**
+			* Remove all documents and files
+			*/
+			void clear();
+
+			/**
+			* Get the total size of all documents and files stored, in bytes
+			*/
+			size_t getStoredBytes() const;
+
+			uint64_t countItemsInCollection(
+				const std::string &database,
+				const std::string &collection,
+				std::string &errMsg);
+
+			std::vector<repo::core::model::RepoBSON> getAllFromCollectionTailable(
+				const std::string             &database,
+				const std::string             &collection,
+				const uint64_t                &skip = 0,
+				const uint32_t                &limit = 0,
+				const std::list<std::string>  &fields = std::list<std::string>(),
+				const std::string             &sortField = std::string(),
+				const int                     &sortOrder = -1);
+
+			std::list<std::string> getCollections(const std::string &database);
+
+			std::list<std::string> getDatabases(const bool &sorted = true);
+
+			std::map<std::string, std::list<std::string> > getDatabasesWithProjects(
+				const std::list<std::string> &databases,
+				const std::string &projectExt = "scene");
+
+			std::list<std::string> getProjects(const std::string &database, const std::string &projectExt);
+
+			std::list<std::string> getAdminDatabaseRoles() { return{}; }
+
+			std::list<std::string> getStandardDatabaseRoles() { return{}; }
+
+			void createCollection(const std::string &database, const std::string &name);
+
+			void createIndex(const std::string &database, const std::string &collection, const mongo::BSONObj &obj) {}
+
+			bool insertDocument(
+				const std::string &database,
+				const std::string &collection,
+				const repo::core::model::RepoBSON &obj,
+				std::string &errMsg);
+
+			bool insertRawFile(
+				const std::string          &database,
+				const std::string          &collection,
+				const std::string          &fileName,
+				const std::vector<uint8_t> &bin,
+				std::string                &errMsg,
+				const std::string          &contentType = "binary/octet-stream");
+
+			bool insertRole(
+				const repo::core::model::RepoRole &role,
+				std::string                       &errmsg) { return true; }
+
+			bool insertUser(
+				const repo::core::model::RepoUser &user,
+				std::string                       &errmsg) { return true; }
+
+			bool upsertDocument(
+				const std::string &database,
+				const std::string &collection,
+				const repo::core::model::RepoBSON &obj,
+				const bool        &overwrite,
+				std::string &errMsg);
+
+			bool dropCollection(
+				const std::string &database,
+				const std::string &collection,
+				std::string &errMsg);
+
+			bool dropDatabase(
+				const std::string &database,
+				std::string &errMsg);
+
+			bool dropDocument(
+				const repo::core::model::RepoBSON bson,
+				const std::string &database,
+				const std::string &collection,
+				std::string &errMsg);
+
+			bool dropDocuments(
+				const repo::core::model::RepoBSON criteria,
+				const std::string &database,
+				const std::string &collection,
+				std::string &errMsg);
+
+			bool dropRawFile(
+				const std::string &database,
+				const std::string &collection,
+				const std::string &fileName,
+				std::string &errMsg);
+
+			bool dropRole(
+				const repo::core::model::RepoRole &role,
+				std::string                       &errmsg) { return true; }
+
+			bool dropUser(
+				const repo::core::model::RepoUser &user,
+				std::string                       &errmsg) { return true; }
+
+			bool updateRole(
+				const repo::core::model::RepoRole &role,
+				std::string                       &errmsg) { return true; }
+
+			bool updateUser(
+				const repo::core::model::RepoUser &user,
+				std::string                       &errmsg) { return true; }
+
+			std::vector<repo::core::model::RepoBSON> findAllByCriteria(
+				const std::string& database,
+				const std::string& collection,
+				const repo::core::model::RepoBSON& criteria);
+
+			repo::core::model::RepoBSON findOneByCriteria(
+				const std::string& database,
+				const std::string& collection,
+				const repo::core::model::RepoBSON& criteria,
+				const std::string& sortField = "");
+
+			std::vector<repo::core::model::RepoBSON> findAllByUniqueIDs(
+				const std::string& database,
+				const std::string& collection,
+				const repo::core::model::RepoBSON& uuid,
+				const bool ignoreExtFiles = false);
+
+			repo::core::model::RepoBSON findOneBySharedID(
+				const std::string& database,
+				const std::string& collection,
+				const repo::lib::RepoUUID& uuid,
+				const std::string& sortField);
+
+			repo::core::model::RepoBSON findOneByUniqueID(
+				const std::string& database,
+				const std::string& collection,
+				const repo::lib::RepoUUID& uuid);
+
+			std::vector<uint8_t> getRawFile(
+				const std::string& database,
+				const std::string& collection,
+				const std::string& fname);
+
+		private:
+			typedef std::vector<repo::core::model::RepoBSON> Collection;
+
+			static std::string getNamespace(const std::string &database, const std::string &collection)
+			{
+				return database + "." + collection;
+			}
+
+			/**
+			* Check if all top level fields of the criteria are equal in the document
+			*/
+			static bool matches(
+				const repo::core::model::RepoBSON &document,
+				const repo::core::model::RepoBSON &criteria);
+
+			/**
+			* Find the index of the document with the given _id
+			* @return returns the index, or -1 if not found
+			*/
+			static int64_t findById(
+				const Collection                  &documents,
+				const repo::core::model::RepoBSON &obj);
+
+			mutable boost::mutex mutex;
+			std::map<std::string, Collection> collections;
+			std::unordered_map<std::string, std::vector<uint8_t>> files;
+		};
+	}
+}
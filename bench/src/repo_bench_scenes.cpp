@@ -0,0 +1,111 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_bench_scenes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <repo/core/model/bson/repo_bson_factory.h>
+
+using namespace repo::core::model;
+
+static const uint32_t N_MATERIALS = 8;
+
+MeshNode repo::bench::createGridMesh(
+	const uint32_t                         &triangles,
+	const float                            &offset,
+	const std::vector<repo::lib::RepoUUID> &parents)
+{
+	//Two triangles per cell of a side x side grid
+	const uint32_t side = std::max(1u, (uint32_t)std::sqrt(triangles / 2.0));
+	const uint32_t rowLength = side + 1;
+
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<repo::lib::RepoVector3D> normals;
+	std::vector<repo::lib::RepoVector2D> uvs;
+	vertices.reserve(rowLength * rowLength);
+	normals.reserve(rowLength * rowLength);
+	uvs.reserve(rowLength * rowLength);
+	for (uint32_t y = 0; y <= side; ++y)
+	{
+		for (uint32_t x = 0; x <= side; ++x)
+		{
+			float u = (float)x / side, v = (float)y / side;
+			//A gentle wave, so the normals are not all identical
+			vertices.push_back({ offset + u, v, 0.05f * std::sin(u * 6.28f) });
+			normals.push_back({ 0, 0, 1 });
+			uvs.push_back({ u, v });
+		}
+	}
+
+	std::vector<repo_face_t> faces;
+	faces.reserve(side * side * 2);
+	for (uint32_t y = 0; y < side; ++y)
+	{
+		for (uint32_t x = 0; x < side; ++x)
+		{
+			uint32_t i = y * rowLength + x;
+			faces.push_back({ i, i + 1, i + rowLength });
+			faces.push_back({ i + 1, i + rowLength + 1, i + rowLength });
+		}
+	}
+
+	std::vector<std::vector<float>> bbox = {
+		{ offset, 0, -0.05f },
+		{ offset + 1, 1, 0.05f }
+	};
+
+	return RepoBSONFactory::makeMeshNode(vertices, faces, normals, bbox, { uvs }, {}, {}, "grid", parents);
+}
+
+RepoScene* repo::bench::createGridScene(
+	const uint32_t &nMeshes,
+	const uint32_t &trianglesPerMesh)
+{
+	RepoNodeSet meshes, materials, metadata, transformations, empty;
+
+	auto root = new TransformationNode(RepoBSONFactory::makeTransformationNode());
+	transformations.insert(root);
+
+	std::vector<std::vector<repo::lib::RepoUUID>> materialParents(N_MATERIALS);
+	for (uint32_t i = 0; i < nMeshes; ++i)
+	{
+		auto mesh = new MeshNode(createGridMesh(trianglesPerMesh, i * 1.5f, { root->getSharedID() }));
+		meshes.insert(mesh);
+		materialParents[i % N_MATERIALS].push_back(mesh->getSharedID());
+
+		std::unordered_map<std::string, std::string> values = {
+			{ "Name", "Element " + std::to_string(i) },
+			{ "Category", "Category " + std::to_string(i % 20) },
+			{ "Area", std::to_string(1.5 * i) },
+			{ "Level", "Level " + std::to_string(i % 5) }
+		};
+		metadata.insert(new MetadataNode(RepoBSONFactory::makeMetaDataNode(values, "Element " + std::to_string(i), { mesh->getSharedID() })));
+	}
+
+	for (uint32_t i = 0; i < N_MATERIALS; ++i)
+	{
+		if (materialParents[i].empty())
+			continue;
+		repo_material_t material;
+		material.diffuse = { (float)i / N_MATERIALS, 0.5f, 1.f - (float)i / N_MATERIALS, 1 };
+		material.opacity = i % 4 ? 1.0f : 0.5f;
+		materials.insert(new MaterialNode(RepoBSONFactory::makeMaterialNode(material, "Material " + std::to_string(i), materialParents[i])));
+	}
+
+	return new RepoScene({}, empty, meshes, materials, metadata, empty, transformations);
+}
@@ -0,0 +1,53 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Procedurally generated scenes for benchmarks that should not depend on
+* the test models being available.
+*/
+
+#pragma once
+
+#include <repo/core/model/bson/repo_node_mesh.h>
+#include <repo/core/model/collection/repo_scene.h>
+
+namespace repo {
+	namespace bench {
+		/**
+		* Create a scene of nMeshes flat grid meshes under one transformation,
+		* each with its own metadata node, sharing a handful of materials.
+		* @param nMeshes number of meshes
+		* @param trianglesPerMesh approximate number of triangles of each mesh
+		* @return returns a scene with the default graph populated, owned by the caller
+		*/
+		repo::core::model::RepoScene* createGridScene(
+			const uint32_t &nMeshes,
+			const uint32_t &trianglesPerMesh);
+
+		/**
+		* Create a single flat grid mesh
+		* @param triangles approximate number of triangles
+		* @param offset offset of the grid along x, so meshes do not overlap
+		* @param parents parents of the mesh node
+		* @return returns the mesh node
+		*/
+		repo::core::model::MeshNode createGridMesh(
+			const uint32_t                         &triangles,
+			const float                            &offset,
+			const std::vector<repo::lib::RepoUUID> &parents);
+	}
+}
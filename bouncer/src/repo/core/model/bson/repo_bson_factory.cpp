@@ -22,6 +22,7 @@
 
 #include "repo_bson_builder.h"
 #include "../../../lib/repo_log.h"
+#include "../../../lib/repo_number_parser.h"
 
 using namespace repo::core::model;
 
@@ -199,6 +200,24 @@ static std::string sanitiseKey(const std::string &key)
 	return cleanedKey;
 }
 
+/**
+* Append a metadata value, stored as a number if it is one
+*/
+static void appendMetadataValue(
+	RepoBSONBuilder   &builder,
+	const std::string &key,
+	const std::string &value)
+{
+	long long valueInt;
+	double valueFloat;
+	if (repo::lib::parseInteger(value, valueInt))
+		builder.append(key, valueInt);
+	else if (repo::lib::parseDouble(value, valueFloat))
+		builder.append(key, valueFloat);
+	else
+		builder.append(key, value);
+}
+
 MetadataNode RepoBSONFactory::makeMetaDataNode(
 	const std::vector<std::string>  &keys,
 	const std::vector<std::string>  &values,
@@ -229,26 +248,7 @@ MetadataNode RepoBSONFactory::makeMetaDataNode(
 
 		if (!key.empty() && !value.empty())
 		{
-			//Check if it is a number, if it is, store it as a number
-
-			try {
-				long long valueInt = boost::lexical_cast<long long>(value);
-				metaBuilder.append(key, valueInt);
-			}
-			catch (boost::bad_lexical_cast &)
-			{
-				//not an int, try a double
-
-				try {
-					double valueFloat = boost::lexical_cast<double>(value);
-					metaBuilder.append(key, valueFloat);
-				}
-				catch (boost::bad_lexical_cast &)
-				{
-					//not an int or float, store as string
-					metaBuilder.append(key, value);
-				}
-			}
+			appendMetadataValue(metaBuilder, key, value);
 		}
 	}
 
@@ -275,26 +275,7 @@ MetadataNode RepoBSONFactory::makeMetaDataNode(
 
 		if (!key.empty() && !value.empty())
 		{
-			//Check if it is a number, if it is, store it as a number
-
-			try {
-				long long valueInt = boost::lexical_cast<long long>(value);
-				metaBuilder.append(key, valueInt);
-			}
-			catch (boost::bad_lexical_cast &)
-			{
-				//not an int, try a double
-
-				try {
-					double valueFloat = boost::lexical_cast<double>(value);
-					metaBuilder.append(key, valueFloat);
-				}
-				catch (boost::bad_lexical_cast &)
-				{
-					//not an int or float, store as string
-					metaBuilder.append(key, value);
-				}
-			}
+			appendMetadataValue(metaBuilder, key, value);
 		}
 	}
 
@@ -398,6 +379,7 @@ MeshNode RepoBSONFactory::makeMeshNode(
 		MeshNode::Primitive primitive = MeshNode::Primitive::UNKNOWN;
 
 		std::vector<uint32_t> facesLevel1;
+		facesLevel1.reserve(faces.size() * (faces[0].size() + 1));
 		for (auto &face : faces) {
 			auto nIndices = face.size();
 			if (!nIndices)
@@ -922,6 +904,20 @@ TextureNode RepoBSONFactory::makeTextureNode(
 	const uint32_t    &height,
 	const std::vector<repo::lib::RepoUUID>& parentIDs,
 	const int         &apiLevel)
+{
+	std::vector<uint8_t> buffer;
+	if (data && byteCount)
+		buffer.assign((const uint8_t*)data, (const uint8_t*)data + byteCount);
+	return makeTextureNode(name, std::move(buffer), width, height, parentIDs, apiLevel);
+}
+
+TextureNode RepoBSONFactory::makeTextureNode(
+	const std::string &name,
+	std::vector<uint8_t> &&data,
+	const uint32_t    &width,
+	const uint32_t    &height,
+	const std::vector<repo::lib::RepoUUID>& parentIDs,
+	const int         &apiLevel)
 {
 	RepoBSONBuilder builder;
 	repo::lib::RepoUUID uniqueID = repo::lib::RepoUUID::createUUID();
@@ -948,13 +944,11 @@ TextureNode RepoBSONFactory::makeTextureNode(
 
 	//--------------------------------------------------------------------------
 	// Data
-	if (data && byteCount) {
+	if (data.size()) {
 		std::string bName = uniqueID.toString() + "_data";
 		//inclusion of this binary exceeds the maximum, store separately
 		binMapping[REPO_LABEL_DATA] =
-			std::pair<std::string, std::vector<uint8_t>>(bName, std::vector<uint8_t>());
-		binMapping[REPO_LABEL_DATA].second.resize(byteCount); //uint8_t will ensure it is a byte addrressing
-		memcpy(binMapping[REPO_LABEL_DATA].second.data(), data, byteCount);
+			std::pair<std::string, std::vector<uint8_t>>(bName, std::move(data));
 	}
 	else
 	{
@@ -1014,26 +1008,8 @@ RepoTask RepoBSONFactory::makeTask(
 		if (!key.empty() && !value.empty())
 		{
 			RepoBSONBuilder metaBuilder;
-			//Check if it is a number, if it is, store it as a number
-
 			metaBuilder.append(REPO_TASK_META_KEY, key);
-			try {
-				long long valueInt = boost::lexical_cast<long long>(value);
-				metaBuilder.append(REPO_TASK_META_VALUE, valueInt);
-			}
-			catch (boost::bad_lexical_cast &)
-			{
-				//not an int, try a double
-				try {
-					double valueFloat = boost::lexical_cast<double>(value);
-					metaBuilder.append(REPO_TASK_META_VALUE, valueFloat);
-				}
-				catch (boost::bad_lexical_cast &)
-				{
-					//not an int or float, store as string
-					metaBuilder.append(REPO_TASK_META_VALUE, value);
-				}
-			}
+			appendMetadataValue(metaBuilder, REPO_TASK_META_VALUE, value);
 
 			metaEntries.push_back(metaBuilder.obj());
 		}
@@ -1049,13 +1025,16 @@ RepoSequence RepoBSONFactory::makeSequence(
 	const std::string &name,
 	const repo::lib::RepoUUID &id,
 	const uint64_t firstFrame,
-	const uint64_t lastFrame
+	const uint64_t lastFrame,
+	const std::string &stateFormat
 ) {
 	RepoBSONBuilder builder;
 	builder.append(REPO_LABEL_ID, id);
 	builder.append(REPO_SEQUENCE_LABEL_NAME, name);
 	builder.append(REPO_SEQUENCE_LABEL_START_DATE, (long long)firstFrame);
 	builder.append(REPO_SEQUENCE_LABEL_END_DATE, (long long)lastFrame);
+	if (!stateFormat.empty())
+		builder.append(REPO_SEQUENCE_LABEL_STATE_FORMAT, stateFormat);
 
 	std::vector<RepoBSON> frames;
 
@@ -1063,6 +1042,8 @@ RepoSequence RepoBSONFactory::makeSequence(
 		RepoBSONBuilder bsonBuilder;
 		bsonBuilder.append(REPO_SEQUENCE_LABEL_DATE, mongo::Date_t(frameEntry.timestamp * 1000));
 		bsonBuilder.append(REPO_SEQUENCE_LABEL_STATE, frameEntry.ref);
+		if (!frameEntry.isKeyFrame)
+			bsonBuilder.append(REPO_SEQUENCE_LABEL_DELTA, true);
 
 		frames.push_back(bsonBuilder.obj());
 	}
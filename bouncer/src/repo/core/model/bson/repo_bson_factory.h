@@ -376,6 +376,24 @@ namespace repo {
 					const std::vector<repo::lib::RepoUUID>& parentIDs = std::vector<repo::lib::RepoUUID>(),
 					const int         &apiLevel = REPO_NODE_API_LEVEL_1);
 
+				/**
+				* Create a Texture Node, taking ownership of the given buffer
+				* rather than copying it
+				* @param name name of the texture node, with extension to indicate file format
+				* @param data binary data to store, moved into the node
+				* @param width width of the texture
+				* @param height height of the texture
+				* @param apiLevel API Level(optional)
+				* @return returns a texture node
+				*/
+				static TextureNode makeTextureNode(
+					const std::string &name,
+					std::vector<uint8_t> &&data,
+					const uint32_t    &width,
+					const uint32_t    &height,
+					const std::vector<repo::lib::RepoUUID>& parentIDs = std::vector<repo::lib::RepoUUID>(),
+					const int         &apiLevel = REPO_NODE_API_LEVEL_1);
+
 				/**
 				* Create a Transformation Node
 				* @param transMatrix a 4 by 4 transformation matrix (optional - default is identity matrix)
@@ -390,12 +408,23 @@ namespace repo {
 					const std::vector<repo::lib::RepoUUID>		      &parents = std::vector<repo::lib::RepoUUID>(),
 					const int                             &apiLevel = REPO_NODE_API_LEVEL_1);
 
+				/**
+				* Create a sequence
+				* @param frameData timestamp and state reference of each frame
+				* @param name name of the sequence
+				* @param id unique id of the sequence
+				* @param firstFrame start date of the sequence
+				* @param lastFrame end date of the sequence
+				* @param stateFormat encoding of the frame states (optional - omitted if empty, i.e. JSON)
+				* @return returns a sequence
+				*/
 				static RepoSequence makeSequence(
 					const std::vector<repo::core::model::RepoSequence::FrameData> &frameData,
 					const std::string &name,
 					const repo::lib::RepoUUID &id,
 					const uint64_t firstFrame,
-					const uint64_t lastFrame
+					const uint64_t lastFrame,
+					const std::string &stateFormat = std::string()
 				);
 
 				static RepoTask makeTask(
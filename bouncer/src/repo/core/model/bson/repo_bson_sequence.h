@@ -34,6 +34,10 @@ namespace repo {
 #define REPO_SEQUENCE_LABEL_START_DATE "startDate"
 #define REPO_SEQUENCE_LABEL_END_DATE "endDate"
 #define REPO_SEQUENCE_LABEL_STATE "state"
+#define REPO_SEQUENCE_LABEL_DELTA "delta"
+#define REPO_SEQUENCE_LABEL_STATE_FORMAT "stateFormat"
+#define REPO_SEQUENCE_STATE_FORMAT_BINARY "binary"
+#define REPO_SEQUENCE_STATE_FORMAT_BINARY_COMPRESSED "binaryCompressed"
 
 			class REPO_API_EXPORT RepoSequence : public RepoBSON
 			{
@@ -42,6 +46,8 @@ namespace repo {
 				struct FrameData {
 					uint64_t timestamp;
 					std::string ref;
+					//false if the state only records the changes since the previous frame
+					bool isKeyFrame = true;
 				};
 
 				RepoSequence() : RepoBSON() {}
@@ -287,17 +287,40 @@ double RepoUser::getQuota() const
 	return subs.discretionary.data + subs.enterprise.data;
 }
 
-bool RepoUser::isVREnabled() const
+bool RepoUser::isCustomDataFlagSet(const std::string &label) const
 {
 	auto customData = getCustomDataBSON();
 
-	return customData.isEmpty() ? false : customData.getBoolField(REPO_USER_LABEL_VR_ENABLED);
+	return customData.isEmpty() ? false : customData.getBoolField(label);
+}
+
+bool RepoUser::isVREnabled() const
+{
+	return isCustomDataFlagSet(REPO_USER_LABEL_VR_ENABLED);
 }
 
 bool RepoUser::isSrcEnabled() const
 {
-	auto customData = getCustomDataBSON();
+	return isCustomDataFlagSet(REPO_USER_LABEL_SRC_ENABLED);
+}
 
-	return customData.isEmpty() ? false : customData.getBoolField(REPO_USER_LABEL_SRC_ENABLED);
+bool RepoUser::isUint32IndicesEnabled() const
+{
+	return isCustomDataFlagSet(REPO_USER_LABEL_UINT32_INDICES_ENABLED);
+}
+
+bool RepoUser::isQuantisedVerticesEnabled() const
+{
+	return isCustomDataFlagSet(REPO_USER_LABEL_QUANTISED_VERTICES_ENABLED);
+}
+
+bool RepoUser::isGeometryCodecEnabled() const
+{
+	return isCustomDataFlagSet(REPO_USER_LABEL_GEOMETRY_CODEC_ENABLED);
+}
+
+bool RepoUser::isHierarchicalLODsEnabled() const
+{
+	return isCustomDataFlagSet(REPO_USER_LABEL_HIERARCHICAL_LODS_ENABLED);
 }
 
@@ -52,6 +52,10 @@ namespace repo {
 #define REPO_USER_LABEL_SUBS_BILLING_USER			"billingUser"
 #define REPO_USER_LABEL_VR_ENABLED					"vrEnabled"
 #define REPO_USER_LABEL_SRC_ENABLED					"srcEnabled"
+#define REPO_USER_LABEL_UINT32_INDICES_ENABLED		"uint32IndicesEnabled"
+#define REPO_USER_LABEL_QUANTISED_VERTICES_ENABLED	"quantisedVerticesEnabled"
+#define REPO_USER_LABEL_GEOMETRY_CODEC_ENABLED		"geometryCodecEnabled"
+#define REPO_USER_LABEL_HIERARCHICAL_LODS_ENABLED	"hierarchicalLODsEnabled"
 #define REPO_USER_LABEL_CREATED_AT					"createdAt"
 #define REPO_USER_LABEL_SUB_PAYPAL					"paypal"
 #define REPO_USER_LABEL_SUB_DISCRETIONARY			"discretionary"
@@ -240,7 +244,34 @@ namespace repo {
 				*/
 				bool isSrcEnabled() const;
 
+				/**
+				* Check if web stashes of this teamspace may use 32 bit indices
+				*/
+				bool isUint32IndicesEnabled() const;
+
+				/**
+				* Check if web stashes of this teamspace may use quantised vertices
+				*/
+				bool isQuantisedVerticesEnabled() const;
+
+				/**
+				* Check if web stashes of this teamspace may use the geometry codec
+				*/
+				bool isGeometryCodecEnabled() const;
+
+				/**
+				* Check if web stashes of this teamspace may carry hierarchical levels of detail
+				*/
+				bool isHierarchicalLODsEnabled() const;
+
 			private:
+				/**
+				* Check a boolean flag of the custom data of the teamspace
+				* @param label label of the flag
+				* @return returns false if the flag or the custom data is missing
+				*/
+				bool isCustomDataFlagSet(const std::string &label) const;
+
 				/**
 				* Converts a RepoBSON object into a PaypalSubscription Object
 				* @params bson
@@ -40,6 +40,7 @@
 #define REPO_NODE_REVISION_LABEL_REF_FILE               "rFile" //!< Reference file
 #define REPO_NODE_REVISION_LABEL_INCOMPLETE             "incomplete"
 #define REPO_NODE_REVISION_LABEL_WORLD_COORD_SHIFT      "coordOffset"
+#define REPO_NODE_REVISION_LABEL_PROFILE                "profile" //!< Per-stage timings of the job that created the revision
 #define REPO_NODE_UUID_SUFFIX_REVISION			"10" //!< uuid suffix
 //------------------------------------------------------------------------------
 
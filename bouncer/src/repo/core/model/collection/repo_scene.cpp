@@ -158,23 +158,11 @@ void RepoScene::abandonChild(
 	repoGraphInstance &g = GraphType::OPTIMIZED == gType ? stashGraph : graph;
 	repo::lib::RepoUUID childSharedID = child->getSharedID();
 
-	if (modifyParent)
+	if (modifyParent && g.parentToChildren.count(parent))
 	{
-		auto pToCIt = g.parentToChildren.find(parent);
-
-		if (pToCIt != g.parentToChildren.end())
+		if (!removeChildFromParent(g, parent, child))
 		{
-			std::vector<RepoNode *> children = pToCIt->second;
-			auto childIt = std::find(children.begin(), children.end(), child);
-			if (childIt != children.end())
-			{
-				children.erase(childIt);
-				g.parentToChildren[parent] = children;
-			}
-			else
-			{
-				repoWarning << "Trying to abandon a child that isn't a child of the parent!";
-			}
+			repoWarning << "Trying to abandon a child that isn't a child of the parent!";
 		}
 	}
 
@@ -207,28 +195,10 @@ void RepoScene::addInheritance(
 		repo::lib::RepoUUID childShareID = childNode->getSharedID();
 
 		//add children to parentToChildren mapping
-		auto childrenIT =
-			g.parentToChildren.find(parentShareID);
-
-		if (childrenIT != g.parentToChildren.end())
-		{
-			std::vector<RepoNode*> &children = childrenIT->second;
-			//TODO: use sets for performance?
-			auto childrenInd = std::find(children.begin(), children.end(), childNode);
-			if (childrenInd == children.end())
-			{
-				children.push_back(childNode);
-			}
-		}
-		else
-		{
-			g.parentToChildren[parentShareID] = std::vector<RepoNode*>();
-			g.parentToChildren[parentShareID].push_back(childNode);
-		}
+		addChildToParent(g, parentShareID, childNode);
 
 		//add parent to children
 		std::vector<repo::lib::RepoUUID> parents = childNode->getParentIDs();
-		//TODO: use sets for performance?
 		auto parentInd = std::find(parents.begin(), parents.end(), parentShareID);
 		if (parentInd == parents.end())
 		{
@@ -248,6 +218,87 @@ void RepoScene::addInheritance(
 	}
 }
 
+void RepoScene::addInheritances(
+	const GraphType &gType,
+	const std::vector<std::pair<const RepoNode*, RepoNode*>> &edges,
+	const bool      &noUpdate)
+{
+	repoGraphInstance &g = gType == GraphType::OPTIMIZED ? stashGraph : graph;
+	bool trackChanges = !noUpdate && gType == GraphType::DEFAULT;
+
+	//Gather the new parents of each child, so each child is only rebuilt once
+	std::vector<RepoNode*> children;
+	std::unordered_map<RepoNode*, std::vector<repo::lib::RepoUUID>> childToParents;
+	for (const auto &edge : edges)
+	{
+		if (!edge.first || !edge.second)
+			continue;
+
+		auto parentShareID = edge.first->getSharedID();
+		addChildToParent(g, parentShareID, edge.second);
+
+		auto it = childToParents.find(edge.second);
+		if (it == childToParents.end())
+		{
+			children.push_back(edge.second);
+			it = childToParents.insert(std::make_pair(edge.second, std::vector<repo::lib::RepoUUID>())).first;
+		}
+		it->second.push_back(parentShareID);
+	}
+
+	for (auto &child : children)
+	{
+		auto currentParents = child->getParentIDs();
+		std::unordered_set<repo::lib::RepoUUID, repo::lib::RepoUUIDHasher> existing(currentParents.begin(), currentParents.end());
+		std::vector<repo::lib::RepoUUID> newParents;
+		for (const auto &parent : childToParents[child])
+		{
+			if (existing.insert(parent).second)
+				newParents.push_back(parent);
+		}
+
+		if (newParents.size())
+		{
+			RepoNode childWithParents = child->cloneAndAddParent(newParents);
+			if (trackChanges)
+			{
+				modifyNode(GraphType::DEFAULT, child, &childWithParents);
+			}
+			else
+			{
+				child->swap(childWithParents);
+			}
+		}
+	}
+}
+
+bool RepoScene::addChildToParent(
+	repoGraphInstance &g,
+	const repo::lib::RepoUUID &parent,
+	RepoNode *child)
+{
+	if (!g.parentChildEdges.insert(ParentChildEdge(parent, child)).second)
+		return false;
+
+	g.parentToChildren[parent].push_back(child);
+	return true;
+}
+
+bool RepoScene::removeChildFromParent(
+	repoGraphInstance &g,
+	const repo::lib::RepoUUID &parent,
+	RepoNode *child)
+{
+	if (!g.parentChildEdges.erase(ParentChildEdge(parent, child)))
+		return false;
+
+	auto &children = g.parentToChildren[parent];
+	auto childIt = std::find(children.begin(), children.end(), child);
+	if (childIt != children.end())
+		children.erase(childIt);
+	return true;
+}
+
 void RepoScene::addMetadata(
 	RepoNodeSet &metadata,
 	const bool  &exactMatch,
@@ -306,19 +357,13 @@ void RepoScene::addMetadata(
 					for (auto &mesh : meshes)
 					{
 						repo::lib::RepoUUID parentSharedID = mesh->getSharedID();
-						if (graph.parentToChildren.find(parentSharedID) == graph.parentToChildren.end())
-							graph.parentToChildren[parentSharedID] = std::vector<RepoNode*>();
-
-						graph.parentToChildren[parentSharedID].push_back(meta);
+						addChildToParent(graph, parentSharedID, meta);
 						parents.push_back(parentSharedID);
 					}
 				}
 				else {
 					repo::lib::RepoUUID parentSharedID = node->getSharedID();
-					if (graph.parentToChildren.find(parentSharedID) == graph.parentToChildren.end())
-						graph.parentToChildren[parentSharedID] = std::vector<RepoNode*>();
-
-					graph.parentToChildren[parentSharedID].push_back(meta);
+					addChildToParent(graph, parentSharedID, meta);
 					parents.push_back(parentSharedID);
 				}
 			}
@@ -433,21 +478,7 @@ bool RepoScene::addNodeToMaps(
 		for (it = parentIDs.begin(); it != parentIDs.end(); ++it)
 		{
 			//add itself to the parent on the "parent -> children" map
-			repo::lib::RepoUUID parent = *it;
-
-			//check if the parent already has an entry
-			auto mapIt = g.parentToChildren.find(parent);
-			if (mapIt != g.parentToChildren.end()) {
-				//has an entry, add to the vector
-				g.parentToChildren[parent].push_back(node);
-			}
-			else {
-				//no entry, create one
-				std::vector<RepoNode*> children;
-				children.push_back(node);
-
-				g.parentToChildren[parent] = children;
-			}
+			addChildToParent(g, *it, node);
 		}
 	} //if (!node->hasField(REPO_NODE_LABEL_PARENTS))
 
@@ -487,6 +518,7 @@ void RepoScene::clearStash()
 	stashGraph.nodesByUniqueID.clear();
 	stashGraph.sharedIDtoUniqueID.clear();
 	stashGraph.parentToChildren.clear();
+	stashGraph.parentChildEdges.clear();
 	stashGraph.referenceToScene.clear(); //how will this work for stash?
 
 	stashGraph.rootNode = nullptr;
@@ -1336,7 +1368,16 @@ void RepoScene::removeNode(
 		//Remove entry from everything.
 		g.nodesByUniqueID.erase(node->getUniqueID());
 		g.sharedIDtoUniqueID.erase(sharedID);
-		g.parentToChildren.erase(sharedID);
+		auto childrenIt = g.parentToChildren.find(sharedID);
+		if (childrenIt != g.parentToChildren.end())
+		{
+			for (const auto &child : childrenIt->second)
+				g.parentChildEdges.erase(ParentChildEdge(sharedID, child));
+			g.parentToChildren.erase(childrenIt);
+		}
+		//the node may be deleted below, so no edge can keep pointing to it
+		for (const auto &parent : node->getParentIDs())
+			removeChildFromParent(g, parent, node);
 
 		bool keepNode = false;
 		if (gtype == GraphType::DEFAULT)
@@ -1671,6 +1712,41 @@ void RepoScene::shiftModel(
 	}
 }
 
+bool RepoScene::attachProfileToRevision(
+	repo::core::handler::AbstractDatabaseHandler *handler,
+	const RepoBSON &profile)
+{
+	bool success = false;
+	if (revNode)
+	{
+		RepoBSONBuilder builder;
+		builder.append(REPO_NODE_REVISION_LABEL_PROFILE, profile);
+		auto changes = builder.obj();
+		RevisionNode updatedRev = revNode->cloneAndAddFields(&changes, false);
+
+		if (handler)
+		{
+			std::string errMsg;
+			if (!(success = handler->upsertDocument(databaseName, projectName + "." + REPO_COLLECTION_HISTORY, updatedRev, true, errMsg)))
+			{
+				repoError << "Failed to attach profile to revision: " << errMsg;
+			}
+		}
+		else
+		{
+			repoError << "Cannot attach a profile to the revision without a database handler";
+		}
+
+		revNode->swap(updatedRev);
+	}
+	else
+	{
+		repoError << "Trying to attach a profile to a revision when the scene is not revisioned!";
+	}
+
+	return success;
+}
+
 bool RepoScene::updateRevisionStatus(
 	repo::core::handler::AbstractDatabaseHandler *handler,
 	const RevisionNode::UploadStatus &status)
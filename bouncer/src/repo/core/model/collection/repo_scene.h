@@ -22,6 +22,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "../../handler/repo_database_handler_abstract.h"
 #include "../../handler/fileservice/repo_file_manager.h"
@@ -37,6 +38,17 @@ namespace repo {
 		namespace model {
 			class REPO_API_EXPORT RepoScene
 			{
+				//! A (parent shared id, child) pair within parentToChildren
+				typedef std::pair<repo::lib::RepoUUID, const RepoNode*> ParentChildEdge;
+
+				struct ParentChildEdgeHasher
+				{
+					std::size_t operator()(const ParentChildEdge &edge) const
+					{
+						return edge.first.getHash() ^ (std::hash<const RepoNode*>()(edge.second) * 0x9E3779B9);
+					}
+				};
+
 				//FIXME: unsure as to whether i should make the graph a differen class.. struct for now.
 				struct repoGraphInstance
 				{
@@ -54,6 +66,7 @@ namespace repo {
 					std::unordered_map<repo::lib::RepoUUID, RepoNode*, repo::lib::RepoUUIDHasher> nodesByUniqueID;
 					std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher> sharedIDtoUniqueID; //** mapping of shared ID to Unique ID
 					ParentMap parentToChildren; //** mapping of shared id to its children's shared id
+					std::unordered_set<ParentChildEdge, ParentChildEdgeHasher> parentChildEdges; //** all the edges in parentToChildren, to find an edge without searching the children
 					std::unordered_map<repo::lib::RepoUUID, RepoScene*, repo::lib::RepoUUIDHasher> referenceToScene; //** mapping of reference ID to it's scene graph
 				};
 
@@ -490,6 +503,18 @@ namespace repo {
 					repo::core::handler::AbstractDatabaseHandler *handler,
 					const RevisionNode::UploadStatus &status);
 
+				/**
+				* Attach a profile report (see repo::lib::RepoProfiler) to the
+				* revision, replacing any attached before. This will also update
+				* the record within the database should a handler is supplied
+				* @param handler database handler to perform this action
+				* @param profile the report to attach
+				* @return returns true upon success
+				*/
+				bool attachProfileToRevision(
+					repo::core::handler::AbstractDatabaseHandler *handler,
+					const RepoBSON &profile);
+
 				/**
 				* --------------------- Node Relationship ----------------------
 				*/
@@ -559,6 +584,21 @@ namespace repo {
 					RepoNode  *child,
 					const bool      &noUpdate = false);
 
+				/**
+				* Introduce a number of parentships at once. This is equivalent
+				* to calling addInheritance for each pair, but each child is only
+				* updated once however many parents it gains, so the cost is
+				* linear in the number of edges.
+				* @param gType which graph are the nodes
+				* @param edges pairs of parent node and child node
+				* @param noUpdate if true, it will not be treated as
+				*        a change that is needed to be commited (only valid for default graph)
+				*/
+				void addInheritances(
+					const GraphType &gType,
+					const std::vector<std::pair<const RepoNode*, RepoNode*>> &edges,
+					const bool      &noUpdate = false);
+
 				/**
 				* Get children nodes of a specified parent
 				* @param g graph to retrieve from
@@ -926,6 +966,30 @@ namespace repo {
 					RepoNode *node,
 					std::string &errMsg);
 
+				/**
+				* Add a child to the parent's entry in parentToChildren
+				* @param g graph to modify
+				* @param parent shared id of the parent
+				* @param child child node
+				* @return returns false if the child was already there
+				*/
+				bool addChildToParent(
+					repoGraphInstance &g,
+					const repo::lib::RepoUUID &parent,
+					RepoNode *child);
+
+				/**
+				* Remove a child from the parent's entry in parentToChildren
+				* @param g graph to modify
+				* @param parent shared id of the parent
+				* @param child child node
+				* @return returns false if the child was not there
+				*/
+				bool removeChildFromParent(
+					repoGraphInstance &g,
+					const repo::lib::RepoUUID &parent,
+					RepoNode *child);
+
 				/**
 				* Commit a vector of nodes into the database
 				* @param handler database handler to perform the commit
@@ -63,12 +63,20 @@ namespace repo {
 	enum class DiffMode { DIFF_BY_ID, DIFF_BY_NAME };
 }
 
+//Simplified geometry standing in for the meshes of a partition
+struct repo_partitioning_proxy_t {
+	std::string                          name;
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<uint32_t>                faces; //triangle list
+};
+
 struct repo_partitioning_tree_t {
 	repo::PartitioningTreeType              type;
 	std::vector<repo_mesh_entry_t>            meshes; //mesh ids if it is a leaf node
 	float                             pValue; //partitioning value if not
 	std::shared_ptr<repo_partitioning_tree_t> left;
 	std::shared_ptr<repo_partitioning_tree_t> right;
+	repo_partitioning_proxy_t         proxy; //empty unless proxies are generated
 
 	//Construction of branch node
 	repo_partitioning_tree_t(
@@ -23,13 +23,93 @@
 using namespace repo::lib;
 
 #include <boost/functional/hash.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/thread/tss.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
 
 const std::string RepoUUID::defaultValue = "00000000-0000-0000-0000-000000000000";
 
+static const char hexDigits[] = "0123456789abcdef";
+
+typedef boost::uuids::basic_random_generator<boost::mt19937> UUIDGenerator;
+
+/*
+* The generator is not thread safe, so each thread has one of its own.
+* It is seeded from the system's entropy source on first use.
+* (thread_specific_ptr rather than thread_local, which Visual Studio 2013 lacks)
+*/
+static boost::thread_specific_ptr<UUIDGenerator> threadGenerator;
+
+static UUIDGenerator& getGenerator()
+{
+	auto gen = threadGenerator.get();
+	if (!gen)
+	{
+		gen = new UUIDGenerator();
+		threadGenerator.reset(gen);
+	}
+	return *gen;
+}
+
+static int hexValue(const char &c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+/*
+* Parse the hex representation of a uuid, with or without braces, and
+* either with all 4 dashes in their canonical position or with none
+* (the forms accepted by boost::uuids::string_generator)
+* @return returns false if the text is not a valid uuid
+*/
+static bool parseUUID(
+	const std::string &text,
+	boost::uuids::uuid &uuid)
+{
+	size_t begin = 0, end = text.size();
+	if (end && text[0] == '{')
+	{
+		if (text[end - 1] != '}')
+			return false;
+		++begin;
+		--end;
+	}
+
+	const size_t length = end - begin;
+	bool dashes;
+	if (length == 36)
+		dashes = true;
+	else if (length == 32)
+		dashes = false;
+	else
+		return false;
+
+	size_t pos = begin;
+	for (size_t i = 0; i < 16; ++i)
+	{
+		if (dashes && (i == 4 || i == 6 || i == 8 || i == 10))
+		{
+			if (text[pos++] != '-')
+				return false;
+		}
+
+		int high = hexValue(text[pos++]);
+		int low = hexValue(text[pos++]);
+		if (high < 0 || low < 0)
+			return false;
+		uuid.data[i] = (uint8_t)((high << 4) | low);
+	}
+
+	return true;
+}
+
 /*!
 * Returns a valid uuid representation of a given string. If empty, returns
 * a randomly generated uuid. If the string is not a uuid representation,
@@ -48,33 +128,19 @@ static boost::uuids::uuid stringToUUID(
 {
 	boost::uuids::uuid uuid;
 	if (text.empty())
-		return stringToUUID(RepoUUID::defaultValue);
-	else
+		return boost::uuids::nil_uuid();
+	else if (!parseUUID(text, uuid))
 	{
-		try
-		{
-			boost::uuids::string_generator gen;
-			if (text.substr(0, 1) != "{")
-				uuid = gen("{" + text + "}");
-			else
-				uuid = gen(text);
-		}
-		catch (std::runtime_error e)
-		{
-			// uniformly distributed hash
-			boost::hash<std::string> string_hash;
-			std::string hashedUUID;
-			std::stringstream str;
-			str << string_hash(text);
-			str >> hashedUUID;
-
-			// uuid: 8 + 4 + 4 + 4 + 12 = 32
-			// pad with zero, leave last places empty for suffix
-			while (hashedUUID.size() < 32 - suffix.size())
-				hashedUUID.append("0");
-			hashedUUID.append(suffix);
-			uuid = stringToUUID(hashedUUID, suffix);
-		}
+		// uniformly distributed hash
+		boost::hash<std::string> string_hash;
+		std::string hashedUUID = std::to_string(string_hash(text));
+
+		// uuid: 8 + 4 + 4 + 4 + 12 = 32
+		// pad with zero, leave last places empty for suffix
+		while (hashedUUID.size() < 32 - suffix.size())
+			hashedUUID.append("0");
+		hashedUUID.append(suffix);
+		uuid = stringToUUID(hashedUUID, suffix);
 	}
 	return uuid;
 }
@@ -116,13 +182,35 @@ RepoUUID RepoUUID::fromBSONElement(const repo::core::model::RepoBSONElement &ele
 
 RepoUUID RepoUUID::createUUID()
 {
-	static boost::uuids::random_generator gen;
-	return RepoUUID(gen());
+	return RepoUUID(getGenerator()());
+}
+
+std::vector<RepoUUID> RepoUUID::createUUIDs(const size_t &count)
+{
+	auto &gen = getGenerator();
+	std::vector<RepoUUID> uuids;
+	uuids.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+		uuids.push_back(RepoUUID(gen()));
+	return uuids;
+}
+
+void RepoUUID::toString(char *buffer) const
+{
+	for (size_t i = 0; i < 16; ++i)
+	{
+		if (i == 4 || i == 6 || i == 8 || i == 10)
+			*buffer++ = '-';
+		*buffer++ = hexDigits[id.data[i] >> 4];
+		*buffer++ = hexDigits[id.data[i] & 0x0F];
+	}
 }
 
 std::string RepoUUID::toString() const
 {
-	return boost::lexical_cast<std::string>(id);
+	std::string str(36, '-');
+	toString(&str[0]);
+	return str;
 }
 
 RepoUUID& RepoUUID::operator =(const RepoUUID& uuid)
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <vector>
 #include <boost/uuid/uuid.hpp>
 #include "../../core/model/bson/repo_bson_element.h"
 
@@ -32,7 +33,19 @@ namespace repo {
 
 			RepoUUID(const std::string &stringRep = defaultValue);
 
+			/**
+			* Generate a random (version 4) UUID. Each thread has its own
+			* generator, so this is safe to call concurrently without locking.
+			*/
 			static RepoUUID createUUID();
+
+			/**
+			* Generate a number of random UUIDs at once
+			* @param count number of UUIDs to generate
+			* @return returns a vector of count distinct UUIDs
+			*/
+			static std::vector<RepoUUID> createUUIDs(const size_t &count);
+
 			static RepoUUID fromBSONElement(const repo::core::model::RepoBSONElement &ele);
 
 			/**
@@ -42,7 +55,7 @@ namespace repo {
 			std::vector<uint8_t> data() const { return std::vector<uint8_t>(std::begin(id.data), std::end(id.data)); }
 
 			bool isDefaultValue() const {
-				return toString() == defaultValue;
+				return id.is_nil();
 			}
 
 			size_t getHash() const;
@@ -53,6 +66,13 @@ namespace repo {
 			*/
 			std::string toString() const;
 
+			/**
+			* Write the string representation of the RepoUUID (36 characters,
+			* without a null terminator) into the given buffer
+			* @param buffer buffer of at least 36 characters
+			*/
+			void toString(char *buffer) const;
+
 			static const std::string defaultValue;
 
 			RepoUUID& operator=(const RepoUUID& uuid);
@@ -128,6 +128,12 @@ RepoConfig RepoConfig::fromFile(const std::string &filePath) {
 			config.configureFS(path, level, useAsDefault == "fs" || useAsDefault.empty());
 	}
 
+	auto threads = jsonTree.get<int>("threads", 0);
+	config.setNumThreads(threads > 0 ? threads : 0);
+
+	auto meshCacheMB = jsonTree.get<int>("meshCacheMB", config.getMeshCacheSize());
+	config.setMeshCacheSize(meshCacheMB > 0 ? meshCacheMB : 0);
+
 	return config;
 }
 
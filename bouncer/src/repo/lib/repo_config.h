@@ -16,6 +16,7 @@
 */
 
 #pragma once
+#include <cstdint>
 #include <string>
 #include "../repo_bouncer_global.h"
 #include "../core/model/bson/repo_bson_ref.h"
@@ -111,6 +112,33 @@ namespace repo {
 			const s3_config_t getS3Config() const { return s3Conf; }
 			const fs_config_t getFSConfig() const { return fsConf; }
 
+			/**
+			* Set the number of worker threads to run parallel work on
+			* @params nThreads number of threads, 0 to use one per hardware thread
+			*/
+			void setNumThreads(const uint32_t &nThreads) { numThreads = nThreads; }
+
+			/**
+			* Get the number of worker threads to run parallel work on
+			* @return returns the number of threads, 0 if unset
+			*/
+			uint32_t getNumThreads() const { return numThreads; }
+
+			/**
+			* Set the memory available to keep mesh reorganisations in, so
+			* exports of several web formats reorganise each mesh only once.
+			* Disabled by default, as most runs export a single format and the
+			* entries would only add to their peak memory.
+			* @params sizeMB size of the cache in MiB, 0 to disable it
+			*/
+			void setMeshCacheSize(const uint32_t &sizeMB) { meshCacheSize = sizeMB; }
+
+			/**
+			* Get the memory available to keep mesh reorganisations in
+			* @return returns the size of the cache in MiB
+			*/
+			uint32_t getMeshCacheSize() const { return meshCacheSize; }
+
 			/**
 			* Get default storage engine currently configured
 			* @return returns the default engine of choice for new writes
@@ -124,6 +152,8 @@ namespace repo {
 			s3_config_t s3Conf;
 			fs_config_t fsConf;
 			FileStorageEngine defaultStorage;
+			uint32_t numThreads = 0;
+			uint32_t meshCacheSize = 0;
 		};
 	}
 }
@@ -32,7 +32,11 @@ namespace repo{
 		class LogToStdout : public RepoAbstractListener
 		{
 		public:
-			LogToStdout() {}
+			/**
+			* @param stream stream to write the messages to (e.g. std::cerr
+			*               when stdout is reserved for other output)
+			*/
+			LogToStdout(std::ostream &stream = std::cout) : stream(stream) {}
 			~LogToStdout(){};
 
 			virtual void messageGenerated(const std::string &message)
@@ -43,10 +47,11 @@ namespace repo{
 				std::transform(severity.begin(), severity.end(), severity.begin(), ::toupper);
 				const std::string actualMessage = message.substr(secPos + 1);
 
-				std::cout << "[" << getTimeAsString() << "][" << severity << "]: " << actualMessage;
+				stream << "[" << getTimeAsString() << "][" << severity << "]: " << actualMessage;
 			};
 
 		private:
+			std::ostream &stream;
 
 			static std::string getTimeAsString()
 			{
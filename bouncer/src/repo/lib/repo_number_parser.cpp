@@ -0,0 +1,164 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "repo_number_parser.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+static bool isDigit(const char &c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static char toLowerAscii(const char &c)
+{
+	return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+/**
+* Case insensitive comparison of str[pos, end) against a lower case word
+*/
+static bool matchesWord(
+	const std::string &str,
+	const size_t      &pos,
+	const size_t      &end,
+	const char        *word)
+{
+	size_t i = pos;
+	for (; i < end && *word; ++i, ++word)
+	{
+		if (toLowerAscii(str[i]) != *word)
+			return false;
+	}
+	return i == end && !*word;
+}
+
+bool repo::lib::parseInteger(
+	const std::string &str,
+	long long         &value)
+{
+	size_t pos = 0;
+	bool negative = false;
+	if (pos < str.size() && (str[pos] == '-' || str[pos] == '+'))
+	{
+		negative = str[pos] == '-';
+		++pos;
+	}
+
+	if (pos == str.size())
+		return false;
+
+	//Accumulate in unsigned so the most negative value can be represented
+	const unsigned long long limit = negative ?
+		(unsigned long long)std::numeric_limits<long long>::max() + 1 :
+		(unsigned long long)std::numeric_limits<long long>::max();
+	unsigned long long result = 0;
+	for (; pos < str.size(); ++pos)
+	{
+		if (!isDigit(str[pos]))
+			return false;
+
+		const unsigned digit = str[pos] - '0';
+		if (result > (limit - digit) / 10)
+			return false;
+		result = result * 10 + digit;
+	}
+
+	value = negative ? (long long)(0 - result) : (long long)result;
+	return true;
+}
+
+bool repo::lib::parseDouble(
+	const std::string &str,
+	double            &value)
+{
+	const size_t end = str.size();
+	size_t pos = 0;
+	bool negative = false;
+	if (pos < end && (str[pos] == '-' || str[pos] == '+'))
+	{
+		negative = str[pos] == '-';
+		++pos;
+	}
+
+	if (pos == end)
+		return false;
+
+	//Special values
+	if (!isDigit(str[pos]) && str[pos] != '.')
+	{
+		if (matchesWord(str, pos, end, "inf") || matchesWord(str, pos, end, "infinity"))
+		{
+			value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+			return true;
+		}
+
+		//nan, optionally followed by (chars)
+		if (end - pos >= 3 && matchesWord(str, pos, pos + 3, "nan"))
+		{
+			size_t i = pos + 3;
+			if (i != end)
+			{
+				if (str[i] != '(' || str[end - 1] != ')')
+					return false;
+				for (++i; i < end - 1; ++i)
+				{
+					if (!isalnum((unsigned char)str[i]) && str[i] != '_')
+						return false;
+				}
+			}
+			value = negative ? -std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::quiet_NaN();
+			return true;
+		}
+
+		return false;
+	}
+
+	//Validate the grammar first, so strtod does not accept anything
+	//lexical_cast would not (hexadecimal, leading whitespace...)
+	size_t nDigits = 0;
+	for (; pos < end && isDigit(str[pos]); ++pos) ++nDigits;
+	if (pos < end && str[pos] == '.')
+	{
+		for (++pos; pos < end && isDigit(str[pos]); ++pos) ++nDigits;
+	}
+
+	if (!nDigits)
+		return false;
+
+	if (pos < end && (str[pos] == 'e' || str[pos] == 'E'))
+	{
+		++pos;
+		if (pos < end && (str[pos] == '-' || str[pos] == '+'))
+			++pos;
+
+		size_t nExpDigits = 0;
+		for (; pos < end && isDigit(str[pos]); ++pos) ++nExpDigits;
+		if (!nExpDigits)
+			return false;
+	}
+
+	if (pos != end)
+		return false;
+
+	value = std::strtod(str.c_str(), nullptr);
+
+	//Out of range values are rejected, as they are by lexical_cast
+	return !std::isinf(value);
+}
@@ -0,0 +1,56 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+* Non throwing number parsing, used to type metadata values.
+* Strings are classified with the same rules as boost::lexical_cast, without
+* the cost of throwing and catching an exception for every string that is not
+* a number.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "../repo_bouncer_global.h"
+
+namespace repo {
+	namespace lib {
+		/**
+		* Parse a string as a signed 64 bit integer
+		* Accepts an optional sign followed by decimal digits only,
+		* as boost::lexical_cast<long long> would
+		* @param str string to parse
+		* @param value returns the parsed value upon success
+		* @return returns true if the whole string is an integer within range
+		*/
+		REPO_API_EXPORT bool parseInteger(
+			const std::string &str,
+			long long         &value);
+
+		/**
+		* Parse a string as a double
+		* Accepts what boost::lexical_cast<double> would: an optional sign,
+		* a decimal number with an optional exponent, or inf, infinity and nan.
+		* @param str string to parse
+		* @param value returns the parsed value upon success
+		* @return returns true if the whole string is a number within range
+		*/
+		REPO_API_EXPORT bool parseDouble(
+			const std::string &str,
+			double            &value);
+	}
+}
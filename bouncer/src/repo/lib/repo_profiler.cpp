@@ -0,0 +1,446 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "repo_log.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+#endif
+
+using namespace repo::lib;
+
+static std::atomic<uint64_t> allocationCount(0);
+static std::atomic<uint64_t> allocatedBytes(0);
+
+#ifdef REPO_PROFILE_ALLOCATIONS
+/*
+* Replacements of the global allocation functions, counting every allocation.
+* On Windows this only sees the allocations made by this library itself.
+*/
+static void* countedAlloc(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new(std::size_t size)
+{
+	if (void *ptr = countedAlloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	if (void *ptr = countedAlloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+#endif
+
+namespace {
+	struct OpenStage
+	{
+		std::vector<RepoProfileStage>::size_type index;
+		uint32_t generation;
+		std::chrono::steady_clock::time_point start;
+		uint64_t allocations;
+		uint64_t allocatedBytes;
+		bool recorded; //false if the profiler was disabled when the stage was entered
+	};
+
+	//Stages currently open on this thread, innermost last
+	//(thread_specific_ptr rather than thread_local, which Visual Studio 2013 lacks)
+	boost::thread_specific_ptr<std::vector<OpenStage>> threadOpenStages;
+
+	std::vector<OpenStage>& getOpenStages()
+	{
+		auto openStages = threadOpenStages.get();
+		if (!openStages)
+		{
+			openStages = new std::vector<OpenStage>();
+			threadOpenStages.reset(openStages);
+		}
+		return *openStages;
+	}
+
+	std::string escapeJSON(const std::string &str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+		for (const char &c : str)
+		{
+			switch (c)
+			{
+			case '"': escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\n': escaped += "\\n"; break;
+			case '\t': escaped += "\\t"; break;
+			default:
+				if ((unsigned char)c < 0x20)
+				{
+					char buffer[8];
+					std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+					escaped += buffer;
+				}
+				else
+				{
+					escaped += c;
+				}
+			}
+		}
+		return escaped;
+	}
+}
+
+RepoProfiler::RepoProfiler() :
+	jobStart(std::chrono::steady_clock::now()),
+	generation(0),
+	enabled(true)
+{
+}
+
+RepoProfiler &RepoProfiler::getInstance()
+{
+	static RepoProfiler profiler;
+	return profiler;
+}
+
+void RepoProfiler::startJob(const std::string &name)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	jobName = name;
+	jobStart = std::chrono::steady_clock::now();
+	stages.clear();
+	++generation;
+}
+
+std::string RepoProfiler::getJobName() const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return jobName;
+}
+
+void RepoProfiler::setEnabled(const bool &enabled)
+{
+	this->enabled = enabled;
+}
+
+bool RepoProfiler::isEnabled() const
+{
+	return enabled;
+}
+
+std::vector<RepoProfileStage>::size_type RepoProfiler::findOrAddStage(
+	const std::string &path,
+	const uint32_t &depth)
+{
+	//Jobs have tens of stages at most, a linear search is as quick as hashing the path
+	for (std::vector<RepoProfileStage>::size_type i = 0; i < stages.size(); ++i)
+	{
+		if (stages[i].path == path)
+			return i;
+	}
+
+	RepoProfileStage stage;
+	stage.path = path;
+	stage.depth = depth;
+	stage.calls = 0;
+	stage.totalSeconds = 0;
+	stage.maxSeconds = 0;
+	stage.rssStartBytes = 0;
+	stage.rssEndBytes = 0;
+	stage.peakRssBytes = 0;
+	stage.allocations = 0;
+	stage.allocatedBytes = 0;
+	stages.push_back(stage);
+	return stages.size() - 1;
+}
+
+void RepoProfiler::beginStage(const std::string &name)
+{
+	auto &openStages = getOpenStages();
+
+	OpenStage open;
+	open.recorded = enabled;
+	if (!open.recorded)
+	{
+		//Still pushed, so the matching endStage pops this rather than an enclosing stage
+		openStages.push_back(open);
+		return;
+	}
+
+	auto rss = getCurrentRSS();
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		std::string path = name;
+		uint32_t depth = 0;
+		if (openStages.size() && openStages.back().generation == generation)
+		{
+			const auto &parent = stages[openStages.back().index];
+			path = parent.path + "/" + name;
+			depth = parent.depth + 1;
+		}
+
+		open.index = findOrAddStage(path, depth);
+		open.generation = generation;
+		if (!stages[open.index].calls)
+			stages[open.index].rssStartBytes = rss;
+	}
+
+	open.allocations = getAllocationCount();
+	open.allocatedBytes = getAllocatedBytes();
+	open.start = std::chrono::steady_clock::now();
+	openStages.push_back(open);
+}
+
+void RepoProfiler::endStage()
+{
+	auto &openStages = getOpenStages();
+	if (openStages.empty())
+	{
+		repoError << "Profiler stage ended without a matching start";
+		return;
+	}
+
+	if (!openStages.back().recorded)
+	{
+		openStages.pop_back();
+		return;
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	auto allocations = getAllocationCount();
+	auto bytes = getAllocatedBytes();
+	auto rss = getCurrentRSS();
+	auto peakRss = std::max(getPeakRSS(), rss);
+
+	auto open = openStages.back();
+	openStages.pop_back();
+
+	boost::mutex::scoped_lock lock(mutex);
+	if (open.generation != generation)
+		return; //opened before the current job started
+
+	double seconds = std::chrono::duration<double>(end - open.start).count();
+	auto &stage = stages[open.index];
+	++stage.calls;
+	stage.totalSeconds += seconds;
+	if (seconds > stage.maxSeconds)
+		stage.maxSeconds = seconds;
+	stage.rssEndBytes = rss;
+	stage.peakRssBytes = peakRss;
+	stage.allocations += allocations - open.allocations;
+	stage.allocatedBytes += bytes - open.allocatedBytes;
+}
+
+std::vector<RepoProfileStage> RepoProfiler::getStages() const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return stages;
+}
+
+std::string RepoProfiler::toJSON() const
+{
+	std::string name;
+	double elapsed;
+	std::vector<RepoProfileStage> completed;
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		name = jobName;
+		elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - jobStart).count();
+		for (const auto &stage : stages)
+		{
+			if (stage.calls)
+				completed.push_back(stage);
+		}
+	}
+
+	std::stringstream ss;
+	ss << std::setprecision(6) << std::fixed;
+	ss << "{\n";
+	ss << "\t\"job\": \"" << escapeJSON(name) << "\",\n";
+	ss << "\t\"totalSeconds\": " << elapsed << ",\n";
+	ss << "\t\"peakRssBytes\": " << getPeakRSS() << ",\n";
+#ifdef REPO_PROFILE_ALLOCATIONS
+	ss << "\t\"allocationsCounted\": true,\n";
+#else
+	ss << "\t\"allocationsCounted\": false,\n";
+#endif
+	ss << "\t\"stages\": [";
+	for (size_t i = 0; i < completed.size(); ++i)
+	{
+		const auto &stage = completed[i];
+		ss << (i ? ",\n" : "\n");
+		ss << "\t\t{";
+		ss << "\"path\": \"" << escapeJSON(stage.path) << "\", ";
+		ss << "\"depth\": " << stage.depth << ", ";
+		ss << "\"calls\": " << stage.calls << ", ";
+		ss << "\"totalSeconds\": " << stage.totalSeconds << ", ";
+		ss << "\"maxSeconds\": " << stage.maxSeconds << ", ";
+		ss << "\"rssStartBytes\": " << stage.rssStartBytes << ", ";
+		ss << "\"rssEndBytes\": " << stage.rssEndBytes << ", ";
+		ss << "\"peakRssBytes\": " << stage.peakRssBytes << ", ";
+		ss << "\"allocations\": " << stage.allocations << ", ";
+		ss << "\"allocatedBytes\": " << stage.allocatedBytes;
+		ss << "}";
+	}
+	ss << (completed.size() ? "\n\t]\n" : "]\n");
+	ss << "}\n";
+	return ss.str();
+}
+
+bool RepoProfiler::writeReport(
+	const std::string &directory,
+	std::string &filePath) const
+{
+	time_t rawtime;
+	time(&rawtime);
+	char timeStr[80];
+	strftime(timeStr, 80, "%Y-%m-%d_%Hh%Mm%S", localtime(&rawtime));
+
+	std::string name = getJobName();
+	if (name.empty())
+		name = "job";
+
+	boost::system::error_code ec;
+	boost::filesystem::path dir(directory);
+	boost::filesystem::create_directories(dir, ec);
+	filePath = (dir / (std::string(timeStr) + "_" + name + "_profile.json")).string();
+
+	std::ofstream out(filePath);
+	if (!out.good())
+	{
+		repoError << "Failed to write profile report to " << filePath;
+		return false;
+	}
+
+	out << toJSON();
+	out.close();
+	repoInfo << "Profile report written to " << filePath;
+	return true;
+}
+
+uint64_t RepoProfiler::getCurrentRSS()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return 0;
+#elif defined(__APPLE__)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+		return info.resident_size;
+	return 0;
+#else
+	uint64_t rss = 0;
+	if (FILE *statm = std::fopen("/proc/self/statm", "r"))
+	{
+		unsigned long size, resident;
+		if (std::fscanf(statm, "%lu %lu", &size, &resident) == 2)
+			rss = (uint64_t)resident * sysconf(_SC_PAGESIZE);
+		std::fclose(statm);
+	}
+	return rss;
+#endif
+}
+
+uint64_t RepoProfiler::getPeakRSS()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage))
+		return 0;
+#if defined(__APPLE__)
+	uint64_t peak = usage.ru_maxrss; //bytes on macOS
+#else
+	uint64_t peak = (uint64_t)usage.ru_maxrss * 1024; //kilobytes on Linux
+#endif
+	//The kernel updates the high water mark lazily, so it can trail the current size
+	return std::max(peak, getCurrentRSS());
+#endif
+}
+
+uint64_t RepoProfiler::getAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t RepoProfiler::getAllocatedBytes()
+{
+	return allocatedBytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,182 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Lightweight profiler for the import and stash pipeline.
+* Stages are marked with REPO_PROFILE_SCOPE and aggregated by their nested
+* path (e.g. "commitScene/generateStashGraph/MultipartOptimizer::apply"), so
+* a job produces one line per distinct stage however many times it runs.
+* Scopes take a lock and sample the resident set size on entry and exit,
+* so they are meant for coarse stages, not inner loops.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#include "../repo_bouncer_global.h"
+
+#define REPO_PROFILE_CONCAT_IMPL(A, B) A##B
+#define REPO_PROFILE_CONCAT(A, B) REPO_PROFILE_CONCAT_IMPL(A, B)
+#define REPO_PROFILE_SCOPE(NAME) repo::lib::RepoProfilerScope REPO_PROFILE_CONCAT(repoProfilerScope, __LINE__)(NAME)
+
+namespace repo {
+	namespace lib {
+		struct RepoProfileStage
+		{
+			std::string path; //names of the enclosing stages and this stage, separated by '/'
+			uint32_t depth; //0 for stages opened outside of any other stage
+			uint64_t calls;
+			double totalSeconds;
+			double maxSeconds;
+			uint64_t rssStartBytes; //resident set size when the stage was first entered
+			uint64_t rssEndBytes; //resident set size when the stage was last left
+			uint64_t peakRssBytes; //process high water mark when the stage was last left
+			uint64_t allocations; //only counted when built with REPO_PROFILE_ALLOCATIONS
+			uint64_t allocatedBytes;
+		};
+
+		class REPO_API_EXPORT RepoProfiler
+		{
+		public:
+			static RepoProfiler &getInstance();
+
+			/**
+			* Start a new job, discarding the stages recorded so far
+			* @param name name of the job (e.g. the client command)
+			*/
+			void startJob(const std::string &name);
+
+			std::string getJobName() const;
+
+			/**
+			* Enable or disable recording of stages. Stages are attributed to
+			* the current job, so recording should be disabled while several
+			* jobs run concurrently. Enabled by default.
+			* @param enabled true to record stages
+			*/
+			void setEnabled(const bool &enabled);
+
+			/**
+			* @return returns true if stages are being recorded
+			*/
+			bool isEnabled() const;
+
+			/**
+			* Enter a stage on the calling thread. Stages entered on a
+			* thread with no open stage are recorded at the top level.
+			* Prefer REPO_PROFILE_SCOPE, which pairs this with endStage.
+			* @param name name of the stage, unique within its parent
+			*/
+			void beginStage(const std::string &name);
+
+			/**
+			* Leave the innermost stage opened on the calling thread
+			*/
+			void endStage();
+
+			/**
+			* Get the stages recorded for the current job, in the order
+			* they were first entered
+			* @return returns a copy of the aggregated stages
+			*/
+			std::vector<RepoProfileStage> getStages() const;
+
+			/**
+			* Serialise the job and its stages as JSON. Stages still open
+			* are not included.
+			* @return returns the report as a JSON string
+			*/
+			std::string toJSON() const;
+
+			/**
+			* Write the report of the current job into the given directory,
+			* named <time>_<job>_profile.json to sit next to the log files
+			* @param directory directory to write into
+			* @param filePath returns the path of the report written
+			* @return returns true upon success
+			*/
+			bool writeReport(
+				const std::string &directory,
+				std::string &filePath) const;
+
+			/**
+			* @return returns the resident set size of the process in bytes,
+			*         or 0 if it is not available on this platform
+			*/
+			static uint64_t getCurrentRSS();
+
+			/**
+			* @return returns the peak resident set size of the process in bytes,
+			*         or 0 if it is not available on this platform
+			*/
+			static uint64_t getPeakRSS();
+
+			/**
+			* @return returns the number of heap allocations made so far. This
+			*         is always 0 unless built with REPO_PROFILE_ALLOCATIONS.
+			*/
+			static uint64_t getAllocationCount();
+
+			/**
+			* @return returns the number of bytes allocated on the heap so far
+			*         (not net of frees). Always 0 unless built with REPO_PROFILE_ALLOCATIONS.
+			*/
+			static uint64_t getAllocatedBytes();
+
+		private:
+			RepoProfiler();
+
+			std::vector<RepoProfileStage>::size_type findOrAddStage(
+				const std::string &path,
+				const uint32_t &depth);
+
+			mutable boost::mutex mutex;
+			std::string jobName;
+			std::chrono::steady_clock::time_point jobStart;
+			std::vector<RepoProfileStage> stages;
+			uint32_t generation; //incremented per job, so stages open across startJob are dropped
+			std::atomic<bool> enabled;
+		};
+
+		/**
+		* Marks a stage for the lifetime of the object
+		*/
+		class REPO_API_EXPORT RepoProfilerScope
+		{
+		public:
+			RepoProfilerScope(const std::string &name)
+			{
+				RepoProfiler::getInstance().beginStage(name);
+			}
+
+			~RepoProfilerScope()
+			{
+				RepoProfiler::getInstance().endStage();
+			}
+
+		private:
+			RepoProfilerScope(const RepoProfilerScope &);
+			RepoProfilerScope &operator=(const RepoProfilerScope &);
+		};
+	}
+}
@@ -0,0 +1,254 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_task_executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <boost/thread/tss.hpp>
+
+using namespace repo::lib;
+
+static boost::mutex defaultMutex;
+static RepoTaskExecutor *defaultExecutor = nullptr;
+
+struct WorkerThread {
+	const RepoTaskExecutor *executor;
+	uint32_t queue;
+};
+
+//Executor and queue owned by the current thread, if it is a worker
+//(thread_specific_ptr rather than thread_local, which Visual Studio 2013 lacks)
+static boost::thread_specific_ptr<WorkerThread> currentWorker;
+
+/**
+* Get the queue owned by the current thread in the given executor
+* @return returns false if the thread is not one of its workers
+*/
+static bool getWorkerQueue(
+	const RepoTaskExecutor *executor,
+	uint32_t &queue)
+{
+	auto worker = currentWorker.get();
+	if (!worker || worker->executor != executor)
+		return false;
+	queue = worker->queue;
+	return true;
+}
+
+RepoTaskExecutor::RepoTaskExecutor(const uint32_t &nThreads) :
+	nQueued(0),
+	nextQueue(0),
+	stopping(false)
+{
+	uint32_t n = nThreads ? nThreads : boost::thread::hardware_concurrency();
+	n = std::max<uint32_t>(n, 1);
+
+	for (uint32_t i = 0; i < n; ++i)
+		queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+
+	for (uint32_t i = 0; i < n; ++i)
+		workers.create_thread(boost::bind(&RepoTaskExecutor::processQueues, this, i));
+}
+
+RepoTaskExecutor::~RepoTaskExecutor()
+{
+	{
+		boost::mutex::scoped_lock lock(wakeMutex);
+		stopping = true;
+	}
+	taskAvailable.notify_all();
+	workers.join_all();
+}
+
+RepoTaskExecutor &RepoTaskExecutor::getDefault()
+{
+	{
+		boost::mutex::scoped_lock lock(defaultMutex);
+		if (defaultExecutor)
+			return *defaultExecutor;
+	}
+
+	static RepoTaskExecutor fallback;
+	return fallback;
+}
+
+void RepoTaskExecutor::setDefault(RepoTaskExecutor *executor)
+{
+	boost::mutex::scoped_lock lock(defaultMutex);
+	defaultExecutor = executor;
+}
+
+void RepoTaskExecutor::submit(const Task &task)
+{
+	uint32_t index;
+	if (!getWorkerQueue(this, index))
+		index = nextQueue++ % queues.size();
+	{
+		boost::mutex::scoped_lock lock(queues[index]->mutex);
+		queues[index]->tasks.push_back(task);
+	}
+
+	{
+		//Taken so a worker cannot miss the notification between checking nQueued and waiting
+		boost::mutex::scoped_lock lock(wakeMutex);
+		++nQueued;
+	}
+	taskAvailable.notify_one();
+}
+
+bool RepoTaskExecutor::takeTask(const uint32_t &index, Task &task)
+{
+	if (!nQueued)
+		return false;
+
+	{
+		auto &own = *queues[index];
+		boost::mutex::scoped_lock lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			--nQueued;
+			return true;
+		}
+	}
+
+	for (uint32_t i = 1; i < queues.size(); ++i)
+	{
+		auto &victim = *queues[(index + i) % queues.size()];
+		boost::mutex::scoped_lock lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			--nQueued;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void RepoTaskExecutor::processQueues(const uint32_t &index)
+{
+	currentWorker.reset(new WorkerThread{ this, index });
+
+	Task task;
+	while (true)
+	{
+		if (takeTask(index, task))
+		{
+			task();
+			task = nullptr;
+			continue;
+		}
+
+		boost::mutex::scoped_lock lock(wakeMutex);
+		while (!stopping && !nQueued)
+			taskAvailable.wait(lock);
+		if (stopping && !nQueued)
+			break;
+	}
+
+	currentWorker.reset();
+}
+
+void RepoTaskExecutor::parallelFor(
+	const size_t &count,
+	const std::function<void(size_t)> &fn,
+	const size_t &grainSize)
+{
+	if (!count)
+		return;
+
+	struct LoopState
+	{
+		std::atomic<size_t> next;
+		std::atomic<uint32_t> nPending;
+		std::atomic<bool> failed;
+		std::exception_ptr error;
+		boost::mutex mutex;
+		boost::condition_variable finished;
+	};
+
+	const size_t grain = std::max<size_t>(grainSize, 1);
+	const size_t nChunks = (count + grain - 1) / grain;
+	const uint32_t nHelpers = (uint32_t)std::min<size_t>(getNumThreads(), nChunks - 1);
+
+	auto state = std::make_shared<LoopState>();
+	state->next = 0;
+	state->nPending = nHelpers;
+	state->failed = false;
+
+	//fn is captured by reference: the caller does not return before every helper has run
+	auto runChunks = [state, &fn, count, grain]() {
+		size_t begin;
+		while (!state->failed && (begin = state->next.fetch_add(grain)) < count)
+		{
+			try {
+				const size_t end = std::min(begin + grain, count);
+				for (size_t i = begin; i < end; ++i)
+					fn(i);
+			}
+			catch (...)
+			{
+				boost::mutex::scoped_lock lock(state->mutex);
+				if (!state->error)
+					state->error = std::current_exception();
+				state->failed = true;
+			}
+		}
+	};
+
+	for (uint32_t i = 0; i < nHelpers; ++i)
+	{
+		submit([state, runChunks]() {
+			runChunks();
+			if (--state->nPending == 0)
+			{
+				boost::mutex::scoped_lock lock(state->mutex);
+				state->finished.notify_all();
+			}
+		});
+	}
+
+	runChunks();
+
+	//Help with whatever is queued until the helpers have all run. Once nothing
+	//can be taken, any helper still pending is running on a worker.
+	uint32_t index;
+	if (!getWorkerQueue(this, index))
+		index = 0;
+	Task task;
+	while (state->nPending)
+	{
+		if (takeTask(index, task))
+		{
+			task();
+			task = nullptr;
+			continue;
+		}
+
+		boost::mutex::scoped_lock lock(state->mutex);
+		while (state->nPending)
+			state->finished.wait(lock);
+	}
+
+	if (state->error)
+		std::rethrow_exception(state->error);
+}
@@ -0,0 +1,133 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Task executor shared by the managers, optimizers and exporters.
+* A fixed set of worker threads, each with its own queue of tasks. Workers
+* take from the back of their own queue and steal from the front of the
+* others when it runs dry. Threads waiting on a parallelFor help run queued
+* tasks, so nested parallel loops cannot deadlock the pool.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <boost/thread.hpp>
+
+#include "../repo_bouncer_global.h"
+
+namespace repo {
+	namespace lib {
+		class REPO_API_EXPORT RepoTaskExecutor
+		{
+		public:
+			typedef std::function<void()> Task;
+
+			/**
+			* Create an executor and start its worker threads
+			* @param nThreads number of worker threads, 0 to use one per hardware thread
+			*/
+			RepoTaskExecutor(const uint32_t &nThreads = 0);
+
+			/**
+			* Runs any tasks still queued, then stops the worker threads
+			*/
+			~RepoTaskExecutor();
+
+			/**
+			* Get the executor the library should run parallel work on. This is the
+			* one registered by the controller, or, if none is, one sized to the
+			* hardware created on first use.
+			* @return returns the default executor
+			*/
+			static RepoTaskExecutor &getDefault();
+
+			/**
+			* Register the executor returned by getDefault(). The caller keeps
+			* ownership, and must unregister it (by passing nullptr) before
+			* destroying it.
+			* @param executor executor to use, nullptr to revert to the fallback
+			*/
+			static void setDefault(RepoTaskExecutor *executor);
+
+			/**
+			* Get the number of worker threads
+			* @return returns the number of worker threads
+			*/
+			uint32_t getNumThreads() const
+			{
+				return queues.size();
+			}
+
+			/**
+			* Queue a task to run on a worker thread. Tasks submitted from a worker
+			* go to the back of its own queue. A task must not throw.
+			* @param task task to run
+			*/
+			void submit(const Task &task);
+
+			/**
+			* Call fn(i) for every i in [0, count), spread over the worker threads
+			* and the calling thread, and return once all calls have completed.
+			* If any call throws, the remaining indices are skipped and the first
+			* exception is rethrown to the caller.
+			* @param count number of indices
+			* @param fn function to call with each index
+			* @param grainSize number of consecutive indices claimed at once
+			*/
+			void parallelFor(
+				const size_t &count,
+				const std::function<void(size_t)> &fn,
+				const size_t &grainSize = 1);
+
+		private:
+			struct WorkerQueue
+			{
+				boost::mutex mutex;
+				std::deque<Task> tasks;
+			};
+
+			/**
+			* Worker loop, running tasks until the executor is destroyed
+			*/
+			void processQueues(const uint32_t &index);
+
+			/**
+			* Take a task, preferring the back of the given queue and then
+			* stealing from the front of the others
+			* @param index queue to start with
+			* @param task returns the task taken
+			* @return returns true if a task was taken
+			*/
+			bool takeTask(const uint32_t &index, Task &task);
+
+			std::vector<std::unique_ptr<WorkerQueue>> queues;
+			std::atomic<size_t> nQueued;
+			std::atomic<uint32_t> nextQueue;
+			bool stopping;
+
+			boost::mutex wakeMutex;
+			boost::condition_variable taskAvailable;
+			boost::thread_group workers;
+		};
+	}
+}
@@ -0,0 +1,384 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_geometry_codec.h"
+
+#include <algorithm>
+
+using namespace repo::manipulator::modelconvertor;
+
+const uint8_t GeometryCodec::INDEX_HEADER;
+const uint8_t GeometryCodec::VERTEX_HEADER;
+const size_t GeometryCodec::INDEX_FIFO_SIZE;
+const size_t GeometryCodec::VERTEX_BLOCK_SIZE;
+const size_t GeometryCodec::MAX_VERTEX_STRIDE;
+
+//Vertex deltas are packed in groups of this many, each with its own bit width
+static const size_t VERTEX_GROUP_SIZE = 16;
+
+static void writeVarint(
+	std::vector<uint8_t> &out,
+	uint64_t             value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t)value);
+}
+
+static bool readVarint(
+	const uint8_t *data,
+	const size_t  &size,
+	size_t        &pos,
+	uint64_t      &value)
+{
+	value = 0;
+	for (uint32_t shift = 0; shift < 64; shift += 7)
+	{
+		if (pos >= size)
+			return false;
+		uint8_t byte = data[pos++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+static uint64_t zigzag(const int64_t &value)
+{
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(const uint64_t &value)
+{
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+* The most recently added vertices, which indices can refer to by age
+*/
+class IndexFifo
+{
+public:
+	IndexFifo() : head(0), count(0) {}
+
+	void push(const uint32_t &index)
+	{
+		head = (head + 1) % GeometryCodec::INDEX_FIFO_SIZE;
+		entries[head] = index;
+		count = std::min(count + 1, GeometryCodec::INDEX_FIFO_SIZE);
+	}
+
+	/**
+	* @return returns the age of the index, or -1 if it is not in the fifo
+	*/
+	int find(const uint32_t &index) const
+	{
+		for (size_t age = 0; age < count; ++age)
+		{
+			if (get(age) == index)
+				return (int)age;
+		}
+		return -1;
+	}
+
+	uint32_t get(const size_t &age) const
+	{
+		return entries[(head + GeometryCodec::INDEX_FIFO_SIZE - age) % GeometryCodec::INDEX_FIFO_SIZE];
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+private:
+	uint32_t entries[GeometryCodec::INDEX_FIFO_SIZE];
+	size_t head;
+	size_t count;
+};
+
+std::vector<uint8_t> GeometryCodec::encodeIndices(
+	const uint32_t *indices,
+	const size_t   &count)
+{
+	//Each index is a code: 0 for the next vertex not seen yet, 1 to INDEX_FIFO_SIZE
+	//for a recently added vertex, or above for a delta to the previous index
+	std::vector<uint8_t> out;
+	out.reserve(count + 8);
+	out.push_back(INDEX_HEADER);
+	writeVarint(out, count);
+
+	IndexFifo fifo;
+	uint64_t next = 0;
+	int64_t last = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint32_t index = indices[i];
+		if (index == next)
+		{
+			writeVarint(out, 0);
+			fifo.push(index);
+			++next;
+		}
+		else
+		{
+			int age = fifo.find(index);
+			if (age >= 0)
+			{
+				writeVarint(out, 1 + age);
+			}
+			else
+			{
+				writeVarint(out, 1 + INDEX_FIFO_SIZE + zigzag((int64_t)index - last));
+				fifo.push(index);
+				next = std::max(next, (uint64_t)index + 1);
+			}
+		}
+		last = index;
+	}
+
+	return out;
+}
+
+bool GeometryCodec::decodeIndices(
+	const uint8_t         *data,
+	const size_t          &size,
+	std::vector<uint32_t> &indices)
+{
+	indices.clear();
+	size_t pos = 0;
+	uint64_t count;
+	if (!size || data[pos++] != INDEX_HEADER || !readVarint(data, size, pos, count))
+		return false;
+
+	//Every index takes at least a byte
+	if (count > size - pos)
+		return false;
+	indices.reserve(count);
+
+	IndexFifo fifo;
+	uint64_t next = 0;
+	int64_t last = 0;
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		uint64_t code;
+		if (!readVarint(data, size, pos, code))
+			return false;
+
+		uint32_t index;
+		if (code == 0)
+		{
+			if (next > UINT32_MAX)
+				return false;
+			index = (uint32_t)next++;
+			fifo.push(index);
+		}
+		else if (code <= INDEX_FIFO_SIZE)
+		{
+			if (code > fifo.size())
+				return false;
+			index = fifo.get(code - 1);
+		}
+		else
+		{
+			int64_t value = last + unzigzag(code - 1 - INDEX_FIFO_SIZE);
+			if (value < 0 || value > UINT32_MAX)
+				return false;
+			index = (uint32_t)value;
+			fifo.push(index);
+			next = std::max(next, (uint64_t)index + 1);
+		}
+
+		indices.push_back(index);
+		last = index;
+	}
+
+	return pos == size;
+}
+
+static uint8_t zigzag8(const uint8_t &delta)
+{
+	return (uint8_t)((delta << 1) ^ ((int8_t)delta >> 7));
+}
+
+static uint8_t unzigzag8(const uint8_t &value)
+{
+	return (uint8_t)((value >> 1) ^ -(value & 1));
+}
+
+/**
+* Bits per delta for each group mode
+*/
+static const uint32_t GROUP_BITS[4] = { 0, 2, 4, 8 };
+
+static void writeGroup(
+	std::vector<uint8_t> &out,
+	const uint8_t        *deltas,
+	const uint32_t       &mode)
+{
+	const uint32_t bits = GROUP_BITS[mode];
+	if (!bits)
+		return;
+
+	const uint32_t perByte = 8 / bits;
+	for (size_t i = 0; i < VERTEX_GROUP_SIZE; i += perByte)
+	{
+		uint8_t byte = 0;
+		for (uint32_t j = 0; j < perByte; ++j)
+			byte |= deltas[i + j] << (j * bits);
+		out.push_back(byte);
+	}
+}
+
+static bool readGroup(
+	const uint8_t  *data,
+	const size_t   &size,
+	size_t         &pos,
+	const uint32_t &mode,
+	uint8_t        *deltas)
+{
+	const uint32_t bits = GROUP_BITS[mode];
+	if (!bits)
+	{
+		std::fill(deltas, deltas + VERTEX_GROUP_SIZE, 0);
+		return true;
+	}
+
+	const uint32_t perByte = 8 / bits;
+	if (size - pos < VERTEX_GROUP_SIZE / perByte)
+		return false;
+
+	const uint8_t mask = (uint8_t)((1u << bits) - 1);
+	for (size_t i = 0; i < VERTEX_GROUP_SIZE; i += perByte)
+	{
+		uint8_t byte = data[pos++];
+		for (uint32_t j = 0; j < perByte; ++j)
+			deltas[i + j] = (byte >> (j * bits)) & mask;
+	}
+	return true;
+}
+
+std::vector<uint8_t> GeometryCodec::encodeVertices(
+	const uint8_t *vertices,
+	const size_t  &count,
+	const size_t  &stride)
+{
+	std::vector<uint8_t> out;
+	if (!stride || stride > MAX_VERTEX_STRIDE)
+		return out;
+
+	out.reserve(count * stride / 2 + 16);
+	out.push_back(VERTEX_HEADER);
+	writeVarint(out, count);
+	writeVarint(out, stride);
+
+	//Each byte of a vertex is delta coded against the same byte of the
+	//previous vertex, one byte plane at a time within a block
+	uint8_t previous[MAX_VERTEX_STRIDE] = {};
+	uint8_t deltas[VERTEX_BLOCK_SIZE];
+	for (size_t blockStart = 0; blockStart < count; blockStart += VERTEX_BLOCK_SIZE)
+	{
+		const size_t nVertices = std::min(VERTEX_BLOCK_SIZE, count - blockStart);
+		const size_t nGroups = (nVertices + VERTEX_GROUP_SIZE - 1) / VERTEX_GROUP_SIZE;
+
+		for (size_t byteIdx = 0; byteIdx < stride; ++byteIdx)
+		{
+			for (size_t i = 0; i < nVertices; ++i)
+			{
+				uint8_t value = vertices[(blockStart + i) * stride + byteIdx];
+				deltas[i] = zigzag8(value - previous[byteIdx]);
+				previous[byteIdx] = value;
+			}
+			std::fill(deltas + nVertices, deltas + nGroups * VERTEX_GROUP_SIZE, 0);
+
+			//The modes of all the groups, 2 bits each, come before their deltas
+			size_t modesPos = out.size();
+			out.resize(out.size() + (nGroups + 3) / 4, 0);
+			for (size_t group = 0; group < nGroups; ++group)
+			{
+				const uint8_t *groupDeltas = &deltas[group * VERTEX_GROUP_SIZE];
+				uint8_t maxDelta = *std::max_element(groupDeltas, groupDeltas + VERTEX_GROUP_SIZE);
+				uint32_t mode = maxDelta == 0 ? 0 : maxDelta < 4 ? 1 : maxDelta < 16 ? 2 : 3;
+
+				out[modesPos + group / 4] |= mode << ((group % 4) * 2);
+				writeGroup(out, groupDeltas, mode);
+			}
+		}
+	}
+
+	return out;
+}
+
+bool GeometryCodec::decodeVertices(
+	const uint8_t        *data,
+	const size_t         &size,
+	std::vector<uint8_t> &vertices,
+	size_t               &stride)
+{
+	vertices.clear();
+	size_t pos = 0;
+	uint64_t count, stride64;
+	if (!size || data[pos++] != VERTEX_HEADER
+		|| !readVarint(data, size, pos, count)
+		|| !readVarint(data, size, pos, stride64))
+		return false;
+
+	if (!stride64 || stride64 > MAX_VERTEX_STRIDE)
+		return false;
+	stride = stride64;
+
+	//Every byte plane of every block takes at least a byte
+	if (count / VERTEX_BLOCK_SIZE > size
+		|| (count + VERTEX_BLOCK_SIZE - 1) / VERTEX_BLOCK_SIZE * stride > size - pos)
+		return false;
+	vertices.resize(count * stride);
+
+	uint8_t previous[MAX_VERTEX_STRIDE] = {};
+	uint8_t deltas[VERTEX_BLOCK_SIZE];
+	for (size_t blockStart = 0; blockStart < count; blockStart += VERTEX_BLOCK_SIZE)
+	{
+		const size_t nVertices = std::min(VERTEX_BLOCK_SIZE, (size_t)count - blockStart);
+		const size_t nGroups = (nVertices + VERTEX_GROUP_SIZE - 1) / VERTEX_GROUP_SIZE;
+
+		for (size_t byteIdx = 0; byteIdx < stride; ++byteIdx)
+		{
+			const size_t modesPos = pos;
+			if (size - pos < (nGroups + 3) / 4)
+				return false;
+			pos += (nGroups + 3) / 4;
+
+			for (size_t group = 0; group < nGroups; ++group)
+			{
+				uint32_t mode = (data[modesPos + group / 4] >> ((group % 4) * 2)) & 3;
+				if (!readGroup(data, size, pos, mode, &deltas[group * VERTEX_GROUP_SIZE]))
+					return false;
+			}
+
+			for (size_t i = 0; i < nVertices; ++i)
+			{
+				previous[byteIdx] += unzigzag8(deltas[i]);
+				vertices[(blockStart + i) * stride + byteIdx] = previous[byteIdx];
+			}
+		}
+	}
+
+	return pos == size;
+}
@@ -0,0 +1,103 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Lossless compression of index and vertex buffers. Indices are coded
+* relative to the vertices seen so far, which suits buffers whose vertices
+* are numbered in order of first use. Vertex attributes are delta coded
+* byte by byte between consecutive vertices, and the deltas packed into
+* as few bits as they need. The output is meant to be deflated further.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace repo {
+	namespace manipulator {
+		namespace modelconvertor {
+			class GeometryCodec
+			{
+			public:
+				static const uint8_t INDEX_HEADER = 0xE1;
+				static const uint8_t VERTEX_HEADER = 0xA1;
+
+				/**
+				* Number of recently added vertices indices can refer to
+				*/
+				static const size_t INDEX_FIFO_SIZE = 16;
+
+				/**
+				* Number of vertices delta coded together
+				*/
+				static const size_t VERTEX_BLOCK_SIZE = 256;
+				static const size_t MAX_VERTEX_STRIDE = 256;
+
+				/**
+				* Encode an index buffer
+				* @param indices indices to encode
+				* @param count number of indices
+				* @return returns the encoded buffer
+				*/
+				static std::vector<uint8_t> encodeIndices(
+					const uint32_t *indices,
+					const size_t   &count);
+
+				/**
+				* Decode a buffer written by encodeIndices()
+				* @param data encoded buffer
+				* @param size size of the encoded buffer in bytes
+				* @param indices receives the decoded indices
+				* @return returns true upon success, false if the buffer is malformed
+				*/
+				static bool decodeIndices(
+					const uint8_t         *data,
+					const size_t          &size,
+					std::vector<uint32_t> &indices);
+
+				/**
+				* Encode a vertex attribute buffer
+				* @param vertices vertex attributes to encode
+				* @param count number of vertices
+				* @param stride size of the attributes of a vertex in bytes,
+				*        at most MAX_VERTEX_STRIDE
+				* @return returns the encoded buffer, empty if the stride is not supported
+				*/
+				static std::vector<uint8_t> encodeVertices(
+					const uint8_t *vertices,
+					const size_t  &count,
+					const size_t  &stride);
+
+				/**
+				* Decode a buffer written by encodeVertices()
+				* @param data encoded buffer
+				* @param size size of the encoded buffer in bytes
+				* @param vertices receives the decoded vertex attributes
+				* @param stride receives the size of the attributes of a vertex in bytes
+				* @return returns true upon success, false if the buffer is malformed
+				*/
+				static bool decodeVertices(
+					const uint8_t        *data,
+					const size_t         &size,
+					std::vector<uint8_t> &vertices,
+					size_t               &stride);
+			};
+		}
+	}
+}
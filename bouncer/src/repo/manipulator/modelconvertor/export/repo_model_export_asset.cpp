@@ -55,8 +55,9 @@ const static std::string MP_LABEL_PROJECT = "model";
 
 AssetModelExport::AssetModelExport(
 	const repo::core::model::RepoScene *scene,
-	const bool vrEnabled
-) : WebModelExport(scene),
+	const bool vrEnabled,
+	const WebExportOptions &options
+) : WebModelExport(scene, nullptr, options),
 generateVR(vrEnabled)
 {
 	//Considering all newly imported models should have a stash graph, we only need to support stash graph?
@@ -157,6 +158,29 @@ bool AssetModelExport::generateJSONMapping(
 	return success;
 }
 
+bool AssetModelExport::getSplitLimits(
+	const repo::core::model::MeshNode *mesh,
+	size_t &maxVertices,
+	size_t &maxFaces) const
+{
+	switch (mesh->getPrimitive())
+	{
+	case repo::core::model::MeshNode::Primitive::TRIANGLES:
+		// For Triangles, the vertex limit is 65536, as Unity stores indices as shorts unless told to use 32 bit indices.
+		// The maximum index array length in Unity is unknown, so the face limit is to SIZE_MAX.
+		maxVertices = getVertexLimit(ASSET_MAX_VERTEX_LIMIT);
+		maxFaces = ASSET_MAX_TRIANGLE_LIMIT;
+		return true;
+	case repo::core::model::MeshNode::Primitive::LINES:
+		// For lines, each line (face) takes four vertices to draw (no-reuse between lines), so the face limit is 65536/4 to ensure they can all fit in the vertex buffer.
+		maxVertices = getVertexLimit(ASSET_MAX_VERTEX_LIMIT);
+		maxFaces = options.indexFormat == WebIndexFormat::UINT32 ? getVertexLimit(ASSET_MAX_VERTEX_LIMIT) / 4 : ASSET_MAX_LINE_LIMIT;
+		return true;
+	default:
+		return false;
+	}
+}
+
 bool AssetModelExport::generateTreeRepresentation()
 {
 	bool success;
@@ -164,6 +188,17 @@ bool AssetModelExport::generateTreeRepresentation()
 	{
 		auto meshes = scene->getAllMeshes(gType);
 
+		//Reorganise the meshes a batch at a time, in parallel, ordering faces for vertex cache reuse
+		std::vector<repo::manipulator::modelutility::MeshReorganiserCache::Request> requests;
+		for (const repo::core::model::RepoNode* node : meshes)
+		{
+			auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
+			size_t maxVertices, maxFaces;
+			if (mesh && getSplitLimits(mesh, maxVertices, maxFaces))
+				requests.push_back({ mesh, maxVertices, maxFaces, true });
+		}
+		repo::manipulator::modelutility::MeshReorganiserCache::BatchReader reorganisations(getReorganiserCache(), requests);
+
 		std::vector<std::string> assetFiles, vrAssetFiles, iosAssetsFiles, androidAssetsFiles, jsons;
 		for (const repo::core::model::RepoNode* node : meshes)
 		{
@@ -174,30 +209,18 @@ bool AssetModelExport::generateTreeRepresentation()
 				continue;
 			}
 
-			repo::manipulator::modelutility::MeshMapReorganiser* reSplitter;
-			switch (mesh->getPrimitive())
+			size_t maxVertices, maxFaces;
+			if (!getSplitLimits(mesh, maxVertices, maxFaces))
 			{
-			case repo::core::model::MeshNode::Primitive::TRIANGLES:
-				// For Triangles, the vertex limit is 65536, as Unity stores indices as shorts.
-				// The maximum index array length in Unity is unknown, so the face limit is to SIZE_MAX.
-				reSplitter = new repo::manipulator::modelutility::MeshMapReorganiser(mesh, ASSET_MAX_VERTEX_LIMIT, ASSET_MAX_TRIANGLE_LIMIT);
-				break;
-			case repo::core::model::MeshNode::Primitive::LINES:
-				// For lines, each line (face) takes four vertices to draw (no-reuse between lines), so the face limit is 65536/4 to ensure they can all fit in the vertex buffer.
-				reSplitter = new repo::manipulator::modelutility::MeshMapReorganiser(mesh, ASSET_MAX_VERTEX_LIMIT, ASSET_MAX_LINE_LIMIT);
-				break;
-			default:
 				repoError << "MeshMapReorganiser cannot operate on node " << node->getUniqueID() << " because it has primitive type " << (int)mesh->getPrimitive() << " and AssetModelExport does not have known limits for this type. Skipping...";
 				continue;
 			}
 
-			if (success = !std::make_shared<repo::core::model::MeshNode>(reSplitter->getRemappedMesh())->isEmpty())
+			auto reorganised = reorganisations.read({ mesh, maxVertices, maxFaces, true });
+			if (success = !reorganised->remappedMesh.isEmpty())
 			{
-				reorganisedMeshes.push_back(std::make_shared<repo::core::model::MeshNode>(reSplitter->getRemappedMesh()));
-				serialisedFaceBuf.push_back(reSplitter->getSerialisedFaces());
-				idMapBuf.push_back(reSplitter->getIDMapArrays());
-				meshMappings.push_back(reSplitter->getMappingsPerSubMesh());
-				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMapping = reSplitter->getSplitMapping();
+				reorganisedMeshes.push_back(std::make_shared<repo::core::model::MeshNode>(reorganised->remappedMesh));
+				reorganisedBuffers.push_back(reorganised);
 				std::string fNamePrefix = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + mesh->getUniqueID().toString();
 				if (generateVR) {
 					vrAssetFiles.push_back(fNamePrefix + "_win64.unity3d");
@@ -207,8 +230,7 @@ bool AssetModelExport::generateTreeRepresentation()
 				assetFiles.push_back(fNamePrefix + ".unity3d");
 				jsons.push_back(fNamePrefix + "_unity.json.mpc");
 
-				success &= generateJSONMapping(mesh, scene, reSplitter->getSplitMapping());
-				delete reSplitter;
+				success &= generateJSONMapping(mesh, scene, reorganised->splitMapping);
 			}
 			else
 			{
@@ -27,7 +27,6 @@
 #include "../../../lib/repo_property_tree.h"
 #include "../../../core/model/collection/repo_scene.h"
 #include "../../../core/model/bson/repo_node_mesh.h"
-#include "../../modelutility/repo_mesh_map_reorganiser.h"
 
 namespace repo{
 	namespace manipulator{
@@ -39,9 +38,11 @@ namespace repo{
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
 				* @param whether the scene requires VR bundles
+				* @param options formats the bundles will be built with
 				*/
 				AssetModelExport(const repo::core::model::RepoScene *scene,
-					const bool vrEnabled = false);
+					const bool vrEnabled = false,
+					const WebExportOptions &options = WebExportOptions());
 
 				/**
 				* Default Destructor
@@ -57,17 +58,29 @@ namespace repo{
 
 				/**
 				* Return a map of super meshes to reorganised meshes
+				* @param faceBuffer (output) face buffers, serialised with the
+				*        index type of the buffer (uint16_t or uint32_t)
 				* @return returns a vector of reorganised meshes
 				*/
+				template <typename IndexType>
 				std::vector<std::shared_ptr<repo::core::model::MeshNode>>
 					getReorganisedMeshes(
-					std::vector<std::vector<uint16_t>> &faceBuffer,
+					std::vector<std::vector<IndexType>> &faceBuffer,
 					std::vector<std::vector<std::vector<float>>> &idMapBuffer,
 					std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMaps
 					) const {
-					faceBuffer = serialisedFaceBuf;
-					idMapBuffer = idMapBuf;
-					meshMaps = meshMappings;
+					faceBuffer.clear();
+					idMapBuffer.clear();
+					meshMaps.clear();
+					faceBuffer.reserve(reorganisedBuffers.size());
+					idMapBuffer.reserve(reorganisedBuffers.size());
+					meshMaps.reserve(reorganisedBuffers.size());
+					for (const auto &reorganised : reorganisedBuffers)
+					{
+						faceBuffer.push_back(std::vector<IndexType>(reorganised->serialisedFaces.begin(), reorganised->serialisedFaces.end()));
+						idMapBuffer.push_back(reorganised->idMapArrays);
+						meshMaps.push_back(reorganised->mappingsPerSubMesh);
+					}
 					return reorganisedMeshes;
 				}
 
@@ -99,11 +112,21 @@ namespace repo{
 				*/
 				bool generateTreeRepresentation();
 
+				/**
+				* Get the limits to split a mesh into sub meshes with
+				* @param mesh mesh to split
+				* @param maxVertices returns the maximum vertices per sub mesh
+				* @param maxFaces returns the maximum faces per sub mesh
+				* @return returns false if the primitive type of the mesh is not supported
+				*/
+				bool getSplitLimits(
+					const repo::core::model::MeshNode *mesh,
+					size_t &maxVertices,
+					size_t &maxFaces) const;
+
 				std::vector<std::shared_ptr<repo::core::model::MeshNode>> reorganisedMeshes;
 				repo::core::model::RepoUnityAssets unityAssets;
-				std::vector<std::vector<uint16_t>> serialisedFaceBuf;
-				std::vector<std::vector<std::vector<float>>> idMapBuf;
-				std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> meshMappings;
+				std::vector<std::shared_ptr<const repo::manipulator::modelutility::ReorganisedMesh>> reorganisedBuffers; //faces are converted to the index type requested
 				std::string assetListFile;
 				const bool generateVR;
 			};
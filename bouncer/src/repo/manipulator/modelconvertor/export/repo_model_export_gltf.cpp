@@ -25,7 +25,6 @@
 
 #include "../../../core/model/bson/repo_bson_factory.h"
 #include "../../../lib/repo_log.h"
-#include "../../modelutility/repo_mesh_map_reorganiser.h"
 #include "../../modelutility/spatialpartitioning/repo_spatial_partitioner_rdtree.h"
 #include "auxiliary/x3dom_constants.h"
 
@@ -57,6 +56,8 @@ static const std::string GLTF_LABEL_COUNT = "count";
 static const std::string GLTF_LABEL_DIFFUSE = "diffuse";
 static const std::string GLTF_LABEL_EMISSIVE = "emission";
 static const std::string GLTF_LABEL_ENABLE = "enable";
+static const std::string GLTF_LABEL_EXTENSIONS = "extensions";
+static const std::string GLTF_LABEL_EXTENSIONS_USED = "extensionsUsed";
 static const std::string GLTF_LABEL_EXTRA = "extras";
 static const std::string GLTF_LABEL_FAR_CP = "zfar";
 static const std::string GLTF_LABEL_FILTER_MAG = "magFilter";
@@ -126,7 +127,9 @@ static const uint32_t GLTF_PRIM_TYPE_TRIANGLE = 4;
 static const uint32_t GLTF_PRIM_TYPE_ARRAY_BUFFER = 34962;
 static const uint32_t GLTF_PRIM_TYPE_ELEMENT_ARRAY_BUFFER = 34963;
 
+static const uint32_t GLTF_COMP_TYPE_SHORT = 5122;
 static const uint32_t GLTF_COMP_TYPE_USHORT = 5123;
+static const uint32_t GLTF_COMP_TYPE_UINT = 5125;
 static const uint32_t GLTF_COMP_TYPE_FLOAT = 5126;
 static const uint32_t GLTF_COMP_TYPE_FLOAT_VEC2 = 35664;
 static const uint32_t GLTF_COMP_TYPE_FLOAT_VEC3 = 35665;
@@ -187,17 +190,44 @@ static const std::vector<float> REPO_GLTF_DEFAULT_SPECULAR = { 0, 0, 0, 0 };
 
 static const std::string REPO_GLTF_LABEL_REF_ID = "refID";
 static const std::string REPO_GLTF_LABEL_LOD = "lodRef";
+static const std::string REPO_GLTF_LABEL_OCT_ENCODED = "octEncoded";
+
+//Quantised positions extension, the glTF 1.0 counterpart of KHR_mesh_quantization
+static const std::string GLTF_EXT_QUANTIZED_ATTRIBUTES = "WEB3D_quantized_attributes";
+static const std::string GLTF_LABEL_DECODE_MATRIX = "decodeMatrix";
+static const std::string GLTF_LABEL_DECODED_MAX = "decodedMax";
+static const std::string GLTF_LABEL_DECODED_MIN = "decodedMin";
+
+//Buffer views compressed with GeometryCodec
+static const std::string GLTF_EXT_GEOMETRY_CODEC = "REPO_geometry_codec";
+
+//Hierarchical levels of detail, as fractions of the triangles of each sub mesh
+static const std::vector<float> REPO_GLTF_LOD_RATIOS = { 0.5f, 0.25f, 0.125f };
+static const float              REPO_GLTF_LOD_MAX_ERROR = 0.05f;
+static const std::string        REPO_GLTF_LABEL_LOD_ERRORS = "lodErrors";
+static const std::string        REPO_GLTF_LABEL_LOD_INDICES = "lodIndices";
+static const std::string        REPO_GLTF_PROXY_MATERIAL = "proxy_material";
+static const std::vector<float> REPO_GLTF_PROXY_DIFFUSE = { 0.5f, 0.5f, 0.5f, 1.0f };
 static const std::string REPO_LABEL_X3D_MATERIAL = "x3dmaterial";
 
 GLTFModelExport::GLTFModelExport(
-	const repo::core::model::RepoScene *scene
-	) : WebModelExport(scene)
+	const repo::core::model::RepoScene *scene,
+	AbstractWebExportSink *sink,
+	const WebExportOptions &options
+	) : WebModelExport(scene, sink, options)
 {
 	if (convertSuccess)
 	{
 		//We only need a GLTF representation if there are meshes or cameras
 		if (scene->getAllMeshes(gType).size() || scene->getAllCameras(gType).size())
+		{
 			convertSuccess = generateTreeRepresentation();
+			if (convertSuccess && sink)
+				convertSuccess = flushFilesToSink();
+			//Every view is encoded by now, only the encoded buffers are exported
+			if (options.bufferEncoding == WebBufferEncoding::GEOMETRY_CODEC)
+				fullDataBuffer.clear();
+		}
 	}
 	else
 	{
@@ -213,11 +243,11 @@ void GLTFModelExport::addAccessors(
 	const std::string              &accName,
 	const std::string              &buffViewName,
 	repo::lib::PropertyTree        &tree,
-	const std::vector<uint16_t>    &faces,
+	const std::vector<uint32_t>    &faces,
 	const uint32_t                 &addrFrom,
 	const uint32_t                 &addrTo,
 	const std::string              &refId,
-	const std::vector<uint16_t>    &lod,
+	const std::vector<uint32_t>    &lod,
 	const size_t                   &offset)
 {
 	std::vector<float> min, max;
@@ -234,7 +264,8 @@ void GLTFModelExport::addAccessors(
 		if (max[0] < faces[i]) max[0] = faces[i];
 	}
 	addAccessors(accName, buffViewName, tree, endFaceIdx - startFaceIdx,
-		(startFaceIdx - offset * 3) * sizeof(*faces.data()), 0, GLTF_COMP_TYPE_USHORT,
+		(startFaceIdx - offset * 3) * getIndexSize(), 0,
+		options.indexFormat == WebIndexFormat::UINT32 ? GLTF_COMP_TYPE_UINT : GLTF_COMP_TYPE_USHORT,
 		GLTF_TYPE_SCALAR, min, max, refId, lod);
 }
 
@@ -353,6 +384,59 @@ void GLTFModelExport::addAccessors(
 		GLTF_COMP_TYPE_FLOAT, GLTF_TYPE_VEC3, min, max, refId);
 }
 
+void GLTFModelExport::addQuantisedPositionAccessors(
+	const std::string                           &accName,
+	const std::string                           &buffViewName,
+	repo::lib::PropertyTree                     &tree,
+	const VertexQuantiser::PositionRange        &range,
+	const uint32_t                              &addrFrom,
+	const uint32_t                              &addrTo,
+	const std::string                           &refId,
+	const size_t                                &offset)
+{
+	//The range is the bounding box of these positions, so they span the whole quantised range
+	std::vector<float> min = { 0, 0, 0 };
+	std::vector<float> max = {
+		range.scale.x > 0 ? (float)VertexQuantiser::POSITION_MAX : 0,
+		range.scale.y > 0 ? (float)VertexQuantiser::POSITION_MAX : 0,
+		range.scale.z > 0 ? (float)VertexQuantiser::POSITION_MAX : 0 };
+	addAccessors(accName, buffViewName, tree, addrTo - addrFrom,
+		(addrFrom - offset) * getPositionSize(), getPositionSize(),
+		GLTF_COMP_TYPE_USHORT, GLTF_TYPE_VEC3, min, max, refId);
+
+	//Column major, decoding a position as min + value * scale
+	std::vector<float> decodeMatrix = {
+		range.scale.x, 0, 0, 0,
+		0, range.scale.y, 0, 0,
+		0, 0, range.scale.z, 0,
+		range.min.x, range.min.y, range.min.z, 1 };
+	std::vector<float> decodedMin = { range.min.x, range.min.y, range.min.z };
+	std::vector<float> decodedMax = { range.max.x, range.max.y, range.max.z };
+
+	std::string extLabel = GLTF_LABEL_ACCESSORS + "." + GLTF_PREFIX_ACCESSORS + "_" + accName + "."
+		+ GLTF_LABEL_EXTENSIONS + "." + GLTF_EXT_QUANTIZED_ATTRIBUTES;
+	tree.addToTree(extLabel + "." + GLTF_LABEL_DECODE_MATRIX, decodeMatrix);
+	tree.addToTree(extLabel + "." + GLTF_LABEL_DECODED_MIN, decodedMin);
+	tree.addToTree(extLabel + "." + GLTF_LABEL_DECODED_MAX, decodedMax);
+}
+
+void GLTFModelExport::addOctEncodedNormalAccessors(
+	const std::string              &accName,
+	const std::string              &buffViewName,
+	repo::lib::PropertyTree        &tree,
+	const uint32_t                 &addrFrom,
+	const uint32_t                 &addrTo,
+	const std::string              &refId,
+	const size_t                   &offset)
+{
+	addAccessors(accName, buffViewName, tree, addrTo - addrFrom,
+		(addrFrom - offset) * getNormalSize(), getNormalSize(),
+		GLTF_COMP_TYPE_SHORT, GLTF_TYPE_VEC2, std::vector<float>(), std::vector<float>(), refId);
+
+	std::string accLabel = GLTF_LABEL_ACCESSORS + "." + GLTF_PREFIX_ACCESSORS + "_" + accName;
+	tree.addToTree(accLabel + "." + GLTF_LABEL_EXTRA + "." + REPO_GLTF_LABEL_OCT_ENCODED, "true");
+}
+
 void GLTFModelExport::addAccessors(
 	const std::string              &accName,
 	const std::string              &buffViewName,
@@ -365,7 +449,7 @@ void GLTFModelExport::addAccessors(
 	const std::vector<float>       &min,
 	const std::vector<float>       &max,
 	const std::string              &refId,
-	const std::vector<uint16_t>    &lod)
+	const std::vector<uint32_t>    &lod)
 {
 	//declare accessor
 	std::string accLabel = GLTF_LABEL_ACCESSORS + "." + GLTF_PREFIX_ACCESSORS + "_" + accName;
@@ -394,16 +478,109 @@ void GLTFModelExport::addAccessors(
 	}
 }
 
+void GLTFModelExport::addLevelOfDetailAccessors(
+	repo::lib::PropertyTree                                                   &primitive,
+	repo::lib::PropertyTree                                                   &tree,
+	const std::string                                                         &subMeshName,
+	const std::string                                                         &meshId,
+	const std::vector<repo::manipulator::modelutility::MeshSimplifier::Level> &levels,
+	const size_t                                                              &subMeshIdx,
+	const std::string                                                         &refId)
+{
+	std::vector<std::string> accessors;
+	std::vector<float> errors;
+	size_t prevCount = SIZE_MAX;
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		const auto &offsets = levels[i].triangleOffsets;
+		if (subMeshIdx + 1 >= offsets.size())
+			break;
+
+		//Skip levels the sub mesh could not be simplified any further for
+		size_t count = offsets[subMeshIdx + 1] - offsets[subMeshIdx];
+		if (!count || count >= prevCount)
+			continue;
+		prevCount = count;
+
+		std::string accessorName = subMeshName + "_" + GLTF_SUFFIX_FACES + "_lod" + std::to_string(i);
+		std::string bufferViewName = meshId + "_" + GLTF_SUFFIX_FACES + "_lod" + std::to_string(i);
+		addAccessors(accessorName, bufferViewName, tree, levels[i].indices, offsets[subMeshIdx], offsets[subMeshIdx + 1], refId);
+		accessors.push_back(GLTF_PREFIX_ACCESSORS + "_" + accessorName);
+		errors.push_back(levels[i].errors[subMeshIdx]);
+	}
+
+	if (accessors.size())
+	{
+		primitive.addToTree(GLTF_LABEL_EXTRA + "." + REPO_GLTF_LABEL_LOD_INDICES, accessors);
+		primitive.addToTree(GLTF_LABEL_EXTRA + "." + REPO_GLTF_LABEL_LOD_ERRORS, errors);
+	}
+}
+
+std::vector<repo::manipulator::modelutility::MeshSimplifier::Level> GLTFModelExport::addLevelsOfDetail(
+	repo::lib::PropertyTree                    &tree,
+	const std::string                          &bufferFileName,
+	const std::string                          &meshId,
+	const std::vector<repo::lib::RepoVector3D> &vertices,
+	const std::vector<uint32_t>                &faces,
+	const std::vector<repo_mesh_mapping_t>     &subMeshes)
+{
+	std::vector<repo::manipulator::modelutility::MeshSimplifier::Level> levels;
+	if (options.lodMode != WebLODMode::HIERARCHICAL || subMeshes.empty())
+		return levels;
+
+	const int32_t vertFrom = subMeshes.front().vertFrom;
+	const int32_t vertTo = subMeshes.back().vertTo;
+	if (vertFrom < 0 || vertTo > (int32_t)vertices.size() || subMeshes.back().triTo * 3 > (int32_t)faces.size())
+	{
+		repoError << "Sub meshes of " << meshId << " are out of bounds, no levels of detail generated.";
+		return levels;
+	}
+
+	//The simplifier takes indices into the vertices of the super mesh
+	std::vector<uint32_t> indices;
+	std::vector<size_t> triangleOffsets;
+	for (const auto &subMesh : subMeshes)
+	{
+		triangleOffsets.push_back(indices.size() / 3);
+		for (int32_t i = subMesh.triFrom * 3; i < subMesh.triTo * 3; ++i)
+			indices.push_back(faces[i] + subMesh.vertFrom - vertFrom);
+	}
+	triangleOffsets.push_back(indices.size() / 3);
+
+	levels = repo::manipulator::modelutility::MeshSimplifier::generateLevels(&vertices[vertFrom], vertTo - vertFrom,
+		indices.data(), triangleOffsets, REPO_GLTF_LOD_RATIOS, REPO_GLTF_LOD_MAX_ERROR);
+
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		auto &level = levels[i];
+		//Back to indices into the vertices of each sub mesh, as the accessors expect
+		for (size_t j = 0; j < subMeshes.size(); ++j)
+		{
+			const uint32_t offset = subMeshes[j].vertFrom - vertFrom;
+			for (size_t k = level.triangleOffsets[j] * 3; k < level.triangleOffsets[j + 1] * 3; ++k)
+				level.indices[k] -= offset;
+		}
+
+		if (level.indices.size())
+		{
+			size_t start = addToDataBuffer(bufferFileName, serialiseIndices(level.indices));
+			std::string bufferViewName = meshId + "_" + GLTF_SUFFIX_FACES + "_lod" + std::to_string(i);
+			addBufferView(bufferViewName, bufferFileName, tree, level.indices, start, level.indices.size() / 3, meshId);
+		}
+	}
+	return levels;
+}
+
 void GLTFModelExport::addBufferView(
 	const std::string              &name,
 	const std::string              &fileName,
 	repo::lib::PropertyTree        &tree,
-	const std::vector<uint16_t>    &buffer,
+	const std::vector<uint32_t>    &buffer,
 	const size_t                   &offset,
 	const size_t                   &count,
 	const std::string              &refId)
 {
-	addBufferView(name, fileName, tree, count * 3 * sizeof(*buffer.data()), offset, GLTF_PRIM_TYPE_ELEMENT_ARRAY_BUFFER, refId);
+	addBufferView(name, fileName, tree, count * 3 * getIndexSize(), offset, GLTF_PRIM_TYPE_ELEMENT_ARRAY_BUFFER, getIndexSize(), refId);
 }
 
 void GLTFModelExport::addBufferView(
@@ -415,19 +592,7 @@ void GLTFModelExport::addBufferView(
 	const size_t                   &count,
 	const std::string              &refId)
 {
-	addBufferView(name, fileName, tree, count * sizeof(*buffer.data()), offset, GLTF_PRIM_TYPE_ARRAY_BUFFER, refId);
-}
-
-void GLTFModelExport::addBufferView(
-	const std::string                   &name,
-	const std::string                   &fileName,
-	repo::lib::PropertyTree             &tree,
-	const std::vector<repo::lib::RepoVector3D>    &buffer,
-	const size_t                        &offset,
-	const size_t                        &count,
-	const std::string                   &refId)
-{
-	addBufferView(name, fileName, tree, count * sizeof(*buffer.data()), offset, GLTF_PRIM_TYPE_ARRAY_BUFFER, refId);
+	addBufferView(name, fileName, tree, count * sizeof(*buffer.data()), offset, GLTF_PRIM_TYPE_ARRAY_BUFFER, sizeof(*buffer.data()), refId);
 }
 
 void GLTFModelExport::addBufferView(
@@ -439,7 +604,7 @@ void GLTFModelExport::addBufferView(
 	const size_t                        &count,
 	const std::string                   &refId)
 {
-	addBufferView(name, fileName, tree, count * sizeof(*buffer.data()), offset, GLTF_PRIM_TYPE_ARRAY_BUFFER, refId);
+	addBufferView(name, fileName, tree, count * sizeof(*buffer.data()), offset, GLTF_PRIM_TYPE_ARRAY_BUFFER, sizeof(*buffer.data()), refId);
 }
 
 void GLTFModelExport::addBufferView(
@@ -449,6 +614,7 @@ void GLTFModelExport::addBufferView(
 	const size_t                   &byteLength,
 	const size_t                   &offset,
 	const uint32_t                 &bufferTarget,
+	const size_t                   &byteStride,
 	const std::string              &refId)
 {
 	std::string bufferViewName = GLTF_PREFIX_BUFFER_VIEWS + "_" + name;
@@ -456,8 +622,28 @@ void GLTFModelExport::addBufferView(
 	//declare buffer view
 	std::string bufferViewLabel = GLTF_LABEL_BUFFER_VIEWS + "." + bufferViewName;
 	tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_BUFFER, fileName);
-	tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_BYTE_LENGTH, byteLength);
-	tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_BYTE_OFFSET, offset);
+	if (options.bufferEncoding == WebBufferEncoding::GEOMETRY_CODEC)
+	{
+		//The view decodes to byteLength bytes, only the encoded bytes live in the buffer
+		const auto &rawBuffer = fullDataBuffer[fileName];
+		if (offset + byteLength > rawBuffer.size())
+		{
+			repoError << "Buffer view " << bufferViewName << " is out of bounds of " << fileName << "!";
+			return;
+		}
+		auto encoded = encodeBufferView(rawBuffer.data() + offset, byteLength, byteStride,
+			bufferTarget == GLTF_PRIM_TYPE_ELEMENT_ARRAY_BUFFER, tree,
+			bufferViewLabel + "." + GLTF_LABEL_EXTENSIONS + "." + GLTF_EXT_GEOMETRY_CODEC);
+		auto &encodedBuffer = encodedDataBuffer[fileName];
+		tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_BYTE_LENGTH, encoded.size());
+		tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_BYTE_OFFSET, encodedBuffer.size());
+		encodedBuffer.insert(encodedBuffer.end(), encoded.begin(), encoded.end());
+	}
+	else
+	{
+		tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_BYTE_LENGTH, byteLength);
+		tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_BYTE_OFFSET, offset);
+	}
 	tree.addToTree(bufferViewLabel + "." + GLTF_LABEL_TARGET, bufferTarget);
 
 	if (!refId.empty())
@@ -485,6 +671,65 @@ size_t GLTFModelExport::addToDataBuffer(
 	return offset;
 }
 
+bool GLTFModelExport::flushDataBufferToSink(
+	const std::string              &bufferName)
+{
+	bool success = true;
+	auto &outputBuffers = getOutputDataBuffers();
+	auto mapIt = outputBuffers.find(bufferName);
+	if (sink && mapIt != outputBuffers.end())
+	{
+		flushedBufferSizes[bufferName] = mapIt->second.size();
+		success = sink->addGeometryFile(getBinaryFileName(bufferName), std::move(mapIt->second));
+		outputBuffers.erase(mapIt);
+	}
+
+	//The raw buffer is only kept to encode views from, and all of them are declared by now
+	if (options.bufferEncoding == WebBufferEncoding::GEOMETRY_CODEC)
+		fullDataBuffer.erase(bufferName);
+	return success;
+}
+
+std::unordered_map<std::string, std::vector<uint8_t>>& GLTFModelExport::getOutputDataBuffers()
+{
+	return options.bufferEncoding == WebBufferEncoding::GEOMETRY_CODEC ? encodedDataBuffer : fullDataBuffer;
+}
+
+const std::unordered_map<std::string, std::vector<uint8_t>>& GLTFModelExport::getOutputDataBuffers() const
+{
+	return options.bufferEncoding == WebBufferEncoding::GEOMETRY_CODEC ? encodedDataBuffer : fullDataBuffer;
+}
+
+bool GLTFModelExport::flushFilesToSink()
+{
+	bool success = true;
+	if (sink)
+	{
+		//bin files first, so the glTF file never references a file that isn't there
+		auto &outputBuffers = getOutputDataBuffers();
+		while (success && outputBuffers.size())
+		{
+			success = flushDataBufferToSink(outputBuffers.begin()->first);
+		}
+		fullDataBuffer.clear();
+
+		for (const auto &pair : trees)
+		{
+			success &= sink->addGeometryFile(pair.first, treeToBuffer(pair.second));
+		}
+		trees.clear();
+
+		success &= flushJSONFilesToSink();
+	}
+	return success;
+}
+
+std::string GLTFModelExport::getBinaryFileName(
+	const std::string              &bufferName) const
+{
+	return "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + bufferName + ".bin";
+}
+
 bool GLTFModelExport::constructScene(
 	repo::lib::PropertyTree &tree)
 {
@@ -505,7 +750,7 @@ bool GLTFModelExport::constructScene(
 			populateWithTextures(tree);
 			populateWithCameras(tree);
 
-			repo::lib::PropertyTree spatialPartTree = generateSpatialPartitioning();
+			repo::lib::PropertyTree spatialPartTree = generateSpatialPartitioning(tree);
 
 #ifdef DEBUG
 			std::string jsonFilePrefix = "/";
@@ -525,11 +770,24 @@ bool GLTFModelExport::constructScene(
 	return success;
 }
 
-repo::lib::PropertyTree GLTFModelExport::generateSpatialPartitioning()
+repo::lib::PropertyTree GLTFModelExport::generateSpatialPartitioning(
+	repo::lib::PropertyTree &tree)
 {
 	//TODO: We could take in a spatial partitioner in the constructor to allow flexibility
 	repo::manipulator::modelutility::RDTreeSpatialPartitioner rdTreePartitioner(scene);
-	return rdTreePartitioner.generatePropertyTreeForPartitioning();
+	if (options.lodMode != WebLODMode::HIERARCHICAL)
+		return rdTreePartitioner.generatePropertyTreeForPartitioning();
+
+	auto spTree = rdTreePartitioner.partitionScene();
+	rdTreePartitioner.generateProxies(spTree);
+	if (spTree && spTree->proxy.faces.size())
+	{
+		std::string matLabel = GLTF_LABEL_MATERIALS + "." + REPO_GLTF_PROXY_MATERIAL;
+		tree.addToTree(matLabel + "." + GLTF_LABEL_TECHNIQUE, REPO_GLTF_DEFAULT_TECHNIQUE);
+		tree.addToTree(matLabel + "." + GLTF_LABEL_VALUES + "." + GLTF_LABEL_DIFFUSE, REPO_GLTF_PROXY_DIFFUSE);
+		populateWithProxies(tree, spTree);
+	}
+	return rdTreePartitioner.generatePropertyTreeForPartitioning(spTree);
 }
 
 bool GLTFModelExport::generateTreeRepresentation()
@@ -548,6 +806,15 @@ bool GLTFModelExport::generateTreeRepresentation()
 	ss << "3D Repo Bouncer v" << BOUNCER_VMAJOR << "." << BOUNCER_VMINOR;
 	tree.addToTree(GLTF_LABEL_ASSET + "." + GLTF_LABEL_GENERATOR, ss.str());
 	tree.addToTree(GLTF_LABEL_ASSET + "." + GLTF_LABEL_VERSION, GLTF_VERSION);
+	std::vector<std::string> extensions;
+	if (options.vertexFormat == WebVertexFormat::QUANTISED)
+		extensions.push_back(GLTF_EXT_QUANTIZED_ATTRIBUTES);
+	if (options.bufferEncoding == WebBufferEncoding::GEOMETRY_CODEC)
+		extensions.push_back(GLTF_EXT_GEOMETRY_CODEC);
+	if (extensions.size())
+	{
+		tree.addToTree(GLTF_LABEL_EXTENSIONS_USED, extensions);
+	}
 	//FIXME: SHADER- Premultiplied alpha?
 
 	success = constructScene(tree);
@@ -587,10 +854,9 @@ std::unordered_map<std::string, std::vector<uint8_t>> GLTFModelExport::getGLTFFi
 	}
 
 	//bin files
-	for (const auto &pair : fullDataBuffer)
+	for (const auto &pair : getOutputDataBuffers())
 	{
-		std::string bufferFilePrefix = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/";
-		std::string fileName = bufferFilePrefix + pair.first + ".bin";
+		std::string fileName = getBinaryFileName(pair.first);
 		if (pair.second.size())
 		{
 			auto it = files.find(fileName);
@@ -625,7 +891,7 @@ std::unordered_map<std::string, std::vector<uint8_t>> GLTFModelExport::getGLTFFi
 */
 bool GLTFModelExport::reIndexFaces(
 	const std::vector<std::vector<repo_mesh_mapping_t>> &matMap,
-	std::vector<uint16_t>                               &faces)
+	std::vector<uint32_t>                               &faces)
 {
 	size_t verticesOffset = 0;
 	size_t verticesLastIndex = 0;
@@ -831,6 +1097,17 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 {
 	repo::core::model::RepoNodeSet meshes = scene->getAllMeshes(gType);
 	std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> splitSizes;
+
+	//Reorganise the multipart meshes a batch at a time, in parallel, ordering faces for vertex cache reuse
+	std::vector<repo::manipulator::modelutility::MeshReorganiserCache::Request> requests;
+	for (const auto &mesh : meshes)
+	{
+		const repo::core::model::MeshNode *node = (const repo::core::model::MeshNode *)mesh;
+		if (node->getPrimitive() == repo::core::model::MeshNode::Primitive::TRIANGLES && node->getMeshMapping().size() > 1)
+			requests.push_back({ node, getVertexLimit(GLTF_MAX_VERTEX_LIMIT), GLTF_MAX_TRIANGLE_LIMIT, true });
+	}
+	repo::manipulator::modelutility::MeshReorganiserCache::BatchReader reorganisations(getReorganiserCache(), requests);
+
 	for (const auto &mesh : meshes)
 	{
 		const repo::core::model::MeshNode *node = (const repo::core::model::MeshNode *)mesh;
@@ -848,27 +1125,24 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 			continue;
 		}
 
-		if (mappings.size() > 1 || vertices.size() > GLTF_MAX_VERTEX_LIMIT)
+		if (mappings.size() > 1 || vertices.size() > getVertexLimit(GLTF_MAX_VERTEX_LIMIT))
 		{
 			//This is a multipart mesh node, the mesh may be too big for
 			//webGL, split the mesh into sub meshes
 			std::string bufferFileName = mesh->getUniqueID().toString();
-			repo::manipulator::modelutility::MeshMapReorganiser *reSplitter =
-				new repo::manipulator::modelutility::MeshMapReorganiser(node, GLTF_MAX_VERTEX_LIMIT, GLTF_MAX_TRIANGLE_LIMIT);
+			auto reorganised = reorganisations.read({ node, getVertexLimit(GLTF_MAX_VERTEX_LIMIT), GLTF_MAX_TRIANGLE_LIMIT, true });
 
-			repo::core::model::MeshNode splitMesh = reSplitter->getRemappedMesh();
+			const repo::core::model::MeshNode &splitMesh = reorganised->remappedMesh;
 			if (splitMesh.isEmpty())
 			{
 				repoError << "Failed to generate remappings for mesh: " << mesh->getUniqueID();
 				splitSizes.clear();
-				delete reSplitter;
 				return splitSizes;
 			}
-			std::vector<uint16_t> newFaces = reSplitter->getSerialisedFaces();
-			std::vector<std::vector<float>> idMapBuf = reSplitter->getIDMapArrays();
-			std::vector<std::vector<repo_mesh_mapping_t>> matMap = reSplitter->getMappingsPerSubMesh();
-
-			delete reSplitter;
+			//The faces and idMaps are modified below, so work on copies of the cached ones
+			std::vector<uint32_t> newFaces = reorganised->serialisedFaces;
+			std::vector<std::vector<float>> idMapBuf = reorganised->idMapArrays;
+			const std::vector<std::vector<repo_mesh_mapping_t>> &matMap = reorganised->mappingsPerSubMesh;
 
 			auto normals = splitMesh.getNormals();
 			auto vertices = splitMesh.getVertices();
@@ -931,9 +1205,15 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 
 			splitSizes[node->getUniqueID()] = newMappings.size();
 
-			size_t vStart = addToDataBuffer(bufferFileName, vertices);
-			size_t nStart = addToDataBuffer(bufferFileName, normals);
-			size_t fStart = addToDataBuffer(bufferFileName, newFaces);
+			//Positions are quantised per sub mesh, so their ranges follow matMap
+			std::vector<repo_mesh_mapping_t> subMeshes;
+			for (const auto &mappings : matMap)
+				subMeshes.insert(subMeshes.end(), mappings.begin(), mappings.end());
+			std::vector<VertexQuantiser::PositionRange> positionRanges;
+
+			size_t vStart = addToDataBuffer(bufferFileName, serialisePositions(vertices, subMeshes, positionRanges));
+			size_t nStart = addToDataBuffer(bufferFileName, serialiseNormals(normals));
+			size_t fStart = addToDataBuffer(bufferFileName, serialiseIndices(newFaces));
 
 			std::vector<size_t> idMapStart;
 			idMapStart.reserve(idMapBuf.size());
@@ -960,6 +1240,7 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				uvStart.push_back(addToDataBuffer(bufferFileName, UVs[i]));
 			}
 
+			size_t subMeshIdx = 0;
 			for (size_t i = 0; i < newMappings.size(); ++i)
 			{
 				//every mapping is a mesh
@@ -978,14 +1259,14 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				size_t fcount = newMappings[i].triTo - newMappings[i].triFrom;
 
 				//for each mesh we need to add a bufferView for each buffer
-				addBufferView(normBufferName, bufferFileName, tree, normals, nStart, vcount, meshId);
-				nStart += vcount * sizeof(repo::lib::RepoVector3D);
+				addBufferView(normBufferName, bufferFileName, tree, vcount * getNormalSize(), nStart, GLTF_PRIM_TYPE_ARRAY_BUFFER, getNormalSize(), meshId);
+				nStart += vcount * getNormalSize();
 
-				addBufferView(posBufferName, bufferFileName, tree, vertices, vStart, vcount, meshId);
-				vStart += vcount * sizeof(repo::lib::RepoVector3D);
+				addBufferView(posBufferName, bufferFileName, tree, vcount * getPositionSize(), vStart, GLTF_PRIM_TYPE_ARRAY_BUFFER, getPositionSize(), meshId);
+				vStart += vcount * getPositionSize();
 
 				addBufferView(faceBufferName, bufferFileName, tree, newFaces, fStart, fcount, meshId);
-				fStart += fcount * 3 * sizeof(uint16_t); //faces are triangulated
+				fStart += fcount * 3 * getIndexSize(); //faces are triangulated
 
 				addBufferView(idBufferName, bufferFileName, tree, idMapBuf[i], idMapStart[i], vcount, meshId);
 
@@ -999,6 +1280,8 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				size_t subMeshOffset_v = newMappings[i].vertFrom;
 				size_t subMeshOffset_f = newMappings[i].triFrom;
 
+				auto levels = addLevelsOfDetail(tree, bufferFileName, meshId, vertices, newFaces, matMap[i]);
+
 				auto lodIterator = lods[i].begin();
 				size_t nVertices = newMappings[i].vertTo - newMappings[i].vertFrom;
 				if (nVertices != idMapBuf[i].size())
@@ -1021,13 +1304,14 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 					{
 						std::string accessorName = subMeshName + "_" + GLTF_SUFFIX_FACES;
 						primitives.back().addToTree(GLTF_LABEL_INDICES, GLTF_PREFIX_ACCESSORS + "_" + accessorName);
-						std::vector<uint16_t> lodVec = *lodIterator;
+						std::vector<uint32_t> lodVec = *lodIterator;
 #if defined(DEBUG) && defined(LODLIMIT)
 						size_t triTo = meshMap.triFrom + (lodVec.size() < lodLimit ? lodVec.back() : lodVec[lodLimit - 1]) / 3;
 #else
 						size_t triTo = meshMap.triTo;
 #endif
 						addAccessors(accessorName, faceBufferName, tree, newFaces, meshMap.triFrom, triTo, subMeshID, *lodIterator, subMeshOffset_f);
+						addLevelOfDetailAccessors(primitives.back(), tree, subMeshName, meshId, levels, count - 1, subMeshID);
 					}
 					++lodIterator;
 
@@ -1035,15 +1319,22 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 					{
 						std::string accessorName = subMeshName + "_" + GLTF_SUFFIX_NORMALS;
 						primitives.back().addToTree(GLTF_LABEL_ATTRIBUTES + "." + GLTF_LABEL_NORMAL, GLTF_PREFIX_ACCESSORS + "_" + accessorName);
-						addAccessors(accessorName, normBufferName, tree, normals, meshMap.vertFrom, meshMap.vertTo, subMeshID, subMeshOffset_v);
+						if (options.vertexFormat == WebVertexFormat::QUANTISED)
+							addOctEncodedNormalAccessors(accessorName, normBufferName, tree, meshMap.vertFrom, meshMap.vertTo, subMeshID, subMeshOffset_v);
+						else
+							addAccessors(accessorName, normBufferName, tree, normals, meshMap.vertFrom, meshMap.vertTo, subMeshID, subMeshOffset_v);
 					}
 
 					if (vertices.size())
 					{
 						std::string accessorName = subMeshName + "_" + GLTF_SUFFIX_POSITION;
 						primitives.back().addToTree(GLTF_LABEL_ATTRIBUTES + "." + GLTF_LABEL_POSITION, GLTF_PREFIX_ACCESSORS + "_" + accessorName);
-						addAccessors(accessorName, posBufferName, tree, vertices, meshMap.vertFrom, meshMap.vertTo, subMeshID, subMeshOffset_v);
+						if (options.vertexFormat == WebVertexFormat::QUANTISED)
+							addQuantisedPositionAccessors(accessorName, posBufferName, tree, positionRanges[subMeshIdx], meshMap.vertFrom, meshMap.vertTo, subMeshID, subMeshOffset_v);
+						else
+							addAccessors(accessorName, posBufferName, tree, vertices, meshMap.vertFrom, meshMap.vertTo, subMeshID, subMeshOffset_v);
 					}
+					++subMeshIdx;
 
 					if (idMapBuf[i].size())
 					{
@@ -1067,6 +1358,15 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				}
 				tree.addArrayObjects(label + "." + GLTF_LABEL_PRIMITIVES, primitives);
 			}
+
+			//This buffer is complete, no need to keep it around if we have somewhere to send it
+			//(or, when encoding, to keep the raw bytes it was encoded from)
+			if (!flushDataBufferToSink(bufferFileName))
+			{
+				repoError << "Failed to hand over binary buffer of mesh " << mesh->getUniqueID() << " to the export sink.";
+				splitSizes.clear();
+				return splitSizes;
+			}
 		}
 		else
 		{
@@ -1086,7 +1386,7 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				tree.addToTree(label + "." + GLTF_LABEL_NAME, node->getName());
 
 			auto faces = node->getFaces();
-			std::vector<uint16_t> sFaces = serialiseFaces(faces);
+			std::vector<uint32_t> sFaces = serialiseFaces(faces);
 
 			bool hasMat = false;
 			repo::lib::RepoUUID matID;
@@ -1152,17 +1452,18 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 #endif
 			std::string bufferFileName = scene->getRevisionID().toString();
 
-			size_t vStart = addToDataBuffer(bufferFileName, vertices);
-			size_t nStart = addToDataBuffer(bufferFileName, vertices);
-			size_t fStart = addToDataBuffer(bufferFileName, sFaces);
+			std::vector<VertexQuantiser::PositionRange> positionRanges;
+			size_t vStart = addToDataBuffer(bufferFileName, serialisePositions(vertices, matMap[0], positionRanges));
+			size_t nStart = addToDataBuffer(bufferFileName, serialiseNormals(normals));
+			size_t fStart = addToDataBuffer(bufferFileName, serialiseIndices(sFaces));
 
 			std::string faceBufferName = meshId + "_" + GLTF_SUFFIX_FACES;
 			std::string normBufferName = meshId + "_" + GLTF_SUFFIX_NORMALS;
 			std::string posBufferName = meshId + "_" + GLTF_SUFFIX_POSITION;
 
 			//for each mesh we need to add a bufferView for each buffer
-			addBufferView(normBufferName, bufferFileName, tree, normals, nStart, normals.size(), meshId);
-			addBufferView(posBufferName, bufferFileName, tree, vertices, vStart, vertices.size(), meshId);
+			addBufferView(normBufferName, bufferFileName, tree, normals.size() * getNormalSize(), nStart, GLTF_PRIM_TYPE_ARRAY_BUFFER, getNormalSize(), meshId);
+			addBufferView(posBufferName, bufferFileName, tree, vertices.size() * getPositionSize(), vStart, GLTF_PRIM_TYPE_ARRAY_BUFFER, getPositionSize(), meshId);
 			addBufferView(faceBufferName, bufferFileName, tree, sFaces, fStart, faces.size(), meshId);
 
 			for (size_t i = 0; i < UVs.size(); ++i)
@@ -1192,6 +1493,9 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 					size_t triTo = faces.size();
 #endif
 					addAccessors(bufferName, faceBufferName, tree, sFaces, 0, faces.size(), meshId);
+
+					auto levels = addLevelsOfDetail(tree, bufferFileName, meshId, vertices, sFaces, matMap[0]);
+					addLevelOfDetailAccessors(primitives[0], tree, meshId, meshId, levels, 0, meshId);
 				}
 
 				//attributes
@@ -1200,14 +1504,20 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				{
 					std::string bufferName = meshId + "_" + GLTF_SUFFIX_NORMALS;
 					primitives[0].addToTree(GLTF_LABEL_ATTRIBUTES + "." + GLTF_LABEL_NORMAL, GLTF_PREFIX_ACCESSORS + "_" + bufferName);
-					addAccessors(bufferName, normBufferName, tree, normals, 0, normals.size(), meshId);
+					if (options.vertexFormat == WebVertexFormat::QUANTISED)
+						addOctEncodedNormalAccessors(bufferName, normBufferName, tree, 0, normals.size(), meshId, 0);
+					else
+						addAccessors(bufferName, normBufferName, tree, normals, 0, normals.size(), meshId);
 				}
 				auto vertices = node->getVertices();
 				if (vertices.size())
 				{
 					std::string bufferName = meshId + "_" + GLTF_SUFFIX_POSITION;
 					primitives[0].addToTree(GLTF_LABEL_ATTRIBUTES + "." + GLTF_LABEL_POSITION, GLTF_PREFIX_ACCESSORS + "_" + bufferName);
-					addAccessors(bufferName, posBufferName, tree, vertices, 0, vertices.size(), meshId);
+					if (options.vertexFormat == WebVertexFormat::QUANTISED)
+						addQuantisedPositionAccessors(bufferName, posBufferName, tree, positionRanges[0], 0, vertices.size(), meshId, 0);
+					else
+						addAccessors(bufferName, posBufferName, tree, vertices, 0, vertices.size(), meshId);
 				}
 
 				auto UVs = node->getUVChannelsSeparated();
@@ -1229,6 +1539,95 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 	return splitSizes;
 }
 
+void GLTFModelExport::populateWithProxies(
+	repo::lib::PropertyTree                         &tree,
+	const std::shared_ptr<repo_partitioning_tree_t> &spTree)
+{
+	if (!spTree)
+		return;
+
+	const auto &proxy = spTree->proxy;
+	if (proxy.faces.size())
+	{
+		const auto &vertices = proxy.vertices;
+		const auto &faces = proxy.faces;
+		const std::string &meshId = proxy.name;
+		const std::string bufferFileName = scene->getRevisionID().toString() + "_proxies";
+
+		//Proxies are too coarse to take normals from the meshes, use area weighted face normals
+		std::vector<repo::lib::RepoVector3D> normals(vertices.size(), { 0, 0, 0 });
+		for (size_t i = 0; i + 2 < faces.size(); i += 3)
+		{
+			const auto &a = vertices[faces[i]];
+			const auto &b = vertices[faces[i + 1]];
+			const auto &c = vertices[faces[i + 2]];
+			repo::lib::RepoVector3D ab = { b.x - a.x, b.y - a.y, b.z - a.z };
+			repo::lib::RepoVector3D ac = { c.x - a.x, c.y - a.y, c.z - a.z };
+			repo::lib::RepoVector3D n = { ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x };
+			for (size_t j = i; j < i + 3; ++j)
+			{
+				normals[faces[j]].x += n.x;
+				normals[faces[j]].y += n.y;
+				normals[faces[j]].z += n.z;
+			}
+		}
+		for (auto &normal : normals)
+			normal.normalize();
+
+		repo_mesh_mapping_t mapping;
+		mapping.vertFrom = 0;
+		mapping.vertTo = vertices.size();
+		mapping.triFrom = 0;
+		mapping.triTo = faces.size() / 3;
+		mapping.min = mapping.max = vertices[0];
+		for (const auto &v : vertices)
+		{
+			mapping.min.x = std::min(mapping.min.x, v.x); mapping.max.x = std::max(mapping.max.x, v.x);
+			mapping.min.y = std::min(mapping.min.y, v.y); mapping.max.y = std::max(mapping.max.y, v.y);
+			mapping.min.z = std::min(mapping.min.z, v.z); mapping.max.z = std::max(mapping.max.z, v.z);
+		}
+
+		std::vector<VertexQuantiser::PositionRange> positionRanges;
+		size_t vStart = addToDataBuffer(bufferFileName, serialisePositions(vertices, { mapping }, positionRanges));
+		size_t nStart = addToDataBuffer(bufferFileName, serialiseNormals(normals));
+		size_t fStart = addToDataBuffer(bufferFileName, serialiseIndices(faces));
+
+		std::string faceBufferName = meshId + "_" + GLTF_SUFFIX_FACES;
+		std::string normBufferName = meshId + "_" + GLTF_SUFFIX_NORMALS;
+		std::string posBufferName = meshId + "_" + GLTF_SUFFIX_POSITION;
+
+		addBufferView(normBufferName, bufferFileName, tree, normals.size() * getNormalSize(), nStart, GLTF_PRIM_TYPE_ARRAY_BUFFER, getNormalSize(), meshId);
+		addBufferView(posBufferName, bufferFileName, tree, vertices.size() * getPositionSize(), vStart, GLTF_PRIM_TYPE_ARRAY_BUFFER, getPositionSize(), meshId);
+		addBufferView(faceBufferName, bufferFileName, tree, faces, fStart, faces.size() / 3, meshId);
+
+		std::vector<repo::lib::PropertyTree> primitives;
+		primitives.push_back(repo::lib::PropertyTree());
+		primitives[0].addToTree(GLTF_LABEL_MATERIAL, REPO_GLTF_PROXY_MATERIAL);
+		primitives[0].addToTree(GLTF_LABEL_PRIMITIVE, GLTF_PRIM_TYPE_TRIANGLE);
+
+		primitives[0].addToTree(GLTF_LABEL_INDICES, GLTF_PREFIX_ACCESSORS + "_" + faceBufferName);
+		addAccessors(faceBufferName, faceBufferName, tree, faces, 0, faces.size() / 3, meshId);
+
+		primitives[0].addToTree(GLTF_LABEL_ATTRIBUTES + "." + GLTF_LABEL_NORMAL, GLTF_PREFIX_ACCESSORS + "_" + normBufferName);
+		if (options.vertexFormat == WebVertexFormat::QUANTISED)
+			addOctEncodedNormalAccessors(normBufferName, normBufferName, tree, 0, normals.size(), meshId, 0);
+		else
+			addAccessors(normBufferName, normBufferName, tree, normals, 0, normals.size(), meshId);
+
+		primitives[0].addToTree(GLTF_LABEL_ATTRIBUTES + "." + GLTF_LABEL_POSITION, GLTF_PREFIX_ACCESSORS + "_" + posBufferName);
+		if (options.vertexFormat == WebVertexFormat::QUANTISED)
+			addQuantisedPositionAccessors(posBufferName, posBufferName, tree, positionRanges[0], 0, vertices.size(), meshId, 0);
+		else
+			addAccessors(posBufferName, posBufferName, tree, vertices, 0, vertices.size(), meshId);
+
+		tree.addToTree(GLTF_LABEL_MESHES + "." + meshId + "." + GLTF_LABEL_NAME, meshId);
+		tree.addArrayObjects(GLTF_LABEL_MESHES + "." + meshId + "." + GLTF_LABEL_PRIMITIVES, primitives);
+	}
+
+	populateWithProxies(tree, spTree->left);
+	populateWithProxies(tree, spTree->right);
+}
+
 void GLTFModelExport::populateWithTextures(
 	repo::lib::PropertyTree           &tree)
 {
@@ -1280,12 +1679,12 @@ void GLTFModelExport::populateWithNodes(
 	}
 }
 
-std::vector<std::vector<std::vector<uint16_t>>> GLTFModelExport::reorderFaces(
-	std::vector<uint16_t>                         &faces,
+std::vector<std::vector<std::vector<uint32_t>>> GLTFModelExport::reorderFaces(
+	std::vector<uint32_t>                         &faces,
 	const std::vector<repo::lib::RepoVector3D>                    &vertices,
 	const std::vector<std::vector<repo_mesh_mapping_t>> &mapping)
 {
-	std::vector<std::vector<std::vector<uint16_t>>> lods;
+	std::vector<std::vector<std::vector<uint32_t>>> lods;
 	for (size_t i = 0; i < mapping.size(); ++i)
 	{
 		lods.resize(lods.size() + 1);
@@ -1294,29 +1693,29 @@ std::vector<std::vector<std::vector<uint16_t>>> GLTFModelExport::reorderFaces(
 		{
 			lods[i].resize(lods[i].size() + 1);
 			lods[i].back().clear();
-			std::vector<uint16_t> newFaces = reorderFaces(faces, vertices, mapping[i][j], lods[i].back());
+			std::vector<uint32_t> newFaces = reorderFaces(faces, vertices, mapping[i][j], lods[i].back());
 			std::copy(newFaces.begin(), newFaces.end(), faces.begin() + mapping[i][j].triFrom * 3);
 		}
 	}
 	return lods;
 }
 
-std::vector<uint16_t> GLTFModelExport::reorderFaces(
-	const std::vector<uint16_t>      &faces,
+std::vector<uint32_t> GLTFModelExport::reorderFaces(
+	const std::vector<uint32_t>      &faces,
 	const std::vector<repo::lib::RepoVector3D> &vertices,
 	const repo_mesh_mapping_t        &mapping,
-	std::vector<uint16_t>      &lods) const
+	std::vector<uint32_t>      &lods) const
 {
 	const uint32_t maxBits = 16;
 	const float maxQuant = pow(2, maxBits) - 1;
 
 	const repo::lib::RepoVector3D *vRaw = &vertices[mapping.vertFrom];
-	const uint16_t      *fRaw = &faces[mapping.triFrom * 3];
+	const uint32_t      *fRaw = &faces[mapping.triFrom * 3];
 
 	const size_t vCount = mapping.vertTo - mapping.vertFrom;
 	const size_t fCount = mapping.triTo - mapping.triFrom;
 
-	//use int32_t because we need to represent all values in uint16_t and also -1
+	//use int32_t because we need to represent all vertex indices and also -1
 	std::vector<int32_t> vertexMap;
 	vertexMap.resize(vCount);
 
@@ -1329,7 +1728,7 @@ std::vector<uint16_t> GLTFModelExport::reorderFaces(
 	//Instantiate with false
 	std::fill(validFaces.begin(), validFaces.end(), false);
 
-	std::vector<uint16_t> reOrderedFaces;
+	std::vector<uint32_t> reOrderedFaces;
 	reOrderedFaces.reserve(fCount * 3);
 
 	repo::lib::RepoVector3D bboxMin = mapping.min;
@@ -1403,10 +1802,10 @@ std::vector<uint16_t> GLTFModelExport::reorderFaces(
 	return reOrderedFaces;
 }
 
-std::vector<uint16_t> GLTFModelExport::serialiseFaces(
+std::vector<uint32_t> GLTFModelExport::serialiseFaces(
 	const std::vector<repo_face_t> &faces) const
 {
-	std::vector<uint16_t> sFaces;
+	std::vector<uint32_t> sFaces;
 
 	for (uint32_t i = 0; i < faces.size(); ++i)
 	{
@@ -1428,7 +1827,13 @@ std::vector<uint16_t> GLTFModelExport::serialiseFaces(
 void GLTFModelExport::writeBuffers(
 	repo::lib::PropertyTree &tree)
 {
-	for (const auto &pair : fullDataBuffer)
+	std::unordered_map<std::string, size_t> bufferSizes = flushedBufferSizes;
+	for (const auto &pair : getOutputDataBuffers())
+	{
+		bufferSizes[pair.first] = pair.second.size()  * sizeof(*pair.second.data());
+	}
+
+	for (const auto &pair : bufferSizes)
 	{
 #ifdef DEBUG
 		std::string bufferFilePrefix = "/";
@@ -1436,7 +1841,7 @@ void GLTFModelExport::writeBuffers(
 		std::string bufferFilePrefix = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/";
 #endif
 		std::string bufferLabel = GLTF_LABEL_BUFFERS + "." + pair.first;
-		tree.addToTree(bufferLabel + "." + GLTF_LABEL_BYTE_LENGTH, pair.second.size()  * sizeof(*pair.second.data()));
+		tree.addToTree(bufferLabel + "." + GLTF_LABEL_BYTE_LENGTH, pair.second);
 		tree.addToTree(bufferLabel + "." + GLTF_LABEL_TYPE, GLTF_ARRAY_BUFFER);
 		tree.addToTree(bufferLabel + "." + GLTF_LABEL_URI, "/api" + bufferFilePrefix + pair.first + ".bin");
 	}
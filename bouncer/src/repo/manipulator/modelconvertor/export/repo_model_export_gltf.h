@@ -26,6 +26,7 @@
 #include "repo_model_export_web.h"
 #include "../../../lib/repo_property_tree.h"
 #include "../../../core/model/collection/repo_scene.h"
+#include "../../modelutility/repo_mesh_simplifier.h"
 
 namespace repo{
 	namespace manipulator{
@@ -36,8 +37,14 @@ namespace repo{
 				/**
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
+				* @param sink if given, each binary buffer is handed to the sink
+				*             as soon as its super mesh is converted
+				* @param options formats of the exported geometry
 				*/
-				GLTFModelExport(const repo::core::model::RepoScene *scene);
+				GLTFModelExport(
+					const repo::core::model::RepoScene *scene,
+					AbstractWebExportSink *sink = nullptr,
+					const WebExportOptions &options = WebExportOptions());
 
 				/**
 				* Default Destructor
@@ -53,16 +60,20 @@ namespace repo{
 
 			private:
 				std::unordered_map<std::string, std::vector<uint8_t>> fullDataBuffer;
+				//data buffers with every buffer view encoded by the geometry codec
+				std::unordered_map<std::string, std::vector<uint8_t>> encodedDataBuffer;
+				//byte length of data buffers already handed over to the sink
+				std::unordered_map<std::string, size_t> flushedBufferSizes;
 
 				void addAccessors(
 					const std::string              &accName,
 					const std::string              &buffViewName,
 					repo::lib::PropertyTree        &tree,
-					const std::vector<uint16_t>    &faces,
+					const std::vector<uint32_t>    &faces,
 					const uint32_t                 &addrFrom,
 					const uint32_t                 &addrTo,
 					const std::string              &refId = std::string(),
-					const std::vector<uint16_t>    &lod = std::vector<uint16_t>(),
+					const std::vector<uint32_t>    &lod = std::vector<uint32_t>(),
 					const size_t                   &offset = 0);
 
 				void addAccessors(
@@ -95,6 +106,48 @@ namespace repo{
 					const std::string                &refId = std::string(),
 					const size_t                     &offset = 0);
 
+				/**
+				* Add an accessor to positions quantised by serialisePositions(),
+				* decoded with the WEB3D_quantized_attributes extension
+				* @param accName name of accessor
+				* @param buffViewName name of buffer
+				* @param tree tree to add the properties in
+				* @param range range the positions were quantised against
+				* @param addrFrom first vertex of the accessor
+				* @param addrTo end of the vertices of the accessor
+				* @param refId id of the sub mesh
+				* @param offset first vertex of the buffer view
+				*/
+				void addQuantisedPositionAccessors(
+					const std::string                           &accName,
+					const std::string                           &buffViewName,
+					repo::lib::PropertyTree                     &tree,
+					const VertexQuantiser::PositionRange        &range,
+					const uint32_t                              &addrFrom,
+					const uint32_t                              &addrTo,
+					const std::string                           &refId,
+					const size_t                                &offset);
+
+				/**
+				* Add an accessor to normals octahedron encoded by serialiseNormals().
+				* The accessor holds the encoded pairs, and is flagged as such in its extras.
+				* @param accName name of accessor
+				* @param buffViewName name of buffer
+				* @param tree tree to add the properties in
+				* @param addrFrom first vertex of the accessor
+				* @param addrTo end of the vertices of the accessor
+				* @param refId id of the sub mesh
+				* @param offset first vertex of the buffer view
+				*/
+				void addOctEncodedNormalAccessors(
+					const std::string              &accName,
+					const std::string              &buffViewName,
+					repo::lib::PropertyTree        &tree,
+					const uint32_t                 &addrFrom,
+					const uint32_t                 &addrTo,
+					const std::string              &refId,
+					const size_t                   &offset);
+
 				/**
 				* Add an accessor to a bufferview
 				* @param accName name of accessor
@@ -120,7 +173,7 @@ namespace repo{
 					const std::vector<float>       &min,
 					const std::vector<float>       &max,
 					const std::string              &refId = std::string(),
-					const std::vector<uint16_t>    &lod = std::vector<uint16_t>());
+					const std::vector<uint32_t>    &lod = std::vector<uint32_t>());
 
 				/**
 				* Add a buffer view into a buffer,
@@ -135,7 +188,7 @@ namespace repo{
 					const std::string                   &name,
 					const std::string                   &fileName,
 					repo::lib::PropertyTree             &tree,
-					const std::vector<uint16_t>         &buffer,
+					const std::vector<uint32_t>         &buffer,
 					const size_t                        &offset,
 					const size_t                        &count,
 					const std::string                   &refId = std::string()
@@ -150,16 +203,6 @@ namespace repo{
 					const size_t                        &count,
 					const std::string                   &refId);
 
-				void addBufferView(
-					const std::string                   &name,
-					const std::string                   &fileName,
-					repo::lib::PropertyTree             &tree,
-					const std::vector<repo::lib::RepoVector3D>    &buffer,
-					const size_t                        &offset,
-					const size_t                        &count,
-					const std::string                   &refId = std::string()
-					);
-
 				void addBufferView(
 					const std::string                   &name,
 					const std::string                   &fileName,
@@ -177,7 +220,11 @@ namespace repo{
 				* @param name name of the buffer
 				* @param fileName name of binary file
 				* @param tree tree to insert header info into
-				* @param buffer buffer to export
+				* @param byteLength length of the buffer view
+				* @param offset offset of the buffer view within the data buffer
+				* @param bufferTarget target of the buffer view
+				* @param byteStride size of an element of the buffer view
+				* @param refId reference id of the mesh
 				*/
 				void addBufferView(
 					const std::string                   &name,
@@ -186,6 +233,7 @@ namespace repo{
 					const size_t						&byteLength,
 					const size_t                        &offset,
 					const uint32_t						&bufferTarget,
+					const size_t                        &byteStride,
 					const std::string                   &refId = std::string()
 					);
 
@@ -211,6 +259,38 @@ namespace repo{
 					return addToDataBuffer(bufferName, (uint8_t*)buffer.data(), buffer.size() * sizeof(T));
 				}
 
+				/**
+				* Hand the given data buffer to the sink and release it from memory
+				* When encoding, the raw buffer is released even without a sink
+				* @param bufferName name of the buffer
+				* @return returns true upon success
+				*/
+				bool flushDataBufferToSink(
+					const std::string              &bufferName);
+
+				/**
+				* Hand all files generated so far to the sink
+				* and release them from memory
+				* @return returns true upon success
+				*/
+				bool flushFilesToSink();
+
+				/**
+				* Get the data buffers as they are written out, i.e. with
+				* the buffer views encoded if the geometry codec is enabled
+				* @return returns the data buffers to write out
+				*/
+				std::unordered_map<std::string, std::vector<uint8_t>>& getOutputDataBuffers();
+				const std::unordered_map<std::string, std::vector<uint8_t>>& getOutputDataBuffers() const;
+
+				/**
+				* Get the file name of the binary file holding the given buffer
+				* @param bufferName name of the buffer
+				* @return returns the file name
+				*/
+				std::string getBinaryFileName(
+					const std::string              &bufferName) const;
+
 				/**
 				* Construct JSON document about the scene
 				* @param tree tree to place the info
@@ -227,10 +307,62 @@ namespace repo{
 				bool generateTreeRepresentation();
 
 				/**
-				* Generate a property tree representing the spatial partitioning
+				* Generate a property tree representing the spatial partitioning.
+				* With hierarchical levels of detail, the proxy meshes of the
+				* partitions are added to the given tree.
+				* @param tree tree to place the proxy meshes
 				* @return return a property tree with adequate entries
 				*/
-				repo::lib::PropertyTree generateSpatialPartitioning();
+				repo::lib::PropertyTree generateSpatialPartitioning(
+					repo::lib::PropertyTree &tree);
+
+				/**
+				* Generate coarser levels of detail of a super mesh, and add their
+				* triangles to the data buffer, with a buffer view per level
+				* @param tree tree to place the buffer views
+				* @param bufferFileName data buffer to add the triangles to
+				* @param meshId name of the super mesh
+				* @param vertices vertices of the mesh
+				* @param faces triangles of the mesh, indexing the vertices of their sub mesh
+				* @param subMeshes sub meshes of the super mesh
+				* @return returns the levels of detail, empty if they are not enabled
+				*/
+				std::vector<repo::manipulator::modelutility::MeshSimplifier::Level> addLevelsOfDetail(
+					repo::lib::PropertyTree                    &tree,
+					const std::string                          &bufferFileName,
+					const std::string                          &meshId,
+					const std::vector<repo::lib::RepoVector3D> &vertices,
+					const std::vector<uint32_t>                &faces,
+					const std::vector<repo_mesh_mapping_t>     &subMeshes);
+
+				/**
+				* Add the accessors of the levels of detail of a sub mesh, and
+				* list them on its primitive
+				* @param primitive primitive of the sub mesh
+				* @param tree tree to place the accessors
+				* @param subMeshName name of the sub mesh
+				* @param meshId name of the super mesh
+				* @param levels levels of detail from addLevelsOfDetail()
+				* @param subMeshIdx index of the sub mesh within the super mesh
+				* @param refId sub mesh id
+				*/
+				void addLevelOfDetailAccessors(
+					repo::lib::PropertyTree                                                   &primitive,
+					repo::lib::PropertyTree                                                   &tree,
+					const std::string                                                         &subMeshName,
+					const std::string                                                         &meshId,
+					const std::vector<repo::manipulator::modelutility::MeshSimplifier::Level> &levels,
+					const size_t                                                              &subMeshIdx,
+					const std::string                                                         &refId);
+
+				/**
+				* Populate the given tree with the proxy meshes of a partitioning
+				* @param tree tree to populate
+				* @param spTree partitioning with proxies
+				*/
+				void populateWithProxies(
+					repo::lib::PropertyTree                         &tree,
+					const std::shared_ptr<repo_partitioning_tree_t> &spTree);
 
 				/**
 				* Return the GLTF file as raw bytes buffer
@@ -245,7 +377,7 @@ namespace repo{
 				*/
 				bool reIndexFaces(
 					const std::vector<std::vector<repo_mesh_mapping_t>> &matMap,
-					std::vector<uint16_t>                               &faces);
+					std::vector<uint32_t>                               &faces);
 
 				/**
 				* Process children of nodes(Transformation)
@@ -295,8 +427,8 @@ namespace repo{
 					repo::lib::PropertyTree          &tree,
 					const std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> &subMeshCounts);
 
-				std::vector<std::vector<std::vector<uint16_t>>> reorderFaces(
-					std::vector<uint16_t>                               &faces,
+				std::vector<std::vector<std::vector<uint32_t>>> reorderFaces(
+					std::vector<uint32_t>                               &faces,
 					const std::vector<repo::lib::RepoVector3D>                    &vertices,
 					const std::vector<std::vector<repo_mesh_mapping_t>> &mapping);
 
@@ -307,13 +439,13 @@ namespace repo{
 				* @param mapping mapping detailing which chunk of face to reorder
 				* @return returns the reordered version of the faces
 				*/
-				std::vector<uint16_t> reorderFaces(
-					const std::vector<uint16_t>      &faces,
+				std::vector<uint32_t> reorderFaces(
+					const std::vector<uint32_t>      &faces,
 					const std::vector<repo::lib::RepoVector3D> &vertices,
 					const repo_mesh_mapping_t        &mapping,
-					std::vector<uint16_t>      &lods) const;
+					std::vector<uint32_t>      &lods) const;
 
-				std::vector<uint16_t> serialiseFaces(
+				std::vector<uint32_t> serialiseFaces(
 					const std::vector<repo_face_t> &faces) const;
 
 				/**
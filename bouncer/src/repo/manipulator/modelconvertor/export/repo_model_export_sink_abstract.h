@@ -0,0 +1,69 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Abstract destination for files produced by the web exporters.
+* Exporters given a sink hand each file over as soon as it is complete,
+* instead of holding the whole web representation in memory.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace repo{
+	namespace manipulator{
+		namespace modelconvertor{
+			class AbstractWebExportSink
+			{
+			public:
+				virtual ~AbstractWebExportSink() {}
+
+				/**
+				* Hand over a geometry file. The sink takes ownership of the buffer.
+				* May block if the sink has too much data in flight.
+				* @param fileName name of the file
+				* @param buffer file content
+				* @return returns false if the sink can no longer accept files
+				*/
+				virtual bool addGeometryFile(
+					const std::string    &fileName,
+					std::vector<uint8_t> &&buffer) = 0;
+
+				/**
+				* Hand over a JSON file. The sink takes ownership of the buffer.
+				* May block if the sink has too much data in flight.
+				* @param fileName name of the file
+				* @param buffer file content
+				* @return returns false if the sink can no longer accept files
+				*/
+				virtual bool addJSONFile(
+					const std::string    &fileName,
+					std::vector<uint8_t> &&buffer) = 0;
+
+				/**
+				* Wait for all files handed over to be processed
+				* No more files should be added after this is called.
+				* @return returns true if every file was processed successfully
+				*/
+				virtual bool finalise() = 0;
+			};
+		} //namespace modelconvertor
+	} //namespace manipulator
+} //namespace repo
@@ -22,8 +22,8 @@
 #include "repo_model_export_src.h"
 #include "../../../core/model/bson/repo_bson_factory.h"
 #include "../../../lib/repo_log.h"
-#include "../../modelutility/repo_mesh_map_reorganiser.h"
 #include <iostream>
+#include <limits>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
@@ -36,7 +36,9 @@ const static uint32_t SRC_VERSION = 42;
 const static size_t SRC_MAX_VERTEX_LIMIT = 65535;
 const static size_t SRC_MAX_TRIANGLE_LIMIT = SIZE_MAX;
 const static size_t SRC_X3DOM_FLOAT = 5126;
+const static size_t SRC_X3DOM_SHORT = 5122;
 const static size_t SRC_X3DOM_USHORT = 5123;
+const static size_t SRC_X3DOM_UINT = 5125;
 const static size_t SRC_X3DOM_TRIANGLE = 4;
 const static std::string SRC_VECTOR_2D = "VEC2";
 const static std::string SRC_VECTOR_3D = "VEC3";
@@ -56,6 +58,7 @@ const static std::string SRC_LABEL_BYTE_STRIDE = "byteStride";
 const static std::string SRC_LABEL_COMP_TYPE = "componentType";
 const static std::string SRC_LABEL_TYPE = "type";
 const static std::string SRC_LABEL_CHUNKS = "chunks";
+const static std::string SRC_LABEL_CODEC = "codec";
 const static std::string SRC_LABEL_COUNT = "count";
 const static std::string SRC_LABEL_DECODE_OFFSET = "decodeOffset";
 const static std::string SRC_LABEL_DECODE_SCALE = "decodeScale";
@@ -64,6 +67,7 @@ const static std::string SRC_LABEL_INDICIES = "indices";
 const static std::string SRC_LABEL_PRIMITIVE = "primitive";
 const static std::string SRC_LABEL_MESHES = "meshes";
 const static std::string SRC_LABEL_NORMAL = "normal";
+const static std::string SRC_LABEL_OCT_ENCODED = "octEncoded";
 const static std::string SRC_LABEL_POSITION = "position";
 const static std::string SRC_LABEL_TEX_COORD = "texcoord";
 
@@ -110,9 +114,24 @@ const static std::string MP_LABEL_TEXTURE_NAME = "name";
 const static std::string MP_LABEL_TEXTURE_EXTENSION = "extension"; // The format of the file; this is different to the pixel format, which can be retrieved from the file itself
 const static std::string MP_LABEL_TEXTURE_ID = "id";
 
+/**
+* A chunk of the SRC data buffer. Its final position is only known once
+* the buffer is written out, as chunks may be encoded.
+*/
+struct SRCBufferChunk
+{
+	std::string label;
+	size_t byteOffset;
+	size_t byteLength;
+	size_t byteStride;
+	bool isIndices;
+};
+
 SRCModelExport::SRCModelExport(
-	const repo::core::model::RepoScene *scene
-	) : WebModelExport(scene)
+	const repo::core::model::RepoScene *scene,
+	AbstractWebExportSink *sink,
+	const WebExportOptions &options
+	) : WebModelExport(scene, sink, options)
 {
 	//Considering all newly imported models should have a stash graph, we only need to support stash graph?
 	if (convertSuccess)
@@ -142,71 +161,101 @@ std::unordered_map<std::string, std::vector<uint8_t>> SRCModelExport::getSRCFile
 
 	for (const auto &treePair : trees)
 	{
-		std::vector<uint8_t> buffer;
-		std::string fName = treePair.first;
+		const auto fdIt = fullDataBuffer.find(treePair.first);
+
+		if (fdIt != fullDataBuffer.end())
+		{
+			fileBuffers[treePair.first] = serialiseSRCFile(treePair.second, fdIt->second);
+		}
+		else
+		{
+			repoError << " Failed to find data buffer for " << treePair.first;
+		}
+	}
+
+	return fileBuffers;
+}
+
+bool SRCModelExport::flushFilesToSink()
+{
+	bool success = true;
+	if (sink)
+	{
+		for (const auto &treePair : trees)
+		{
+			const auto fdIt = fullDataBuffer.find(treePair.first);
 
-		std::stringstream ss;
-		treePair.second.write_json(ss);
-		std::string jsonStr = ss.str();
+			if (fdIt != fullDataBuffer.end())
+			{
+				success &= sink->addGeometryFile(treePair.first, serialiseSRCFile(treePair.second, fdIt->second));
+			}
+			else
+			{
+				repoError << " Failed to find data buffer for " << treePair.first;
+				success = false;
+			}
+		}
+		trees.clear();
+		fullDataBuffer.clear();
 
-		//one char is one byte, 12bytes for Magic Bit(4), SRC Version (4), Header Length(4)
-		size_t jsonByteSize = jsonStr.size()*sizeof(*jsonStr.c_str());
-		size_t headerSize = 12 + jsonByteSize;
+		success &= flushJSONFilesToSink();
+	}
 
-		size_t buffPtr = 0; //BufferPointer in bytes
+	return success;
+}
 
-		buffer.resize(headerSize);
+std::vector<uint8_t> SRCModelExport::serialiseSRCFile(
+	const repo::lib::PropertyTree &tree,
+	const std::vector<uint8_t>    &dataBuffer) const
+{
+	std::vector<uint8_t> buffer;
+
+	std::stringstream ss;
+	tree.write_json(ss);
+	std::string jsonStr = ss.str();
+
+	//one char is one byte, 12bytes for Magic Bit(4), SRC Version (4), Header Length(4)
+	size_t jsonByteSize = jsonStr.size()*sizeof(*jsonStr.c_str());
+	size_t headerSize = 12 + jsonByteSize;
+
+	size_t buffPtr = 0; //BufferPointer in bytes
+
+	buffer.resize(headerSize);
 
-		uint32_t* bufferAsUInt = (uint32_t*)buffer.data();
+	uint32_t* bufferAsUInt = (uint32_t*)buffer.data();
 
-		//Header ints
+	//Header ints
 #if defined(REPO_BOOST_NO_GZIP)
-		bufferAsUInt[0] = SRC_MAGIC_BIT;
+	bufferAsUInt[0] = SRC_MAGIC_BIT;
 #else
-		bufferAsUInt[0] = SRC_MAGIC_BIT_COMPRESSED;
+	bufferAsUInt[0] = SRC_MAGIC_BIT_COMPRESSED;
 #endif
-		bufferAsUInt[1] = SRC_VERSION;
-		bufferAsUInt[2] = jsonByteSize;
+	bufferAsUInt[1] = SRC_VERSION;
+	bufferAsUInt[2] = jsonByteSize;
 
-		buffPtr += 3 * sizeof(uint32_t);
+	buffPtr += 3 * sizeof(uint32_t);
 
-		//write json
-		memcpy(&buffer[buffPtr], jsonStr.c_str(), jsonByteSize);
+	//write json
+	memcpy(&buffer[buffPtr], jsonStr.c_str(), jsonByteSize);
 
-		buffPtr += jsonByteSize;
+	buffPtr += jsonByteSize;
 
-		const auto fdIt = fullDataBuffer.find(fName);
+#if !defined(REPO_BOOST_NO_GZIP)
+	boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
+	out.push(boost::iostreams::zlib_compressor());
+	out.push(boost::iostreams::array_source((const char*)dataBuffer.data(), dataBuffer.size()));
 
-		if (fdIt != fullDataBuffer.end())
-		{
-			auto fullDataArray = fdIt->second;
+	// The first 4 bytes define the length of the uncompressed data. ZLib, at the least, requires this be known ahead of time.
+	buffer.resize(buffPtr + 4);
+	((uint32_t*)&buffer[buffPtr])[0] = dataBuffer.size();
 
-#if !defined(REPO_BOOST_NO_GZIP)
-				boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
-				out.push(boost::iostreams::zlib_compressor());
-				out.push(boost::iostreams::array_source((const char*)fullDataArray.data(), fullDataArray.size()));
-
-				// The first 4 bytes define the length of the uncompressed data. ZLib, at the least, requires this be known ahead of time.
-				std::vector<uint8_t> compressed;
-				compressed.resize(4);
-				((uint32_t*)compressed.data())[0] = fullDataArray.size();
-				
-				compressed.insert(compressed.end(), std::istreambuf_iterator<char>(&out), std::istreambuf_iterator<char>());
-				
-				fullDataArray = compressed;
+	buffer.insert(buffer.end(), std::istreambuf_iterator<char>(&out), std::istreambuf_iterator<char>());
+#else
+	//Add data buffer to the full buffer
+	buffer.insert(buffer.end(), dataBuffer.begin(), dataBuffer.end());
 #endif
 
-			//Add data buffer to the full buffer
-			buffer.insert(buffer.end(), fullDataArray.begin(), fullDataArray.end());
-			fileBuffers[fName] = buffer;
-		}
-		else
-		{
-			repoError << " Failed to find data buffer for " << fName;
-		}
-	}
-
-	return fileBuffers;
+	return buffer;
 }
 
 repo_web_buffers_t SRCModelExport::getAllFilesExportedAsBuffer() const
@@ -337,6 +386,17 @@ bool SRCModelExport::generateTreeRepresentation(
 		size_t index = 0;
 		//Every mesh is a new SRC file
 		fullDataBuffer.reserve(meshes.size());
+
+		//Reorganise the meshes a batch at a time, in parallel, ordering faces for vertex cache reuse
+		std::vector<repo::manipulator::modelutility::MeshReorganiserCache::Request> requests;
+		for (const repo::core::model::RepoNode* node : meshes)
+		{
+			auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
+			if (mesh && mesh->getPrimitive() == repo::core::model::MeshNode::Primitive::TRIANGLES)
+				requests.push_back({ mesh, getVertexLimit(SRC_MAX_VERTEX_LIMIT), SRC_MAX_TRIANGLE_LIMIT, true });
+		}
+		repo::manipulator::modelutility::MeshReorganiserCache::BatchReader reorganisations(getReorganiserCache(), requests);
+
 		for (const repo::core::model::RepoNode* node : meshes)
 		{
 			auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
@@ -352,23 +412,22 @@ bool SRCModelExport::generateTreeRepresentation(
 				continue;
 			}
 
-			repo::manipulator::modelutility::MeshMapReorganiser *reSplitter =
-				new repo::manipulator::modelutility::MeshMapReorganiser(mesh, SRC_MAX_VERTEX_LIMIT, SRC_MAX_TRIANGLE_LIMIT);
+			auto reorganised = reorganisations.read({ mesh, getVertexLimit(SRC_MAX_VERTEX_LIMIT), SRC_MAX_TRIANGLE_LIMIT, true });
 
-			repo::core::model::MeshNode splittedMesh = reSplitter->getRemappedMesh();
+			const repo::core::model::MeshNode &splittedMesh = reorganised->remappedMesh;
 			if (success = !(splittedMesh.isEmpty()))
 			{
-				std::vector<uint16_t> facebuf = reSplitter->getSerialisedFaces();
-				std::vector<std::vector<float>> idMapBuf = reSplitter->getIDMapArrays();
-				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMapping = reSplitter->getSplitMapping();
-				delete reSplitter;
-
 				std::string ext = ".src.mpc";
 
-				if (success = addMeshToExport(splittedMesh, index, facebuf, idMapBuf, ext))
+				if (success = addMeshToExport(splittedMesh, index, reorganised->serialisedFaces, reorganised->idMapArrays, ext))
 				{
 					++index;
-					success &= generateJSONMapping(mesh, scene, splitMapping);
+					success &= generateJSONMapping(mesh, scene, reorganised->splitMapping);
+					if (success && sink && !(success = flushFilesToSink()))
+					{
+						repoError << "Failed to hand over SRC files of mesh " << mesh->getUniqueID() << " to the export sink.";
+						break;
+					}
 				}
 				else
 				{
@@ -390,7 +449,7 @@ bool SRCModelExport::generateTreeRepresentation(
 bool SRCModelExport::addMeshToExport(
 	const repo::core::model::MeshNode      &mesh,
 	const size_t                           &idx,
-	const std::vector<uint16_t>            &faceBuf,
+	const std::vector<uint32_t>            &faceBuf,
 	const std::vector<std::vector<float>>  &idMapBuf,
 	const std::string                      &fileExt
 	)
@@ -407,17 +466,22 @@ bool SRCModelExport::addMeshToExport(
 		return false;
 	}
 
+	std::vector<VertexQuantiser::PositionRange> positionRanges;
+	auto positionBuf = serialisePositions(vertices, mapping, positionRanges);
+	auto normalBuf = serialiseNormals(normals);
+	const bool quantised = options.vertexFormat == WebVertexFormat::QUANTISED;
+
 	//Define starting position of buffers
 	size_t bufPos = 0; //In bytes
 	size_t vertexWritePosition = bufPos;
 
-	bufPos += vertices.size()*sizeof(*vertices.data());
+	bufPos += positionBuf.size();
 
 	size_t normalWritePosition = bufPos;
-	bufPos += normals.size()*sizeof(*normals.data());
+	bufPos += normalBuf.size();
 
 	size_t facesWritePosition = bufPos;
-	bufPos += faceBuf.size() * sizeof(*faceBuf.data());
+	bufPos += faceBuf.size() * getIndexSize();
 
 	size_t idMapWritePosition = bufPos;
 	bufPos += vertices.size() * sizeof(float); //idMap array is of floats
@@ -428,6 +492,7 @@ bool SRCModelExport::addMeshToExport(
 	std::string meshId = mesh.getUniqueID().toString();
 
 	repo::lib::PropertyTree tree;
+	std::vector<SRCBufferChunk> chunks;
 	size_t lastV = 0, lastF = 0;
 	repoTrace << "Looping Through submeshes (#submeshes : " << nSubMeshes << ")";
 	for (size_t subMeshIdx = 0; subMeshIdx < nSubMeshes; ++subMeshIdx)
@@ -487,21 +552,35 @@ bool SRCModelExport::addMeshToExport(
 			std::string srcAccessors_AttrViews_positionAttrView = srcAccessors_AttributeViews + "." + positionAttributeView + ".";
 			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_BUFFVIEW, positionBufferView);
 			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_BYTE_OFFSET, 0);
-			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_BYTE_STRIDE, 12);
-			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_COMP_TYPE, SRC_X3DOM_FLOAT);
+			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_BYTE_STRIDE, getPositionSize());
+			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_COMP_TYPE, quantised ? SRC_X3DOM_USHORT : SRC_X3DOM_FLOAT);
 			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_TYPE, SRC_VECTOR_3D);
 			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_COUNT, vCount);
 
-			std::vector<uint32_t> offsetArr = { 0, 0, 0 };
-			std::vector<uint32_t> scaleArr = { 1, 1, 1 };
-			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_DECODE_OFFSET, offsetArr);
-			tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_DECODE_SCALE, scaleArr);
+			if (quantised)
+			{
+				//SRC decodes as (value + offset) * scale. Flat axes are all 0s, so any scale will do.
+				const auto &range = positionRanges[subMeshIdx];
+				std::vector<float> scaleArr = {
+					range.scale.x > 0 ? range.scale.x : 1,
+					range.scale.y > 0 ? range.scale.y : 1,
+					range.scale.z > 0 ? range.scale.z : 1 };
+				std::vector<float> offsetArr = { range.min.x / scaleArr[0], range.min.y / scaleArr[1], range.min.z / scaleArr[2] };
+				tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_DECODE_OFFSET, offsetArr);
+				tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_DECODE_SCALE, scaleArr);
+			}
+			else
+			{
+				std::vector<uint32_t> offsetArr = { 0, 0, 0 };
+				std::vector<uint32_t> scaleArr = { 1, 1, 1 };
+				tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_DECODE_OFFSET, offsetArr);
+				tree.addToTree(srcAccessors_AttrViews_positionAttrView + SRC_LABEL_DECODE_SCALE, scaleArr);
+			}
 
 			std::string srcBufferChunks_positionBufferChunks = SRC_LABEL_BUFFER_CHUNKS + "." + positionBufferChunk + ".";
-			size_t verticeBufferLength = vCount * sizeof(*vertices.data());
+			size_t verticeBufferLength = vCount * getPositionSize();
 
-			tree.addToTree(srcBufferChunks_positionBufferChunks + SRC_LABEL_BYTE_OFFSET, vertexWritePosition);
-			tree.addToTree(srcBufferChunks_positionBufferChunks + SRC_LABEL_BYTE_LENGTH, verticeBufferLength);
+			chunks.push_back({ srcBufferChunks_positionBufferChunks, vertexWritePosition, verticeBufferLength, getPositionSize(), false });
 
 			vertexWritePosition += verticeBufferLength;
 
@@ -519,21 +598,33 @@ bool SRCModelExport::addMeshToExport(
 			std::string srcAccessors_AttrViews_normalAttrView = srcAccessors_AttributeViews + "." + normalAttributeView + ".";
 			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_BUFFVIEW, normalBufferView);
 			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_BYTE_OFFSET, 0);
-			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_BYTE_STRIDE, 12);
-			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_COMP_TYPE, SRC_X3DOM_FLOAT);
-			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_TYPE, SRC_VECTOR_3D);
+			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_BYTE_STRIDE, getNormalSize());
+			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_COMP_TYPE, quantised ? SRC_X3DOM_SHORT : SRC_X3DOM_FLOAT);
+			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_TYPE, quantised ? SRC_VECTOR_2D : SRC_VECTOR_3D);
 			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_COUNT, vCount);
 
-			std::vector<uint32_t> offsetArr = { 0, 0, 0 };
-			std::vector<uint32_t> scaleArr = { 1, 1, 1 };
-			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_DECODE_OFFSET, offsetArr);
-			tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_DECODE_SCALE, scaleArr);
+			if (quantised)
+			{
+				//Decodes to the octahedron encoding in [-1, 1], which the client unfolds into the normal
+				const float scale = 1.0f / std::numeric_limits<int16_t>::max();
+				std::vector<float> offsetArr = { 0, 0 };
+				std::vector<float> scaleArr = { scale, scale };
+				tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_DECODE_OFFSET, offsetArr);
+				tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_DECODE_SCALE, scaleArr);
+				tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_OCT_ENCODED, "true");
+			}
+			else
+			{
+				std::vector<uint32_t> offsetArr = { 0, 0, 0 };
+				std::vector<uint32_t> scaleArr = { 1, 1, 1 };
+				tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_DECODE_OFFSET, offsetArr);
+				tree.addToTree(srcAccessors_AttrViews_normalAttrView + SRC_LABEL_DECODE_SCALE, scaleArr);
+			}
 
 			std::string srcBufferChunks_positionBufferChunks = SRC_LABEL_BUFFER_CHUNKS + "." + normalBufferChunk + ".";
-			size_t verticeBufferLength = vCount * sizeof(*normals.data());
+			size_t verticeBufferLength = vCount * getNormalSize();
 
-			tree.addToTree(srcBufferChunks_positionBufferChunks + SRC_LABEL_BYTE_OFFSET, normalWritePosition);
-			tree.addToTree(srcBufferChunks_positionBufferChunks + SRC_LABEL_BYTE_LENGTH, verticeBufferLength);
+			chunks.push_back({ srcBufferChunks_positionBufferChunks, normalWritePosition, verticeBufferLength, getNormalSize(), false });
 
 			normalWritePosition += verticeBufferLength;
 
@@ -552,14 +643,13 @@ bool SRCModelExport::addMeshToExport(
 
 			tree.addToTree(srcAccessors_indexViews + SRC_LABEL_BUFFVIEW, indexBufferView);
 			tree.addToTree(srcAccessors_indexViews + SRC_LABEL_BYTE_OFFSET, 0);
-			tree.addToTree(srcAccessors_indexViews + SRC_LABEL_COMP_TYPE, SRC_X3DOM_USHORT);
+			tree.addToTree(srcAccessors_indexViews + SRC_LABEL_COMP_TYPE, options.indexFormat == WebIndexFormat::UINT32 ? SRC_X3DOM_UINT : SRC_X3DOM_USHORT);
 			tree.addToTree(srcAccessors_indexViews + SRC_LABEL_COUNT, fCount * 3);
 
 			std::string srcBufferChunks_indexBufferChunk = SRC_LABEL_BUFFER_CHUNKS + "." + indexBufferChunk + ".";
-			size_t facesBufferLength = fCount * 3 * sizeof(*faceBuf.data()); //3 shorts for face index
+			size_t facesBufferLength = fCount * 3 * getIndexSize(); //3 indices per face
 
-			tree.addToTree(srcBufferChunks_indexBufferChunk + SRC_LABEL_BYTE_OFFSET, facesWritePosition);
-			tree.addToTree(srcBufferChunks_indexBufferChunk + SRC_LABEL_BYTE_LENGTH, facesBufferLength);
+			chunks.push_back({ srcBufferChunks_indexBufferChunk, facesWritePosition, facesBufferLength, getIndexSize(), true });
 
 			facesWritePosition += facesBufferLength;
 
@@ -591,8 +681,7 @@ bool SRCModelExport::addMeshToExport(
 			std::string srcBufferChunks_idMapBufferChunks = SRC_LABEL_BUFFER_CHUNKS + "." + idMapBufferChunk + ".";
 			size_t idMapBufferLength = idMapBuf[subMeshIdx].size() * sizeof(*idMapBuf[subMeshIdx].data());
 
-			tree.addToTree(srcBufferChunks_idMapBufferChunks + SRC_LABEL_BYTE_OFFSET, idMapWritePosition);
-			tree.addToTree(srcBufferChunks_idMapBufferChunks + SRC_LABEL_BYTE_LENGTH, idMapBufferLength);
+			chunks.push_back({ srcBufferChunks_idMapBufferChunks, idMapWritePosition, idMapBufferLength, sizeof(*idMapBuf[subMeshIdx].data()), false });
 
 			idMapWritePosition += idMapBufferLength;
 
@@ -623,8 +712,7 @@ bool SRCModelExport::addMeshToExport(
 			std::string srcBufferChunks_uvBufferChunks = SRC_LABEL_BUFFER_CHUNKS + "." + uvBufferChunk + ".";
 			size_t uvBufferLength = vCount * sizeof(*uvs.data());
 
-			tree.addToTree(srcBufferChunks_uvBufferChunks + SRC_LABEL_BYTE_OFFSET, uvWritePosition);
-			tree.addToTree(srcBufferChunks_uvBufferChunks + SRC_LABEL_BYTE_LENGTH, uvBufferLength);
+			chunks.push_back({ srcBufferChunks_uvBufferChunks, uvWritePosition, uvBufferLength, sizeof(*uvs.data()), false });
 
 			uvWritePosition += uvBufferLength;
 
@@ -649,9 +737,9 @@ bool SRCModelExport::addMeshToExport(
 		}
 	}
 
-	size_t bufferSize = vertices.size() * sizeof(*vertices.data())
-		+ normals.size() * sizeof(*normals.data())
-		+ faceBuf.size() * sizeof(*faceBuf.data())
+	size_t bufferSize = positionBuf.size()
+		+ normalBuf.size()
+		+ faceBuf.size() * getIndexSize()
 		+ idMapBufFull.size() * sizeof(*idMapBufFull.data())
 		+ uvs.size() *sizeof(*uvs.data());
 
@@ -661,20 +749,20 @@ bool SRCModelExport::addMeshToExport(
 	size_t bufferPtr = 0;
 	repoTrace << "Writing to buffer... expected Size is : " << bufferSize;
 	// Output vertices
-	if (vertices.size())
+	if (positionBuf.size())
 	{
-		size_t byteSize = vertices.size() * sizeof(*vertices.data());
-		memcpy(&dataBuffer[bufferPtr], vertices.data(), byteSize);
+		size_t byteSize = positionBuf.size();
+		memcpy(&dataBuffer[bufferPtr], positionBuf.data(), byteSize);
 		bufferPtr += byteSize;
 
 		repoTrace << "Written Vertices: byte Size " << byteSize << " bufferPtr is " << bufferPtr;
 	}
 
 	// Output normals
-	if (normals.size())
+	if (normalBuf.size())
 	{
-		size_t byteSize = normals.size() * sizeof(*normals.data());
-		memcpy(&dataBuffer[bufferPtr], normals.data(), byteSize);
+		size_t byteSize = normalBuf.size();
+		memcpy(&dataBuffer[bufferPtr], normalBuf.data(), byteSize);
 		bufferPtr += byteSize;
 		repoTrace << "Written normals: byte Size " << byteSize << " bufferPtr is " << bufferPtr;
 	}
@@ -682,8 +770,9 @@ bool SRCModelExport::addMeshToExport(
 	// Output faces
 	if (faceBuf.size())
 	{
-		size_t byteSize = faceBuf.size() * sizeof(*faceBuf.data());
-		memcpy(&dataBuffer[bufferPtr], faceBuf.data(), byteSize);
+		auto faceBytes = serialiseIndices(faceBuf);
+		size_t byteSize = faceBytes.size();
+		memcpy(&dataBuffer[bufferPtr], faceBytes.data(), byteSize);
 		bufferPtr += byteSize;
 		repoTrace << "Written faces: byte Size " << byteSize << " bufferPtr is " << bufferPtr;
 	}
@@ -703,6 +792,35 @@ bool SRCModelExport::addMeshToExport(
 		repoTrace << "Written UVs: byte Size " << byteSize << " bufferPtr is " << bufferPtr;
 	}
 
+	if (options.bufferEncoding == WebBufferEncoding::GEOMETRY_CODEC)
+	{
+		//Each chunk is encoded on its own, so the client can decode them as they are needed
+		std::vector<uint8_t> encodedBuffer;
+		for (const auto &chunk : chunks)
+		{
+			if (chunk.byteOffset + chunk.byteLength > dataBuffer.size())
+			{
+				repoError << "Buffer chunk " << chunk.label << " is out of bounds of the data buffer!";
+				return false;
+			}
+			auto encoded = encodeBufferView(dataBuffer.data() + chunk.byteOffset, chunk.byteLength,
+				chunk.byteStride, chunk.isIndices, tree, chunk.label + SRC_LABEL_CODEC);
+			tree.addToTree(chunk.label + SRC_LABEL_BYTE_OFFSET, encodedBuffer.size());
+			tree.addToTree(chunk.label + SRC_LABEL_BYTE_LENGTH, encoded.size());
+			encodedBuffer.insert(encodedBuffer.end(), encoded.begin(), encoded.end());
+		}
+		repoTrace << "Encoded buffer from " << dataBuffer.size() << " to " << encodedBuffer.size() << " bytes";
+		dataBuffer.swap(encodedBuffer);
+	}
+	else
+	{
+		for (const auto &chunk : chunks)
+		{
+			tree.addToTree(chunk.label + SRC_LABEL_BYTE_OFFSET, chunk.byteOffset);
+			tree.addToTree(chunk.label + SRC_LABEL_BYTE_LENGTH, chunk.byteLength);
+		}
+	}
+
 	std::string fname = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + meshId + fileExt;
 
 	trees[fname] = tree;
@@ -37,8 +37,14 @@ namespace repo{
 				/**
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
+				* @param sink if given, each SRC file is compressed and handed
+				*             to the sink as soon as its mesh is converted
+				* @param options formats of the exported geometry
 				*/
-				SRCModelExport(const repo::core::model::RepoScene *scene);
+				SRCModelExport(
+					const repo::core::model::RepoScene *scene,
+					AbstractWebExportSink *sink = nullptr,
+					const WebExportOptions &options = WebExportOptions());
 
 				/**
 				* Default Destructor
@@ -66,7 +72,7 @@ namespace repo{
 				bool addMeshToExport(
 					const repo::core::model::MeshNode &mesh,
 					const size_t &idx,
-					const std::vector<uint16_t> &faceBuf,
+					const std::vector<uint32_t> &faceBuf,
 					const std::vector<std::vector<float>>  &idMapBuf,
 					const std::string                      &fileExt
 					);
@@ -90,11 +96,28 @@ namespace repo{
 				*/
 				bool generateTreeRepresentation();
 
+				/**
+				* Hand all SRC and JSON files generated so far to the sink
+				* and release them from memory
+				* @return returns true upon success
+				*/
+				bool flushFilesToSink();
+
 				/**
 				* Return the SRC file as raw bytes buffer
 				* returns an empty vector if the export has failed
 				*/
 				std::unordered_map<std::string, std::vector<uint8_t>> getSRCFilesAsBuffer() const;
+
+				/**
+				* Assemble a SRC file from its header and its data buffer
+				* @param tree header of the SRC file
+				* @param dataBuffer geometry data of the SRC file
+				* @return returns the SRC file as raw bytes buffer
+				*/
+				std::vector<uint8_t> serialiseSRCFile(
+					const repo::lib::PropertyTree &tree,
+					const std::vector<uint8_t>    &dataBuffer) const;
 			};
 		} //namespace modelconvertor
 	} //namespace manipulator
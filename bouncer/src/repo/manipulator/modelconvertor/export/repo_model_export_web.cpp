@@ -24,13 +24,32 @@
 #include "../../../core/model/bson/repo_bson_factory.h"
 
 #include <boost/filesystem.hpp>
+#include <cstring>
 
 using namespace repo::manipulator::modelconvertor;
 
+static const std::string WEB_LABEL_CODEC_BYTE_LENGTH = "byteLength";
+static const std::string WEB_LABEL_CODEC_BYTE_STRIDE = "byteStride";
+static const std::string WEB_LABEL_CODEC_COUNT = "count";
+static const std::string WEB_LABEL_CODEC_MODE = "mode";
+static const std::string WEB_CODEC_MODE_ATTRIBUTES = "ATTRIBUTES";
+static const std::string WEB_CODEC_MODE_INDICES = "INDICES";
+
 WebModelExport::WebModelExport(
-	const repo::core::model::RepoScene *scene
-	) : AbstractModelExport(scene)
+	const repo::core::model::RepoScene *scene,
+	AbstractWebExportSink *sink,
+	const WebExportOptions &options
+	) : AbstractModelExport(scene),
+	sink(sink),
+	options(options),
+	reorganiserCache(repo::manipulator::modelutility::MeshReorganiserCache::getShared())
 {
+	if (!reorganiserCache)
+	{
+		localReorganiserCache.reset(new repo::manipulator::modelutility::MeshReorganiserCache());
+		reorganiserCache = localReorganiserCache.get();
+	}
+
 	//We don't cache reference scenes
 	if (convertSuccess = scene && !scene->getAllReferences(repo::core::model::RepoScene::GraphType::DEFAULT).size())
 	{
@@ -106,18 +125,151 @@ std::unordered_map<std::string, std::vector<uint8_t>> WebModelExport::getJSONFil
 
 	for (const auto &treePair : jsonTrees)
 	{
-		std::stringstream ss;
-		treePair.second.write_json(ss);
-		std::string jsonStr = ss.str();
-
-		fileBuffers[treePair.first] = std::vector<uint8_t>();
-		fileBuffers[treePair.first].resize(jsonStr.size());
-		memcpy(fileBuffers[treePair.first].data(), jsonStr.c_str(), jsonStr.size());
+		fileBuffers[treePair.first] = treeToBuffer(treePair.second);
 	}
 
 	return fileBuffers;
 }
 
+bool WebModelExport::flushJSONFilesToSink()
+{
+	bool success = true;
+	if (sink)
+	{
+		for (const auto &treePair : jsonTrees)
+		{
+			success &= sink->addJSONFile(treePair.first, treeToBuffer(treePair.second));
+		}
+		jsonTrees.clear();
+	}
+	return success;
+}
+
+std::vector<uint8_t> WebModelExport::treeToBuffer(
+	const repo::lib::PropertyTree &tree)
+{
+	std::stringstream ss;
+	tree.write_json(ss);
+	std::string jsonStr = ss.str();
+
+	return std::vector<uint8_t>(jsonStr.begin(), jsonStr.end());
+}
+
+std::vector<uint8_t> WebModelExport::serialiseIndices(
+	const std::vector<uint32_t> &indices) const
+{
+	std::vector<uint8_t> buffer(indices.size() * getIndexSize());
+	if (options.indexFormat == WebIndexFormat::UINT32)
+	{
+		if (indices.size())
+			memcpy(buffer.data(), indices.data(), buffer.size());
+	}
+	else
+	{
+		uint16_t *indices16 = (uint16_t*)buffer.data();
+		for (size_t i = 0; i < indices.size(); ++i)
+			indices16[i] = indices[i];
+	}
+
+	return buffer;
+}
+
+std::vector<uint8_t> WebModelExport::serialisePositions(
+	const std::vector<repo::lib::RepoVector3D>     &vertices,
+	const std::vector<repo_mesh_mapping_t>         &mappings,
+	std::vector<VertexQuantiser::PositionRange>    &ranges) const
+{
+	std::vector<uint8_t> buffer(vertices.size() * getPositionSize());
+	ranges.clear();
+	if (options.vertexFormat == WebVertexFormat::QUANTISED)
+	{
+		ranges.reserve(mappings.size());
+		for (const auto &mapping : mappings)
+		{
+			if (mapping.vertFrom > mapping.vertTo || mapping.vertTo > vertices.size())
+			{
+				repoError << "Sub mesh " << mapping.mesh_id << " vertex range (" << mapping.vertFrom << ", " << mapping.vertTo
+					<< ") is out of bounds (" << vertices.size() << "), its positions will not be quantised.";
+				ranges.push_back(VertexQuantiser::getPositionRange(nullptr, 0));
+				continue;
+			}
+
+			size_t count = mapping.vertTo - mapping.vertFrom;
+			const repo::lib::RepoVector3D *subMeshVertices = count ? &vertices[mapping.vertFrom] : nullptr;
+			ranges.push_back(VertexQuantiser::getPositionRange(subMeshVertices, count));
+			auto quantised = VertexQuantiser::quantisePositions(subMeshVertices, count, ranges.back());
+			if (quantised.size())
+				memcpy(&buffer[mapping.vertFrom * getPositionSize()], quantised.data(), quantised.size() * sizeof(*quantised.data()));
+		}
+	}
+	else if (vertices.size())
+	{
+		memcpy(buffer.data(), vertices.data(), buffer.size());
+	}
+
+	return buffer;
+}
+
+std::vector<uint8_t> WebModelExport::serialiseNormals(
+	const std::vector<repo::lib::RepoVector3D> &normals) const
+{
+	std::vector<uint8_t> buffer(normals.size() * getNormalSize());
+	if (options.vertexFormat == WebVertexFormat::QUANTISED)
+	{
+		auto encoded = VertexQuantiser::octEncodeNormals(normals.data(), normals.size());
+		if (encoded.size())
+			memcpy(buffer.data(), encoded.data(), buffer.size());
+	}
+	else if (normals.size())
+	{
+		memcpy(buffer.data(), normals.data(), buffer.size());
+	}
+
+	return buffer;
+}
+
+std::vector<uint8_t> WebModelExport::encodeBufferView(
+	const uint8_t           *data,
+	const size_t            &byteLength,
+	const size_t            &stride,
+	const bool              &isIndices,
+	repo::lib::PropertyTree &tree,
+	const std::string       &label) const
+{
+	const size_t count = stride ? byteLength / stride : 0;
+	std::vector<uint8_t> encoded;
+	if (isIndices)
+	{
+		//Views are not necessarily aligned within the buffer
+		std::vector<uint32_t> indices(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (stride == sizeof(uint16_t))
+			{
+				uint16_t index;
+				memcpy(&index, data + i * stride, sizeof(index));
+				indices[i] = index;
+			}
+			else
+			{
+				memcpy(&indices[i], data + i * stride, sizeof(indices[i]));
+			}
+		}
+		encoded = GeometryCodec::encodeIndices(indices.data(), indices.size());
+	}
+	else
+	{
+		encoded = GeometryCodec::encodeVertices(data, count, stride);
+	}
+
+	tree.addToTree(label + "." + WEB_LABEL_CODEC_MODE, isIndices ? WEB_CODEC_MODE_INDICES : WEB_CODEC_MODE_ATTRIBUTES);
+	tree.addToTree(label + "." + WEB_LABEL_CODEC_COUNT, count);
+	tree.addToTree(label + "." + WEB_LABEL_CODEC_BYTE_STRIDE, stride);
+	tree.addToTree(label + "." + WEB_LABEL_CODEC_BYTE_LENGTH, byteLength);
+
+	return encoded;
+}
+
 std::string WebModelExport::getSupportedFormats()
 {
 	return ".src, .gltf";
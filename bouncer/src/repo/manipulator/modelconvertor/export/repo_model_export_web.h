@@ -21,26 +21,79 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include "repo_model_export_abstract.h"
+#include "repo_model_export_sink_abstract.h"
+#include "repo_geometry_codec.h"
+#include "repo_vertex_quantiser.h"
 #include "../../../lib/repo_property_tree.h"
 #include "../../../lib/datastructure/repo_structs.h"
 #include "../../../core/model/collection/repo_scene.h"
+#include "../../modelutility/repo_mesh_reorganiser_cache.h"
 
 namespace repo{
 	namespace manipulator{
 		namespace modelconvertor{
 			enum class WebExportType { GLTF, SRC, UNITY };
 
+			/**
+			* Index format of the exported geometry. With 16 bit indices, multipart
+			* meshes are split into sub meshes of at most 65535 vertices. With 32 bit
+			* indices they are exported whole, for clients that support them.
+			*/
+			enum class WebIndexFormat { UINT16, UINT32 };
+
+			/**
+			* Vertex format of the exported geometry. QUANTISED writes positions as
+			* 16 bit integers relative to the bounding box of their sub mesh, and
+			* normals octahedron encoded into pairs of 16 bit integers, for clients
+			* that decode them.
+			*/
+			enum class WebVertexFormat { FLOAT, QUANTISED };
+
+			/**
+			* Encoding of the exported geometry buffers. With GEOMETRY_CODEC, each
+			* buffer view is compressed on its own with GeometryCodec, and annotated
+			* with what a client needs to decode it.
+			*/
+			enum class WebBufferEncoding { RAW, GEOMETRY_CODEC };
+
+			/**
+			* Levels of detail of the exported geometry. With HIERARCHICAL, coarser
+			* index buffers are generated for every sub mesh, and each partition of
+			* the spatial partitioning gets a clustered proxy mesh, for clients that
+			* pick geometry by distance.
+			*/
+			enum class WebLODMode { NONE, HIERARCHICAL };
+
+			/**
+			* Options of a web export. The defaults are what every viewer can read.
+			*/
+			struct WebExportOptions
+			{
+				WebIndexFormat indexFormat = WebIndexFormat::UINT16;
+				WebVertexFormat vertexFormat = WebVertexFormat::FLOAT;
+				WebBufferEncoding bufferEncoding = WebBufferEncoding::RAW;
+				WebLODMode lodMode = WebLODMode::NONE; //only generated by glTF exports
+			};
+
 			class WebModelExport : public AbstractModelExport
 			{
 			public:
 				/**
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
+				* @param sink if given, files are handed to the sink as they are
+				*             generated instead of being kept in memory
+				* @param options formats of the exported geometry
 				*/
-				WebModelExport(const repo::core::model::RepoScene *scene);
+				WebModelExport(
+					const repo::core::model::RepoScene *scene,
+					AbstractWebExportSink *sink = nullptr,
+					const WebExportOptions &options = WebExportOptions());
 
 				/**
 				* Default Destructor
@@ -84,7 +137,122 @@ namespace repo{
 				}
 
 			protected:
+				/**
+				* Hand all JSON files generated so far to the sink
+				* and release them from memory
+				* @return returns true upon success
+				*/
+				bool flushJSONFilesToSink();
+
+				/**
+				* Serialise a property tree into a raw bytes buffer
+				*/
+				static std::vector<uint8_t> treeToBuffer(
+					const repo::lib::PropertyTree &tree);
+
+				/**
+				* Get the maximum number of vertices of an exported sub mesh
+				* @param limit16 limit of the exporter when using 16 bit indices
+				* @return returns the limit for the configured index format
+				*/
+				size_t getVertexLimit(const size_t &limit16) const
+				{
+					return options.indexFormat == WebIndexFormat::UINT32 ? UINT32_MAX : limit16;
+				}
+
+				/**
+				* Size of an index in the exported buffers, in bytes
+				*/
+				size_t getIndexSize() const
+				{
+					return options.indexFormat == WebIndexFormat::UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+				}
+
+				/**
+				* Serialise indices into a raw bytes buffer of the configured index format
+				* @param indices indices to serialise
+				* @return returns the indices as raw bytes
+				*/
+				std::vector<uint8_t> serialiseIndices(
+					const std::vector<uint32_t> &indices) const;
+
+				/**
+				* Size of a position in the exported buffers, in bytes
+				*/
+				size_t getPositionSize() const
+				{
+					return options.vertexFormat == WebVertexFormat::QUANTISED ?
+						VertexQuantiser::POSITION_COMPONENTS * sizeof(uint16_t) : sizeof(repo::lib::RepoVector3D);
+				}
+
+				/**
+				* Size of a normal in the exported buffers, in bytes
+				*/
+				size_t getNormalSize() const
+				{
+					return options.vertexFormat == WebVertexFormat::QUANTISED ?
+						2 * sizeof(int16_t) : sizeof(repo::lib::RepoVector3D);
+				}
+
+				/**
+				* Serialise positions into a raw bytes buffer of the configured
+				* vertex format. Quantised positions are relative to the bounding
+				* box of the sub mesh they belong to.
+				* @param vertices positions to serialise
+				* @param mappings sub meshes the positions belong to
+				* @param ranges receives the range the positions of each sub mesh
+				*        were quantised against, in the order of mappings. This is
+				*        left empty if positions are not quantised.
+				* @return returns the positions as raw bytes
+				*/
+				std::vector<uint8_t> serialisePositions(
+					const std::vector<repo::lib::RepoVector3D>     &vertices,
+					const std::vector<repo_mesh_mapping_t>         &mappings,
+					std::vector<VertexQuantiser::PositionRange>    &ranges) const;
+
+				/**
+				* Serialise normals into a raw bytes buffer of the configured
+				* vertex format
+				* @param normals normals to serialise
+				* @return returns the normals as raw bytes
+				*/
+				std::vector<uint8_t> serialiseNormals(
+					const std::vector<repo::lib::RepoVector3D> &normals) const;
+
+				/**
+				* Encode a view of a geometry buffer with the geometry codec,
+				* and add how to decode it to a tree
+				* @param data start of the view in the raw buffer
+				* @param byteLength length of the view in bytes
+				* @param stride size of an element of the view, i.e. an index or
+				*        the attribute of a vertex
+				* @param isIndices whether the view holds indices or vertex attributes
+				* @param tree tree to add the decoding parameters to
+				* @param label where the decoding parameters live in the tree
+				* @return returns the encoded view
+				*/
+				std::vector<uint8_t> encodeBufferView(
+					const uint8_t           *data,
+					const size_t            &byteLength,
+					const size_t            &stride,
+					const bool              &isIndices,
+					repo::lib::PropertyTree &tree,
+					const std::string       &label) const;
+
+				/**
+				* Get the cache to reorganise meshes with. This is the shared
+				* cache if one is registered, so that exports of other formats
+				* in the same job reuse the reorganisations.
+				* @return returns the cache of mesh reorganisations
+				*/
+				repo::manipulator::modelutility::MeshReorganiserCache &getReorganiserCache()
+				{
+					return *reorganiserCache;
+				}
+
 				bool convertSuccess;
+				AbstractWebExportSink *sink;
+				const WebExportOptions options;
 				repo::core::model::RepoScene::GraphType gType;
 				std::unordered_map<std::string, repo::lib::PropertyTree> trees;
 				std::unordered_map<std::string, repo::lib::PropertyTree> jsonTrees;
@@ -92,6 +260,9 @@ namespace repo{
 			private:
 				std::string sanitizeFileName(
 					const std::string &name) const;
+
+				std::unique_ptr<repo::manipulator::modelutility::MeshReorganiserCache> localReorganiserCache;
+				repo::manipulator::modelutility::MeshReorganiserCache *reorganiserCache;
 			};
 		} //namespace modelconvertor
 	} //namespace manipulator
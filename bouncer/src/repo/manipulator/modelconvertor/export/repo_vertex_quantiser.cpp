@@ -0,0 +1,181 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_vertex_quantiser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace repo::manipulator::modelconvertor;
+
+const uint16_t VertexQuantiser::POSITION_MAX;
+const size_t VertexQuantiser::POSITION_COMPONENTS;
+
+static float signNotZero(const float &value)
+{
+	return value < 0 ? -1.0f : 1.0f;
+}
+
+/**
+* Fold the lower hemisphere of the octahedron over the upper one. This
+* is its own inverse, so it is used both to encode and to decode.
+*/
+static void octWrap(float &u, float &v)
+{
+	float uIn = u;
+	u = (1.0f - std::fabs(v)) * signNotZero(uIn);
+	v = (1.0f - std::fabs(uIn)) * signNotZero(v);
+}
+
+VertexQuantiser::PositionRange VertexQuantiser::getPositionRange(
+	const repo::lib::RepoVector3D *positions,
+	const size_t                  &count)
+{
+	PositionRange range;
+	if (count)
+	{
+		range.min = range.max = positions[0];
+		for (size_t i = 1; i < count; ++i)
+		{
+			range.min.x = std::min(range.min.x, positions[i].x);
+			range.min.y = std::min(range.min.y, positions[i].y);
+			range.min.z = std::min(range.min.z, positions[i].z);
+			range.max.x = std::max(range.max.x, positions[i].x);
+			range.max.y = std::max(range.max.y, positions[i].y);
+			range.max.z = std::max(range.max.z, positions[i].z);
+		}
+	}
+
+	range.scale.x = (range.max.x - range.min.x) / POSITION_MAX;
+	range.scale.y = (range.max.y - range.min.y) / POSITION_MAX;
+	range.scale.z = (range.max.z - range.min.z) / POSITION_MAX;
+	return range;
+}
+
+static uint16_t quantiseComponent(
+	const float &value,
+	const float &min,
+	const float &max)
+{
+	if (max <= min)
+		return 0;
+	double normalised = ((double)value - min) / ((double)max - min);
+	double quantised = std::floor(normalised * VertexQuantiser::POSITION_MAX + 0.5);
+	return (uint16_t)std::max(0.0, std::min((double)VertexQuantiser::POSITION_MAX, quantised));
+}
+
+std::vector<uint16_t> VertexQuantiser::quantisePositions(
+	const repo::lib::RepoVector3D *positions,
+	const size_t                  &count,
+	const PositionRange           &range)
+{
+	std::vector<uint16_t> quantised(count * POSITION_COMPONENTS, 0);
+	for (size_t i = 0; i < count; ++i)
+	{
+		uint16_t *q = &quantised[i * POSITION_COMPONENTS];
+		q[0] = quantiseComponent(positions[i].x, range.min.x, range.max.x);
+		q[1] = quantiseComponent(positions[i].y, range.min.y, range.max.y);
+		q[2] = quantiseComponent(positions[i].z, range.min.z, range.max.z);
+	}
+	return quantised;
+}
+
+repo::lib::RepoVector3D VertexQuantiser::dequantisePosition(
+	const uint16_t      *quantised,
+	const PositionRange &range)
+{
+	return repo::lib::RepoVector3D(
+		range.min.x + quantised[0] * range.scale.x,
+		range.min.y + quantised[1] * range.scale.y,
+		range.min.z + quantised[2] * range.scale.z);
+}
+
+template <typename T>
+void VertexQuantiser::octEncode(
+	const repo::lib::RepoVector3D &normal,
+	T                             *encoded)
+{
+	const float maxValue = std::numeric_limits<T>::max();
+	encoded[0] = encoded[1] = 0;
+
+	float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	if (l1 <= 0)
+		return;
+
+	//Project onto the octahedron, then unfold it onto the unit square
+	float u = normal.x / l1;
+	float v = normal.y / l1;
+	if (normal.z < 0)
+		octWrap(u, v);
+
+	//Rounding each component independently is not always the closest
+	//encoding once decoded, so try the four around the exact one. They are
+	//compared by distance, as dot products are all 1 in single precision.
+	repo::lib::RepoVector3D unit = normal;
+	unit.normalize();
+	const float uFloor = std::floor(u * maxValue);
+	const float vFloor = std::floor(v * maxValue);
+	float bestDistance = std::numeric_limits<float>::max();
+	for (int i = 0; i < 4; ++i)
+	{
+		T candidate[2] = {
+			(T)std::max(-maxValue, std::min(maxValue, uFloor + (i & 1))),
+			(T)std::max(-maxValue, std::min(maxValue, vFloor + (i >> 1)))
+		};
+		repo::lib::RepoVector3D decoded = octDecode(candidate);
+		repo::lib::RepoVector3D diff(decoded.x - unit.x, decoded.y - unit.y, decoded.z - unit.z);
+		float distance = diff.dotProduct(diff);
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			encoded[0] = candidate[0];
+			encoded[1] = candidate[1];
+		}
+	}
+}
+
+template <typename T>
+repo::lib::RepoVector3D VertexQuantiser::octDecode(
+	const T *encoded)
+{
+	const float maxValue = std::numeric_limits<T>::max();
+	float u = std::max(-1.0f, encoded[0] / maxValue);
+	float v = std::max(-1.0f, encoded[1] / maxValue);
+	float z = 1.0f - std::fabs(u) - std::fabs(v);
+	if (z < 0)
+		octWrap(u, v);
+
+	repo::lib::RepoVector3D normal(u, v, z);
+	normal.normalize();
+	return normal;
+}
+
+std::vector<int16_t> VertexQuantiser::octEncodeNormals(
+	const repo::lib::RepoVector3D *normals,
+	const size_t                  &count)
+{
+	std::vector<int16_t> encoded(count * 2);
+	for (size_t i = 0; i < count; ++i)
+		octEncode(normals[i], &encoded[i * 2]);
+	return encoded;
+}
+
+template void VertexQuantiser::octEncode<int8_t>(const repo::lib::RepoVector3D &, int8_t *);
+template void VertexQuantiser::octEncode<int16_t>(const repo::lib::RepoVector3D &, int16_t *);
+template repo::lib::RepoVector3D VertexQuantiser::octDecode<int8_t>(const int8_t *);
+template repo::lib::RepoVector3D VertexQuantiser::octDecode<int16_t>(const int16_t *);
@@ -0,0 +1,122 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Compact encodings of vertex attributes for the web exports. Positions are
+* quantised to 16 bit integers within the bounding box of their sub mesh,
+* and unit normals are octahedron encoded into two signed integers.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../../lib/datastructure/repo_vector.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelconvertor {
+			class VertexQuantiser
+			{
+			public:
+				/**
+				* Range quantised positions are relative to. A quantised
+				* component q decodes as min + q * scale.
+				*/
+				struct PositionRange
+				{
+					repo::lib::RepoVector3D min;
+					repo::lib::RepoVector3D max;
+					repo::lib::RepoVector3D scale;
+				};
+
+				static const uint16_t POSITION_MAX = 65535;
+
+				/**
+				* Number of components written per quantised position. Positions
+				* are padded with a fourth component so each one is 4 byte aligned.
+				*/
+				static const size_t POSITION_COMPONENTS = 4;
+
+				/**
+				* Get the range to quantise a set of positions against
+				* @param positions positions to quantise
+				* @param count number of positions
+				* @return returns the bounding box of the positions and the decode scale
+				*/
+				static PositionRange getPositionRange(
+					const repo::lib::RepoVector3D *positions,
+					const size_t                  &count);
+
+				/**
+				* Quantise positions to 16 bits per component
+				* @param positions positions to quantise
+				* @param count number of positions
+				* @param range range to quantise against, from getPositionRange()
+				* @return returns POSITION_COMPONENTS values per position
+				*/
+				static std::vector<uint16_t> quantisePositions(
+					const repo::lib::RepoVector3D *positions,
+					const size_t                  &count,
+					const PositionRange           &range);
+
+				/**
+				* Decode a position written by quantisePositions()
+				* @param quantised the quantised components of the position
+				* @param range range the position was quantised against
+				* @return returns the decoded position
+				*/
+				static repo::lib::RepoVector3D dequantisePosition(
+					const uint16_t      *quantised,
+					const PositionRange &range);
+
+				/**
+				* Octahedron encode a normal into two normalised signed
+				* integers. Of the nearest encodings, the one decoding closest
+				* to the normal is picked.
+				* @param normal normal to encode, it need not be unit length
+				* @param encoded the two encoded components, int8_t or int16_t
+				*/
+				template <typename T>
+				static void octEncode(
+					const repo::lib::RepoVector3D &normal,
+					T                             *encoded);
+
+				/**
+				* Decode a normal written by octEncode()
+				* @param encoded the two encoded components
+				* @return returns the unit length normal
+				*/
+				template <typename T>
+				static repo::lib::RepoVector3D octDecode(
+					const T *encoded);
+
+				/**
+				* Octahedron encode normals into 16 bit pairs
+				* @param normals normals to encode
+				* @param count number of normals
+				* @return returns two values per normal
+				*/
+				static std::vector<int16_t> octEncodeNormals(
+					const repo::lib::RepoVector3D *normals,
+					const size_t                  &count);
+			};
+		}
+	}
+}
@@ -21,8 +21,10 @@
 
 enum IfcSchemaVersion { IFC2x3, IFC4, UNKNOWN };
 
-static IfcSchemaVersion getIFCSchema(const std::string &file) {
-	IfcParse::IfcFile ifcFile = file;
+static IfcSchemaVersion getIFCSchema(const IfcParse::IfcFile &ifcFile) {
+	if (!ifcFile.schema()) {
+		return IfcSchemaVersion::UNKNOWN;
+	}
 	if (ifcFile.schema()->name() == "IFC2X3") {
 		return IfcSchemaVersion::IFC2x3;
 	}
@@ -31,4 +33,9 @@ static IfcSchemaVersion getIFCSchema(const std::string &file) {
 	}
 
 	return IfcSchemaVersion::UNKNOWN;
-}
\ No newline at end of file
+}
+
+static IfcSchemaVersion getIFCSchema(const std::string &file) {
+	IfcParse::IfcFile ifcFile(file);
+	return getIFCSchema(ifcFile);
+}
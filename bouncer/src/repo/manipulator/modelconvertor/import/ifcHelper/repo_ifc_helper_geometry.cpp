@@ -25,12 +25,17 @@
 #include "repo_ifc_helper_geometry.h"
 #include "../../../../core/model/bson/repo_bson_factory.h"
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include "../repo_model_import_config_default_values.h"
 
 using namespace repo::manipulator::modelconvertor::ifcHelper;
 
-IFCUtilsGeometry::IFCUtilsGeometry(const std::string &file, const modelConverter::ModelImportConfig &settings) :
-	file(file)
+IFCUtilsGeometry::IFCUtilsGeometry(
+	const std::shared_ptr<IfcParse::IfcFile> &ifcFile,
+	const modelConverter::ModelImportConfig &settings,
+	const int &nThreads) :
+	ifcFile(ifcFile),
+	nThreads(nThreads)
 {
 }
 
@@ -44,22 +49,88 @@ bool IFCUtilsGeometry::generateGeometry(
 {
 	partialFailure = false;
 
-	std::vector<std::vector<repo_face_t>> allFaces;
-	std::vector<std::vector<double>> allVertices;
-	std::vector<std::vector<double>> allNormals;
-	std::vector<std::vector<double>> allUVs;
-	std::vector<std::string> allIds, allNames, allMaterials;
+	if (!ifcFile) {
+		errMsg = "No IFC file to generate geometry from";
+		return false;
+	}
+
 	std::unordered_map<std::string, repo_material_t> matNameToMaterials;
+	std::map<std::string, std::vector<repo::lib::RepoUUID>> materialParent;
+	std::string defaultMaterialName = "_3DREPO_DEFAULT_MAT";
+	size_t nMeshes = 0;
+
+	//Geometry arrives in whichever order the threads triangulate it. Each piece
+	//is converted to single precision relative to its own minimum as soon as
+	//it arrives, so the double precision buffers for the whole file never exist
+	//at once. Once everything is triangulated, the pieces are sorted by product
+	//and moved to the world offset (the minimum over all geometry), so the
+	//output does not depend on thread scheduling.
+	struct PendingMesh
+	{
+		int productId;
+		std::string guid;
+		std::string material;
+		double origin[3];
+		std::vector<repo::lib::RepoVector3D> vertices;
+		std::vector<repo::lib::RepoVector3D> normals;
+		std::vector<repo::lib::RepoVector2D> uvs;
+		std::vector<repo_face_t> faces;
+	};
+	std::vector<PendingMesh> pending;
+	offset.clear();
+
+	auto collectMesh = [&](IfcGeometryData &data) {
+		if (data.vertices.empty())
+			return;
+
+		pending.push_back(PendingMesh());
+		auto &mesh = pending.back();
+		mesh.productId = data.productId;
+		mesh.guid = data.guid;
+		mesh.material = data.material;
+
+		for (int k = 0; k < 3; ++k)
+			mesh.origin[k] = data.vertices[k];
+		for (int j = 3; j < data.vertices.size(); j += 3)
+		{
+			for (int k = 0; k < 3; ++k)
+				mesh.origin[k] = mesh.origin[k] > data.vertices[j + k] ? data.vertices[j + k] : mesh.origin[k];
+		}
+
+		if (offset.empty())
+			offset = { mesh.origin[0], mesh.origin[1], mesh.origin[2] };
+		for (int k = 0; k < 3; ++k)
+			offset[k] = offset[k] > mesh.origin[k] ? mesh.origin[k] : offset[k];
 
-	switch (getIFCSchema(file)) {
+		const size_t nVertices = data.vertices.size() / 3;
+		mesh.vertices.reserve(nVertices);
+		if (data.normals.size())
+			mesh.normals.reserve(nVertices);
+		for (int j = 0; j < data.vertices.size(); j += 3)
+		{
+			mesh.vertices.push_back({ (float)(data.vertices[j] - mesh.origin[0]), (float)(data.vertices[j + 1] - mesh.origin[1]), (float)(data.vertices[j + 2] - mesh.origin[2]) });
+			if (data.normals.size())
+				mesh.normals.push_back({ (float)data.normals[j], (float)data.normals[j + 1], (float)data.normals[j + 2] });
+		}
+
+		mesh.uvs.reserve(data.uvs.size() / 2);
+		for (int j = 0; j < data.uvs.size(); j += 2)
+		{
+			mesh.uvs.push_back({ (float)data.uvs[j], (float)data.uvs[j + 1] });
+		}
+
+		mesh.faces = std::move(data.faces);
+	};
+
+	switch (getIFCSchema(*ifcFile)) {
 	case IfcSchemaVersion::IFC2x3:
-		if (!repo::ifcUtility::Schema_Ifc2x3::GeometryHandler::retrieveGeometry(file,
-			allVertices, allFaces, allNormals, allUVs, allIds, allNames, allMaterials, matNameToMaterials, offset, errMsg))
+		if (!repo::ifcUtility::Schema_Ifc2x3::GeometryHandler::retrieveGeometry(*ifcFile, nThreads,
+			collectMesh, matNameToMaterials, errMsg))
 			return false;
 		break;
 	case IfcSchemaVersion::IFC4:
-		if (!repo::ifcUtility::Schema_Ifc4::GeometryHandler::retrieveGeometry(file,
-			allVertices, allFaces, allNormals, allUVs, allIds, allNames, allMaterials, matNameToMaterials, offset, errMsg))
+		if (!repo::ifcUtility::Schema_Ifc4::GeometryHandler::retrieveGeometry(*ifcFile, nThreads,
+			collectMesh, matNameToMaterials, errMsg))
 			return false;
 		break;
 	default:
@@ -67,27 +138,18 @@ bool IFCUtilsGeometry::generateGeometry(
 		return false;
 	}
 
-	//now we have found all meshes, take the minimum bounding box of the scene as offset
-	//and create repo meshes
-	repoTrace << "Finished iterating. number of meshes found: " << allVertices.size();
-	repoTrace << "Finished iterating. number of materials found: " << materials.size();
+	//Pieces of one product arrive together, in a fixed order, so a stable sort is enough
+	std::stable_sort(pending.begin(), pending.end(),
+		[](const PendingMesh &a, const PendingMesh &b) { return a.productId < b.productId; });
 
-	std::map<std::string, std::vector<repo::lib::RepoUUID>> materialParent;
-	std::string defaultMaterialName = "_3DREPO_DEFAULT_MAT";
-	std::vector<repo::lib::RepoUUID> parentsOfDefault;
-	for (int i = 0; i < allVertices.size(); ++i)
+	for (auto &mesh : pending)
 	{
-		std::vector<repo::lib::RepoVector3D> vertices, normals;
-		std::vector<repo::lib::RepoVector2D> uvs;
-		std::vector<repo_face_t> faces;
+		const double shift[3] = { mesh.origin[0] - offset[0], mesh.origin[1] - offset[1], mesh.origin[2] - offset[2] };
 		std::vector<std::vector<float>> boundingBox;
-		for (int j = 0; j < allVertices[i].size(); j += 3)
+		for (size_t j = 0; j < mesh.vertices.size(); ++j)
 		{
-			vertices.push_back({ (float)(allVertices[i][j] - offset[0]), (float)(allVertices[i][j + 1] - offset[1]), (float)(allVertices[i][j + 2] - offset[2]) });
-			if (allNormals[i].size())
-				normals.push_back({ (float)allNormals[i][j], (float)allNormals[i][j + 1], (float)allNormals[i][j + 2] });
-
-			auto vertex = vertices.back();
+			auto &vertex = mesh.vertices[j];
+			vertex = { (float)(vertex.x + shift[0]), (float)(vertex.y + shift[1]), (float)(vertex.z + shift[2]) };
 			if (j == 0)
 			{
 				boundingBox.push_back({ vertex.x, vertex.y, vertex.z });
@@ -105,48 +167,32 @@ bool IFCUtilsGeometry::generateGeometry(
 			}
 		}
 
-		for (int j = 0; j < allUVs[i].size(); j += 2)
-		{
-			uvs.push_back({ (float)allUVs[i][j], (float)allUVs[i][j + 1] });
-		}
-
 		std::vector < std::vector<repo::lib::RepoVector2D>> uvChannels;
-		if (uvs.size())
-			uvChannels.push_back(uvs);
+		if (mesh.uvs.size())
+			uvChannels.push_back(std::move(mesh.uvs));
 
-		auto mesh = repo::core::model::RepoBSONFactory::makeMeshNode(vertices, allFaces[i], normals, boundingBox, uvChannels,
+		auto meshNode = repo::core::model::RepoBSONFactory::makeMeshNode(mesh.vertices, mesh.faces, mesh.normals, boundingBox, uvChannels,
 			std::vector<repo_color4d_t>(), std::vector<std::vector<float>>());
 
-		if (meshes.find(allIds[i]) == meshes.end())
-		{
-			meshes[allIds[i]] = std::vector<repo::core::model::MeshNode*>();
-		}
-		meshes[allIds[i]].push_back(new repo::core::model::MeshNode(mesh));
+		meshes[mesh.guid].push_back(new repo::core::model::MeshNode(meshNode));
+		materialParent[mesh.material.empty() ? defaultMaterialName : mesh.material].push_back(meshNode.getSharedID());
+		++nMeshes;
 
-		if (allMaterials[i] != "")
-		{
-			if (materialParent.find(allMaterials[i]) == materialParent.end())
-			{
-				materialParent[allMaterials[i]] = std::vector<repo::lib::RepoUUID>();
-			}
+		//Release the buffers as soon as the node holds them
+		mesh = PendingMesh();
+	}
+	std::vector<PendingMesh>().swap(pending);
 
-			materialParent[allMaterials[i]].push_back(mesh.getSharedID());
-		}
-		else
-		{
-			//This mesh has no material, assigning a default
-			if (matNameToMaterials.find(defaultMaterialName) == matNameToMaterials.end())
-			{
-				repo_material_t matProp;
-				matProp.diffuse = { 0.5, 0.5, 0.5, 1 };
-				matNameToMaterials[defaultMaterialName] = matProp;
-			}
-			if (materialParent.find(defaultMaterialName) == materialParent.end())
-			{
-				materialParent[defaultMaterialName] = std::vector<repo::lib::RepoUUID>();
-			}
-			materialParent[defaultMaterialName].push_back(mesh.getSharedID());
-		}
+	repoTrace << "Finished iterating. number of meshes found: " << nMeshes;
+	repoTrace << "Finished iterating. number of materials found: " << matNameToMaterials.size();
+
+	if (materialParent.find(defaultMaterialName) != materialParent.end()
+		&& matNameToMaterials.find(defaultMaterialName) == matNameToMaterials.end())
+	{
+		//Some meshes have no material, assigning a default
+		repo_material_t matProp;
+		matProp.diffuse = { 0.5, 0.5, 0.5, 1 };
+		matNameToMaterials[defaultMaterialName] = matProp;
 	}
 
 	repoTrace << "Meshes constructed. Wiring materials to parents...";
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <unordered_map>
 
 #include "../repo_model_import_config.h"
@@ -29,6 +30,10 @@
 #include "../../../../core/model/bson/repo_node_mesh.h"
 namespace modelConverter = repo::manipulator::modelconvertor;
 
+namespace IfcParse {
+	class IfcFile;
+}
+
 namespace repo {
 	namespace manipulator {
 		namespace modelconvertor {
@@ -40,9 +45,14 @@ namespace repo {
 					/**
 					* Create IFCUtilsGeometry
 					* in this object!
-					* @param file IFC file location
+					* @param ifcFile parsed IFC file, which may be shared with other readers
+					* @param settings import settings
+					* @param nThreads number of threads to triangulate the geometry with
 					*/
-					IFCUtilsGeometry(const std::string &file, const modelConverter::ModelImportConfig &settings);
+					IFCUtilsGeometry(
+						const std::shared_ptr<IfcParse::IfcFile> &ifcFile,
+						const modelConverter::ModelImportConfig &settings,
+						const int &nThreads = 1);
 
 					/**
 					* Default Deconstructor
@@ -89,7 +99,8 @@ namespace repo {
 					}
 
 				protected:
-					const std::string file;
+					const std::shared_ptr<IfcParse::IfcFile> ifcFile;
+					const int nThreads;
 					std::unordered_map<std::string, std::vector<repo::core::model::MeshNode*>> meshes;
 					std::unordered_map<std::string, repo::core::model::MaterialNode*> materials;
 					std::vector<double> offset;
@@ -16,8 +16,13 @@
 
 using namespace repo::manipulator::modelconvertor::ifcHelper;
 
-IFCUtilsParser::IFCUtilsParser(const std::string &file) :
-	file(file)
+IFCUtilsParser::IFCUtilsParser(
+	const std::shared_ptr<IfcParse::IfcFile> &ifcFile,
+	const std::string &file) :
+	ifcFile(ifcFile),
+	file(file),
+	treeParsed(false),
+	missingEntities(false)
 {
 }
 
@@ -61,32 +66,42 @@ void convertTreeToNodes(
 	}
 }
 
-repo::core::model::RepoScene* IFCUtilsParser::generateRepoScene(
-	std::string                                                                &errMsg,
-	std::unordered_map<std::string, std::vector<repo::core::model::MeshNode*>> &meshes,
-	std::unordered_map<std::string, repo::core::model::MaterialNode*>          &materials,
-	const std::vector<double>                                                  &offset
-)
+bool IFCUtilsParser::parseTree(std::string &errMsg)
 {
 	repoInfo << "IFC Parser initialised.";
 
-	//repoInfo << "Creating Transformations..." << ifcfile.schema()->name();
-
-	TransNode tree;
-	bool missingEntities = false;
+	if (!ifcFile) {
+		errMsg = "No IFC file to parse";
+		return false;
+	}
 
-	switch (getIFCSchema(file)) {
+	missingEntities = false;
+	switch (getIFCSchema(*ifcFile)) {
 	case IfcSchemaVersion::IFC2x3:
-		tree = repo::ifcUtility::Schema_Ifc2x3::TreeParser::createTransformations(file, missingEntities);
+		tree = repo::ifcUtility::Schema_Ifc2x3::TreeParser::createTransformations(*ifcFile, missingEntities);
 		break;
 	case IfcSchemaVersion::IFC4:
-		tree = repo::ifcUtility::Schema_Ifc4::TreeParser::createTransformations(file, missingEntities);
+		tree = repo::ifcUtility::Schema_Ifc4::TreeParser::createTransformations(*ifcFile, missingEntities);
 		break;
 	default:
 		errMsg = "Unsupported IFC Version";
-		return nullptr;
+		return false;
 	}
 
+	treeParsed = true;
+	return true;
+}
+
+repo::core::model::RepoScene* IFCUtilsParser::generateRepoScene(
+	std::string                                                                &errMsg,
+	std::unordered_map<std::string, std::vector<repo::core::model::MeshNode*>> &meshes,
+	std::unordered_map<std::string, repo::core::model::MaterialNode*>          &materials,
+	const std::vector<double>                                                  &offset
+)
+{
+	if (!treeParsed && !parseTree(errMsg))
+		return nullptr;
+
 	repoDebug << "Tree generated. root node is " << tree.name << " with " << tree.children.size() << " children";
 
 	repo::core::model::RepoNodeSet dummy, meshSet, matSet, metaSet, transSet;
@@ -22,12 +22,18 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <unordered_map>
 
+#include <ifcUtils/repo_ifc_utils_globals.h>
 #include "../../../../core/model/bson/repo_node_material.h"
 #include "../../../../core/model/bson/repo_node_mesh.h"
 #include "../../../../core/model/collection/repo_scene.h"
 
+namespace IfcParse {
+	class IfcFile;
+}
+
 namespace repo {
 	namespace manipulator {
 		namespace modelconvertor {
@@ -39,17 +45,31 @@ namespace repo {
 					/**
 					* Create IFCUtilsParser
 					* in this object!
+					* @param ifcFile parsed IFC file, which may be shared with other readers
 					* @param file IFC file location
 					*/
-					IFCUtilsParser(const std::string &file);
+					IFCUtilsParser(
+						const std::shared_ptr<IfcParse::IfcFile> &ifcFile,
+						const std::string &file);
 
 					/**
 					* Default Deconstructor
 					*/
 					virtual ~IFCUtilsParser();
 
+					/**
+					* Parse the transformation tree from the IFC file.
+					* IfcParse::IfcFile is not safe to use from several threads,
+					* so this must not run whilst geometry is being generated
+					* from the same file.
+					* @param errMsg error message shown should the function fail
+					* @return returns true upon success
+					*/
+					bool parseTree(std::string &errMsg);
+
 					/**
 					* Generate tree based on the file given.
+					* Parses the tree first if parseTree() has not been called.
 					* @param errMsg error message shown should the function fail
 					* @param meshes meshes generated by IFCUtilsGeometry
 					* @param materials materials generated by IFCUtilsGeometry
@@ -65,7 +85,11 @@ namespace repo {
 
 				protected:
 
+					const std::shared_ptr<IfcParse::IfcFile> ifcFile;
 					const std::string file;
+					TransNode tree;
+					bool treeParsed;
+					bool missingEntities;
 				};
 			}
 		} //namespace modelconvertor
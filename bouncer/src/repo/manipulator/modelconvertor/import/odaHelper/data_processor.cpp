@@ -64,14 +64,15 @@ void DataProcessor::getVertices(
 
 void DataProcessor::triangleOut(const OdInt32* p3Vertices, const OdGeVector3d* pNormal)
 {
-	std::vector<repo::lib::RepoVector3D64> vertices;
-	std::vector<repo::lib::RepoVector2D> uv;
+	//The buffers are reused between triangles, so no allocation happens per triangle
+	triangleVertices.clear();
+	triangleUvs.clear();
 	repo::lib::RepoVector3D64 normal;
-	
-	convertTo3DRepoTriangle(p3Vertices, vertices, normal, uv);
 
-	if (vertices.size()) {
-		collector->addFace(vertices, normal, uv);
+	convertTo3DRepoTriangle(p3Vertices, triangleVertices, normal, triangleUvs);
+
+	if (triangleVertices.size() == 3) {
+		collector->addFaces(triangleVertices.data(), 1, 3, &normal, triangleUvs.size() == 3 ? triangleUvs.data() : nullptr);
 	}
 }
 
@@ -89,15 +90,29 @@ void DataProcessor::polylineOut(OdInt32 numPoints, const OdInt32* vertexIndexLis
 
 void DataProcessor::polylineOut(OdInt32 numPoints, const OdGePoint3d* vertexList)
 {
-	std::vector<repo::lib::RepoVector3D64> vertices;
+	if (numPoints < 2)
+		return;
 
+	//Each segment is a line, added to the collector as one batch
+	lineVertices.clear();
 	for (OdInt32 i = 0; i < (numPoints - 1); i++)
 	{
-		vertices.clear();
-		vertices.push_back(convertTo3DRepoWorldCoorindates(vertexList[i]));
-		vertices.push_back(convertTo3DRepoWorldCoorindates(vertexList[i + 1]));
-		collector->addFace(vertices);
+		lineVertices.push_back(convertTo3DRepoWorldCoorindates(vertexList[i]));
+		lineVertices.push_back(convertTo3DRepoWorldCoorindates(vertexList[i + 1]));
 	}
+	collector->addFaces(lineVertices.data(), numPoints - 1, 2);
+}
+
+void DataProcessor::shellProc(OdInt32 numVertices,
+	const OdGePoint3d* vertexList,
+	OdInt32 faceListSize,
+	const OdInt32* faceList,
+	const OdGiEdgeData* pEdgeData,
+	const OdGiFaceData* pFaceData,
+	const OdGiVertexData* pVertexData)
+{
+	collector->reserveVertices(numVertices);
+	OdGiGeometrySimplifier::shellProc(numVertices, vertexList, faceListSize, faceList, pEdgeData, pFaceData, pVertexData);
 }
 
 double DataProcessor::deviation(
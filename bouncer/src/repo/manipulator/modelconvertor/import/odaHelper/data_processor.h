@@ -112,6 +112,9 @@ namespace repo {
 
 					double deviationValue = 0;
 				private:
+					std::vector<repo::lib::RepoVector3D64> triangleVertices, lineVertices;
+					std::vector<repo::lib::RepoVector2D> triangleUvs;
+
 					/**
 					* This callback is invoked when next triangle should be processed
 					* defined in OdGiGeometrySimplifier class
@@ -135,6 +138,19 @@ namespace repo {
 					void polylineOut(OdInt32 numPoints,
 						const OdGePoint3d* vertexList) final;
 
+					/**
+					* This callback is invoked for each shell before it is triangulated.
+					* Defined in OdGiGeometrySimplifier. Used to size the mesh
+					* buffers ahead of the triangles of the shell.
+					*/
+					void shellProc(OdInt32 numVertices,
+						const OdGePoint3d* vertexList,
+						OdInt32 faceListSize,
+						const OdInt32* faceList,
+						const OdGiEdgeData* pEdgeData = 0,
+						const OdGiFaceData* pFaceData = 0,
+						const OdGiVertexData* pVertexData = 0) override;
+
 					/**
 					* This callback is invoked when next material should be processed
 					* @param prevCache - previous material cache
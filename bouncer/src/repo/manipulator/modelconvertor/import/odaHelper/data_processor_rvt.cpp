@@ -217,7 +217,8 @@ void DataProcessorRvt::convertTo3DRepoTriangle(
 	repo::lib::RepoVector3D64& normalOut,
 	std::vector<repo::lib::RepoVector2D>& uvOut)
 {
-	std::vector<OdGePoint3d> odaPoints;
+	auto &odaPoints = triangleOdaPoints;
+	odaPoints.clear();
 	getVertices(3, p3Vertices, odaPoints, verticesOut);
 
 	if (verticesOut.size() != 3) {
@@ -304,7 +305,11 @@ void DataProcessorRvt::fillMeshData(const OdGiDrawable* pDrawable)
 	{
 		//some objects material is not set. set default here
 		collector->setCurrentMaterial(GetDefaultMaterial());
-		if (!collector->hasMeta(elementName)) collector->setMetadata(elementName, fillMetadata(element));
+		if (!collector->hasMeta(elementName)) {
+			std::string sharedKey;
+			auto metadata = fillMetadata(element, sharedKey);
+			collector->setMetadata(elementName, metadata, sharedKey);
+		}
 	}
 	catch (OdError& er)
 	{
@@ -327,7 +332,7 @@ void DataProcessorRvt::fillMetadataById(
 	if (ptr.isNull())
 		return;
 
-	fillMetadataByElemPtr(ptr, metadata);
+	fillMetadataByElemPtr(ptr, metadata, true);
 }
 
 void DataProcessorRvt::initLabelUtils() {
@@ -894,8 +899,8 @@ void DataProcessorRvt::processParameter(
 
 void DataProcessorRvt::fillMetadataByElemPtr(
 	OdBmElementPtr element,
-
-	std::unordered_map<std::string, std::string>& outputData)
+	std::unordered_map<std::string, std::string>& outputData,
+	const bool useCache)
 {
 	OdBmParameterSet aParams;
 	element->getListParams(aParams);
@@ -907,8 +912,9 @@ void DataProcessorRvt::fillMetadataByElemPtr(
 	OdBmAUnitsPtr pAUnits = pUnitsElem->getUnits();
 
 	auto id = std::to_string((OdUInt64)element->objectId().getHandle());
-	if (collector->metadataCache.find(id) != collector->metadataCache.end()) {
-		metadata = collector->metadataCache[id];
+	auto cached = collector->metadataCache.find(id);
+	if (cached != collector->metadataCache.end()) {
+		metadata = *cached->second;
 	}
 	else {
 		if (!labelUtils) return;
@@ -919,6 +925,11 @@ void DataProcessorRvt::fillMetadataByElemPtr(
 
 			processParameter(element, element->database()->getObjectId(entry), pAUnits, metadata, entry);
 		}
+
+		//Families, types and categories are referenced by many elements, so their built-in parameters are kept
+		if (useCache) {
+			collector->metadataCache[id] = std::make_shared<const GeometryCollector::MetadataMap>(metadata);
+		}
 	}
 
 	for (const auto &entry : aParams.getUserParamsIterator()) {
@@ -932,7 +943,7 @@ void DataProcessorRvt::fillMetadataByElemPtr(
 	}
 }
 
-std::unordered_map<std::string, std::string> DataProcessorRvt::fillMetadata(OdBmElementPtr element)
+std::unordered_map<std::string, std::string> DataProcessorRvt::fillMetadata(OdBmElementPtr element, std::string &sharedKey)
 {
 	std::unordered_map<std::string, std::string> metadata;
 	metadata[REVIT_ELEMENT_ID] = std::to_string((OdUInt64)element->objectId().getHandle());
@@ -947,34 +958,112 @@ std::unordered_map<std::string, std::string> DataProcessorRvt::fillMetadata(OdBm
 		repoTrace << "Caught exception whilst trying to fetch metadata by element pointer " << convertToStdString(er.description());
 	}
 
+	OdBmObjectId famId, typeId, catId;
 	try
 	{
-		fillMetadataById(element->getFamId(), metadata);
+		famId = element->getFamId();
 	}
 	catch (OdError& er)
 	{
-		repoTrace << "Caught exception whilst trying to get metadata by family ID: " << convertToStdString(er.description());
+		repoTrace << "Caught exception whilst trying to get family ID: " << convertToStdString(er.description());
 	}
 
 	try
 	{
-		fillMetadataById(element->getTypeID(), metadata);
+		typeId = element->getTypeID();
 	}
 	catch (OdError& er)
 	{
-		repoTrace << "Caught exception whilst trying to get metadata by Type ID: " << convertToStdString(er.description());
+		repoTrace << "Caught exception whilst trying to get Type ID: " << convertToStdString(er.description());
 	}
+
 	try
 	{
-		fillMetadataById(element->getHeaderCategoryId(), metadata);
+		catId = element->getHeaderCategoryId();
 	}
 	catch (OdError& er)
 	{
-		repoTrace << "Caught exception whilst trying to get ,etadata nu category ID: " << convertToStdString(er.description());
+		repoTrace << "Caught exception whilst trying to get category ID: " << convertToStdString(er.description());
 	}
+
+	auto idToString = [](const OdBmObjectId &id) {
+		return id.isNull() ? std::string() : std::to_string((OdUInt64)id.getHandle());
+	};
+	sharedKey = idToString(famId) + "_" + idToString(typeId) + "_" + idToString(catId);
+
+	//Family, type and category parameters are identical for all instances of a type,
+	//so they are read once and go into a metadata node shared by all of them
+	if (!collector->getSharedMetadata(sharedKey)) {
+		GeometryCollector::MetadataMap sharedMetadata;
+		try
+		{
+			fillMetadataById(famId, sharedMetadata);
+		}
+		catch (OdError& er)
+		{
+			repoTrace << "Caught exception whilst trying to get metadata by family ID: " << convertToStdString(er.description());
+		}
+
+		try
+		{
+			fillMetadataById(typeId, sharedMetadata);
+		}
+		catch (OdError& er)
+		{
+			repoTrace << "Caught exception whilst trying to get metadata by Type ID: " << convertToStdString(er.description());
+		}
+
+		try
+		{
+			fillMetadataById(catId, sharedMetadata);
+		}
+		catch (OdError& er)
+		{
+			repoTrace << "Caught exception whilst trying to get metadata by category ID: " << convertToStdString(er.description());
+		}
+
+		collector->setSharedMetadata(sharedKey, getSharedMetadataName(famId, typeId, catId), std::move(sharedMetadata));
+	}
+
 	return metadata;
 }
 
+std::string DataProcessorRvt::getSharedMetadataName(
+	const OdBmObjectId &famId,
+	const OdBmObjectId &typeId,
+	const OdBmObjectId &catId)
+{
+	auto getName = [](const OdBmObjectId &id) -> std::string {
+		std::string name;
+		if (id.isNull())
+			return name;
+		try
+		{
+			OdBmElementPtr element = id.safeOpenObject();
+			if (!element.isNull())
+				name = convertToStdString(element->getElementName());
+		}
+		catch (OdError& er)
+		{
+			repoTrace << "Caught exception whilst trying to get the name of " << (OdUInt64)id.getHandle() << ": " << convertToStdString(er.description());
+		}
+		return name;
+	};
+
+	//As Revit's "Family and Type", e.g. "Basic Wall: Generic - 200mm"
+	auto famName = getName(famId);
+	auto typeName = getName(typeId);
+	if (!famName.empty() && !typeName.empty() && famName != typeName)
+		return famName + ": " + typeName;
+	if (!typeName.empty())
+		return typeName;
+	if (!famName.empty())
+		return famName;
+
+	auto catName = getName(catId);
+	return catName.empty() ? "Type" : catName;
+}
+
 void DataProcessorRvt::fillMaterial(OdBmMaterialElemPtr materialPtr, const MaterialColours& matColors, repo_material_t& material)
 {
 	const float norm = 255.f;
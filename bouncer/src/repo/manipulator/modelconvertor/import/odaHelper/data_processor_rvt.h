@@ -113,9 +113,28 @@ namespace repo {
 
 					void fillMetadataByElemPtr(
 						OdBmElementPtr element,
-						std::unordered_map<std::string, std::string>& metadata);
-
-					std::unordered_map<std::string, std::string> fillMetadata(OdBmElementPtr element);
+						std::unordered_map<std::string, std::string>& metadata,
+						const bool useCache = false);
+
+					/**
+					* Get the metadata of an element. Family, type and category parameters
+					* are collected once per combination into shared metadata held by the
+					* collector; the returned entry only holds the element's own values.
+					* @param element element to get the metadata of
+					* @param sharedKey returns the key of the shared metadata that applies
+					*        to this element (see GeometryCollector::setMetadata)
+					* @return returns the element's own metadata
+					*/
+					std::unordered_map<std::string, std::string> fillMetadata(OdBmElementPtr element, std::string &sharedKey);
+
+					/**
+					* Get the name of the metadata node shared by the instances of a type,
+					* as the family and type names, falling back to the category name
+					*/
+					std::string getSharedMetadataName(
+						const OdBmObjectId &famId,
+						const OdBmObjectId &typeId,
+						const OdBmObjectId &catId);
 					std::string getLevel(OdBmElementPtr element, const std::string& name);
 					std::string getElementName(OdBmElementPtr element);
 
@@ -144,6 +163,7 @@ namespace repo {
 
 					OdBmDatabasePtr database;
 					OdBmSampleLabelUtilsPE* labelUtils = nullptr;
+					std::vector<OdGePoint3d> triangleOdaPoints; //reused by convertTo3DRepoTriangle
 				};
 			}
 		}
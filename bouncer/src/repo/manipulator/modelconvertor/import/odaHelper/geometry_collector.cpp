@@ -17,6 +17,8 @@
 
 #include "geometry_collector.h"
 
+#include <algorithm>
+
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
@@ -63,10 +65,12 @@ repo::core::model::TransformationNode GeometryCollector::createRootNode()
 void GeometryCollector::setCurrentMaterial(const repo_material_t &material, bool missingTexture) {
 	auto checkSum = material.checksum();
 	if (idxToMat.find(checkSum) == idxToMat.end()) {
-		idxToMat[checkSum] = {
-			repo::core::model::RepoBSONFactory::makeMaterialNode(material),
-			createTextureNode(material.texturePath)
-		};
+		idxToMat[checkSum] = repo::core::model::RepoBSONFactory::makeMaterialNode(material);
+
+		//Textures shared between materials are only read and stored once
+		TextureCache::TextureId textureId;
+		if (!material.texturePath.empty() && textureCache.addTextureFile(material.texturePath, material.texturePath, textureId))
+			idxToTexture[checkSum] = textureId;
 
 		if (missingTexture)
 			this->missingTextures = true;
@@ -79,13 +83,15 @@ repo::core::model::RepoNodeSet repo::manipulator::modelconvertor::odaHelper::Geo
 	return metaNodes;
 }
 
-mesh_data_t GeometryCollector::createMeshEntry(uint32_t format) {
+mesh_data_t GeometryCollector::createMeshEntry(uint32_t format, uint32_t faceSize) {
 	mesh_data_t entry;
-	entry.matIdx = currMat;
+	entry.matIdx = currentEntry->matIdx;
 	entry.name = nextMeshName;
-	entry.groupName = nextGroupName;
-	entry.layerName = nextLayer.empty() ? "UnknownLayer" : nextLayer;
+	entry.groupName = currentEntry->groupName;
+	entry.layerName = currentEntry->layerName;
 	entry.format = format;
+	entry.faceSize = faceSize;
+	entry.vertexMap = VertexMap(weldTolerance);
 	return entry;
 }
 
@@ -94,19 +100,25 @@ void GeometryCollector::startMeshEntry() {
 	nextGroupName = nextGroupName.empty() ? nextMeshName : nextGroupName;
 	nextLayer = nextLayer.empty() ? nextMeshName : nextLayer;
 
-	if (meshData.find(nextGroupName) == meshData.end()) {
-		meshData[nextGroupName] = std::unordered_map<std::string, std::unordered_map<int, std::vector<mesh_data_t>>>();
+	//Names cannot contain a null character, so this is unique for each group, layer and material
+	std::string key = nextGroupName;
+	key += '\0';
+	key += nextLayer;
+	key += '\0';
+	key += std::to_string(currMat);
+
+	auto it = meshBuckets.find(key);
+	if (it == meshBuckets.end()) {
+		auto &bucket = meshBuckets[key];
+		bucket.groupName = nextGroupName;
+		bucket.layerName = nextLayer;
+		bucket.matIdx = currMat;
+		currentEntry = &bucket;
 	}
-
-	if (meshData[nextGroupName].find(nextLayer) == meshData[nextGroupName].end()) {
-		meshData[nextGroupName][nextLayer] = std::unordered_map<int, std::vector<mesh_data_t>>();
+	else {
+		currentEntry = &it->second;
 	}
-
-	if (meshData[nextGroupName][nextLayer].find(currMat) == meshData[nextGroupName][nextLayer].end()) {
-		meshData[nextGroupName][nextLayer][currMat] = std::vector<mesh_data_t>();
-	}
-
-	currentEntry = &meshData[nextGroupName][nextLayer][currMat];
+	currentMesh = nullptr;
 }
 
 void  GeometryCollector::stopMeshEntry() {
@@ -119,12 +131,12 @@ uint32_t GeometryCollector::getMeshFormat(bool hasUvs, bool hasNormals, int face
 {
 	uint32_t vBit = 1;
 	uint32_t fBit = faceSize << 8;
-	uint32_t nBit = hasNormals ? 1 : 0 << 16;
-	uint32_t uBit = hasUvs ? 1 : 0 << 17;
+	uint32_t nBit = (hasNormals ? 1 : 0) << 16;
+	uint32_t uBit = (hasUvs ? 1 : 0) << 17;
 	return vBit | fBit | nBit | uBit;
 }
 
-mesh_data_t* GeometryCollector::startOrContinueMeshByFormat(uint32_t format)
+mesh_data_t* GeometryCollector::startOrContinueMeshByFormat(uint32_t format, uint32_t faceSize)
 {
 	if (!currentMesh || currentMesh->format != format)
 	{
@@ -135,28 +147,41 @@ mesh_data_t* GeometryCollector::startOrContinueMeshByFormat(uint32_t format)
 			startMeshEntry();
 		}
 
-		for (auto meshDataIterator = currentEntry->begin(); meshDataIterator != currentEntry->end(); meshDataIterator++)
+		//A group rarely has more than a couple of formats
+		for (auto mesh : currentEntry->meshes)
 		{
-			if (meshDataIterator->format == format)
+			if (mesh->format == format)
 			{
-				currentMesh = &(*meshDataIterator);
+				currentMesh = mesh;
+				break;
 			}
 		}
 
 		if (!currentMesh)
 		{
-			currentEntry->push_back(createMeshEntry(format));
-			currentMesh = &currentEntry->back();
+			meshes.push_back(createMeshEntry(format, faceSize));
+			currentMesh = &meshes.back();
+			currentEntry->meshes.push_back(currentMesh);
 		}
 	}
 
+	if (vertexReserveHint)
+	{
+		currentMesh->vertexMap.reserve(currentMesh->vertexMap.vertices.size() + vertexReserveHint);
+		//Shells are usually small, so the index buffer is still grown geometrically
+		auto nIndices = currentMesh->indices.size() + vertexReserveHint * faceSize;
+		if (nIndices > currentMesh->indices.capacity())
+			currentMesh->indices.reserve(std::max(nIndices, currentMesh->indices.capacity() * 2));
+		vertexReserveHint = 0;
+	}
+
 	return currentMesh;
 }
 
 void GeometryCollector::addFace(
 	const std::vector<repo::lib::RepoVector3D64>& vertices)
 {
-	addFace(vertices, boost::optional<const repo::lib::RepoVector3D64&>(), boost::optional<const std::vector<repo::lib::RepoVector2D>&>());
+	addFaces(vertices.data(), 1, vertices.size());
 }
 
 void GeometryCollector::addFace(
@@ -164,85 +189,94 @@ void GeometryCollector::addFace(
 	const repo::lib::RepoVector3D64& normal,
 	const std::vector<repo::lib::RepoVector2D>& uvCoords)
 {
-	addFace(vertices, boost::optional<const repo::lib::RepoVector3D64&>(normal), boost::optional<const std::vector<repo::lib::RepoVector2D>&>(uvCoords)); // make the boost option type explicit so we get the correct overload
+	if (uvCoords.size() && uvCoords.size() != vertices.size())
+	{
+		repoError << "UVs size [" << uvCoords.size() << "] does not match the vertices size [" << vertices.size() << "].";
+		errorCode = REPOERR_GEOMETRY_ERROR;
+		return;
+	}
+
+	addFaces(vertices.data(), 1, vertices.size(), &normal, uvCoords.size() ? uvCoords.data() : nullptr);
 }
 
-void GeometryCollector::addFace(
-	const std::vector<repo::lib::RepoVector3D64>& vertices,
-	boost::optional<const repo::lib::RepoVector3D64&> normal,
-	boost::optional<const std::vector<repo::lib::RepoVector2D>&> uvCoords
-)
+void GeometryCollector::addFaces(
+	const repo::lib::RepoVector3D64* vertices,
+	const size_t &nFaces,
+	const uint32_t &faceSize,
+	const repo::lib::RepoVector3D64* normals,
+	const repo::lib::RepoVector2D* uvs)
 {
-	if (!vertices.size())
+	if (!faceSize)
 	{
-		repoError << "Vertices size [" << vertices.size() << "] is unsupported. A face must have more than 0 vertices.";
+		repoError << "Vertices size [" << faceSize << "] is unsupported. A face must have more than 0 vertices.";
 		errorCode = REPOERR_GEOMETRY_ERROR;
 		return;
 	}
 
-	bool hasNormals = (bool)normal;
-	bool hasUvs = (bool)uvCoords && (*uvCoords).size();
+	if (uvs && !normals)
+	{
+		repoError << "Face has uvs but no normals. This is not supported. Faces that have uvs must also have a normal.";
+		errorCode = REPOERR_GEOMETRY_ERROR;
+		return;
+	}
 
-	auto meshData = startOrContinueMeshByFormat(getMeshFormat(hasUvs, hasNormals, vertices.size()));
+	if (!nFaces)
+	{
+		return;
+	}
 
-	repo_face_t face;
-	for (auto i = 0; i < vertices.size(); ++i) {
-		auto& v = vertices[i];
+	auto meshData = startOrContinueMeshByFormat(getMeshFormat(uvs, normals, faceSize), faceSize);
+	auto &vertexMap = meshData->vertexMap;
+	auto &indices = meshData->indices;
 
-		VertexMap::result_t vertexReference;
-		if (hasNormals)
-		{
-			if (hasUvs)
+	for (size_t f = 0; f < nFaces; ++f) {
+		for (uint32_t i = 0; i < faceSize; ++i) {
+			const auto vIdx = f * faceSize + i;
+			auto& v = vertices[vIdx];
+
+			VertexMap::result_t vertexReference;
+			if (uvs)
 			{
-				auto& uv = (*uvCoords)[i];
-				vertexReference = meshData->vertexMap.find(v, *normal, uv);
+				vertexReference = vertexMap.find(v, normals[f], uvs[vIdx]);
+			}
+			else if (normals)
+			{
+				vertexReference = vertexMap.find(v, normals[f]);
 			}
 			else
 			{
-				vertexReference = meshData->vertexMap.find(v, *normal);
+				vertexReference = vertexMap.find(v);
 			}
-		}
-		else if (hasUvs)
-		{
-			repoError << "Face has uvs but no normals. This is not supported. Faces that have uvs must also have a normal.";
-			errorCode = REPOERR_GEOMETRY_ERROR;
-			return;
-		}
-		else
-		{
-			vertexReference = meshData->vertexMap.find(v);
-		}
 
-		if (vertexReference.added)
-		{
-			if (meshData->boundingBox.size()) {
-				meshData->boundingBox[0][0] = meshData->boundingBox[0][0] > v.x ? (float)v.x : meshData->boundingBox[0][0];
-				meshData->boundingBox[0][1] = meshData->boundingBox[0][1] > v.y ? (float)v.y : meshData->boundingBox[0][1];
-				meshData->boundingBox[0][2] = meshData->boundingBox[0][2] > v.z ? (float)v.z : meshData->boundingBox[0][2];
-
-				meshData->boundingBox[1][0] = meshData->boundingBox[1][0] < v.x ? (float)v.x : meshData->boundingBox[1][0];
-				meshData->boundingBox[1][1] = meshData->boundingBox[1][1] < v.y ? (float)v.y : meshData->boundingBox[1][1];
-				meshData->boundingBox[1][2] = meshData->boundingBox[1][2] < v.z ? (float)v.z : meshData->boundingBox[1][2];
-			}
-			else {
-				meshData->boundingBox.push_back({ (float)v.x, (float)v.y, (float)v.z });
-				meshData->boundingBox.push_back({ (float)v.x, (float)v.y, (float)v.z });
-			}
+			if (vertexReference.added)
+			{
+				if (meshData->boundingBox.size()) {
+					meshData->boundingBox[0][0] = meshData->boundingBox[0][0] > v.x ? (float)v.x : meshData->boundingBox[0][0];
+					meshData->boundingBox[0][1] = meshData->boundingBox[0][1] > v.y ? (float)v.y : meshData->boundingBox[0][1];
+					meshData->boundingBox[0][2] = meshData->boundingBox[0][2] > v.z ? (float)v.z : meshData->boundingBox[0][2];
+
+					meshData->boundingBox[1][0] = meshData->boundingBox[1][0] < v.x ? (float)v.x : meshData->boundingBox[1][0];
+					meshData->boundingBox[1][1] = meshData->boundingBox[1][1] < v.y ? (float)v.y : meshData->boundingBox[1][1];
+					meshData->boundingBox[1][2] = meshData->boundingBox[1][2] < v.z ? (float)v.z : meshData->boundingBox[1][2];
+				}
+				else {
+					meshData->boundingBox.push_back({ (float)v.x, (float)v.y, (float)v.z });
+					meshData->boundingBox.push_back({ (float)v.x, (float)v.y, (float)v.z });
+				}
 
-			if (minMeshBox.size()) {
-				minMeshBox[0] = v.x < minMeshBox[0] ? v.x : minMeshBox[0];
-				minMeshBox[1] = v.y < minMeshBox[1] ? v.y : minMeshBox[1];
-				minMeshBox[2] = v.z < minMeshBox[2] ? v.z : minMeshBox[2];
-			}
-			else {
-				minMeshBox = { v.x, v.y, v.z };
+				if (minMeshBox.size()) {
+					minMeshBox[0] = v.x < minMeshBox[0] ? v.x : minMeshBox[0];
+					minMeshBox[1] = v.y < minMeshBox[1] ? v.y : minMeshBox[1];
+					minMeshBox[2] = v.z < minMeshBox[2] ? v.z : minMeshBox[2];
+				}
+				else {
+					minMeshBox = { v.x, v.y, v.z };
+				}
 			}
-		}
 
-		face.push_back(vertexReference.index);
+			indices.push_back(vertexReference.index);
+		}
 	}
-
-	meshData->faces.push_back(face);
 }
 
 repo::core::model::TransformationNode* GeometryCollector::ensureParentNodeExists(
@@ -270,110 +304,101 @@ repo::core::model::RepoNodeSet GeometryCollector::getMeshNodes(const repo::core:
 	std::unordered_map<std::string, repo::core::model::TransformationNode*> layerToTrans;
 	std::unordered_map < repo::core::model::MetadataNode*, std::vector<repo::lib::RepoUUID>>  metaNodeToParents;
 
-	int numEntries = 0;
-	for (const auto& meshGroupEntry : meshData) {
-		for (const auto& meshLayerEntry : meshGroupEntry.second) {
-			for (const auto& meshMatEntry : meshLayerEntry.second) {
-				for (const auto& meshData : meshMatEntry.second) {
-					numEntries++;
-				}
+	repoInfo << "Collecting " << meshes.size() << " mesh nodes...";
+
+	auto rootId = root.getSharedID();
+	for (const auto& meshData : meshes) {
+		if (!meshData.vertexMap.vertices.size()) {
+			continue;
+		}
+
+		if (meshData.vertexMap.uvs.size() && (meshData.vertexMap.uvs.size() != meshData.vertexMap.vertices.size()))
+		{
+			repoError << "Vertices size [" << meshData.vertexMap.vertices.size() << "] does not match the uvs size [" << meshData.vertexMap.uvs.size() << "]. Skipping...";
+			errorCode = REPOERR_GEOMETRY_ERROR;
+			continue;
+		}
+
+		auto uvChannels = meshData.vertexMap.uvs.size() ?
+			std::vector<std::vector<repo::lib::RepoVector2D>>{meshData.vertexMap.uvs} :
+			std::vector<std::vector<repo::lib::RepoVector2D>>();
+
+		ensureParentNodeExists(meshData.layerName, rootId, layerToTrans);
+
+		std::vector<repo::lib::RepoVector3D> normals32;
+
+		if (meshData.vertexMap.normals.size()) {
+			if ((meshData.vertexMap.normals.size() != meshData.vertexMap.vertices.size()))
+			{
+				repoError << "Vertices size [" << meshData.vertexMap.vertices.size() << "] does not match the Normals size [" << meshData.vertexMap.uvs.size() << "]. At this point the normals must be defined per-vertex. Skipping...";
+				errorCode = REPOERR_GEOMETRY_ERROR;
+				continue;
+			}
+
+			normals32.reserve(meshData.vertexMap.normals.size());
+
+			for (int i = 0; i < meshData.vertexMap.vertices.size(); ++i) {
+				auto& n = meshData.vertexMap.normals[i];
+				normals32.push_back({ (float)(n.x), (float)(n.y), (float)(n.z) });
 			}
 		}
-	}
 
-	repoInfo << "Collecting " << numEntries << " mesh nodes...";
+		std::vector<repo_face_t> faces;
+		faces.reserve(meshData.indices.size() / meshData.faceSize);
+		for (size_t i = 0; i < meshData.indices.size(); i += meshData.faceSize) {
+			faces.emplace_back(meshData.indices.begin() + i, meshData.indices.begin() + i + meshData.faceSize);
+		}
 
-	auto rootId = root.getSharedID();
-	for (const auto& meshGroupEntry : meshData) {
-		for (const auto& meshLayerEntry : meshGroupEntry.second) {
-			for (const auto& meshMatEntry : meshLayerEntry.second) {
-				for (const auto& meshData : meshMatEntry.second) {
-					if (!meshData.vertexMap.vertices.size()) {
-						continue;
-					}
-
-					if (meshData.vertexMap.uvs.size() && (meshData.vertexMap.uvs.size() != meshData.vertexMap.vertices.size()))
-					{
-						repoError << "Vertices size [" << meshData.vertexMap.vertices.size() << "] does not match the uvs size [" << meshData.vertexMap.uvs.size() << "]. Skipping...";
-						errorCode = REPOERR_GEOMETRY_ERROR;
-						continue;
-					}
-
-					auto uvChannels = meshData.vertexMap.uvs.size() ?
-						std::vector<std::vector<repo::lib::RepoVector2D>>{meshData.vertexMap.uvs} :
-						std::vector<std::vector<repo::lib::RepoVector2D>>();
-
-					ensureParentNodeExists(meshLayerEntry.first, rootId, layerToTrans);
-
-					std::vector<repo::lib::RepoVector3D> normals32;
-
-					if (meshData.vertexMap.normals.size()) {
-						if ((meshData.vertexMap.normals.size() != meshData.vertexMap.vertices.size()))
-						{
-							repoError << "Vertices size [" << meshData.vertexMap.vertices.size() << "] does not match the Normals size [" << meshData.vertexMap.uvs.size() << "]. At this point the normals must be defined per-vertex. Skipping...";
-							errorCode = REPOERR_GEOMETRY_ERROR;
-							continue;
-						}
-
-						normals32.reserve(meshData.vertexMap.normals.size());
-
-						for (int i = 0; i < meshData.vertexMap.vertices.size(); ++i) {
-							auto& n = meshData.vertexMap.normals[i];
-							normals32.push_back({ (float)(n.x), (float)(n.y), (float)(n.z) });
-						}
-					}
-
-					std::vector<repo::lib::RepoVector3D> vertices32;
-					vertices32.reserve(meshData.vertexMap.vertices.size());
-					bool partialObject = meshGroupEntry.first == meshLayerEntry.first;
-					auto parentId = layerToTrans[meshLayerEntry.first]->getSharedID();
-
-					for (int i = 0; i < meshData.vertexMap.vertices.size(); ++i) {
-						auto& v = meshData.vertexMap.vertices[i];
-						vertices32.push_back({ (float)(v.x - minMeshBox[0]), (float)(v.y - minMeshBox[1]), (float)(v.z - minMeshBox[2]) });
-					}
-
-					auto meshNode = repo::core::model::RepoBSONFactory::makeMeshNode(
-						vertices32,
-						meshData.faces,
-						normals32,
-						meshData.boundingBox,
-						uvChannels,
-						dummyCol,
-						dummyOutline,
-						partialObject ? "" : meshGroupEntry.first,
-						{ parentId }
-					);
-
-					if (idToMeta.find(meshGroupEntry.first) != idToMeta.end()) {
-						auto itPtr = elementToMetaNode.find(meshGroupEntry.first);
-						auto metaParent = partialObject ? parentId : meshNode.getSharedID();
-						if (itPtr == elementToMetaNode.end()) {
-							auto metaNode = createMetaNode(meshGroupEntry.first, {}, idToMeta[meshGroupEntry.first]);
-							elementToMetaNode[meshGroupEntry.first] = metaNode;
-							metaNodes.insert(metaNode);
-							metaNodeToParents[metaNode] = { metaParent };
-						}
-						else {
-							metaNodeToParents[itPtr->second].push_back(metaParent);
-						}
-					}
-
-					if (matToMeshes.find(meshData.matIdx) == matToMeshes.end()) {
-						matToMeshes[meshData.matIdx] = std::vector<repo::lib::RepoUUID>();
-					}
-					matToMeshes[meshData.matIdx].push_back(meshNode.getSharedID());
-
-					res.insert(new repo::core::model::MeshNode(meshNode));
-				}
+		std::vector<repo::lib::RepoVector3D> vertices32;
+		vertices32.reserve(meshData.vertexMap.vertices.size());
+		bool partialObject = meshData.groupName == meshData.layerName;
+		auto parentId = layerToTrans[meshData.layerName]->getSharedID();
+
+		for (int i = 0; i < meshData.vertexMap.vertices.size(); ++i) {
+			auto& v = meshData.vertexMap.vertices[i];
+			vertices32.push_back({ (float)(v.x - minMeshBox[0]), (float)(v.y - minMeshBox[1]), (float)(v.z - minMeshBox[2]) });
+		}
+
+		auto meshNode = repo::core::model::RepoBSONFactory::makeMeshNode(
+			vertices32,
+			faces,
+			normals32,
+			meshData.boundingBox,
+			uvChannels,
+			dummyCol,
+			dummyOutline,
+			partialObject ? "" : meshData.groupName,
+			{ parentId }
+		);
+
+		if (idToMeta.find(meshData.groupName) != idToMeta.end()) {
+			auto itPtr = elementToMetaNode.find(meshData.groupName);
+			auto metaParent = partialObject ? parentId : meshNode.getSharedID();
+			addSharedMetaParent(meshData.groupName, metaParent);
+			if (itPtr == elementToMetaNode.end()) {
+				auto metaNode = createMetaNode(meshData.groupName, {}, idToMeta[meshData.groupName]);
+				elementToMetaNode[meshData.groupName] = metaNode;
+				metaNodes.insert(metaNode);
+				metaNodeToParents[metaNode] = { metaParent };
+			}
+			else {
+				metaNodeToParents[itPtr->second].push_back(metaParent);
 			}
 		}
+
+		if (matToMeshes.find(meshData.matIdx) == matToMeshes.end()) {
+			matToMeshes[meshData.matIdx] = std::vector<repo::lib::RepoUUID>();
+		}
+		matToMeshes[meshData.matIdx].push_back(meshNode.getSharedID());
+
+		res.insert(new repo::core::model::MeshNode(meshNode));
 	}
 	for (auto &metaEntry : metaNodeToParents) {
 		auto metaNode = metaEntry.first;
 		auto parentSet = metaEntry.second;
 		*metaNode = metaNode->cloneAndAddParent(parentSet);
 	}
+	createSharedMetaNodes();
 
 	transNodes.insert(new repo::core::model::TransformationNode(root));
 	return res;
@@ -402,10 +427,87 @@ repo::core::model::TransformationNode*  GeometryCollector::createTransNode(
 		else {
 			*elementToMetaNode[id] = elementToMetaNode[id]->cloneAndAddParent(transNode->getSharedID());
 		}
+		addSharedMetaParent(id, transNode->getSharedID());
 	}
 	return transNode;
 }
 
+void GeometryCollector::setMetadata(
+	const std::string &groupName,
+	const std::unordered_map<std::string, std::string> &metaEntry,
+	const std::string &sharedKey)
+{
+	if (hasMeta(groupName) || metaEntry.empty())
+		return;
+
+	auto shared = getSharedMetadata(sharedKey);
+	if (!shared) {
+		idToMeta[groupName] = metaEntry;
+		return;
+	}
+
+	bool conflict = false;
+	for (const auto &entry : *shared) {
+		auto it = metaEntry.find(entry.first);
+		if (it != metaEntry.end() && it->second != entry.second) {
+			conflict = true;
+			break;
+		}
+	}
+
+	auto &metadata = idToMeta[groupName];
+	metadata = metaEntry;
+	if (conflict) {
+		//insert() keeps the group's own values
+		metadata.insert(shared->begin(), shared->end());
+	}
+	else {
+		for (const auto &entry : *shared) {
+			metadata.erase(entry.first);
+		}
+		idToSharedMeta[groupName] = sharedKey;
+	}
+}
+
+std::shared_ptr<const GeometryCollector::MetadataMap> GeometryCollector::setSharedMetadata(
+	const std::string &key,
+	const std::string &name,
+	MetadataMap &&metaEntry)
+{
+	auto &shared = sharedMeta[key];
+	if (!shared.values) {
+		shared.name = name;
+		shared.values = std::make_shared<const MetadataMap>(std::move(metaEntry));
+	}
+	return shared.values;
+}
+
+void GeometryCollector::addSharedMetaParent(
+	const std::string &groupName,
+	const repo::lib::RepoUUID &parent)
+{
+	auto keyIt = idToSharedMeta.find(groupName);
+	if (keyIt != idToSharedMeta.end()) {
+		auto it = sharedMeta.find(keyIt->second);
+		if (it != sharedMeta.end()) {
+			it->second.parents.push_back(parent);
+		}
+	}
+}
+
+void GeometryCollector::createSharedMetaNodes()
+{
+	for (auto &entry : sharedMeta) {
+		auto &shared = entry.second;
+		if (shared.parents.empty() || shared.values->empty())
+			continue;
+
+		metaNodes.insert(new repo::core::model::MetadataNode(
+			repo::core::model::RepoBSONFactory::makeMetaDataNode(*shared.values, shared.name, shared.parents)));
+		shared.parents.clear();
+	}
+}
+
 void repo::manipulator::modelconvertor::odaHelper::GeometryCollector::setRootMatrix(repo::lib::RepoMatrix matrix)
 {
 	rootMatrix = matrix;
@@ -428,47 +530,20 @@ void GeometryCollector::getMaterialAndTextureNodes(repo::core::model::RepoNodeSe
 	for (const auto &matPair : idxToMat) {
 		auto matIdx = matPair.first;
 		if (matToMeshes.find(matIdx) != matToMeshes.end()) {
-			auto& materialNode = matPair.second.first;
-			auto& textureNode = matPair.second.second;
+			auto& materialNode = matPair.second;
 
 			auto matNode = new repo::core::model::MaterialNode(materialNode.cloneAndAddParent(matToMeshes[matIdx]));
 			materials.insert(matNode);
 
-			//FIXME: Mat shared ID is known at the point of creating texture node. We shouldn't be cloning here.
-			if (!textureNode.isEmpty()) {
-				auto texNode = new repo::core::model::TextureNode(textureNode.cloneAndAddParent(matNode->getSharedID()));
-				textures.insert(texNode);
+			auto texIt = idxToTexture.find(matIdx);
+			if (texIt != idxToTexture.end()) {
+				textureCache.addParent(texIt->second, matNode->getSharedID());
 			}
 		}
 		else {
 			repoDebug << "Did not find matTo Meshes: " << matIdx;
 		}
 	}
-}
 
-repo::core::model::TextureNode GeometryCollector::createTextureNode(const std::string& texturePath)
-{
-	std::ifstream::pos_type size;
-	std::ifstream file(texturePath, std::ios::in | std::ios::binary | std::ios::ate);
-	char *memblock = nullptr;
-	if (!file.is_open())
-		return repo::core::model::TextureNode();
-
-	size = file.tellg();
-	memblock = new char[size];
-	file.seekg(0, std::ios::beg);
-	file.read(memblock, size);
-	file.close();
-
-	auto texnode = repo::core::model::RepoBSONFactory::makeTextureNode(
-		texturePath,
-		(const char*)memblock,
-		size,
-		1,
-		0
-	);
-
-	delete[] memblock;
-
-	return texnode;
+	textures = textureCache.createTextureNodes(true);
 }
\ No newline at end of file
@@ -21,12 +21,14 @@
 #include "../../../../core/model/bson/repo_bson_factory.h"
 #include "../../../../lib/datastructure/repo_structs.h"
 #include "helper_functions.h"
-#include "vertex_map.h"
+#include "../repo_texture_cache.h"
+#include "../repo_vertex_map.h"
 
+#include <deque>
 #include <fstream>
+#include <memory>
 #include <vector>
 #include <string>
-#include <boost/optional.hpp>
 
 namespace repo {
 	namespace manipulator {
@@ -45,7 +47,7 @@ namespace repo {
 				};
 
 				struct mesh_data_t {
-					std::vector<repo_face_t> faces;
+					std::vector<uint32_t> indices; //faceSize indices per face
 					std::vector<std::vector<float>> boundingBox;
 					VertexMap vertexMap;
 					std::string name;
@@ -53,6 +55,17 @@ namespace repo {
 					std::string groupName;
 					uint32_t matIdx;
 					uint32_t format;
+					uint32_t faceSize;
+				};
+
+				/**
+				* The meshes of one group, on one layer, with one material (one per format)
+				*/
+				struct mesh_bucket_t {
+					std::string groupName;
+					std::string layerName;
+					uint32_t matIdx;
+					std::vector<mesh_data_t*> meshes;
 				};
 
 				class GeometryCollector
@@ -61,7 +74,14 @@ namespace repo {
 					GeometryCollector();
 					~GeometryCollector();
 
-					std::unordered_map<std::string, std::unordered_map<std::string, std::string>> metadataCache;
+					typedef std::unordered_map<std::string, std::string> MetadataMap;
+
+					/**
+					* Metadata already read for an element, by element id. Entries are
+					* immutable and shared, so an element referenced by many others
+					* (e.g. a family or a type) is only read and held once.
+					*/
+					std::unordered_map<std::string, std::shared_ptr<const MetadataMap>> metadataCache;
 
 					/**
 					* Check whether collector has missing textures.
@@ -164,6 +184,25 @@ namespace repo {
 						nextGroupName = groupName;
 					}
 
+					/**
+					* Hint that around nVertices vertices are about to be added, so
+					* the mesh they go into reserves its buffers once. The hint is
+					* applied to the next mesh that receives a face.
+					* @param nVertices number of vertices expected
+					*/
+					void reserveVertices(const size_t &nVertices) {
+						vertexReserveHint = nVertices;
+					}
+
+					/**
+					* Set the tolerance used to weld vertices of meshes started
+					* from now on. 0 (the default) only welds identical vertices.
+					* @param tolerance grid spacing positions are quantised to
+					*/
+					void setVertexWeldTolerance(const double &tolerance) {
+						weldTolerance = tolerance;
+					}
+
 					/**
 					* Add a face to the current mesh, setting the normal for all the vertices
 					* @param vertices a vector of vertices that makes up this face
@@ -182,6 +221,23 @@ namespace repo {
 						const std::vector<repo::lib::RepoVector3D64>& vertices
 					);
 
+					/**
+					* Add a batch of faces with the same number of vertices to the current mesh.
+					* Setting faces with uvs but no normals is not supported.
+					* @param vertices nFaces * faceSize vertices, faceSize consecutive ones per face
+					* @param nFaces number of faces
+					* @param faceSize number of vertices per face (e.g. 3 for triangles, 2 for lines)
+					* @param normals nFaces normals, one for all the vertices of each face (optional)
+					* @param uvs nFaces * faceSize uvs, one per vertex (optional)
+					*/
+					void addFaces(
+						const repo::lib::RepoVector3D64* vertices,
+						const size_t &nFaces,
+						const uint32_t &faceSize,
+						const repo::lib::RepoVector3D64* normals = nullptr,
+						const repo::lib::RepoVector2D* uvs = nullptr
+					);
+
 					/**
 					* Change current material to the one provided
 					* @param material material contents.
@@ -235,62 +291,106 @@ namespace repo {
 
 					/**
 					* Set metadata of a group
+					* If the group references shared metadata, its own values take precedence:
+					* entries repeating a shared value are left to the shared node. If any of its
+					* values conflicts with a shared one, the group keeps a full copy instead
+					* (its own values over the shared ones) and does not reference the shared node.
 					* @param groupName groupName
 					* @param metaEntry Metadata entry for groupName
+					* @param sharedKey key of the shared metadata (see setSharedMetadata)
+					*        that also applies to this group, if any
 					*/
 					void setMetadata(const std::string &groupName,
-						const std::unordered_map<std::string, std::string> &metaEntry)
+						const std::unordered_map<std::string, std::string> &metaEntry,
+						const std::string &sharedKey = std::string());
+
+					/**
+					* Get metadata shared by many groups (e.g. the type parameters
+					* of all instances of a type)
+					* @param key key of the shared metadata
+					* @return returns the shared metadata, or nullptr if it has not been set
+					*/
+					std::shared_ptr<const MetadataMap> getSharedMetadata(const std::string &key) const
 					{
-						if (!hasMeta(groupName) && metaEntry.size() > 0) {
-							idToMeta[groupName] = metaEntry;
-						}
+						auto it = sharedMeta.find(key);
+						return it == sharedMeta.end() ? nullptr : it->second.values;
 					}
 
+					/**
+					* Set metadata shared by many groups. A single metadata node is
+					* created for it, parented to every group that references the key.
+					* Shared metadata that is never referenced produces no node.
+					* Groups then have two metadata nodes, their own and the shared one.
+					* The selection tree lists every metadata node of a node, and the
+					* transformation reduction moves all of them, so both stay attached.
+					* @param key key of the shared metadata
+					* @param name name of the metadata node
+					* @param metaEntry metadata values
+					* @return returns the shared metadata stored
+					*/
+					std::shared_ptr<const MetadataMap> setSharedMetadata(
+						const std::string &key,
+						const std::string &name,
+						MetadataMap &&metaEntry);
+
 				private:
 
-					std::unordered_map<std::string, std::unordered_map<std::string, std::unordered_map<int, std::vector<mesh_data_t>>>> meshData;
+					std::deque<mesh_data_t> meshes; //a deque so pointers to meshes stay valid as it grows
+					std::unordered_map<std::string, mesh_bucket_t> meshBuckets;
 					std::unordered_map<std::string, std::unordered_map<std::string, std::string> > idToMeta;
 					std::unordered_map<std::string, std::string> layerIDToName, layerIDToParent;
 					std::unordered_map<std::string, repo::core::model::MetadataNode*> elementToMetaNode;
+					struct SharedMetadata {
+						std::string name;
+						std::shared_ptr<const MetadataMap> values;
+						std::vector<repo::lib::RepoUUID> parents;
+					};
+					std::unordered_map<std::string, SharedMetadata> sharedMeta;
+					std::unordered_map<std::string, std::string> idToSharedMeta;
 					std::string nextMeshName, nextLayer, nextGroupName;
 					uint32_t nextFormat;
-					std::unordered_map< uint32_t, std::pair<repo::core::model::MaterialNode, repo::core::model::TextureNode> > idxToMat;
+					std::unordered_map< uint32_t, repo::core::model::MaterialNode > idxToMat;
+					std::unordered_map< uint32_t, TextureCache::TextureId > idxToTexture;
+					TextureCache textureCache;
 					std::unordered_map<uint32_t, std::vector<repo::lib::RepoUUID> > matToMeshes;
 					repo::core::model::RepoNodeSet transNodes, metaNodes;
 					uint32_t currMat;
+					size_t vertexReserveHint = 0;
+					double weldTolerance = 0;
 					std::vector<double> minMeshBox, origin;
 
-					std::vector<mesh_data_t>* currentEntry = nullptr;
+					mesh_bucket_t* currentEntry = nullptr;
 					mesh_data_t* currentMesh = nullptr;
 					bool missingTextures = false;
 					int errorCode = REPOERR_OK;
 					repo::lib::RepoMatrix rootMatrix;
 					std::vector<repo::manipulator::modelconvertor::odaHelper::camera_t> cameras;
 
-					/**
-					* Add a face to the current mesh. This method should only be called by one of the overloads above.
-					* Setting a face with uvs but no normals is not supported.
-					*/
-					void addFace(
-						const std::vector<repo::lib::RepoVector3D64>& vertices,
-						boost::optional<const repo::lib::RepoVector3D64&> normal,
-						boost::optional<const std::vector<repo::lib::RepoVector2D>&> uvCoords
-					);
-
 					repo::core::model::TransformationNode* createTransNode(
 						const std::string &name,
 						const std::string &id,
 						const repo::lib::RepoUUID &parentId
 					);
 
-					repo::core::model::TextureNode createTextureNode(const std::string& texturePath);
 					repo::core::model::MetadataNode*  createMetaNode(
 						const std::string &name,
 						const repo::lib::RepoUUID &parentId,
 						const  std::unordered_map<std::string, std::string> &metaValues
 					);
 
-					mesh_data_t* startOrContinueMeshByFormat(uint32_t format);
+					/**
+					* Record parent as a parent of the shared metadata of the given group, if any
+					*/
+					void addSharedMetaParent(
+						const std::string &groupName,
+						const repo::lib::RepoUUID &parent);
+
+					/**
+					* Create the metadata nodes of all shared metadata that has parents
+					*/
+					void createSharedMetaNodes();
+
+					mesh_data_t* startOrContinueMeshByFormat(uint32_t format, uint32_t faceSize);
 					uint32_t getMeshFormat(bool hasUvs, bool hasNormals, int faceSize);
 					repo::core::model::TransformationNode* ensureParentNodeExists(
 						const std::string &layerId,
@@ -298,7 +398,7 @@ namespace repo {
 						std::unordered_map<std::string, repo::core::model::TransformationNode*> &layerToTrans
 					);
 
-					mesh_data_t createMeshEntry(uint32_t format);
+					mesh_data_t createMeshEntry(uint32_t format, uint32_t faceSize);
 				};
 			}
 		}
@@ -36,10 +36,18 @@ std::istream& MetadataImportCSV::readLine(
 	tokenizedLine.clear();
 	std::string line;
 	getline(stream, line);
-	std::stringstream ss(line);
-	std::string field;
-	while (std::getline(ss, field, delimiter))
-		tokenizedLine.push_back(field);
+
+	//Split in place rather than through a stringstream. As with std::getline,
+	//a trailing empty field is dropped
+	size_t start = 0;
+	while (start < line.size())
+	{
+		size_t end = line.find(delimiter, start);
+		if (end == std::string::npos)
+			end = line.size();
+		tokenizedLine.emplace_back(line, start, end - start);
+		start = end + 1;
+	}
 
 	//FIXME: remove trailing white spaces!
 	return stream;
@@ -193,17 +193,10 @@ void RepoModelImport::parseTexture(
 
 	char* data = &dataBuffer[DataStartEnd[0]];
 
-	repo::core::model::TextureNode* textureNode =
-		new repo::core::model::TextureNode(
-			repo::core::model::RepoBSONFactory::makeTextureNode(
-				name,
-				data,
-				byteCount,
-				width,
-				height,
-				textureIdToParents[id]));
-
-	textures.insert(textureNode);
+	//Identical textures are merged into one node parented to all their materials
+	auto cacheId = textureCache.addTexture(name, data, byteCount, width, height);
+	textureCache.addParents(cacheId, textureIdToParents[id]);
+	++nTextures;
 }
 
 RepoModelImport::mesh_data_t RepoModelImport::createMeshRecord(
@@ -541,13 +534,14 @@ bool RepoModelImport::importModel(std::string filePath, uint8_t& err)
 			{
 				parseTexture(element.second, dataBuffer);
 			}
-			repoInfo << "Loaded: " << textures.size() << " textures";
+			textures = textureCache.createTextureNodes();
+			repoInfo << "Loaded: " << nTextures << " textures (" << textures.size() << " distinct)";
 			if (textureIdToParents.size() > 0)
 			{
 				int maxTextureId = textureIdToParents.rbegin()->first;
 				// Texture ids in the material JSON should map
 				// directly on to the order they appear in the texture JSON
-				if (maxTextureId > (textures.size() - 1))
+				if (maxTextureId > ((int)nTextures - 1))
 				{
 					repoError << "A material is referencing a missing texture";
 					missingTextures = true;
@@ -35,6 +35,7 @@
 #include "../../../core/model/bson/repo_node_metadata.h"
 #include "../../../core/model/bson/repo_node_transformation.h"
 #include "../../../core/model/bson/repo_node_texture.h"
+#include "repo_texture_cache.h"
 
 namespace repo {
 	namespace manipulator {
@@ -150,6 +151,8 @@ namespace repo {
 				std::vector<std::vector<repo::lib::RepoUUID>> matParents;			//!< Stores the UUIDs of all parents of a given material node in the same order matNodeList
 				std::map<int, std::vector<repo::lib::RepoUUID>> textureIdToParents; //!< Maps a texture to the UUID of all the parents that reference it 
 				std::vector<mesh_data_t> meshEntries;
+				TextureCache textureCache;											//!< De-duplicates textures by content before nodes are created
+				uint32_t nTextures = 0;												//!< Number of textures parsed, including duplicates
 
 				// Variables directly used to instantiate the RepoScene
 				repo::core::model::RepoNodeSet cameras;
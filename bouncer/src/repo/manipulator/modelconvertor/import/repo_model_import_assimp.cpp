@@ -22,14 +22,18 @@
 #include "repo_model_import_assimp.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <regex>
+#include <type_traits>
 #include <boost/filesystem.hpp>
 
 #include <assimp/importerdesc.h>
 
 #include "../../../core/model/bson/repo_bson_builder.h"
 #include "../../../core/model/bson/repo_bson_factory.h"
+#include "../../../lib/repo_task_executor.h"
 #include "../../../lib/repo_utils.h"
 #include "../../../error_codes.h"
 #include "./repo_model_import_config_default_values.h"
@@ -264,7 +268,8 @@ float AssimpModelImport::normaliseShininess(const float &rawValue) const {
 repo::core::model::MaterialNode* AssimpModelImport::createMaterialRepoNode(
 	const aiMaterial *material,
 	const std::string &name,
-	const std::unordered_map<std::string, repo::core::model::RepoNode *> &nameToTexture)
+	const std::unordered_map<std::string, TextureCache::TextureId> &nameToTexture,
+	TextureCache &textureCache)
 {
 	repo::core::model::MaterialNode *materialNode;
 
@@ -368,14 +373,11 @@ repo::core::model::MaterialNode* AssimpModelImport::createMaterialRepoNode(
 
 		if (AI_SUCCESS == material->GetTexture(aiTextureType_DIFFUSE, 0, &texPath))
 		{
-			std::unordered_map<std::string, repo::core::model::RepoNode *>::const_iterator it = nameToTexture.find(texPath.data);
+			auto it = nameToTexture.find(texPath.data);
 
 			if (nameToTexture.end() != it)
 			{
-				repo::core::model::RepoNode * nodeAddr = it->second;
-
-				repo::core::model::RepoNode tmp = nodeAddr->cloneAndAddParent(materialNode->getSharedID());
-				nodeAddr->swap(tmp);
+				textureCache.addParent(it->second, materialNode->getSharedID());
 			}
 			else
 			{
@@ -389,8 +391,6 @@ repo::core::model::MaterialNode* AssimpModelImport::createMaterialRepoNode(
 
 repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 	const aiMesh *assimpMesh,
-	const std::vector<repo::core::model::RepoNode *> &materials,
-	std::unordered_map < repo::core::model::RepoNode*, std::vector<repo::lib::RepoUUID>> &matMap,
 	const bool hasTexture,
 	const std::vector<double> &offset)
 {
@@ -413,11 +413,13 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 	repo::lib::RepoVector3D minVertex = { (float)firstV.x, (float)firstV.y, (float)firstV.z };
 	repo::lib::RepoVector3D maxVertex = minVertex;
 
-	for (uint32_t i = 0; i < assimpMesh->mNumVertices; i++)
+	const uint32_t nVertices = assimpMesh->mNumVertices;
+	vertices.resize(nVertices);
+	for (uint32_t i = 0; i < nVertices; i++)
 	{
 		auto aiVertex = assimpMesh->mVertices[i];
 		aiVertex -= offsetVec;
-		vertices.push_back({ (float)aiVertex.x, (float)aiVertex.y, (float)aiVertex.z });
+		vertices[i] = { (float)aiVertex.x, (float)aiVertex.y, (float)aiVertex.z };
 
 		minVertex.x = minVertex.x < aiVertex.x ? minVertex.x : aiVertex.x;
 		minVertex.y = minVertex.y < aiVertex.y ? minVertex.y : aiVertex.y;
@@ -437,10 +439,23 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 	*/
 	if (assimpMesh->HasFaces())
 	{
-		for (uint32_t i = 0; i < assimpMesh->mNumFaces; i++)
+		faces.resize(assimpMesh->mNumFaces);
+		if (assimpMesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE)
 		{
-			faces.push_back({ std::vector<uint32_t>(assimpMesh->mFaces[i].mIndices,
-				assimpMesh->mFaces[i].mIndices + assimpMesh->mFaces[i].mNumIndices) });
+			//Triangle only mesh (the norm after aiProcess_Triangulate), every face has 3 indices
+			for (uint32_t i = 0; i < assimpMesh->mNumFaces; i++)
+			{
+				const auto indices = assimpMesh->mFaces[i].mIndices;
+				faces[i] = { indices[0], indices[1], indices[2] };
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < assimpMesh->mNumFaces; i++)
+			{
+				faces[i].assign(assimpMesh->mFaces[i].mIndices,
+					assimpMesh->mFaces[i].mIndices + assimpMesh->mFaces[i].mNumIndices);
+			}
 		}
 	}
 	/*
@@ -452,9 +467,18 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 	*/
 	if (assimpMesh->HasNormals())
 	{
-		for (uint32_t i = 0; i < assimpMesh->mNumVertices; i++)
+		normals.resize(nVertices);
+		if (std::is_same<ai_real, float>::value && sizeof(aiVector3D) == sizeof(repo::lib::RepoVector3D))
+		{
+			//Same memory layout, copy the whole buffer over
+			memcpy(normals.data(), assimpMesh->mNormals, nVertices * sizeof(aiVector3D));
+		}
+		else
 		{
-			normals.push_back({ (float)assimpMesh->mNormals[i].x, (float)assimpMesh->mNormals[i].y, (float)assimpMesh->mNormals[i].z });
+			for (uint32_t i = 0; i < nVertices; i++)
+			{
+				normals[i] = { (float)assimpMesh->mNormals[i].x, (float)assimpMesh->mNormals[i].y, (float)assimpMesh->mNormals[i].z };
+			}
 		}
 	}
 	/*
@@ -489,17 +513,18 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 	// TODO: add support for all UV channels.
 	if (assimpMesh->HasTextureCoords(0))
 	{
-		std::vector<repo::lib::RepoVector2D> channelVector;
-		for (uint32_t i = 0; i < assimpMesh->mNumVertices; i++)
+		std::vector<repo::lib::RepoVector2D> channelVector(nVertices);
+		for (uint32_t i = 0; i < nVertices; i++)
 		{
-			channelVector.push_back({ (float)assimpMesh->mTextureCoords[0][i].x, (float)assimpMesh->mTextureCoords[0][i].y });
+			channelVector[i] = { (float)assimpMesh->mTextureCoords[0][i].x, (float)assimpMesh->mTextureCoords[0][i].y };
 		}
-		uvChannels.push_back(channelVector);
+		uvChannels.push_back(std::move(channelVector));
 	}
 	else if (hasTexture)
 	{
 		//Has texture but no UV coordinates, attempt to fabricate some
 		std::vector<repo::lib::RepoVector2D> channelVector;
+		channelVector.reserve(nVertices);
 
 		repo::lib::RepoVector3D bboxSize = { fabsf(maxVertex.x - minVertex.x), fabsf(maxVertex.y - minVertex.y), fabsf(maxVertex.z - minVertex.z) };
 
@@ -508,19 +533,20 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 			repo::lib::RepoVector3D dVector = { fabsf(v.x - minVertex.x), fabsf(v.y - minVertex.y), fabsf(v.z - minVertex.z) };
 			channelVector.push_back({ dVector.x / bboxSize.x, dVector.y / bboxSize.y });
 		}
-		uvChannels.push_back(channelVector);
+		uvChannels.push_back(std::move(channelVector));
 	}
 
 	// Consider only first color set
 	if (assimpMesh->HasVertexColors(0))
 	{
-		for (uint32_t i = 0; i < assimpMesh->mNumVertices; i++)
+		colors.resize(nVertices);
+		for (uint32_t i = 0; i < nVertices; i++)
 		{
-			colors.push_back({
+			colors[i] = {
 				(float)assimpMesh->mColors[0][i].r,
 				(float)assimpMesh->mColors[0][i].g,
 				(float)assimpMesh->mColors[0][i].b,
-				(float)assimpMesh->mColors[0][i].a });
+				(float)assimpMesh->mColors[0][i].a };
 		}
 	}
 	/*
@@ -559,21 +585,31 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 	meshNode = repo::core::model::MeshNode(repo::core::model::RepoBSONFactory::makeMeshNode(
 		vertices, faces, normals, boundingBox, uvChannels, colors, outline));
 
-	///*
-	//*------------------------------ setParents ----------------------------------
-	//*/
-
-	if (assimpMesh->mMaterialIndex < materials.size())
-	{
-		repo::core::model::RepoNode *materialNode = materials[assimpMesh->mMaterialIndex];
-		matMap[materialNode].push_back(meshNode.getSharedID());
-	}
+	return meshNode;
+}
 
-	///*
-	//*-----------------------------------------------------------------------------
-	//*/
+std::vector<repo::core::model::MeshNode> AssimpModelImport::createMeshRepoNodes(
+	const std::vector<double> &offset)
+{
+	const uint32_t nMeshes = assimpScene->mNumMeshes;
+	std::vector<repo::core::model::MeshNode> meshNodes(nMeshes);
+
+	//Meshes are independent of each other: each result is written into its own
+	//slot so the order matches the assimp indices
+	std::atomic<uint32_t> nConverted(0);
+	repo::lib::RepoTaskExecutor::getDefault().parallelFor(nMeshes, [&](size_t i) {
+		const aiMesh *assimpMesh = assimpScene->mMeshes[i];
+		int numTextures = assimpScene->mMaterials[assimpMesh->mMaterialIndex]->GetTextureCount(aiTextureType_DIFFUSE);
+		meshNodes[i] = createMeshRepoNode(assimpMesh, numTextures > 0, offset);
+
+		uint32_t count = ++nConverted;
+		if (count % 500 == 0 || count == nMeshes)
+		{
+			repoInfo << "Constructed " << count << " of " << nMeshes;
+		}
+	});
 
-	return meshNode;
+	return meshNodes;
 }
 
 repo::core::model::MetadataNode* AssimpModelImport::createMetadataRepoNode(
@@ -777,7 +813,8 @@ repo::core::model::RepoScene* AssimpModelImport::convertAiSceneToRepoScene()
 		std::unordered_map<repo::lib::RepoUUID, repo::core::model::RepoNode*, repo::lib::RepoUUIDHasher> meshToMat;
 		std::vector<repo::core::model::RepoNode> originalOrderMesh; //vector that keeps track original order for assimp indices
 		std::unordered_map<std::string, repo::core::model::RepoNode *> camerasMap;
-		std::unordered_map<std::string, repo::core::model::RepoNode *> nameToTexture;
+		std::unordered_map<std::string, TextureCache::TextureId> nameToTexture;
+		TextureCache textureCache;
 
 		std::vector<std::vector<double>> sceneBbox = getSceneBoundingBox();
 		//-------------------------------------------------------------------------
@@ -801,67 +838,44 @@ repo::core::model::RepoScene* AssimpModelImport::convertAiSceneToRepoScene()
 					std::string texName(path.data);
 					repoTrace << "texture name: " << texName;
 
-					if (!texName.empty())
+					if (nameToTexture.find(texName) != nameToTexture.end())
+					{
+						repoTrace << "Texture already loaded: " << texName;
+					}
+					else if (!texName.empty())
 					{
-						repo::core::model::RepoNode *textureNode = nullptr;
-
 						const aiTexture* texture = nullptr;
 						if (texture = assimpScene->GetEmbeddedTexture(texName.c_str()))
 						{
 							repoTrace << "Embedded texture name: " << texName;
 							//---------------------------------------------------------
 							// Embedded texture
-							char *memblock = (char*)malloc(texture->mWidth);
-							memcpy(memblock, texture->pcData, texture->mWidth);
-
 							auto size = texture->mWidth * (texture->mHeight == 0 ? 1 : texture->mHeight);
-							textureNode = new repo::core::model::TextureNode(repo::core::model::RepoBSONFactory::makeTextureNode(
+							nameToTexture[texName] = textureCache.addTexture(
 								texName,
 								(char*)texture->pcData,
 								size,
 								texture->mWidth,
-								texture->mHeight));
-
-							free(memblock);
+								texture->mHeight);
+							repoTrace << "Added texture :" << texName;
 						}
 						else
 						{
 							repoTrace << "External texture name: " << texName;
 							//External texture
-							std::ifstream::pos_type size;
 							std::string dirPath = getDirPath(orgFile);
 							boost::filesystem::path filePath = boost::filesystem::absolute(texName, dirPath);
-							std::ifstream file(filePath.string(), std::ios::in | std::ios::binary | std::ios::ate);
-							char *memblock = nullptr;
-							if (!file.is_open())
+							TextureCache::TextureId textureId;
+							if (textureCache.addTextureFile(texName, filePath.string(), textureId))
 							{
-								repoError << "Could not open texture: " << filePath << std::endl;
-								missingTextures = true;
+								nameToTexture[texName] = textureId;
+								repoTrace << "Added texture :" << texName;
 							}
 							else
 							{
-								size = file.tellg();
-								memblock = new char[size];
-								file.seekg(0, std::ios::beg);
-								file.read(memblock, size);
-								file.close();
+								repoError << "Could not open texture: " << filePath << std::endl;
+								missingTextures = true;
 							}
-
-							textureNode = new repo::core::model::TextureNode(repo::core::model::RepoBSONFactory::makeTextureNode(
-								texName,
-								memblock,
-								size,
-								size,
-								0));
-
-							if (memblock)delete[] memblock;
-						}
-
-						if (textureNode)
-						{
-							textures.insert(textureNode);
-							nameToTexture[texName] = textureNode;
-							repoTrace << "Added texture :" << texName;
 						}
 					}
 					else
@@ -894,7 +908,7 @@ repo::core::model::RepoScene* AssimpModelImport::convertAiSceneToRepoScene()
 
 				repo::core::model::RepoNode* material = createMaterialRepoNode(
 					assimpScene->mMaterials[i],
-					name.data, nameToTexture);
+					name.data, nameToTexture, textureCache);
 
 				if (!material)
 					repoError << "Unable to construct material node in Assimp Model Convertor!";
@@ -911,6 +925,9 @@ repo::core::model::RepoScene* AssimpModelImport::convertAiSceneToRepoScene()
 			}
 		}
 
+		//Every material using a texture is registered with the cache by now
+		textures = textureCache.createTextureNodes();
+
 		/*
 		* ---------------------------------------------
 		*/
@@ -929,24 +946,20 @@ repo::core::model::RepoScene* AssimpModelImport::convertAiSceneToRepoScene()
 		*/
 		if (assimpScene->HasMeshes())
 		{
-			for (unsigned int i = 0; i < assimpScene->mNumMeshes; ++i)
+			auto meshNodes = createMeshRepoNodes(sceneBbox[0]);
+			originalOrderMesh.reserve(meshNodes.size());
+			for (unsigned int i = 0; i < meshNodes.size(); ++i)
 			{
-				if (i % 500 == 0 || i == assimpScene->mNumMeshes - 1)
-				{
-					repoInfo << "Constructing " << i << " of " << assimpScene->mNumMeshes;
-				}
-
-				int numTextures = assimpScene->mMaterials[assimpScene->mMeshes[i]->mMaterialIndex]->GetTextureCount(aiTextureType_DIFFUSE);
-				repo::core::model::RepoNode mesh = createMeshRepoNode(
-					assimpScene->mMeshes[i],
-					originalOrderMaterial,
-					matParents, numTextures > 0,
-					sceneBbox.size() ? sceneBbox[0] : std::vector<double>());
-
+				auto &mesh = meshNodes[i];
 				if (mesh.isEmpty())
 					repoError << "Unable to construct mesh node in Assimp Model Convertor!";
 				else
 				{
+					const auto materialIndex = assimpScene->mMeshes[i]->mMaterialIndex;
+					if (materialIndex < originalOrderMaterial.size())
+					{
+						matParents[originalOrderMaterial[materialIndex]].push_back(mesh.getSharedID());
+					}
 					originalOrderMesh.push_back(mesh);
 				}
 			}
@@ -32,6 +32,7 @@
 #include <boost/bimap.hpp>
 
 #include "repo_model_import_abstract.h"
+#include "repo_texture_cache.h"
 #include "../../../core/model/collection/repo_scene.h"
 #include "../../../core/model/bson/repo_node_camera.h"
 #include "../../../core/model/bson/repo_node_material.h"
@@ -101,28 +102,41 @@ namespace repo {
 				* NOTE: textures must've been populated at this point to populate references
 				* @param material assimp material object
 				* @param name name of the material
-				* @param nameToTexture a mapping of texture name to texture node
+				* @param nameToTexture a mapping of texture name to texture within the texture cache
+				* @param textureCache texture cache the material is added to as a parent of its texture
 				* @return returns the created material node
 				*/
 				repo::core::model::MaterialNode* createMaterialRepoNode(
 					const aiMaterial *material,
 					const std::string &name,
-					const std::unordered_map<std::string, repo::core::model::RepoNode *> &nameToTexture);
+					const std::unordered_map<std::string, TextureCache::TextureId> &nameToTexture,
+					TextureCache &textureCache);
 
 				/**
 				* Create a Mesh Node given the information in ASSIMP objects
-				* NOTE: materials must've been populated at this point to populate references
+				* This does not touch any shared state, so it is safe to call
+				* from multiple threads at once.
 				* @param assimpMesh assimp mesh object
-				* @param materials RepoNodeSet of material objects (to add reference)
+				* @param hasTexture whether the mesh's material has a texture
+				* @param offset offset to subtract from the vertices
 				* @return returns the created Mesh Node
 				*/
 				repo::core::model::MeshNode createMeshRepoNode(
 					const aiMesh *assimpMesh,
-					const std::vector<repo::core::model::RepoNode *> &materials,
-					std::unordered_map < repo::core::model::RepoNode*, std::vector<repo::lib::RepoUUID>> &matMap,
 					const bool hasTexture,
 					const std::vector<double> &offset);
 
+				/**
+				* Create Mesh Nodes for all meshes within the assimp scene
+				* Meshes are converted concurrently, the result is in the
+				* same order as the assimp meshes. The first exception thrown
+				* by a worker is rethrown once all of them have finished.
+				* @param offset offset to subtract from the vertices
+				* @return returns a mesh node per assimp mesh
+				*/
+				std::vector<repo::core::model::MeshNode> createMeshRepoNodes(
+					const std::vector<double> &offset);
+
 				/**
 				* Create a Metadata Node given the information in ASSIMP objects
 				* @param assimpMeta assimp metadata object
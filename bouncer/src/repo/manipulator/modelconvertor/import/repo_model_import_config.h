@@ -31,27 +31,49 @@
 namespace repo {
 	namespace manipulator {
 		namespace modelconvertor {
+			/**
+			* Encoding of the per frame states of a sequence
+			* JSON - human readable JSON
+			* BINARY - packed binary, with shared ids in a table (see SequenceFrameState)
+			* BINARY_COMPRESSED - as BINARY, with the payload zlib compressed
+			*/
+			enum class SequenceStateFormat { JSON, BINARY, BINARY_COMPRESSED };
+
 			class REPO_API_EXPORT ModelImportConfig
 			{
 			private:
 				bool applyReductions;
 				bool rotateModel;
 				bool importAnimations;
+				uint32_t sequenceKeyFrameInterval;
+				SequenceStateFormat sequenceStateFormat;
 			public:
+				/**
+				* @param sequenceKeyFrameInterval number of frames between full sequence states,
+				*        frames in between only store what changed. 0 or 1 (the default) stores every
+				*        frame in full, as readers that do not reconstruct deltas expect
+				* @param sequenceStateFormat encoding of the sequence frame states
+				*/
 				ModelImportConfig(
 					const bool applyReductions = true,
 					const bool rotateModel = false,
-					const bool importAnimations = true
+					const bool importAnimations = true,
+					const uint32_t sequenceKeyFrameInterval = 0,
+					const SequenceStateFormat sequenceStateFormat = SequenceStateFormat::JSON
 				) {
 					this->applyReductions = applyReductions;
 					this->rotateModel = rotateModel;
 					this->importAnimations = importAnimations;
+					this->sequenceKeyFrameInterval = sequenceKeyFrameInterval;
+					this->sequenceStateFormat = sequenceStateFormat;
 				}
 				~ModelImportConfig() {}
 
 				bool shouldApplyReductions() const { return applyReductions; }
 				bool shouldRotateModel() const { return rotateModel; }
 				bool shouldImportAnimations() const { return importAnimations; }
+				uint32_t getSequenceKeyFrameInterval() const { return sequenceKeyFrameInterval; }
+				SequenceStateFormat getSequenceStateFormat() const { return sequenceStateFormat; }
 			};
 		}//namespace modelconvertor
 	}//namespace manipulator
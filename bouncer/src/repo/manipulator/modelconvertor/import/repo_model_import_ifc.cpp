@@ -24,7 +24,9 @@
 #include "ifcHelper/repo_ifc_helper_parser.h"
 #include "../../../core/model/bson/repo_bson_factory.h"
 #include "../../../error_codes.h"
+#include "../../../lib/repo_task_executor.h"
 #include <boost/filesystem.hpp>
+#include <ifcparse/IfcFile.h>
 
 using namespace repo::manipulator::modelconvertor;
 
@@ -40,9 +42,10 @@ IFCModelImport::~IFCModelImport()
 
 repo::core::model::RepoScene* IFCModelImport::generateRepoScene(uint8_t &errCode)
 {
-	ifcHelper::IFCUtilsParser parserUtil(ifcFile);
+	if (!parser)
+		parser = std::make_shared<ifcHelper::IFCUtilsParser>(std::make_shared<IfcParse::IfcFile>(ifcFile), ifcFile);
 	std::string errMsg;
-	auto scene = parserUtil.generateRepoScene(errMsg, meshes, materials, offset);
+	auto scene = parser->generateRepoScene(errMsg, meshes, materials, offset);
 	if (!scene) {
 		repoError << "Failed to generate Repo Scene: " << errMsg;
 		errCode = REPOERR_LOAD_SCENE_FAIL;
@@ -61,8 +64,20 @@ bool IFCModelImport::importModel(std::string filePath, uint8_t &err)
 
 	bool success = false;
 	std::string errMsg;
-	ifcHelper::IFCUtilsGeometry geoUtil(filePath, settings);
-	if (success = geoUtil.generateGeometry(errMsg, partialFailure))
+
+	//Parse the file once, and share it between the geometry and the tree.
+	//IfcParse::IfcFile makes no guarantee of being safe to use from several
+	//threads: entities are resolved and cached lazily as they are looked up.
+	//The geometry iterator's own worker threads are the only concurrent users
+	//of the file, so the tree is parsed from it afterwards, in generateRepoScene().
+	auto ifcData = std::make_shared<IfcParse::IfcFile>(filePath);
+	parser = std::make_shared<ifcHelper::IFCUtilsParser>(ifcData, filePath);
+
+	//Geometry is triangulated on as many threads as the shared executor has
+	ifcHelper::IFCUtilsGeometry geoUtil(ifcData, settings, repo::lib::RepoTaskExecutor::getDefault().getNumThreads());
+	success = geoUtil.generateGeometry(errMsg, partialFailure);
+
+	if (success)
 	{
 		//generate tree;
 		repoInfo << "Geometry generated successfully";
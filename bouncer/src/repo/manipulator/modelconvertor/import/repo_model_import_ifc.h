@@ -22,7 +22,9 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include "repo_model_import_abstract.h"
+#include "ifcHelper/repo_ifc_helper_parser.h"
 #include "../../../core/model/bson/repo_node_material.h"
 #include "../../../core/model/bson/repo_node_mesh.h"
 
@@ -74,6 +76,7 @@ namespace repo {
 				std::unordered_map<std::string, repo::core::model::MaterialNode*> materials;
 				std::vector<double> offset;
 				std::string ifcFile;
+				std::shared_ptr<ifcHelper::IFCUtilsParser> parser;
 				bool partialFailure;
 			};
 		} //namespace modelconvertor
@@ -16,6 +16,7 @@
 */
 
 #include "repo_model_import_manager.h"
+#include "../../../lib/repo_profiler.h"
 #include "../../../lib/repo_utils.h"
 #include "../../../error_codes.h"
 #include "repo_model_import_assimp.h"
@@ -23,6 +24,9 @@
 #include "repo_model_import_3drepo.h"
 #include "repo_model_import_oda.h"
 #include "repo_model_import_synchro.h"
+#ifdef REPO_BUILD_BENCHMARKS
+#include "repo_model_import_synthetic.h"
+#endif
 #include "../../modeloptimizer/repo_optimizer_trans_reduction.h"
 #include <boost/filesystem.hpp>
 
@@ -33,6 +37,7 @@ repo::core::model::RepoScene* ModelImportManager::ImportFromFile(
 	const repo::manipulator::modelconvertor::ModelImportConfig &config,
 	uint8_t &error
 ) const {
+	REPO_PROFILE_SCOPE("ImportFromFile");
 	if (!repo::lib::doesFileExist(file)) {
 		error = REPOERR_MODEL_FILE_READ;
 		repoError << "Cannot find file: " << file;
@@ -47,10 +52,18 @@ repo::core::model::RepoScene* ModelImportManager::ImportFromFile(
 
 	repo::core::model::RepoScene* scene = nullptr;
 	repoTrace << "Importing model...";
-	if (modelConvertor->importModel(file, error)) {
+	bool imported;
+	{
+		REPO_PROFILE_SCOPE("importModel");
+		imported = modelConvertor->importModel(file, error);
+	}
+	if (imported) {
 		repoTrace << "model Imported, generating Repo Scene";
 		uint8_t errCode = REPOERR_LOAD_SCENE_FAIL;
-		scene = modelConvertor->generateRepoScene(errCode);
+		{
+			REPO_PROFILE_SCOPE("generateRepoScene");
+			scene = modelConvertor->generateRepoScene(errCode);
+		}
 
 		if (!scene) {
 			error = errCode;
@@ -69,11 +82,13 @@ repo::core::model::RepoScene* ModelImportManager::ImportFromFile(
 			else {
 				if (config.shouldRotateModel() || modelConvertor->requireReorientation()) {
 					repoTrace << "rotating model by 270 degress on the x axis...";
+					REPO_PROFILE_SCOPE("reorientateDirectXModel");
 					scene->reorientateDirectXModel();
 				}
 
 				if (config.shouldApplyReductions() && modelConvertor->applyReduction()) {
 					repoTrace << "Applying transformation reduction optimizer";
+					REPO_PROFILE_SCOPE("TransformationReductionOptimizer::apply");
 					repo::manipulator::modeloptimizer::TransformationReductionOptimizer optimizer;
 					optimizer.apply(scene);
 				}
@@ -105,6 +120,11 @@ std::shared_ptr<AbstractModelImport> ModelImportManager::chooseModelConvertor(
 		modelConvertor = std::shared_ptr<AbstractModelImport>(new repo::manipulator::modelconvertor::RepoModelImport(config));
 	else if (fileExt == ".SPM")
 		modelConvertor = std::shared_ptr<AbstractModelImport>(new repo::manipulator::modelconvertor::SynchroModelImport(config));
+#ifdef REPO_BUILD_BENCHMARKS
+	//Benchmark builds only, so an uploaded file cannot have the server generate scenes
+	else if (repo::manipulator::modelconvertor::SyntheticModelImport::isSupportedExts(fileExt))
+		modelConvertor = std::shared_ptr<AbstractModelImport>(new repo::manipulator::modelconvertor::SyntheticModelImport(config));
+#endif
 
 	return modelConvertor;
 }
\ No newline at end of file
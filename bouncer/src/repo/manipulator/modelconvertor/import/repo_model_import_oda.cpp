@@ -6,12 +6,19 @@
 #include <OdaCommon.h>
 #include <Gs/GsBaseInclude.h>
 #include "odaHelper/helper_functions.h"
+#include <boost/thread/mutex.hpp>
 #endif
 
 using namespace repo::manipulator::modelconvertor;
 
 const std::string OdaModelImport::supportedExtensions = ".dgn.rvt.rfa.dwg.dxf";
 
+#ifdef ODA_SUPPORT
+//The file processors initialise and uninitialise the ODA runtime per file, which is process-global state;
+//imports running concurrently (e.g. daemon jobs) must take turns reading through it.
+static boost::mutex odaMutex;
+#endif
+
 OdaModelImport::~OdaModelImport()
 {
 }
@@ -73,6 +80,7 @@ bool OdaModelImport::importModel(std::string filePath, uint8_t &err)
 	bool success = false;
 	err = REPOERR_OK;
 	try {
+		boost::mutex::scoped_lock lock(odaMutex);
 		err = odaProcessor->readFile();
 		if (err == REPOERR_OK) {
 			err = geoCollector.getErrorCode(); // the outermost error codes should take precedence as they could cause inner errors
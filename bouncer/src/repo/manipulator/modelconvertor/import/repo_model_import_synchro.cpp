@@ -18,6 +18,7 @@
 #ifdef SYNCHRO_SUPPORT
 #include <memory>
 #include "repo_model_import_synchro.h"
+#include "repo_sequence_cache_writer.h"
 
 #include "../../../core/model/bson/repo_bson_builder.h"
 #include "../../../core/model/bson/repo_bson_factory.h"
@@ -30,20 +31,6 @@ using namespace repo::manipulator::modelconvertor;
 const std::string RESOURCE_ID_NAME = "Resource ID";
 const std::string DEFAULT_SEQUENCE_NAME = "Unnamed Sequence";
 
-const static std::string SEQ_CACHE_LABEL_TRANSPARENCY = "transparency";
-const static std::string SEQ_CACHE_LABEL_COLOR = "color";
-const static std::string SEQ_CACHE_LABEL_TRANSFORMATION = "transformation";
-const static std::string SEQ_CACHE_LABEL_CLIP = "clip";
-const static std::string SEQ_CACHE_LABEL_VALUE = "value";
-const static std::string SEQ_CACHE_LABEL_SHARED_IDS = "shared_ids";
-const static std::string SEQ_CACHE_LABEL_CAMERA = "camera";
-const static std::string SEQ_CACHE_LABEL_POSITION = "position";
-const static std::string SEQ_CACHE_LABEL_DIRECTION = "direction";
-const static std::string SEQ_CACHE_LABEL_FORWARD = "forward";
-const static std::string SEQ_CACHE_LABEL_UP = "up";
-const static std::string SEQ_CACHE_LABEL_FOV = "fov";
-const static std::string SEQ_CACHE_LABEL_PERSPECTIVE = "perspective";
-
 class SynchroModelImport::CameraChange {
 public:
 	CameraChange(
@@ -350,87 +337,124 @@ std::vector<float> SynchroModelImport::colourFrom32Bit(const uint32_t &color) co
 	return{ (float)colorArr[0] / 255.f, (float)colorArr[1] / 255.f, (float)colorArr[2] / 255.f };
 }
 
-std::string SynchroModelImport::generateCache(
+SequenceFrameState SynchroModelImport::generateFrameState(
 	const std::unordered_map<std::string, std::vector<repo::lib::RepoUUID>> &resourceIDsToSharedIDs,
 	const std::unordered_map<float, std::set<std::string>> &alphaValueToIDs,
 	const std::unordered_map<repo::lib::RepoUUID, std::pair<uint32_t, std::vector<float>>, repo::lib::RepoUUIDHasher> &meshColourState,
 	const std::unordered_map<std::string, std::vector<double>> &resourceIDTransState,
 	const std::unordered_map<repo::lib::RepoUUID, std::pair<repo::lib::RepoVector3D64, repo::lib::RepoVector3D64>, repo::lib::RepoUUIDHasher> &clipState,
-	const std::shared_ptr<CameraChange> &cam,
-	std::unordered_map<std::string, std::vector<uint8_t>> &stateBuffers) {
-	std::vector<repo::lib::PropertyTree> transparencyStates, colourStates, transformationStates, clipPlaneStates;
-	std::unordered_map<float, std::vector<std::string>> transToIDs;
-	std::unordered_map<uint32_t, std::vector<std::string>> colorToIDs;
+	const std::shared_ptr<CameraChange> &cam) {
+	SequenceFrameState state;
 
 	for (const auto &entry : meshColourState) {
 		if (!entry.second.second.size()) continue;
 		auto value = colourIn32Bit(entry.second.second);
 		if (value != entry.second.first) {
-			if (colorToIDs.find(value) == colorToIDs.end()) {
-				colorToIDs[value] = { entry.first.toString() };
-			}
-			else {
-				colorToIDs[value].push_back(entry.first.toString());
-			}
+			auto colour = colourFrom32Bit(value);
+			state.setValue(SequenceFrameState::Property::COLOR, entry.first.toString(), std::vector<double>(colour.begin(), colour.end()));
 		}
 	}
 	if (settings.shouldImportAnimations()) {
 		for (const auto &entry : resourceIDTransState) {
-			if (resourceIDsToSharedIDs.find(entry.first) != resourceIDsToSharedIDs.end()
-				&& resourceIDsToSharedIDs.at(entry.first).size()) {
-				repo::lib::PropertyTree transformTree;
-				transformTree.addToTree(SEQ_CACHE_LABEL_VALUE, entry.second);
-				std::vector<repo::lib::RepoUUID> idArr = resourceIDsToSharedIDs.at(entry.first);
-				transformTree.addToTree(SEQ_CACHE_LABEL_SHARED_IDS, idArr);
-				transformationStates.push_back(transformTree);
+			auto idsIt = resourceIDsToSharedIDs.find(entry.first);
+			if (idsIt == resourceIDsToSharedIDs.end()) continue;
+			for (const auto &id : idsIt->second) {
+				state.setValue(SequenceFrameState::Property::TRANSFORMATION, id.toString(), entry.second);
 			}
 		}
 	}
 
 	for (const auto &entry : clipState) {
-		repo::lib::PropertyTree clipTree, valueTree;
-		valueTree.addToTree(SEQ_CACHE_LABEL_POSITION, entry.second.first);
-		valueTree.addToTree(SEQ_CACHE_LABEL_DIRECTION, entry.second.second);
-		clipTree.mergeSubTree(SEQ_CACHE_LABEL_VALUE, valueTree);
-		std::vector<repo::lib::RepoUUID> idArr = { entry.first };
-		clipTree.addToTree(SEQ_CACHE_LABEL_SHARED_IDS, idArr);
-		clipPlaneStates.push_back(clipTree);
+		state.setValue(SequenceFrameState::Property::CLIP, entry.first.toString(), {
+			entry.second.first.x, entry.second.first.y, entry.second.first.z,
+			entry.second.second.x, entry.second.second.y, entry.second.second.z });
 	}
 
 	for (const auto &entry : alphaValueToIDs) {
-		if (!entry.second.size()) continue;
-		repo::lib::PropertyTree transTree;
-		transTree.addToTree(SEQ_CACHE_LABEL_VALUE, entry.first);
-		transTree.addToTree(SEQ_CACHE_LABEL_SHARED_IDS, entry.second);
-		transparencyStates.push_back(transTree);
+		for (const auto &id : entry.second) {
+			state.setValue(SequenceFrameState::Property::TRANSPARENCY, id, { entry.first });
+		}
 	}
 
-	for (const auto &entry : colorToIDs) {
-		repo::lib::PropertyTree colTree;
-		colTree.addToTree(SEQ_CACHE_LABEL_VALUE, colourFrom32Bit(entry.first));
-		colTree.addToTree(SEQ_CACHE_LABEL_SHARED_IDS, entry.second);
-		colourStates.push_back(colTree);
+	if (cam) {
+		state.setCamera({ cam->position, cam->forward, cam->up, cam->fov, cam->isPerspective });
 	}
-	repo::lib::PropertyTree bufferTree;
-	if (transparencyStates.size()) bufferTree.addArrayObjects(SEQ_CACHE_LABEL_TRANSPARENCY, transparencyStates);
-	if (colourStates.size()) bufferTree.addArrayObjects(SEQ_CACHE_LABEL_COLOR, colourStates);
-	if (transformationStates.size()) bufferTree.addArrayObjects(SEQ_CACHE_LABEL_TRANSFORMATION, transformationStates);
-	if (clipPlaneStates.size()) bufferTree.addArrayObjects(SEQ_CACHE_LABEL_CLIP, clipPlaneStates);
 
-	if (cam) {
-		repo::lib::PropertyTree camTree;
-		camTree.addToTree(SEQ_CACHE_LABEL_POSITION, cam->position);
-		camTree.addToTree(SEQ_CACHE_LABEL_FORWARD, cam->forward);
-		camTree.addToTree(SEQ_CACHE_LABEL_UP, cam->up);
-		camTree.addToTree(SEQ_CACHE_LABEL_PERSPECTIVE, cam->isPerspective ? "true" : "false");
-		camTree.addToTree(SEQ_CACHE_LABEL_FOV, cam->fov);
-		bufferTree.mergeSubTree(SEQ_CACHE_LABEL_CAMERA, camTree);
+	return state;
+}
+
+SequenceFrameState SynchroModelImport::generateFrameDelta(
+	const FrameChanges &changes,
+	const std::unordered_map<std::string, std::vector<repo::lib::RepoUUID>> &resourceIDsToSharedIDs,
+	const std::unordered_map<float, std::set<std::string>> &alphaValueToIDs,
+	const std::unordered_map<repo::lib::RepoUUID, std::pair<float, float>, repo::lib::RepoUUIDHasher> &meshAlphaState,
+	const std::unordered_map<repo::lib::RepoUUID, std::pair<uint32_t, std::vector<float>>, repo::lib::RepoUUIDHasher> &meshColourState,
+	const std::unordered_map<std::string, std::vector<double>> &resourceIDTransState,
+	const std::unordered_map<repo::lib::RepoUUID, std::pair<repo::lib::RepoVector3D64, repo::lib::RepoVector3D64>, repo::lib::RepoUUIDHasher> &clipState,
+	const std::shared_ptr<CameraChange> &cam) {
+	SequenceFrameState delta;
+
+	//Mirrors generateFrameState(), for the touched nodes only
+	for (const auto &mesh : changes.colour) {
+		auto it = meshColourState.find(mesh);
+		uint32_t value = 0;
+		bool isSet = it != meshColourState.end() && it->second.second.size()
+			&& (value = colourIn32Bit(it->second.second)) != it->second.first;
+		if (isSet) {
+			auto colour = colourFrom32Bit(value);
+			delta.setValue(SequenceFrameState::Property::COLOR, mesh.toString(), std::vector<double>(colour.begin(), colour.end()));
+		}
+		else {
+			delta.resetValue(SequenceFrameState::Property::COLOR, mesh.toString());
+		}
+	}
+
+	if (settings.shouldImportAnimations()) {
+		for (const auto &resourceID : changes.transformation) {
+			auto idsIt = resourceIDsToSharedIDs.find(resourceID);
+			if (idsIt == resourceIDsToSharedIDs.end()) continue;
+			auto transIt = resourceIDTransState.find(resourceID);
+			for (const auto &id : idsIt->second) {
+				if (transIt != resourceIDTransState.end())
+					delta.setValue(SequenceFrameState::Property::TRANSFORMATION, id.toString(), transIt->second);
+				else
+					delta.resetValue(SequenceFrameState::Property::TRANSFORMATION, id.toString());
+			}
+		}
 	}
 
-	auto id = repo::lib::RepoUUID::createUUID().toString();
+	for (const auto &mesh : changes.clip) {
+		auto it = clipState.find(mesh);
+		if (it != clipState.end()) {
+			delta.setValue(SequenceFrameState::Property::CLIP, mesh.toString(), {
+				it->second.first.x, it->second.first.y, it->second.first.z,
+				it->second.second.x, it->second.second.y, it->second.second.z });
+		}
+		else {
+			delta.resetValue(SequenceFrameState::Property::CLIP, mesh.toString());
+		}
+	}
+
+	for (const auto &mesh : changes.transparency) {
+		auto meshStr = mesh.toString();
+		auto alphaIt = meshAlphaState.find(mesh);
+		bool isSet = false;
+		if (alphaIt != meshAlphaState.end()) {
+			auto idsIt = alphaValueToIDs.find(alphaIt->second.second);
+			isSet = idsIt != alphaValueToIDs.end() && idsIt->second.count(meshStr);
+		}
+
+		if (isSet)
+			delta.setValue(SequenceFrameState::Property::TRANSPARENCY, meshStr, { alphaIt->second.second });
+		else
+			delta.resetValue(SequenceFrameState::Property::TRANSPARENCY, meshStr);
+	}
+
+	if (changes.camera && cam) {
+		delta.setCamera({ cam->position, cam->forward, cam->up, cam->fov, cam->isPerspective });
+	}
 
-	stateBuffers[id] = bufferTree.writeJsonToBuffer();
-	return id;
+	return delta;
 }
 
 repo::lib::RepoMatrix64 SynchroModelImport::convertMatrixTo3DRepoWorld(
@@ -475,6 +499,7 @@ void SynchroModelImport::updateFrameState(
 	std::unordered_map<repo::lib::RepoUUID, std::pair<repo::lib::RepoVector3D64, repo::lib::RepoVector3D64>, repo::lib::RepoUUIDHasher> &clipState,
 	std::shared_ptr<CameraChange> &cam,
 	std::set<std::string> &transformingResource,
+	FrameChanges &changes,
 	const std::vector<double> &offset
 
 ) {
@@ -490,12 +515,14 @@ void SynchroModelImport::updateFrameState(
 				camChange->fov,
 				camChange->isPerspective
 				);
+			changes.camera = true;
 		}
 		break;
 		case synchro_reader::AnimationTask::TaskType::CLIP:
 		{
 			auto clipTask = std::dynamic_pointer_cast<const synchro_reader::ClipTask>(task);
 			auto meshes = resourceIDsToSharedIDs.at(clipTask->resourceID);
+			changes.clip.insert(meshes.begin(), meshes.end());
 			if (clipTask->reset) {
 				for (const auto &mesh : meshes)
 					clipState.erase(mesh);
@@ -518,6 +545,7 @@ void SynchroModelImport::updateFrameState(
 				bool reset = !color.size();
 				auto colour32Bit = reset ? 0 : colourIn32Bit(color);
 				auto meshes = resourceIDsToSharedIDs.at(colourTask->resourceID);
+				changes.colour.insert(meshes.begin(), meshes.end());
 				for (const auto &mesh : meshes) {
 					meshColourState[mesh].second = reset || meshColourState[mesh].first == colour32Bit ? std::vector<float>() : color;
 				}
@@ -531,6 +559,7 @@ void SynchroModelImport::updateFrameState(
 
 				auto meshes = resourceIDsToSharedIDs.at(transTask->resourceID);
 				transformingResource.insert(transTask->resourceID);
+				changes.transformation.insert(transTask->resourceID);
 				repo::lib::RepoMatrix64 matrix(transTask->trans);
 
 				bool isTransforming = true;
@@ -579,6 +608,7 @@ void SynchroModelImport::updateFrameState(
 			if (resourceIDsToSharedIDs.find(visibilityTask->resourceID) != resourceIDsToSharedIDs.end()) {
 				auto visibility = visibilityTask->visibility;
 				auto meshes = resourceIDsToSharedIDs.at(visibilityTask->resourceID);
+				changes.transparency.insert(meshes.begin(), meshes.end());
 
 				for (const auto mesh : meshes) {
 					auto previousState = meshAlphaState[mesh].second;
@@ -776,6 +806,30 @@ repo::core::model::RepoScene* SynchroModelImport::generateRepoScene(uint8_t &err
 
 		std::set<std::string> transformingResources;
 
+		//Only every keyFrameInterval frames is stored in full, the frames in between
+		//only store the changes recorded whilst updating the state since the previous frame
+		const uint32_t keyFrameInterval = std::max(settings.getSequenceKeyFrameInterval(), 1u);
+		FrameChanges changes;
+		size_t nFrames = 0, nKeyFrames = 0;
+
+		//Snapshots of the frame states are serialised on the writer's threads whilst
+		//this thread carries on updating the state for the following frames
+		SequenceCacheWriter cacheWriter(stateBuffers, settings.getSequenceStateFormat());
+		bool framesQueued = true;
+		auto addFrame = [&](const uint64_t &timestamp) {
+			repo::core::model::RepoSequence::FrameData data;
+			data.isKeyFrame = nFrames++ % keyFrameInterval == 0;
+			data.ref = repo::lib::RepoUUID::createUUID().toString();
+			data.timestamp = timestamp;
+			auto state = std::make_shared<const SequenceFrameState>(data.isKeyFrame ?
+				generateFrameState(resourceIDsToSharedIDs, alphaValueToIDs, meshColourState, resourceIDTransState, clipState, cam) :
+				generateFrameDelta(changes, resourceIDsToSharedIDs, alphaValueToIDs, meshAlphaState, meshColourState, resourceIDTransState, clipState, cam));
+			framesQueued &= cacheWriter.addFrame(data.ref, state);
+			frameData.push_back(data);
+			changes.clear();
+			if (data.isKeyFrame) ++nKeyFrames;
+		};
+
 		int count = 0;
 		auto total = animation.frames.size();
 		int step = total > 10 ? total / 10 : 1;
@@ -784,26 +838,27 @@ repo::core::model::RepoScene* SynchroModelImport::generateRepoScene(uint8_t &err
 			resourceIDTransState.size()) {
 			//First animation frame is bigger than the task frame
 			//And we have animations... need to reset the state of the transforms.
-			repo::core::model::RepoSequence::FrameData data;
-			data.ref = generateCache(resourceIDsToSharedIDs, alphaValueToIDs, meshColourState, resourceIDTransState, clipState, cam, stateBuffers);
-			data.timestamp = firstFrame;
-			frameData.push_back(data);
+			addFrame(firstFrame);
 		}
 
 		for (const auto &currentFrame : animation.frames) {
 			auto currentTime = currentFrame.first;
 			firstFrame = std::min(firstFrame, currentTime * 1000);
 			lastFrame = std::max(lastFrame, currentTime * 1000);
-			updateFrameState(currentFrame.second, resourceIDsToSharedIDs, resourceIDLastTrans, alphaValueToIDs, meshAlphaState, meshColourState, resourceIDTransState, clipState, cam, transformingResources, offset);
-			repo::core::model::RepoSequence::FrameData data;
-			data.ref = generateCache(resourceIDsToSharedIDs, alphaValueToIDs, meshColourState, resourceIDTransState, clipState, cam, stateBuffers);
-			data.timestamp = currentTime;
-			frameData.push_back(data);
+			updateFrameState(currentFrame.second, resourceIDsToSharedIDs, resourceIDLastTrans, alphaValueToIDs, meshAlphaState, meshColourState, resourceIDTransState, clipState, cam, transformingResources, changes, offset);
+			addFrame(currentTime);
 			if (++count % step == 0) {
 				repoInfo << "Processed " << count << " of " << total << " frames";
 			};
 		}
 
+		if (!cacheWriter.finalise() || !framesQueued) {
+			repoError << "Failed to generate the sequence frame states";
+			errMsg = REPOERR_LOAD_SCENE_FAIL;
+			delete scene;
+			return nullptr;
+		}
+
 		repoInfo << "transforming Mesh: " << transformingResources.size();
 		for (const auto &resourceID : transformingResources) {
 			for (const auto &mesh : resourceIDsToSharedIDs[resourceID]) {
@@ -813,7 +868,18 @@ repo::core::model::RepoScene* SynchroModelImport::generateRepoScene(uint8_t &err
 		}
 
 		std::string animationName = animation.name.empty() ? DEFAULT_SEQUENCE_NAME : animation.name;
-		auto sequence = repo::core::model::RepoBSONFactory::makeSequence(frameData, animationName, sequenceID, firstFrame, lastFrame);
+		std::string stateFormat;
+		switch (settings.getSequenceStateFormat()) {
+		case SequenceStateFormat::BINARY:
+			stateFormat = REPO_SEQUENCE_STATE_FORMAT_BINARY;
+			break;
+		case SequenceStateFormat::BINARY_COMPRESSED:
+			stateFormat = REPO_SEQUENCE_STATE_FORMAT_BINARY_COMPRESSED;
+			break;
+		default:
+			break;
+		}
+		auto sequence = repo::core::model::RepoBSONFactory::makeSequence(frameData, animationName, sequenceID, firstFrame, lastFrame, stateFormat);
 
 		if (sequence.objsize() > REPO_MAX_OBJ_SIZE) {
 			errMsg = REPOERR_SYNCHRO_SEQUENCE_TOO_BIG;
@@ -821,7 +887,7 @@ repo::core::model::RepoScene* SynchroModelImport::generateRepoScene(uint8_t &err
 			scene = nullptr;
 		}
 		else {
-			repoInfo << "Animation constructed, number of frames: " << frameData.size();
+			repoInfo << "Animation constructed, number of frames: " << frameData.size() << " (" << nKeyFrames << " key frames)";
 			scene->addSequence(sequence, stateBuffers);
 
 			scene->setDefaultInvisible(defaultInvisible);
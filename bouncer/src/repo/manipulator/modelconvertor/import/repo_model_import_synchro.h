@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <set>
 #include <string>
 #include <utility>
 #ifdef SYNCHRO_SUPPORT
@@ -25,6 +26,7 @@
 #include <memory>
 
 #include "repo_model_import_abstract.h"
+#include "repo_sequence_frame_state.h"
 #include "../../../core/model/collection/repo_scene.h"
 #include "../../../core/model/bson/repo_node_material.h"
 #include "../../../core/model/bson/repo_node_mesh.h"
@@ -86,6 +88,28 @@ namespace repo {
 					}
 				};
 
+				/**
+				* Nodes whose animation state was touched since the last frame was stored,
+				* so delta frames only visit what changed instead of the whole state
+				*/
+				struct FrameChanges {
+					std::set<repo::lib::RepoUUID> transparency;
+					std::set<repo::lib::RepoUUID> colour;
+					std::set<std::string> transformation;
+					std::set<repo::lib::RepoUUID> clip;
+					bool camera;
+
+					FrameChanges() : camera(false) {}
+
+					void clear() {
+						transparency.clear();
+						colour.clear();
+						transformation.clear();
+						clip.clear();
+						camera = false;
+					}
+				};
+
 				const std::string TASK_ID = "id";
 				const std::string TASK_NAME = "name";
 				const std::string TASK_START_DATE = "startDate";
@@ -124,14 +148,28 @@ namespace repo {
 
 				std::vector<float> colourFrom32Bit(const uint32_t &color) const;
 
-				std::string generateCache(
+				SequenceFrameState generateFrameState(
+					const std::unordered_map<std::string, std::vector<repo::lib::RepoUUID>> &resourceIDsToSharedIDs,
+					const std::unordered_map<float, std::set<std::string>> &alphaValueToIDs,
+					const std::unordered_map<repo::lib::RepoUUID, std::pair<uint32_t, std::vector<float>>, repo::lib::RepoUUIDHasher> &meshColourState,
+					const std::unordered_map<std::string, std::vector<double>> &resourceIDTransState,
+					const std::unordered_map<repo::lib::RepoUUID, std::pair<repo::lib::RepoVector3D64, repo::lib::RepoVector3D64>, repo::lib::RepoUUIDHasher> &clipState,
+					const std::shared_ptr<CameraChange> &cam);
+
+				/**
+				* Generate the changes to the frame state recorded since the last frame
+				* Nodes which no longer have a value for a property are reset.
+				* @return returns a state to serialise in full as the delta frame
+				*/
+				SequenceFrameState generateFrameDelta(
+					const FrameChanges &changes,
 					const std::unordered_map<std::string, std::vector<repo::lib::RepoUUID>> &resourceIDsToSharedIDs,
 					const std::unordered_map<float, std::set<std::string>> &alphaValueToIDs,
+					const std::unordered_map<repo::lib::RepoUUID, std::pair<float, float>, repo::lib::RepoUUIDHasher> &meshAlphaState,
 					const std::unordered_map<repo::lib::RepoUUID, std::pair<uint32_t, std::vector<float>>, repo::lib::RepoUUIDHasher> &meshColourState,
 					const std::unordered_map<std::string, std::vector<double>> &resourceIDTransState,
 					const std::unordered_map<repo::lib::RepoUUID, std::pair<repo::lib::RepoVector3D64, repo::lib::RepoVector3D64>, repo::lib::RepoUUIDHasher> &clipState,
-					const std::shared_ptr<CameraChange> &cam,
-					std::unordered_map<std::string, std::vector<uint8_t>> &stateBuffers);
+					const std::shared_ptr<CameraChange> &cam);
 
 				void updateFrameState(
 					const std::vector<std::shared_ptr<synchro_reader::AnimationTask>> &tasks,
@@ -144,6 +182,7 @@ namespace repo {
 					std::unordered_map<repo::lib::RepoUUID, std::pair<repo::lib::RepoVector3D64, repo::lib::RepoVector3D64>, repo::lib::RepoUUIDHasher> &clipState,
 					std::shared_ptr<CameraChange> &cam,
 					std::set<std::string> &transformingResource,
+					FrameChanges &changes,
 					const std::vector<double> &offset
 
 				);
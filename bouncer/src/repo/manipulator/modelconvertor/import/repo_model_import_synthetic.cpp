@@ -0,0 +1,122 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_model_import_synthetic.h"
+
+#include <limits>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include "../../../error_codes.h"
+#include "../../../lib/repo_log.h"
+
+using namespace repo::manipulator::modelconvertor;
+
+//Upper bounds of the parameters, to fail early rather than exhaust the memory
+static const int64_t MAX_DEPTH = 32;
+static const int64_t MAX_FAN_OUT = 1024;
+static const int64_t MAX_MESH_COUNT = 10000000;
+static const int64_t MAX_TRIANGLES_PER_MESH = 1000000;
+static const int64_t MAX_METADATA_DENSITY = 1000;
+static const int64_t MAX_TEXTURE_COUNT = 1024;
+static const int64_t MAX_MATERIAL_COUNT = 65536;
+//The counts are bounded individually, but not their product
+static const uint64_t MAX_VERTEX_COUNT = 50000000;
+
+/**
+* Read an optional count parameter. Counts are read as signed, as reading
+* them unsigned would silently wrap negative values around.
+* @param tree parameters
+* @param key name of the parameter
+* @param max largest value accepted
+* @param value value to update, holding the default
+* @return returns false if the value is out of range
+*/
+static bool readCount(
+	const boost::property_tree::ptree &tree,
+	const std::string &key,
+	const int64_t &max,
+	uint32_t &value)
+{
+	auto read = tree.get<int64_t>(key, value);
+	if (read < 0 || read > max)
+	{
+		repoError << "Invalid synthetic scene parameter " << key << ": " << read << " (expected 0 to " << max << ")";
+		return false;
+	}
+
+	value = (uint32_t)read;
+	return true;
+}
+
+bool SyntheticModelImport::importModel(std::string filePath, uint8_t &errMsg)
+{
+	repoInfo << "IMPORT [" << getFileName(filePath) << "]";
+	repoInfo << "=== GENERATING SYNTHETIC MODEL ===";
+
+	boost::property_tree::ptree tree;
+	try {
+		boost::property_tree::read_json(filePath, tree);
+
+		bool valid = readCount(tree, "seed", std::numeric_limits<uint32_t>::max(), config.seed)
+			&& readCount(tree, "depth", MAX_DEPTH, config.depth)
+			&& readCount(tree, "fanOut", MAX_FAN_OUT, config.fanOut)
+			&& readCount(tree, "meshCount", MAX_MESH_COUNT, config.meshCount)
+			&& readCount(tree, "trianglesPerMesh", MAX_TRIANGLES_PER_MESH, config.trianglesPerMesh)
+			&& readCount(tree, "metadataDensity", MAX_METADATA_DENSITY, config.metadataDensity)
+			&& readCount(tree, "textureCount", MAX_TEXTURE_COUNT, config.textureCount)
+			&& readCount(tree, "materialCount", MAX_MATERIAL_COUNT, config.materialCount);
+
+		config.instancingRatio = tree.get<double>("instancingRatio", config.instancingRatio);
+		if (valid && !(config.instancingRatio >= 0 && config.instancingRatio <= 1))
+		{
+			repoError << "Invalid synthetic scene parameter instancingRatio: " << config.instancingRatio << " (expected 0 to 1)";
+			valid = false;
+		}
+
+		if (valid)
+		{
+			auto nVertices = repo::manipulator::modelutility::SceneGenerator(config).getVertexCount();
+			if (nVertices > MAX_VERTEX_COUNT)
+			{
+				repoError << "Synthetic scene parameters would generate " << nVertices << " vertices (expected at most " << MAX_VERTEX_COUNT << ")";
+				valid = false;
+			}
+		}
+
+		if (!valid)
+		{
+			errMsg = REPOERR_MODEL_FILE_READ;
+			return false;
+		}
+	}
+	catch (const boost::property_tree::ptree_error &e)
+	{
+		repoError << "Failed to read synthetic scene parameters: " << e.what();
+		errMsg = REPOERR_MODEL_FILE_READ;
+		return false;
+	}
+
+	return true;
+}
+
+repo::core::model::RepoScene* SyntheticModelImport::generateRepoScene(uint8_t &errMsg)
+{
+	auto scene = repo::manipulator::modelutility::SceneGenerator(config).generate();
+	if (!scene)
+		errMsg = REPOERR_LOAD_SCENE_FAIL;
+	return scene;
+}
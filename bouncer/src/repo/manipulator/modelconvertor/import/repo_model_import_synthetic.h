@@ -0,0 +1,73 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Pseudo-importer producing a synthetic scene. The "model" is a JSON file
+* of SceneGenerator parameters with a .synthetic extension, e.g.
+* { "seed": 1, "depth": 5, "fanOut": 10, "meshCount": 100000, "trianglesPerMesh": 500,
+*   "instancingRatio": 0.3, "metadataDensity": 20, "textureCount": 4, "materialCount": 32 }
+* Parameters left out take their default values. Negative or unreasonably
+* large counts, or too many vertices in all, fail the import.
+* ModelImportManager only recognises the extension in benchmark builds
+* (REPO_BUILD_BENCHMARKS).
+*/
+
+#pragma once
+
+#include <string>
+
+#include "repo_model_import_abstract.h"
+#include "../../modelutility/repo_scene_generator.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelconvertor {
+			class SyntheticModelImport : public AbstractModelImport
+			{
+			public:
+				SyntheticModelImport(const ModelImportConfig &settings) : AbstractModelImport(settings) {}
+				~SyntheticModelImport() {}
+
+				/**
+				* Generates a repo scene graph from the parameters read by importModel()
+				* @return returns a populated RepoScene upon success.
+				*/
+				repo::core::model::RepoScene* generateRepoScene(uint8_t &errMsg);
+
+				/**
+				* Read the generator parameters from a given file
+				* @param path to the file
+				* @param error message if failed
+				* @return returns true upon success
+				*/
+				bool importModel(std::string filePath, uint8_t &errMsg);
+
+				/**
+				* Check if the extension is that of a synthetic scene file
+				* @param testExt extension, in upper case
+				*/
+				static bool isSupportedExts(const std::string &testExt)
+				{
+					return testExt == ".SYNTHETIC";
+				}
+
+			private:
+				repo::manipulator::modelutility::SceneGeneratorConfig config;
+			};
+		} //namespace modelconvertor
+	} //namespace manipulator
+} //namespace repo
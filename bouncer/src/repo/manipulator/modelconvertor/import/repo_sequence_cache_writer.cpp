@@ -0,0 +1,118 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "repo_sequence_cache_writer.h"
+#include "../../../lib/repo_log.h"
+
+using namespace repo::manipulator::modelconvertor;
+
+SequenceCacheWriter::SequenceCacheWriter(
+	std::unordered_map<std::string, std::vector<uint8_t>> &stateBuffers,
+	const SequenceStateFormat                             &format,
+	const uint32_t                                        &nThreads,
+	const uint32_t                                        &maxQueued)
+	: stateBuffers(stateBuffers),
+	format(format),
+	maxQueued(maxQueued ? maxQueued : 1),
+	finished(false),
+	success(true)
+{
+	const uint32_t nWorkers = nThreads ? nThreads : 1;
+	for (uint32_t i = 0; i < nWorkers; ++i)
+	{
+		workers.create_thread(boost::bind(&SequenceCacheWriter::processQueue, this));
+	}
+}
+
+SequenceCacheWriter::~SequenceCacheWriter()
+{
+	finalise();
+}
+
+bool SequenceCacheWriter::addFrame(
+	const std::string                               &ref,
+	const std::shared_ptr<const SequenceFrameState> &state)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	while (!finished && success && queue.size() >= maxQueued)
+	{
+		slotAvailable.wait(lock);
+	}
+
+	if (finished || !success)
+	{
+		repoError << "Failed to queue sequence frame (" << ref << "): " << (finished ? "writer is finalised" : "a previous frame failed to serialise");
+		return false;
+	}
+
+	queue.push_back({ ref, state });
+	jobAvailable.notify_one();
+	return true;
+}
+
+bool SequenceCacheWriter::finalise()
+{
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		finished = true;
+	}
+	jobAvailable.notify_all();
+	slotAvailable.notify_all();
+	workers.join_all();
+
+	return success;
+}
+
+void SequenceCacheWriter::processQueue()
+{
+	while (true)
+	{
+		FrameJob job;
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			while (!finished && queue.empty())
+			{
+				jobAvailable.wait(lock);
+			}
+
+			if (queue.empty())
+				break;
+
+			job = std::move(queue.front());
+			queue.pop_front();
+		}
+		slotAvailable.notify_one();
+
+		std::vector<uint8_t> buffer;
+		bool serialised = true;
+		try {
+			buffer = job.state->serialise(format);
+		}
+		catch (const std::exception &e)
+		{
+			repoError << "Failed to serialise sequence frame (" << job.ref << "): " << e.what();
+			serialised = false;
+		}
+
+		//Release the snapshot before waiting on the lock
+		job.state.reset();
+
+		boost::mutex::scoped_lock lock(mutex);
+		if (serialised)
+			stateBuffers[job.ref] = std::move(buffer);
+		success &= serialised;
+	}
+}
@@ -0,0 +1,101 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+* Serialises the frame states of a sequence on a pool of worker threads,
+* so the caller can carry on advancing the timeline while earlier frames
+* are being encoded. The number of snapshots waiting to be serialised is
+* bounded, blocking the caller whilst the queue is full.
+*/
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <boost/thread.hpp>
+
+#include "repo_sequence_frame_state.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelconvertor {
+			class SequenceCacheWriter
+			{
+			public:
+				/**
+				* Construct a writer and start its worker threads
+				* @param stateBuffers buffers to add the serialised states to, keyed by reference.
+				*        It must not be accessed until finalise() returns
+				* @param format encoding of the states
+				* @param nThreads number of worker threads. These run alongside the shared
+				*        task executor, so only enough to keep up with the caller
+				* @param maxQueued maximum number of frames waiting to be serialised
+				*/
+				SequenceCacheWriter(
+					std::unordered_map<std::string, std::vector<uint8_t>> &stateBuffers,
+					const SequenceStateFormat                             &format,
+					const uint32_t                                        &nThreads = 2,
+					const uint32_t                                        &maxQueued = 16);
+
+				/**
+				* Waits for any pending frames before destruction
+				*/
+				~SequenceCacheWriter();
+
+				/**
+				* Queue a frame to be serialised, blocking whilst the queue is full
+				* The state is shared with the writer, and must not be modified afterwards.
+				* @param ref reference to store the serialised state under
+				* @param state state of the frame
+				* @return returns false if the writer is finalised or a frame failed to serialise
+				*/
+				bool addFrame(
+					const std::string                               &ref,
+					const std::shared_ptr<const SequenceFrameState> &state);
+
+				/**
+				* Wait for all queued frames to be serialised and stop the workers
+				* @return returns true if all frames were serialised successfully
+				*/
+				bool finalise();
+
+			private:
+				struct FrameJob {
+					std::string ref;
+					std::shared_ptr<const SequenceFrameState> state;
+				};
+
+				/**
+				* Worker loop, serialising queued frames until finalised
+				*/
+				void processQueue();
+
+				std::unordered_map<std::string, std::vector<uint8_t>> &stateBuffers;
+				const SequenceStateFormat format;
+				const uint32_t maxQueued;
+
+				std::deque<FrameJob> queue;
+				bool finished;
+				bool success;
+
+				boost::mutex mutex;
+				boost::condition_variable jobAvailable;
+				boost::condition_variable slotAvailable;
+				boost::thread_group workers;
+			};
+		} //namespace modelconvertor
+	} //namespace manipulator
+} //namespace repo
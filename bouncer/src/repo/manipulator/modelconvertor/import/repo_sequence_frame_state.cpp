@@ -0,0 +1,697 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "repo_sequence_frame_state.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+#include "../../../lib/repo_log.h"
+#include "../../../lib/repo_property_tree.h"
+
+using namespace repo::manipulator::modelconvertor;
+
+const static std::string SEQ_CACHE_LABEL_TRANSPARENCY = "transparency";
+const static std::string SEQ_CACHE_LABEL_COLOR = "color";
+const static std::string SEQ_CACHE_LABEL_TRANSFORMATION = "transformation";
+const static std::string SEQ_CACHE_LABEL_CLIP = "clip";
+const static std::string SEQ_CACHE_LABEL_VALUE = "value";
+const static std::string SEQ_CACHE_LABEL_SHARED_IDS = "shared_ids";
+const static std::string SEQ_CACHE_LABEL_CAMERA = "camera";
+const static std::string SEQ_CACHE_LABEL_POSITION = "position";
+const static std::string SEQ_CACHE_LABEL_DIRECTION = "direction";
+const static std::string SEQ_CACHE_LABEL_FORWARD = "forward";
+const static std::string SEQ_CACHE_LABEL_UP = "up";
+const static std::string SEQ_CACHE_LABEL_FOV = "fov";
+const static std::string SEQ_CACHE_LABEL_PERSPECTIVE = "perspective";
+const static std::string SEQ_CACHE_LABEL_RESET = "reset";
+
+const static std::string PROPERTY_LABELS[] = {
+	SEQ_CACHE_LABEL_TRANSPARENCY,
+	SEQ_CACHE_LABEL_COLOR,
+	SEQ_CACHE_LABEL_TRANSFORMATION,
+	SEQ_CACHE_LABEL_CLIP
+};
+
+const static size_t PROPERTY_SIZES[] = { 1, 3, 16, 6 };
+
+const static uint8_t BINARY_MAGIC[] = { 'R', 'S', 'F', 'S' };
+const static uint8_t BINARY_VERSION = 1;
+const static uint8_t BINARY_FLAG_COMPRESSED = 1;
+
+static void addValueToTree(
+	repo::lib::PropertyTree &tree,
+	const SequenceFrameState::Property &property,
+	const std::vector<double> &value)
+{
+	switch (property) {
+	case SequenceFrameState::Property::TRANSPARENCY:
+		tree.addToTree(SEQ_CACHE_LABEL_VALUE, (float)value[0]);
+		break;
+	case SequenceFrameState::Property::COLOR:
+		tree.addToTree(SEQ_CACHE_LABEL_VALUE, std::vector<float>(value.begin(), value.end()));
+		break;
+	case SequenceFrameState::Property::TRANSFORMATION:
+		tree.addToTree(SEQ_CACHE_LABEL_VALUE, value);
+		break;
+	case SequenceFrameState::Property::CLIP:
+	{
+		repo::lib::PropertyTree valueTree;
+		valueTree.addToTree(SEQ_CACHE_LABEL_POSITION, repo::lib::RepoVector3D64(value[0], value[1], value[2]));
+		valueTree.addToTree(SEQ_CACHE_LABEL_DIRECTION, repo::lib::RepoVector3D64(value[3], value[4], value[5]));
+		tree.mergeSubTree(SEQ_CACHE_LABEL_VALUE, valueTree);
+		break;
+	}
+	}
+}
+
+/**
+* Parse a space separated vector, as written by the property tree
+*/
+static bool parseVectorString(
+	const std::string &str,
+	std::vector<double> &result)
+{
+	std::stringstream ss(str);
+	double value;
+	while (ss >> value)
+		result.push_back(value);
+
+	return ss.eof() && result.size() == 3;
+}
+
+static bool parseValue(
+	const SequenceFrameState::Property &property,
+	const boost::property_tree::ptree &tree,
+	std::vector<double> &value)
+{
+	switch (property) {
+	case SequenceFrameState::Property::TRANSPARENCY:
+		value.push_back(tree.get_value<double>());
+		break;
+	case SequenceFrameState::Property::COLOR:
+	case SequenceFrameState::Property::TRANSFORMATION:
+		for (const auto &child : tree)
+			value.push_back(child.second.get_value<double>());
+		break;
+	case SequenceFrameState::Property::CLIP:
+	{
+		std::vector<double> direction;
+		if (!parseVectorString(tree.get<std::string>(SEQ_CACHE_LABEL_POSITION), value)
+			|| !parseVectorString(tree.get<std::string>(SEQ_CACHE_LABEL_DIRECTION), direction))
+			return false;
+		value.insert(value.end(), direction.begin(), direction.end());
+		break;
+	}
+	}
+
+	return value.size() == PROPERTY_SIZES[(int)property];
+}
+
+static bool cameraEquals(
+	const SequenceFrameState::Camera &a,
+	const SequenceFrameState::Camera &b)
+{
+	return a.position == b.position && a.forward == b.forward && a.up == b.up
+		&& a.fov == b.fov && a.isPerspective == b.isPerspective;
+}
+
+template <typename T>
+static void writeToBuffer(
+	std::vector<uint8_t> &buffer,
+	const T &value)
+{
+	auto bytes = (const uint8_t*)&value;
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+/**
+* Bounds checked reader over a binary buffer
+*/
+class BufferReader
+{
+public:
+	BufferReader(const uint8_t *data, const size_t &size) : data(data), size(size), offset(0) {}
+
+	bool read(void *dest, const size_t &nBytes)
+	{
+		if (remaining() < nBytes)
+			return false;
+		memcpy(dest, data + offset, nBytes);
+		offset += nBytes;
+		return true;
+	}
+
+	template <typename T>
+	bool read(T &value)
+	{
+		return read(&value, sizeof(T));
+	}
+
+	void skip(const size_t &nBytes) { offset = std::min(size, offset + nBytes); }
+	const uint8_t* current() const { return data + offset; }
+	size_t remaining() const { return size - offset; }
+
+private:
+	const uint8_t *data;
+	size_t size;
+	size_t offset;
+};
+
+static void writeValue(
+	std::vector<uint8_t> &buffer,
+	const SequenceFrameState::Property &property,
+	const std::vector<double> &value)
+{
+	if (property == SequenceFrameState::Property::COLOR)
+	{
+		for (const auto &channel : value)
+			writeToBuffer(buffer, (uint8_t)std::round(channel * 255));
+		writeToBuffer(buffer, (uint8_t)255);
+	}
+	else
+	{
+		for (const auto &entry : value)
+			writeToBuffer(buffer, (float)entry);
+	}
+}
+
+static bool readValue(
+	BufferReader &reader,
+	const SequenceFrameState::Property &property,
+	std::vector<double> &value)
+{
+	const auto nValues = PROPERTY_SIZES[(int)property];
+	value.reserve(nValues);
+	if (property == SequenceFrameState::Property::COLOR)
+	{
+		uint8_t rgba[4];
+		if (!reader.read(rgba, sizeof(rgba)))
+			return false;
+		//Same conversion as the importer's, so values are restored exactly
+		for (size_t i = 0; i < nValues; ++i)
+			value.push_back((float)rgba[i] / 255.f);
+	}
+	else
+	{
+		float entry;
+		for (size_t i = 0; i < nValues; ++i)
+		{
+			if (!reader.read(entry))
+				return false;
+			value.push_back(entry);
+		}
+	}
+	return true;
+}
+
+const std::vector<double>* SequenceFrameState::getValue(
+	const Property    &property,
+	const std::string &sharedId) const
+{
+	auto it = values[(int)property].find(sharedId);
+	return it == values[(int)property].end() ? nullptr : &it->second;
+}
+
+std::vector<uint8_t> SequenceFrameState::serialise(
+	const SequenceStateFormat &format) const
+{
+	return serialiseDelta(SequenceFrameState(), format);
+}
+
+std::vector<uint8_t> SequenceFrameState::serialiseDelta(
+	const SequenceFrameState  &previous,
+	const SequenceStateFormat &format) const
+{
+	auto changes = getChanges(previous);
+	switch (format) {
+	case SequenceStateFormat::BINARY:
+		return writeBinary(changes, false);
+	case SequenceStateFormat::BINARY_COMPRESSED:
+		return writeBinary(changes, true);
+	default:
+		return writeJSON(changes);
+	}
+}
+
+SequenceFrameState::Changes SequenceFrameState::getChanges(
+	const SequenceFrameState &previous) const
+{
+	Changes changes;
+	for (int i = 0; i < N_PROPERTIES; ++i)
+	{
+		const auto &previousValues = previous.values[i];
+		for (const auto &entry : values[i])
+		{
+			auto it = previousValues.find(entry.first);
+			if (it == previousValues.end() || it->second != entry.second)
+				changes.values[i][entry.second].push_back(entry.first);
+		}
+
+		for (const auto &entry : previousValues)
+		{
+			if (values[i].find(entry.first) == values[i].end())
+				changes.resets[i].push_back(entry.first);
+		}
+
+		for (const auto &id : resets[i])
+		{
+			if (previousValues.find(id) == previousValues.end())
+				changes.resets[i].push_back(id);
+		}
+	}
+
+	if (hasCam && (!previous.hasCam || !cameraEquals(camera, previous.camera)))
+		changes.camera = CameraChange::SET;
+	else if (!hasCam && (previous.hasCam || camReset))
+		changes.camera = CameraChange::RESET;
+	else
+		changes.camera = CameraChange::NONE;
+
+	return changes;
+}
+
+std::vector<uint8_t> SequenceFrameState::writeJSON(const Changes &changes) const
+{
+	repo::lib::PropertyTree bufferTree, resetTree;
+	bool hasChanges = false, hasResets = false;
+
+	for (int i = 0; i < N_PROPERTIES; ++i)
+	{
+		if (changes.values[i].size())
+		{
+			std::vector<repo::lib::PropertyTree> states;
+			states.reserve(changes.values[i].size());
+			for (const auto &entry : changes.values[i])
+			{
+				repo::lib::PropertyTree stateTree;
+				addValueToTree(stateTree, (Property)i, entry.first);
+				stateTree.addToTree(SEQ_CACHE_LABEL_SHARED_IDS, entry.second);
+				states.push_back(stateTree);
+			}
+			bufferTree.addArrayObjects(PROPERTY_LABELS[i], states);
+			hasChanges = true;
+		}
+
+		if (changes.resets[i].size())
+		{
+			resetTree.addToTree(PROPERTY_LABELS[i], changes.resets[i]);
+			hasResets = true;
+		}
+	}
+
+	if (changes.camera == CameraChange::SET)
+	{
+		repo::lib::PropertyTree camTree;
+		camTree.addToTree(SEQ_CACHE_LABEL_POSITION, camera.position);
+		camTree.addToTree(SEQ_CACHE_LABEL_FORWARD, camera.forward);
+		camTree.addToTree(SEQ_CACHE_LABEL_UP, camera.up);
+		camTree.addToTree(SEQ_CACHE_LABEL_PERSPECTIVE, camera.isPerspective ? "true" : "false");
+		camTree.addToTree(SEQ_CACHE_LABEL_FOV, camera.fov);
+		bufferTree.mergeSubTree(SEQ_CACHE_LABEL_CAMERA, camTree);
+		hasChanges = true;
+	}
+	else if (changes.camera == CameraChange::RESET)
+	{
+		resetTree.addToTree(SEQ_CACHE_LABEL_CAMERA, "true");
+		hasResets = true;
+	}
+
+	if (hasResets)
+		bufferTree.mergeSubTree(SEQ_CACHE_LABEL_RESET, resetTree);
+	else if (!hasChanges)
+		//An empty property tree would be written out as an empty string
+		return { '{', '}' };
+
+	return bufferTree.writeJsonToBuffer();
+}
+
+std::vector<uint8_t> SequenceFrameState::writeBinary(
+	const Changes &changes,
+	const bool    &compress) const
+{
+	std::vector<uint8_t> payload;
+
+	//Table of all the shared ids referenced, so each is written once in binary form
+	std::unordered_map<std::string, uint32_t> idToIndex;
+	std::vector<uint32_t> indices;
+	auto getIndex = [&](const std::string &id) {
+		auto it = idToIndex.find(id);
+		if (it == idToIndex.end())
+			it = idToIndex.insert({ id, (uint32_t)idToIndex.size() }).first;
+		return it->second;
+	};
+
+	std::vector<uint8_t> body;
+	for (int i = 0; i < N_PROPERTIES; ++i)
+	{
+		writeToBuffer(body, (uint32_t)changes.values[i].size());
+		for (const auto &entry : changes.values[i])
+		{
+			writeValue(body, (Property)i, entry.first);
+			writeToBuffer(body, (uint32_t)entry.second.size());
+			for (const auto &id : entry.second)
+				writeToBuffer(body, getIndex(id));
+		}
+
+		writeToBuffer(body, (uint32_t)changes.resets[i].size());
+		for (const auto &id : changes.resets[i])
+			writeToBuffer(body, getIndex(id));
+	}
+
+	writeToBuffer(body, (uint8_t)changes.camera);
+	if (changes.camera == CameraChange::SET)
+	{
+		writeToBuffer(body, camera.position.x);
+		writeToBuffer(body, camera.position.y);
+		writeToBuffer(body, camera.position.z);
+		writeToBuffer(body, camera.forward.x);
+		writeToBuffer(body, camera.forward.y);
+		writeToBuffer(body, camera.forward.z);
+		writeToBuffer(body, camera.up.x);
+		writeToBuffer(body, camera.up.y);
+		writeToBuffer(body, camera.up.z);
+		writeToBuffer(body, camera.fov);
+		writeToBuffer(body, (uint8_t)camera.isPerspective);
+	}
+
+	std::vector<std::string> ids(idToIndex.size());
+	for (const auto &entry : idToIndex)
+		ids[entry.second] = entry.first;
+
+	payload.reserve(sizeof(uint32_t) + ids.size() * 16 + body.size());
+	writeToBuffer(payload, (uint32_t)ids.size());
+	for (const auto &id : ids)
+	{
+		repo::lib::RepoUUID uuid(id);
+		const auto &data = uuid.getInternalID().data;
+		payload.insert(payload.end(), std::begin(data), std::end(data));
+	}
+	payload.insert(payload.end(), body.begin(), body.end());
+
+	std::vector<uint8_t> buffer(BINARY_MAGIC, BINARY_MAGIC + sizeof(BINARY_MAGIC));
+	writeToBuffer(buffer, BINARY_VERSION);
+#if !defined(REPO_BOOST_NO_GZIP)
+	if (compress)
+	{
+		writeToBuffer(buffer, BINARY_FLAG_COMPRESSED);
+		writeToBuffer(buffer, (uint16_t)0);
+		writeToBuffer(buffer, (uint32_t)payload.size());
+
+		boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
+		out.push(boost::iostreams::zlib_compressor());
+		out.push(boost::iostreams::array_source((const char*)payload.data(), payload.size()));
+		buffer.insert(buffer.end(), std::istreambuf_iterator<char>(&out), std::istreambuf_iterator<char>());
+		return buffer;
+	}
+#else
+	if (compress)
+		repoWarning << "zlib is not compiled into Boost, writing uncompressed sequence state";
+#endif
+	writeToBuffer(buffer, (uint8_t)0);
+	writeToBuffer(buffer, (uint16_t)0);
+	buffer.insert(buffer.end(), payload.begin(), payload.end());
+
+	return buffer;
+}
+
+bool SequenceFrameState::applyDelta(const std::vector<uint8_t> &buffer)
+{
+	if (buffer.size() >= sizeof(BINARY_MAGIC) && std::equal(BINARY_MAGIC, BINARY_MAGIC + sizeof(BINARY_MAGIC), buffer.begin()))
+		return readBinary(buffer);
+	else
+		return readJSON(buffer);
+}
+
+bool SequenceFrameState::readBinary(const std::vector<uint8_t> &buffer)
+{
+	BufferReader header(buffer.data(), buffer.size());
+	header.skip(sizeof(BINARY_MAGIC));
+	uint8_t version, flags;
+	uint16_t reserved;
+	if (!header.read(version) || !header.read(flags) || !header.read(reserved) || version != BINARY_VERSION)
+	{
+		repoError << "Failed to parse sequence frame state: unsupported binary header";
+		return false;
+	}
+
+	std::vector<uint8_t> decompressed;
+	BufferReader reader = header;
+	if (flags & BINARY_FLAG_COMPRESSED)
+	{
+#if !defined(REPO_BOOST_NO_GZIP)
+		uint32_t payloadSize;
+		if (!header.read(payloadSize))
+		{
+			repoError << "Failed to parse sequence frame state: truncated header";
+			return false;
+		}
+
+		try {
+			boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+			in.push(boost::iostreams::zlib_decompressor());
+			in.push(boost::iostreams::array_source((const char*)header.current(), header.remaining()));
+			decompressed.reserve(payloadSize);
+			decompressed.insert(decompressed.end(), std::istreambuf_iterator<char>(&in), std::istreambuf_iterator<char>());
+		}
+		catch (const std::exception &e)
+		{
+			repoError << "Failed to parse sequence frame state: " << e.what();
+			return false;
+		}
+
+		if (decompressed.size() != payloadSize)
+		{
+			repoError << "Failed to parse sequence frame state: payload size mismatch";
+			return false;
+		}
+		reader = BufferReader(decompressed.data(), decompressed.size());
+#else
+		repoError << "Failed to parse sequence frame state: zlib is not compiled into Boost";
+		return false;
+#endif
+	}
+
+	uint32_t nIds;
+	if (!reader.read(nIds) || reader.remaining() / 16 < nIds)
+	{
+		repoError << "Failed to parse sequence frame state: truncated id table";
+		return false;
+	}
+
+	std::vector<std::string> ids;
+	ids.reserve(nIds);
+	for (uint32_t i = 0; i < nIds; ++i)
+	{
+		boost::uuids::uuid uuid;
+		reader.read(uuid.data, sizeof(uuid.data));
+		ids.push_back(repo::lib::RepoUUID(uuid).toString());
+	}
+
+	//Parse into a copy, so a malformed buffer leaves this state untouched
+	auto result = *this;
+	auto readId = [&](std::string &id) {
+		uint32_t index;
+		if (!reader.read(index) || index >= ids.size())
+			return false;
+		id = ids[index];
+		return true;
+	};
+
+	for (int i = 0; i < N_PROPERTIES; ++i)
+	{
+		uint32_t nValues;
+		if (!reader.read(nValues))
+		{
+			repoError << "Failed to parse sequence frame state: truncated " << PROPERTY_LABELS[i] << " values";
+			return false;
+		}
+
+		for (uint32_t j = 0; j < nValues; ++j)
+		{
+			std::vector<double> value;
+			uint32_t count;
+			if (!readValue(reader, (Property)i, value) || !reader.read(count))
+			{
+				repoError << "Failed to parse sequence frame state: malformed " << PROPERTY_LABELS[i] << " value";
+				return false;
+			}
+
+			std::string id;
+			for (uint32_t k = 0; k < count; ++k)
+			{
+				if (!readId(id))
+				{
+					repoError << "Failed to parse sequence frame state: invalid shared id index";
+					return false;
+				}
+				result.values[i][id] = value;
+			}
+		}
+
+		uint32_t nResets;
+		if (!reader.read(nResets))
+		{
+			repoError << "Failed to parse sequence frame state: truncated " << PROPERTY_LABELS[i] << " resets";
+			return false;
+		}
+
+		std::string id;
+		for (uint32_t j = 0; j < nResets; ++j)
+		{
+			if (!readId(id))
+			{
+				repoError << "Failed to parse sequence frame state: invalid shared id index";
+				return false;
+			}
+			result.values[i].erase(id);
+		}
+	}
+
+	uint8_t cameraChange;
+	if (!reader.read(cameraChange))
+	{
+		repoError << "Failed to parse sequence frame state: truncated camera";
+		return false;
+	}
+
+	if (cameraChange == (uint8_t)CameraChange::SET)
+	{
+		uint8_t isPerspective;
+		auto &cam = result.camera;
+		if (!reader.read(cam.position.x) || !reader.read(cam.position.y) || !reader.read(cam.position.z)
+			|| !reader.read(cam.forward.x) || !reader.read(cam.forward.y) || !reader.read(cam.forward.z)
+			|| !reader.read(cam.up.x) || !reader.read(cam.up.y) || !reader.read(cam.up.z)
+			|| !reader.read(cam.fov) || !reader.read(isPerspective))
+		{
+			repoError << "Failed to parse sequence frame state: truncated camera";
+			return false;
+		}
+		cam.isPerspective = isPerspective;
+		result.hasCam = true;
+	}
+	else if (cameraChange == (uint8_t)CameraChange::RESET)
+	{
+		result.hasCam = false;
+	}
+
+	*this = std::move(result);
+	return true;
+}
+
+bool SequenceFrameState::readJSON(const std::vector<uint8_t> &buffer)
+{
+	try {
+		boost::property_tree::ptree tree;
+		std::stringstream ss(std::string(buffer.begin(), buffer.end()));
+		read_json(ss, tree);
+
+		//Parse into a copy, so a malformed buffer leaves this state untouched
+		auto result = *this;
+
+		auto resetTree = tree.get_child_optional(SEQ_CACHE_LABEL_RESET);
+		if (resetTree)
+		{
+			for (int i = 0; i < N_PROPERTIES; ++i)
+			{
+				auto ids = resetTree->get_child_optional(PROPERTY_LABELS[i]);
+				if (!ids) continue;
+				for (const auto &id : *ids)
+					result.values[i].erase(id.second.data());
+			}
+
+			if (resetTree->get_child_optional(SEQ_CACHE_LABEL_CAMERA))
+				result.hasCam = false;
+		}
+
+		for (int i = 0; i < N_PROPERTIES; ++i)
+		{
+			auto states = tree.get_child_optional(PROPERTY_LABELS[i]);
+			if (!states) continue;
+			for (const auto &state : *states)
+			{
+				std::vector<double> value;
+				if (!parseValue((Property)i, state.second.get_child(SEQ_CACHE_LABEL_VALUE), value))
+				{
+					repoError << "Failed to parse sequence frame state: malformed " << PROPERTY_LABELS[i] << " value";
+					return false;
+				}
+
+				for (const auto &id : state.second.get_child(SEQ_CACHE_LABEL_SHARED_IDS))
+					result.values[i][id.second.data()] = value;
+			}
+		}
+
+		auto camTree = tree.get_child_optional(SEQ_CACHE_LABEL_CAMERA);
+		if (camTree)
+		{
+			std::vector<double> position, forward, up;
+			if (!parseVectorString(camTree->get<std::string>(SEQ_CACHE_LABEL_POSITION), position)
+				|| !parseVectorString(camTree->get<std::string>(SEQ_CACHE_LABEL_FORWARD), forward)
+				|| !parseVectorString(camTree->get<std::string>(SEQ_CACHE_LABEL_UP), up))
+			{
+				repoError << "Failed to parse sequence frame state: malformed camera";
+				return false;
+			}
+
+			result.camera.position = repo::lib::RepoVector3D64(position);
+			result.camera.forward = repo::lib::RepoVector3D(forward[0], forward[1], forward[2]);
+			result.camera.up = repo::lib::RepoVector3D(up[0], up[1], up[2]);
+			result.camera.fov = camTree->get<float>(SEQ_CACHE_LABEL_FOV);
+			result.camera.isPerspective = camTree->get<std::string>(SEQ_CACHE_LABEL_PERSPECTIVE) == "true";
+			result.hasCam = true;
+		}
+
+		*this = std::move(result);
+	}
+	catch (const std::exception &e)
+	{
+		repoError << "Failed to parse sequence frame state: " << e.what();
+		return false;
+	}
+
+	return true;
+}
+
+bool SequenceFrameState::deserialise(
+	const std::vector<uint8_t> &buffer,
+	SequenceFrameState         &state)
+{
+	state = SequenceFrameState();
+	return state.applyDelta(buffer);
+}
+
+bool SequenceFrameState::reconstruct(
+	const std::vector<uint8_t>              &keyFrame,
+	const std::vector<std::vector<uint8_t>> &deltas,
+	SequenceFrameState                      &state)
+{
+	if (!deserialise(keyFrame, state))
+		return false;
+
+	for (const auto &delta : deltas)
+	{
+		if (!state.applyDelta(delta))
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,225 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+* Animation state of a sequence frame, as stored in the sequence cache.
+* A frame is either stored in full (a key frame), or as the changes since the
+* previous frame (a delta frame). The reconstruction functions allow readers
+* of the cache to recover the full state of any frame.
+*
+* States are written either in JSON or in a packed binary format:
+*   header:  "RSFS", uint8 version, uint8 flags (bit 0: compressed), uint16 reserved
+*            followed by the uint32 size of the uncompressed payload if compressed.
+*   payload: uint32 number of shared ids, followed by the 16 byte ids.
+*            For each property (transparency, colour, transformation, clip):
+*              uint32 number of values, each followed by uint32 count and
+*              uint32 indices into the id table of the nodes taking the value,
+*              uint32 number of resets followed by their indices.
+*            uint8 camera (0: unchanged, 1: set, 2: reset); if set, float64[3]
+*            position, float32[3] forward, float32[3] up, float32 fov, uint8 perspective.
+*   values:  transparency float32, colour uint8 RGBA, transformation float32[16]
+*            (row major), clip float32[6] (position, direction).
+* All values are little endian.
+*/
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../lib/datastructure/repo_vector.h"
+#include "repo_model_import_config.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelconvertor {
+			class SequenceFrameState
+			{
+			public:
+				enum class Property { TRANSPARENCY, COLOR, TRANSFORMATION, CLIP };
+
+				struct Camera {
+					repo::lib::RepoVector3D64 position;
+					repo::lib::RepoVector3D forward;
+					repo::lib::RepoVector3D up;
+					float fov;
+					bool isPerspective;
+				};
+
+				SequenceFrameState() : hasCam(false), camReset(false) {}
+				~SequenceFrameState() {}
+
+				/**
+				* Set the value of a property for a given shared id
+				* Transparency takes 1 value, colour 3 (rgb), transformation 16
+				* (row major matrix) and clip 6 (position followed by direction)
+				* @param property property to set
+				* @param sharedId shared id (in string form) of the node
+				* @param value value of the property
+				*/
+				void setValue(
+					const Property            &property,
+					const std::string         &sharedId,
+					const std::vector<double> &value)
+				{
+					values[(int)property][sharedId] = value;
+					resets[(int)property].erase(sharedId);
+				}
+
+				/**
+				* Unset a property for a given shared id, and record it as reset
+				* so serialising this state writes the reset. This allows callers
+				* that track their own changes to build a delta frame directly,
+				* without keeping the full state of the previous frame
+				* @param property property to reset
+				* @param sharedId shared id (in string form) of the node
+				*/
+				void resetValue(
+					const Property    &property,
+					const std::string &sharedId)
+				{
+					values[(int)property].erase(sharedId);
+					resets[(int)property].insert(sharedId);
+				}
+
+				/**
+				* Get the value of a property for a given shared id
+				* @return returns the value, or nullptr if it is not set
+				*/
+				const std::vector<double>* getValue(
+					const Property    &property,
+					const std::string &sharedId) const;
+
+				/**
+				* Get the number of nodes with a value set for the property
+				*/
+				size_t size(const Property &property) const
+				{
+					return values[(int)property].size();
+				}
+
+				void setCamera(const Camera &cam)
+				{
+					camera = cam;
+					hasCam = true;
+					camReset = false;
+				}
+
+				/**
+				* Unset the camera and record it as reset, see resetValue()
+				*/
+				void resetCamera()
+				{
+					hasCam = false;
+					camReset = true;
+				}
+
+				bool hasCamera() const { return hasCam; }
+
+				const Camera& getCamera() const { return camera; }
+
+				/**
+				* Serialise the full state of the frame
+				* In binary formats, shared ids must be UUIDs in string form
+				* @param format encoding to use
+				* @return returns the serialised state
+				*/
+				std::vector<uint8_t> serialise(
+					const SequenceStateFormat &format = SequenceStateFormat::JSON) const;
+
+				/**
+				* Serialise the changes between the given frame and this one.
+				* On top of the properties that changed, the delta lists under
+				* "reset" the nodes for which a property is no longer set, along
+				* with those explicitly reset on this state.
+				* @param previous state of the previous frame
+				* @param format encoding to use
+				* @return returns the serialised delta
+				*/
+				std::vector<uint8_t> serialiseDelta(
+					const SequenceFrameState  &previous,
+					const SequenceStateFormat &format = SequenceStateFormat::JSON) const;
+
+				/**
+				* Apply a serialised delta (or key frame) on top of this state
+				* The encoding is detected from the buffer
+				* @param buffer serialised delta
+				* @return returns true upon success
+				*/
+				bool applyDelta(const std::vector<uint8_t> &buffer);
+
+				/**
+				* Parse a serialised key frame
+				* @param buffer serialised key frame
+				* @param state state to populate
+				* @return returns true upon success
+				*/
+				static bool deserialise(
+					const std::vector<uint8_t> &buffer,
+					SequenceFrameState         &state);
+
+				/**
+				* Reconstruct the state of a frame from the key frame preceding
+				* it and the deltas of all frames up to and including it
+				* @param keyFrame serialised key frame
+				* @param deltas serialised deltas, in frame order
+				* @param state state to populate
+				* @return returns true upon success
+				*/
+				static bool reconstruct(
+					const std::vector<uint8_t>              &keyFrame,
+					const std::vector<std::vector<uint8_t>> &deltas,
+					SequenceFrameState                      &state);
+
+			private:
+				static const int N_PROPERTIES = 4;
+
+				enum class CameraChange { NONE, SET, RESET };
+
+				/**
+				* Differences between two frames, with the changed
+				* values grouped so each value is only written once
+				*/
+				struct Changes {
+					std::map<std::vector<double>, std::vector<std::string>> values[N_PROPERTIES];
+					std::vector<std::string> resets[N_PROPERTIES];
+					CameraChange camera;
+				};
+
+				Changes getChanges(const SequenceFrameState &previous) const;
+
+				std::vector<uint8_t> writeJSON(const Changes &changes) const;
+
+				std::vector<uint8_t> writeBinary(
+					const Changes &changes,
+					const bool    &compress) const;
+
+				bool readJSON(const std::vector<uint8_t> &buffer);
+
+				bool readBinary(const std::vector<uint8_t> &buffer);
+
+				std::unordered_map<std::string, std::vector<double>> values[N_PROPERTIES];
+				std::set<std::string> resets[N_PROPERTIES];
+				Camera camera;
+				bool hasCam;
+				bool camReset;
+			};
+		} //namespace modelconvertor
+	} //namespace manipulator
+} //namespace repo
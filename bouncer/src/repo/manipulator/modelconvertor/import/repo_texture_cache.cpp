@@ -0,0 +1,175 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_texture_cache.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "../../../core/model/bson/repo_bson_factory.h"
+#include "../../../lib/repo_log.h"
+
+using namespace repo::manipulator::modelconvertor;
+
+//Textures read from files are not decoded, so their dimensions are unknown.
+//They keep the placeholder dimensions texture nodes of files have always had.
+static const uint32_t FILE_TEXTURE_WIDTH = 1;
+static const uint32_t FILE_TEXTURE_HEIGHT = 0;
+
+static uint64_t hashContent(const uint8_t *data, const size_t &size)
+{
+	//64 bit FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+bool TextureCache::findTexture(
+	const uint64_t &hash,
+	const uint8_t  *data,
+	const size_t   &byteCount,
+	const uint32_t &width,
+	const uint32_t &height,
+	TextureId      &id) const
+{
+	auto range = hashToTexture.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		const auto &cached = textures[it->second];
+		if (cached.data.size() == byteCount
+			&& cached.width == width && cached.height == height
+			&& (!byteCount || !memcmp(cached.data.data(), data, byteCount)))
+		{
+			id = it->second;
+			return true;
+		}
+	}
+	return false;
+}
+
+TextureCache::TextureId TextureCache::insertTexture(
+	const uint64_t         &hash,
+	const std::string      &name,
+	std::vector<uint8_t>  &&data,
+	const uint32_t         &width,
+	const uint32_t         &height)
+{
+	TextureId id = textures.size();
+	textures.push_back({ name, std::move(data), width, height, {} });
+	hashToTexture.insert({ hash, id });
+	return id;
+}
+
+TextureCache::TextureId TextureCache::addTexture(
+	const std::string &name,
+	const char        *data,
+	const uint32_t    &byteCount,
+	const uint32_t    &width,
+	const uint32_t    &height)
+{
+	const uint32_t size = data ? byteCount : 0;
+	auto hash = hashContent((const uint8_t*)data, size);
+	TextureId id;
+	if (findTexture(hash, (const uint8_t*)data, size, width, height, id))
+	{
+		repoTrace << "Texture " << name << " is identical to " << textures[id].name << ", reusing it";
+		return id;
+	}
+
+	//Not seen before, only now take a copy of the data
+	return insertTexture(hash, name, std::vector<uint8_t>((const uint8_t*)data, (const uint8_t*)data + size), width, height);
+}
+
+bool TextureCache::addTextureFile(
+	const std::string &name,
+	const std::string &filePath,
+	TextureId         &id)
+{
+	auto fileIt = fileToTexture.find(filePath);
+	if (fileIt != fileToTexture.end())
+	{
+		id = fileIt->second;
+		return true;
+	}
+
+	std::ifstream file(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	//Read straight into the buffer the texture node will own
+	std::vector<uint8_t> buffer(file.tellg());
+	file.seekg(0, std::ios::beg);
+	file.read((char*)buffer.data(), buffer.size());
+	file.close();
+
+	const uint32_t size = buffer.size();
+	auto hash = hashContent(buffer.data(), size);
+	if (findTexture(hash, buffer.data(), size, FILE_TEXTURE_WIDTH, FILE_TEXTURE_HEIGHT, id))
+	{
+		repoTrace << "Texture " << filePath << " is identical to " << textures[id].name << ", reusing it";
+	}
+	else
+	{
+		id = insertTexture(hash, name, std::move(buffer), FILE_TEXTURE_WIDTH, FILE_TEXTURE_HEIGHT);
+	}
+	fileToTexture[filePath] = id;
+	return true;
+}
+
+void TextureCache::addParent(
+	const TextureId           &id,
+	const repo::lib::RepoUUID &parent)
+{
+	if (id < textures.size())
+		textures[id].parents.push_back(parent);
+}
+
+void TextureCache::addParents(
+	const TextureId                        &id,
+	const std::vector<repo::lib::RepoUUID> &parents)
+{
+	if (id < textures.size())
+		textures[id].parents.insert(textures[id].parents.end(), parents.begin(), parents.end());
+}
+
+repo::core::model::RepoNodeSet TextureCache::createTextureNodes(
+	const bool &skipUnreferenced)
+{
+	repo::core::model::RepoNodeSet nodes;
+	for (auto &texture : textures)
+	{
+		if (skipUnreferenced && texture.parents.empty())
+			continue;
+
+		nodes.insert(new repo::core::model::TextureNode(repo::core::model::RepoBSONFactory::makeTextureNode(
+			texture.name,
+			std::move(texture.data),
+			texture.width,
+			texture.height,
+			texture.parents)));
+		texture.data.clear();
+	}
+
+	repoInfo << "Created " << nodes.size() << " distinct texture nodes";
+	return nodes;
+}
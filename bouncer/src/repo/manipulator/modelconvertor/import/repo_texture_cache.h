@@ -0,0 +1,154 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Texture cache shared by the importers.
+* Textures are identified by their content, so a texture referenced by many
+* materials (or by many names) is read and stored once, and produces a single
+* texture node parented to all of the materials using it.
+*/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../core/model/collection/repo_scene.h"
+#include "../../../lib/datastructure/repo_uuid.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelconvertor {
+			class TextureCache
+			{
+			public:
+				typedef uint32_t TextureId;
+
+				TextureCache() {}
+				~TextureCache() {}
+
+				/**
+				* Add a texture from memory. The data is only copied if no
+				* texture with identical content has been added before.
+				* @param name name of the texture, with extension to indicate file format
+				* @param data image data
+				* @param byteCount size of the image data in bytes
+				* @param width width of the texture
+				* @param height height of the texture
+				* @return returns the id of the texture within the cache
+				*/
+				TextureId addTexture(
+					const std::string &name,
+					const char        *data,
+					const uint32_t    &byteCount,
+					const uint32_t    &width,
+					const uint32_t    &height);
+
+				/**
+				* Add a texture from a file. Each file is only read once,
+				* subsequent calls with the same path return the same id.
+				* The image is not decoded, so the texture is stored with a
+				* placeholder width of 1 and height of 0.
+				* @param name name of the texture, with extension to indicate file format
+				* @param filePath path to the image file
+				* @param id returns the id of the texture within the cache
+				* @return returns true upon success, false if the file cannot be read
+				*/
+				bool addTextureFile(
+					const std::string &name,
+					const std::string &filePath,
+					TextureId         &id);
+
+				/**
+				* Add a parent to the texture node that will be generated for
+				* the given texture
+				* @param id id of the texture
+				* @param parent shared id of the parent (usually a material)
+				*/
+				void addParent(
+					const TextureId           &id,
+					const repo::lib::RepoUUID &parent);
+
+				/**
+				* Add parents to the texture node that will be generated for
+				* the given texture
+				* @param id id of the texture
+				* @param parents shared ids of the parents
+				*/
+				void addParents(
+					const TextureId                        &id,
+					const std::vector<repo::lib::RepoUUID> &parents);
+
+				/**
+				* Get the number of distinct textures within the cache
+				* @return returns the number of distinct textures
+				*/
+				size_t getNumUniqueTextures() const
+				{
+					return textures.size();
+				}
+
+				/**
+				* Create one texture node per distinct texture, with all its parents.
+				* The image data is handed over to the nodes, so this should only
+				* be called once all textures and parents have been added.
+				* @param skipUnreferenced do not create nodes for textures without parents
+				* @return returns a set of texture nodes, owned by the caller
+				*/
+				repo::core::model::RepoNodeSet createTextureNodes(
+					const bool &skipUnreferenced = false);
+
+			private:
+				struct CachedTexture {
+					std::string name;
+					std::vector<uint8_t> data;
+					uint32_t width;
+					uint32_t height;
+					std::vector<repo::lib::RepoUUID> parents;
+				};
+
+				/**
+				* Find a texture with identical content and dimensions
+				* @return returns true if one is found, with its id in id
+				*/
+				bool findTexture(
+					const uint64_t &hash,
+					const uint8_t  *data,
+					const size_t   &byteCount,
+					const uint32_t &width,
+					const uint32_t &height,
+					TextureId      &id) const;
+
+				/**
+				* Add a new texture to the cache
+				* @return returns the id of the new texture
+				*/
+				TextureId insertTexture(
+					const uint64_t         &hash,
+					const std::string      &name,
+					std::vector<uint8_t>  &&data,
+					const uint32_t         &width,
+					const uint32_t         &height);
+
+				std::vector<CachedTexture> textures;
+				std::unordered_multimap<uint64_t, TextureId> hashToTexture;
+				std::unordered_map<std::string, TextureId> fileToTexture;
+			};
+		} //namespace modelconvertor
+	} //namespace manipulator
+} //namespace repo
@@ -0,0 +1,201 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_vertex_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace repo::manipulator::modelconvertor;
+
+static const uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+static const size_t MIN_SLOTS = 64;
+
+/**
+* Bit pattern of a double. Adding 0 turns -0 into +0, so the two compare equal
+* as they would with ==.
+*/
+static uint64_t doubleBits(const double &value)
+{
+	double v = value + 0.0;
+	uint64_t bits;
+	std::memcpy(&bits, &v, sizeof(bits));
+	return bits;
+}
+
+static uint64_t floatBits(const float &value)
+{
+	float v = value + 0.0f;
+	uint32_t bits;
+	std::memcpy(&bits, &v, sizeof(bits));
+	return bits;
+}
+
+VertexMap::VertexMap(const double &tolerance) :
+	tolerance(tolerance > 0 ? tolerance : 0),
+	invTolerance(tolerance > 0 ? 1.0 / tolerance : 0)
+{
+}
+
+bool VertexMap::Key::operator==(const Key &other) const
+{
+	return count == other.count && !std::memcmp(words, other.words, count * sizeof(words[0]));
+}
+
+void VertexMap::makeKey(
+	Key &key,
+	const repo::lib::RepoVector3D64 &position,
+	const repo::lib::RepoVector3D64 *normal,
+	const repo::lib::RepoVector2D *uv) const
+{
+	if (tolerance > 0) {
+		key.words[0] = (uint64_t)std::llround(position.x * invTolerance);
+		key.words[1] = (uint64_t)std::llround(position.y * invTolerance);
+		key.words[2] = (uint64_t)std::llround(position.z * invTolerance);
+	}
+	else {
+		key.words[0] = doubleBits(position.x);
+		key.words[1] = doubleBits(position.y);
+		key.words[2] = doubleBits(position.z);
+	}
+	key.count = 3;
+
+	if (normal) {
+		key.words[key.count++] = doubleBits(normal->x);
+		key.words[key.count++] = doubleBits(normal->y);
+		key.words[key.count++] = doubleBits(normal->z);
+	}
+
+	if (uv) {
+		key.words[key.count++] = floatBits(uv->x);
+		key.words[key.count++] = floatBits(uv->y);
+	}
+}
+
+uint64_t VertexMap::hashKey(const Key &key)
+{
+	uint64_t hash = key.count;
+	for (uint32_t i = 0; i < key.count; ++i) {
+		hash = (hash ^ key.words[i]) * 0x9E3779B97F4A7C15ull;
+		hash ^= hash >> 29;
+	}
+
+	//Finaliser of MurmurHash3, so the low bits used to pick a slot depend on all the input
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+void VertexMap::reserve(const size_t &nVertices)
+{
+	if (nVertices > vertices.capacity()) {
+		auto capacity = std::max(nVertices, vertices.capacity() * 2);
+		vertices.reserve(capacity);
+		hashes.reserve(capacity);
+		if (normals.size())
+			normals.reserve(capacity);
+		if (uvs.size())
+			uvs.reserve(capacity);
+	}
+
+	//Keep the table at most half full
+	if (nVertices * 2 > slots.size()) {
+		size_t nSlots = std::max(MIN_SLOTS, slots.size());
+		while (nSlots < nVertices * 2)
+			nSlots *= 2;
+		rehash(nSlots);
+	}
+}
+
+void VertexMap::rehash(const size_t &nSlots)
+{
+	slots.assign(nSlots, EMPTY_SLOT);
+	const size_t mask = nSlots - 1;
+	for (uint32_t i = 0; i < hashes.size(); ++i) {
+		auto slot = hashes[i] & mask;
+		while (slots[slot] != EMPTY_SLOT)
+			slot = (slot + 1) & mask;
+		slots[slot] = i;
+	}
+}
+
+VertexMap::result_t VertexMap::findOrInsert(
+	const repo::lib::RepoVector3D64 &position,
+	const repo::lib::RepoVector3D64 *normal,
+	const repo::lib::RepoVector2D *uv)
+{
+	if ((vertices.size() + 1) * 2 > slots.size())
+		rehash(std::max(MIN_SLOTS, slots.size() * 2));
+
+	Key key;
+	makeKey(key, position, normal, uv);
+	const auto hash = hashKey(key);
+
+	const size_t mask = slots.size() - 1;
+	auto slot = hash & mask;
+	Key existing;
+	while (slots[slot] != EMPTY_SLOT)
+	{
+		auto idx = slots[slot];
+		if (hashes[idx] == hash)
+		{
+			makeKey(existing, vertices[idx], normal ? &normals[idx] : nullptr, uv ? &uvs[idx] : nullptr);
+			if (existing == key)
+			{
+				return { false, idx };
+			}
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	uint32_t idx = vertices.size();
+	slots[slot] = idx;
+	hashes.push_back(hash);
+
+	vertices.push_back(position);
+	if (normal) {
+		if (normals.capacity() < vertices.capacity())
+			normals.reserve(vertices.capacity());
+		normals.push_back(*normal);
+	}
+	if (uv) {
+		if (uvs.capacity() < vertices.capacity())
+			uvs.reserve(vertices.capacity());
+		uvs.push_back(*uv);
+	}
+
+	return { true, idx };
+}
+
+VertexMap::result_t VertexMap::find(const repo::lib::RepoVector3D64& position)
+{
+	return findOrInsert(position, nullptr, nullptr);
+}
+
+VertexMap::result_t VertexMap::find(const repo::lib::RepoVector3D64& position, const repo::lib::RepoVector3D64& normal)
+{
+	return findOrInsert(position, &normal, nullptr);
+}
+
+VertexMap::result_t VertexMap::find(const repo::lib::RepoVector3D64& position, const repo::lib::RepoVector3D64& normal, const repo::lib::RepoVector2D& uv)
+{
+	return findOrInsert(position, &normal, &uv);
+}
@@ -0,0 +1,119 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Vertex welding for importers that receive geometry as unindexed faces.
+* Vertices are looked up in a flat open addressing hash table of indices,
+* so welding a vertex costs no allocation beyond the growth of the tables.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../../../lib/datastructure/repo_vector.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelconvertor {
+			/*
+			* Helper class for referencing existing vertices into indices. All the vertices
+			* added to one map must have the same format (i.e. always with or without normals
+			* and uvs); this is left to the caller (e.g. the format checking in GeometryCollector).
+			*/
+			class VertexMap {
+			public:
+				struct result_t
+				{
+					bool added;
+					uint32_t index;
+				};
+
+				/**
+				* @param tolerance if greater than 0, positions are quantised to a grid
+				*        of this spacing before being compared, so vertices falling into the
+				*        same cell are welded into the first one seen. Normals and uvs are
+				*        always compared exactly.
+				*/
+				VertexMap(const double &tolerance = 0.0);
+
+				std::vector<repo::lib::RepoVector3D64> vertices;
+				std::vector<repo::lib::RepoVector3D64> normals;
+				std::vector<repo::lib::RepoVector2D> uvs;
+
+				/**
+				* Hint that the map will hold at least nVertices vertices, so the vertex
+				* buffers and the table are only grown once. Unlike std::vector::reserve,
+				* capacity grows geometrically, so it is safe to call this repeatedly with
+				* slowly increasing counts.
+				* @param nVertices expected total number of vertices
+				*/
+				void reserve(const size_t &nVertices);
+
+				/**
+				* Find the index of a vertex, adding it if it does not exist yet
+				* @return returns the index of the vertex, and whether it was added
+				*/
+				result_t find(const repo::lib::RepoVector3D64& position);
+				result_t find(const repo::lib::RepoVector3D64& position, const repo::lib::RepoVector3D64& normal);
+				result_t find(const repo::lib::RepoVector3D64& position, const repo::lib::RepoVector3D64& normal, const repo::lib::RepoVector2D& uv);
+
+				double getTolerance() const
+				{
+					return tolerance;
+				}
+
+			private:
+				/**
+				* A vertex packed into words that compare equal if and only if the
+				* vertices should be welded
+				*/
+				struct Key
+				{
+					uint64_t words[8];
+					uint32_t count;
+
+					bool operator==(const Key &other) const;
+				};
+
+				void makeKey(
+					Key &key,
+					const repo::lib::RepoVector3D64 &position,
+					const repo::lib::RepoVector3D64 *normal,
+					const repo::lib::RepoVector2D *uv) const;
+
+				static uint64_t hashKey(const Key &key);
+
+				result_t findOrInsert(
+					const repo::lib::RepoVector3D64 &position,
+					const repo::lib::RepoVector3D64 *normal,
+					const repo::lib::RepoVector2D *uv);
+
+				/**
+				* Resize the table to nSlots (a power of 2) slots and re-insert all vertices
+				*/
+				void rehash(const size_t &nSlots);
+
+				double tolerance;
+				double invTolerance;
+				std::vector<uint32_t> slots; //vertex index per slot, or EMPTY_SLOT
+				std::vector<uint64_t> hashes; //hash per vertex, to avoid recomputing it on probes and rehashes
+			};
+		}
+	}
+}
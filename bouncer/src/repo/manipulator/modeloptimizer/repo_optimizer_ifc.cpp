@@ -110,6 +110,7 @@ bool IFCOptimzer::removeTransformationsWithNames(
 				}
 
 				//Remove self from parent and  patch children to parents
+				std::vector<std::pair<const repo::core::model::RepoNode*, repo::core::model::RepoNode*>> edges;
 				for (const auto &parent : parents)
 				{
 					auto parentNode = scene->getNodeBySharedID(defaultG, parent);
@@ -120,7 +121,7 @@ bool IFCOptimzer::removeTransformationsWithNames(
 						scene->abandonChild(defaultG, parent, transNode, true, false);
 						for (auto &child : children)
 						{
-							scene->addInheritance(defaultG, parentNode, child);
+							edges.push_back(std::make_pair(parentNode, child));
 						}
 					}
 					else
@@ -129,6 +130,7 @@ bool IFCOptimzer::removeTransformationsWithNames(
 						success = false;
 					}
 				}
+				scene->addInheritances(defaultG, edges);
 
 				scene->removeNode(defaultG, transSharedID);
 			}
@@ -22,6 +22,7 @@
 #include "repo_optimizer_multipart.h"
 #include "../../core/model/bson/repo_bson_factory.h"
 #include "../../core/model/bson/repo_bson_builder.h"
+#include "../../lib/repo_profiler.h"
 
 using namespace repo::manipulator::modeloptimizer;
 
@@ -41,6 +42,7 @@ MultipartOptimizer::~MultipartOptimizer()
 
 bool MultipartOptimizer::apply(repo::core::model::RepoScene *scene)
 {
+	REPO_PROFILE_SCOPE("MultipartOptimizer::apply");
 	bool success = false;
 	if (!scene)
 	{
@@ -17,16 +17,19 @@
 #include "repo_mesh_map_reorganiser.h"
 #include "../../core/model/bson/repo_bson_builder.h"
 #include "../../core/model/bson/repo_bson_factory.h"
+#include "repo_vertex_cache_optimiser.h"
 
 using namespace repo::manipulator::modelutility;
 
 MeshMapReorganiser::MeshMapReorganiser(
 	const repo::core::model::MeshNode *mesh,
 	const size_t                    &vertThreshold,
-	const size_t					&faceThreshold) :
+	const size_t					&faceThreshold,
+	const bool                      &optimiseVertexCache) :
 	mesh(mesh),
 	maxVertices(vertThreshold),
 	maxFaces(faceThreshold),
+	optimiseVertexCache(optimiseVertexCache),
 	oldFaces(mesh->getFaces()),
 	oldVertices(mesh->getVertices()),
 	oldNormals(mesh->getNormals()),
@@ -43,7 +46,12 @@ MeshMapReorganiser::MeshMapReorganiser(
 		newFaces.reserve(oldFaces.size());
 		serialisedFaces.reserve(oldFaces.size() * static_cast<int>(mesh->getPrimitive()));
 
-		if (!(reMapSuccess = performSplitting()))
+		if (fitsWithoutSplitting())
+		{
+			copyWithoutSplitting();
+			reMapSuccess = true;
+		}
+		else if (!(reMapSuccess = performSplitting()))
 		{
 			//mission failed clear up the memory
 			newVertices.clear();
@@ -57,6 +65,9 @@ MeshMapReorganiser::MeshMapReorganiser(
 			splitMap.clear();
 			idMapBuf.clear();
 		}
+
+		if (reMapSuccess && optimiseVertexCache)
+			optimiseVertexCacheOrder();
 	}
 	else
 	{
@@ -137,7 +148,11 @@ MeshMapReorganiser::getMappingsPerSubMesh() const {
 }
 
 std::vector<uint16_t> MeshMapReorganiser::getSerialisedFaces() const {
-	return reMapSuccess ? serialisedFaces : std::vector<uint16_t>();
+	return reMapSuccess ? std::vector<uint16_t>(serialisedFaces.begin(), serialisedFaces.end()) : std::vector<uint16_t>();
+}
+
+std::vector<uint32_t> MeshMapReorganiser::getSerialisedFaces32() const {
+	return reMapSuccess ? serialisedFaces : std::vector<uint32_t>();
 }
 
 std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher>
@@ -172,6 +187,129 @@ repo::core::model::MeshNode MeshMapReorganiser::getRemappedMesh() const
 	}
 }
 
+bool MeshMapReorganiser::fitsWithoutSplitting() const
+{
+	if (oldVertices.size() > maxVertices || oldFaces.size() > maxFaces)
+		return false;
+
+	size_t nVertices = 0, nFaces = 0;
+	for (const auto &mapping : mesh->getMeshMapping())
+	{
+		if (mapping.vertFrom != nVertices || mapping.triFrom != nFaces
+			|| mapping.vertTo < mapping.vertFrom || mapping.triTo < mapping.triFrom)
+			return false;
+		nVertices = mapping.vertTo;
+		nFaces = mapping.triTo;
+	}
+
+	return nVertices == oldVertices.size() && nFaces == oldFaces.size();
+}
+
+void MeshMapReorganiser::copyWithoutSplitting()
+{
+	//With the mappings back to back, performSplitting() would put every mapping
+	//into the first sub mesh at the position it already has, and leave all the
+	//indices unchanged. So the buffers can be taken as they are.
+	const std::vector<repo_mesh_mapping_t> orgMappings = mesh->getMeshMapping();
+	repoTrace << "Mesh " << mesh->getUniqueID() << " fits within a single sub mesh, skipping splitting";
+
+	std::vector<float> bboxMin;
+	std::vector<float> bboxMax;
+	reMappedMappings.resize(1);
+	startSubMesh(reMappedMappings.back(), mesh->getUniqueID(), mesh->getSharedID(), orgMappings.front().material_id, 0, 0);
+	idMapBuf.back().reserve(oldVertices.size());
+
+	size_t idMapIdx = 0;
+	for (const auto &mapping : orgMappings)
+	{
+		matMap.back().push_back(mapping);
+		updateIDMapArray(mapping.vertTo - mapping.vertFrom, idMapIdx++);
+		updateBoundingBoxes(bboxMin, bboxMax, mapping.min, mapping.max);
+		splitMap[mapping.mesh_id].push_back(0);
+	}
+
+	newFaces = oldFaces;
+	for (const auto &face : oldFaces)
+		serialisedFaces.insert(serialisedFaces.end(), face.begin(), face.end());
+
+	finishSubMesh(reMappedMappings.back(), bboxMin, bboxMax, oldVertices.size(), oldFaces.size());
+}
+
+/**
+* Move the values in [start, start + newIndices.size()) to start + newIndices[i]
+*/
+template <typename T>
+static void reorderRange(
+	std::vector<T>              &values,
+	const size_t                &start,
+	const std::vector<uint32_t> &newIndices)
+{
+	if (values.size() < start + newIndices.size())
+		return;
+
+	std::vector<T> reordered(newIndices.size());
+	for (size_t i = 0; i < newIndices.size(); ++i)
+		reordered[newIndices[i]] = values[start + i];
+	std::copy(reordered.begin(), reordered.end(), values.begin() + start);
+}
+
+void MeshMapReorganiser::optimiseVertexCacheOrder()
+{
+	if (mesh->getPrimitive() != repo::core::model::MeshNode::Primitive::TRIANGLES
+		|| serialisedFaces.size() != newFaces.size() * 3)
+		return;
+
+	std::vector<uint32_t> indices;
+	for (size_t subMeshIdx = 0; subMeshIdx < matMap.size() && subMeshIdx < reMappedMappings.size(); ++subMeshIdx)
+	{
+		//Face indices are relative to the start of the sub mesh
+		const size_t subMeshVFrom = reMappedMappings[subMeshIdx].vertFrom;
+		for (const auto &mapping : matMap[subMeshIdx])
+		{
+			const size_t nTriangles = mapping.triTo - mapping.triFrom;
+			const size_t nVertices = mapping.vertTo - mapping.vertFrom;
+			if (nTriangles < 2 || mapping.triTo > newFaces.size() || mapping.vertTo > newVertices.size())
+				continue;
+
+			//Faces of a mapping only refer to its own vertices, check it before moving them
+			const size_t base = mapping.vertFrom - subMeshVFrom;
+			bool inRange = true;
+			indices.clear();
+			for (size_t fIdx = mapping.triFrom; fIdx < mapping.triTo && inRange; ++fIdx)
+			{
+				inRange = newFaces[fIdx].size() == 3;
+				for (const auto &index : newFaces[fIdx])
+				{
+					inRange &= index >= base && index < base + nVertices;
+					indices.push_back(index - base);
+				}
+			}
+
+			if (!inRange)
+			{
+				repoWarning << "Faces of mapping " << mapping.mesh_id << " refer to vertices outside of it, skipping vertex cache optimisation";
+				continue;
+			}
+
+			VertexCacheOptimiser::optimiseTriangleOrder(indices.data(), nTriangles, nVertices);
+			auto newIndices = VertexCacheOptimiser::optimiseVertexOrder(indices.data(), indices.size(), nVertices);
+
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				const uint32_t index = indices[i] + base;
+				newFaces[mapping.triFrom + i / 3][i % 3] = index;
+				serialisedFaces[mapping.triFrom * 3 + i] = index;
+			}
+
+			reorderRange(newVertices, mapping.vertFrom, newIndices);
+			reorderRange(newNormals, mapping.vertFrom, newIndices);
+			reorderRange(newColors, mapping.vertFrom, newIndices);
+			for (auto &uvChannel : newUVs)
+				reorderRange(uvChannel, mapping.vertFrom, newIndices);
+		}
+	}
+}
+
 bool MeshMapReorganiser::performSplitting()
 {
 	std::vector<repo_mesh_mapping_t> newMappings;
@@ -30,11 +30,15 @@ namespace repo {
 				* a remapped mesh, it will return an empty meshNode.
 				* @param mesh the mesh to reorganise
 				* @param vertThreshold maximum vertices
+				* @param faceThreshold maximum faces
+				* @param optimiseVertexCache reorder the triangles and vertices of each
+				*        mapping for GPU vertex cache reuse (triangle meshes only)
 				*/
 				MeshMapReorganiser(
 					const repo::core::model::MeshNode *mesh,
 					const size_t                        &vertThreshold,
-					const size_t						&faceThreshold);
+					const size_t						&faceThreshold,
+					const bool                          &optimiseVertexCache = false);
 				~MeshMapReorganiser();
 
 				/**
@@ -56,11 +60,18 @@ namespace repo {
 				repo::core::model::MeshNode getRemappedMesh() const;
 
 				/**
-				* Return serialised faces of the modified mesh
+				* Return serialised faces of the modified mesh, as 16 bit indices.
+				* Only valid if the vertex threshold is at most 65536.
 				* @return returns a serialised buffer of faces
 				*/
 				std::vector<uint16_t> getSerialisedFaces() const;
 
+				/**
+				* Return serialised faces of the modified mesh, as 32 bit indices
+				* @return returns a serialised buffer of faces
+				*/
+				std::vector<uint32_t> getSerialisedFaces32() const;
+
 				/**
 				* Get the mapping between submeshes UUID to new super mesh index
 				* @return sub mesh to super mesh(es) mapping
@@ -103,6 +114,27 @@ namespace repo {
 				*/
 				bool performSplitting();
 
+				/**
+				* Check if the mesh fits within the thresholds as it is, with its
+				* mappings laid out back to back from the start of the buffers
+				* @return returns true if the mesh needs no splitting
+				*/
+				bool fitsWithoutSplitting() const;
+
+				/**
+				* Produce the output of performSplitting() for a mesh that fits
+				* in a single sub mesh, without reindexing any faces
+				*/
+				void copyWithoutSplitting();
+
+				/**
+				* Reorder the triangles within each mapping for vertex cache reuse,
+				* then the vertices within each mapping in order of first use.
+				* Mappings keep their ranges, so idMaps and split mappings are
+				* unaffected.
+				*/
+				void optimiseVertexCacheOrder();
+
 				/**
 				* Split a single large sub mesh that exceeds the number of
 				* vertices into multiple sub meshes
@@ -165,6 +197,7 @@ namespace repo {
 				const repo::core::model::MeshNode *mesh;
 				const size_t maxVertices;
 				const size_t maxFaces;
+				const bool optimiseVertexCache;
 				const std::vector<repo::lib::RepoVector3D> oldVertices;
 				const std::vector<repo::lib::RepoVector3D> oldNormals;
 				const std::vector<std::vector<repo::lib::RepoVector2D>> oldUVs;
@@ -177,7 +210,7 @@ namespace repo {
 				std::vector<repo_color4d_t>   newColors;
 				std::vector<std::vector<repo::lib::RepoVector2D>> newUVs;
 
-				std::vector<uint16_t> serialisedFaces;
+				std::vector<uint32_t> serialisedFaces;
 
 				std::vector<std::vector<float>> idMapBuf;
 				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMap;
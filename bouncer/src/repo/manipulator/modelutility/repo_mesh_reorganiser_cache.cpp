@@ -0,0 +1,199 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_mesh_reorganiser_cache.h"
+#include "repo_mesh_map_reorganiser.h"
+#include <algorithm>
+#include "../../lib/repo_log.h"
+#include "../../lib/repo_task_executor.h"
+
+using namespace repo::manipulator::modelutility;
+
+const size_t MeshReorganiserCache::DEFAULT_MAX_BYTES;
+const size_t MeshReorganiserCache::PREPARE_BATCH_SIZE;
+
+static boost::mutex sharedMutex;
+static MeshReorganiserCache *sharedCache = nullptr;
+
+size_t ReorganisedMesh::getSize() const
+{
+	size_t size = sizeof(*this) + remappedMesh.objsize() + serialisedFaces.size() * sizeof(uint32_t);
+	for (const auto &idMap : idMapArrays)
+		size += idMap.size() * sizeof(float);
+	for (const auto &mappings : mappingsPerSubMesh)
+		size += mappings.size() * sizeof(repo_mesh_mapping_t);
+	for (const auto &split : splitMapping)
+		size += sizeof(split) + split.second.size() * sizeof(uint32_t);
+	return size;
+}
+
+size_t MeshReorganiserCache::KeyHasher::operator()(const Key &key) const
+{
+	size_t hash = repo::lib::RepoUUIDHasher()(key.meshId);
+	hash ^= std::hash<size_t>()(key.maxVertices) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<size_t>()(key.maxFaces) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+	return key.optimiseVertexCache ? ~hash : hash;
+}
+
+MeshReorganiserCache::MeshReorganiserCache(const size_t &maxBytes) :
+	maxBytes(maxBytes),
+	nBytes(0)
+{
+}
+
+MeshReorganiserCache *MeshReorganiserCache::getShared()
+{
+	boost::mutex::scoped_lock lock(sharedMutex);
+	return sharedCache;
+}
+
+void MeshReorganiserCache::setShared(MeshReorganiserCache *cache)
+{
+	boost::mutex::scoped_lock lock(sharedMutex);
+	sharedCache = cache;
+}
+
+std::shared_ptr<const ReorganisedMesh> MeshReorganiserCache::reorganise(const Request &request)
+{
+	MeshMapReorganiser reorganiser(request.mesh, request.maxVertices, request.maxFaces, request.optimiseVertexCache);
+
+	auto result = std::make_shared<ReorganisedMesh>();
+	result->remappedMesh = reorganiser.getRemappedMesh();
+	if (!result->remappedMesh.isEmpty())
+	{
+		result->serialisedFaces = reorganiser.getSerialisedFaces32();
+		result->idMapArrays = reorganiser.getIDMapArrays();
+		result->mappingsPerSubMesh = reorganiser.getMappingsPerSubMesh();
+		result->splitMapping = reorganiser.getSplitMapping();
+	}
+	return result;
+}
+
+std::shared_ptr<const ReorganisedMesh> MeshReorganiserCache::find(const Key &key) const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto it = entries.find(key);
+	return it == entries.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const ReorganisedMesh> MeshReorganiserCache::insert(
+	const Key &key,
+	const std::shared_ptr<const ReorganisedMesh> &entry)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto it = entries.find(key);
+	if (it != entries.end())
+		return it->second;
+
+	//Entries larger than the whole cache are returned without being kept
+	auto size = entry->getSize();
+	if (size > maxBytes)
+		return entry;
+
+	while (nBytes + size > maxBytes && insertionOrder.size())
+	{
+		auto oldest = entries.find(insertionOrder.front());
+		nBytes -= oldest->second->getSize();
+		entries.erase(oldest);
+		insertionOrder.pop_front();
+	}
+
+	entries[key] = entry;
+	insertionOrder.push_back(key);
+	nBytes += size;
+	return entry;
+}
+
+std::shared_ptr<const ReorganisedMesh> MeshReorganiserCache::getReorganisedMesh(
+	const repo::core::model::MeshNode *mesh,
+	const size_t &maxVertices,
+	const size_t &maxFaces,
+	const bool &optimiseVertexCache)
+{
+	Key key = { mesh->getUniqueID(), maxVertices, maxFaces, optimiseVertexCache };
+	if (auto entry = find(key))
+		return entry;
+
+	return insert(key, reorganise({ mesh, maxVertices, maxFaces, optimiseVertexCache }));
+}
+
+std::vector<std::shared_ptr<const ReorganisedMesh>> MeshReorganiserCache::prepare(
+	const std::vector<Request> &requests,
+	const size_t &first,
+	const size_t &count)
+{
+	const size_t end = first + std::min(count, requests.size() - std::min(first, requests.size()));
+
+	std::vector<std::shared_ptr<const ReorganisedMesh>> results;
+	std::vector<size_t> missing;
+	for (size_t i = first; i < end; ++i)
+	{
+		const auto &request = requests[i];
+		results.push_back(find({ request.mesh->getUniqueID(), request.maxVertices, request.maxFaces, request.optimiseVertexCache }));
+		if (!results.back())
+			missing.push_back(i - first);
+	}
+
+	if (missing.size())
+	{
+		repoTrace << "Reorganising " << missing.size() << " meshes (" << results.size() - missing.size() << " cached)";
+		repo::lib::RepoTaskExecutor::getDefault().parallelFor(missing.size(), [&](size_t i)
+		{
+			const auto &request = requests[first + missing[i]];
+			results[missing[i]] = insert({ request.mesh->getUniqueID(), request.maxVertices, request.maxFaces, request.optimiseVertexCache }, reorganise(request));
+		});
+	}
+	return results;
+}
+
+std::shared_ptr<const ReorganisedMesh> MeshReorganiserCache::BatchReader::read(const Request &request)
+{
+	if (next < requests.size())
+	{
+		const auto &expected = requests[next];
+		if (expected.mesh == request.mesh && expected.maxVertices == request.maxVertices
+			&& expected.maxFaces == request.maxFaces && expected.optimiseVertexCache == request.optimiseVertexCache)
+		{
+			const size_t batchIdx = next++ % PREPARE_BATCH_SIZE;
+			if (!batchIdx)
+				batch = cache.prepare(requests, next - 1, PREPARE_BATCH_SIZE);
+			return std::move(batch[batchIdx]); //released by the batch once read
+		}
+	}
+
+	return cache.getReorganisedMesh(request.mesh, request.maxVertices, request.maxFaces, request.optimiseVertexCache);
+}
+
+void MeshReorganiserCache::clear()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	entries.clear();
+	insertionOrder.clear();
+	nBytes = 0;
+}
+
+size_t MeshReorganiserCache::getNumEntries() const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return entries.size();
+}
+
+size_t MeshReorganiserCache::getSize() const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return nBytes;
+}
@@ -0,0 +1,214 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Cache of mesh reorganisations shared by the web exporters.
+* SRC, glTF and Unity asset exports all split the stash meshes with
+* MeshMapReorganiser using the same limits, so a job exporting several
+* formats only needs to reorganise each mesh once.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <boost/thread.hpp>
+
+#include "../../core/model/bson/repo_node_mesh.h"
+#include "../../lib/datastructure/repo_uuid.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelutility {
+			/**
+			* Output of MeshMapReorganiser. It does not refer to the mesh it
+			* was computed from, so it may outlive the scene.
+			*/
+			struct ReorganisedMesh
+			{
+				repo::core::model::MeshNode remappedMesh; //empty if the reorganisation failed
+				std::vector<uint32_t> serialisedFaces;
+				std::vector<std::vector<float>> idMapArrays;
+				std::vector<std::vector<repo_mesh_mapping_t>> mappingsPerSubMesh;
+				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMapping;
+
+				/**
+				* Approximate memory used by the reorganisation, in bytes
+				*/
+				size_t getSize() const;
+			};
+
+			class MeshReorganiserCache
+			{
+			public:
+				struct Request
+				{
+					const repo::core::model::MeshNode *mesh;
+					size_t maxVertices;
+					size_t maxFaces;
+					bool optimiseVertexCache;
+				};
+
+				/**
+				* Create a cache
+				* @param maxBytes the oldest entries are dropped once the entries
+				*        take more than this many bytes
+				*/
+				MeshReorganiserCache(const size_t &maxBytes = DEFAULT_MAX_BYTES);
+				~MeshReorganiserCache() {}
+
+				static const size_t DEFAULT_MAX_BYTES = size_t(512) << 20;
+				static const size_t PREPARE_BATCH_SIZE = 32; //enough to keep the executor busy without holding every mesh at once
+
+				/**
+				* Get the cache registered to be shared by all exports, if any
+				* @return returns the shared cache, or nullptr
+				*/
+				static MeshReorganiserCache *getShared();
+
+				/**
+				* Register the cache returned by getShared(). The caller keeps
+				* ownership, and must unregister it (by passing nullptr) before
+				* destroying it.
+				* @param cache cache to share, nullptr to stop sharing
+				*/
+				static void setShared(MeshReorganiserCache *cache);
+
+				/**
+				* Get the reorganisation of a mesh, computing it if it is not
+				* cached. Meshes are identified by their unique ID, so a mesh
+				* must not change while it is cached.
+				* @param mesh mesh to reorganise
+				* @param maxVertices maximum vertices per sub mesh
+				* @param maxFaces maximum faces per sub mesh
+				* @param optimiseVertexCache order the faces for vertex cache reuse
+				* @return returns the reorganisation, never nullptr
+				*/
+				std::shared_ptr<const ReorganisedMesh> getReorganisedMesh(
+					const repo::core::model::MeshNode *mesh,
+					const size_t &maxVertices,
+					const size_t &maxFaces,
+					const bool &optimiseVertexCache = false);
+
+				/**
+				* Get the reorganisations of a batch of requests, computing
+				* those not cached yet in parallel. The results are returned
+				* rather than looked up again, so they cannot be dropped from
+				* the cache before the caller uses them; prepare bounded
+				* batches and use each before preparing the next.
+				* @param requests meshes and limits to reorganise
+				* @param first index of the first request of the batch
+				* @param count maximum number of requests in the batch
+				* @return returns the reorganisations of the batch, in order
+				*/
+				std::vector<std::shared_ptr<const ReorganisedMesh>> prepare(
+					const std::vector<Request> &requests,
+					const size_t &first = 0,
+					const size_t &count = PREPARE_BATCH_SIZE);
+
+				/**
+				* Hands out the reorganisations of a list of requests in order,
+				* preparing them a batch at a time, so at most one batch is held
+				* on top of what the cache keeps
+				*/
+				class BatchReader
+				{
+				public:
+					/**
+					* @param cache cache to prepare the requests with
+					* @param requests requests in the order they will be read, must
+					*        outlive the reader
+					*/
+					BatchReader(MeshReorganiserCache &cache, const std::vector<Request> &requests) :
+						cache(cache), requests(requests), next(0) {}
+
+					/**
+					* Get the reorganisation of a mesh. If it is the next request
+					* it comes from the prepared batch, otherwise it is looked up
+					* (or computed) on its own.
+					* @return returns the reorganisation, never nullptr
+					*/
+					std::shared_ptr<const ReorganisedMesh> read(const Request &request);
+
+				private:
+					MeshReorganiserCache &cache;
+					const std::vector<Request> &requests;
+					size_t next;
+					std::vector<std::shared_ptr<const ReorganisedMesh>> batch;
+				};
+
+				/**
+				* Drop all entries
+				*/
+				void clear();
+
+				size_t getNumEntries() const;
+
+				/**
+				* Get the approximate memory used by the entries, in bytes
+				*/
+				size_t getSize() const;
+
+			private:
+				struct Key
+				{
+					repo::lib::RepoUUID meshId;
+					size_t maxVertices;
+					size_t maxFaces;
+					bool optimiseVertexCache;
+
+					bool operator==(const Key &other) const
+					{
+						return meshId == other.meshId && maxVertices == other.maxVertices && maxFaces == other.maxFaces
+							&& optimiseVertexCache == other.optimiseVertexCache;
+					}
+				};
+
+				struct KeyHasher
+				{
+					size_t operator()(const Key &key) const;
+				};
+
+				/**
+				* Look up an entry
+				* @return returns the entry, or nullptr if it is not cached
+				*/
+				std::shared_ptr<const ReorganisedMesh> find(const Key &key) const;
+
+				/**
+				* Add an entry, dropping the oldest ones to stay within maxBytes.
+				* If the key is cached already the existing entry is kept.
+				* @return returns the entry cached for the key
+				*/
+				std::shared_ptr<const ReorganisedMesh> insert(
+					const Key &key,
+					const std::shared_ptr<const ReorganisedMesh> &entry);
+
+				static std::shared_ptr<const ReorganisedMesh> reorganise(const Request &request);
+
+				const size_t maxBytes;
+				size_t nBytes;
+				std::unordered_map<Key, std::shared_ptr<const ReorganisedMesh>, KeyHasher> entries;
+				std::deque<Key> insertionOrder;
+				mutable boost::mutex mutex;
+			};
+		}
+	}
+}
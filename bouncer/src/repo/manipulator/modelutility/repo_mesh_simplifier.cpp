@@ -0,0 +1,412 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_mesh_simplifier.h"
+#include "repo_vertex_cache_optimiser.h"
+#include "../../lib/repo_log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+using namespace repo::manipulator::modelutility;
+
+static const uint32_t NO_VERTEX = UINT32_MAX;
+static const size_t QUADRIC_SIZE = 10;
+
+/**
+* Add the plane n.p + d = 0 to a quadric
+*/
+static void addPlane(double *q, const double *n, const double &d)
+{
+	q[0] += n[0] * n[0]; q[1] += n[0] * n[1]; q[2] += n[0] * n[2]; q[3] += n[0] * d;
+	q[4] += n[1] * n[1]; q[5] += n[1] * n[2]; q[6] += n[1] * d;
+	q[7] += n[2] * n[2]; q[8] += n[2] * d;
+	q[9] += d * d;
+}
+
+/**
+* Sum of squared distances from a point to the planes of the sum of two quadrics
+*/
+static double evaluate(const double *a, const double *b, const repo::lib::RepoVector3D &p)
+{
+	double q[QUADRIC_SIZE];
+	for (size_t i = 0; i < QUADRIC_SIZE; ++i)
+		q[i] = a[i] + b[i];
+
+	const double x = p.x, y = p.y, z = p.z;
+	double error = x * (q[0] * x + 2 * q[1] * y + 2 * q[2] * z + 2 * q[3])
+		+ y * (q[4] * y + 2 * q[5] * z + 2 * q[6])
+		+ z * (q[7] * z + 2 * q[8])
+		+ q[9];
+	//Rounding can take it slightly below 0
+	return error > 0 ? error : 0;
+}
+
+/**
+* Unnormalised normal of a triangle
+*/
+static void triangleNormal(
+	const repo::lib::RepoVector3D &a,
+	const repo::lib::RepoVector3D &b,
+	const repo::lib::RepoVector3D &c,
+	double *n)
+{
+	const double e1[] = { (double)b.x - a.x, (double)b.y - a.y, (double)b.z - a.z };
+	const double e2[] = { (double)c.x - a.x, (double)c.y - a.y, (double)c.z - a.z };
+	n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+MeshSimplifier::MeshSimplifier(
+	const repo::lib::RepoVector3D *vertices,
+	const uint32_t                &nVertices,
+	const uint32_t                *triangles,
+	const size_t                  &nTriangles) :
+	vertices(vertices),
+	base(0),
+	nLocalVertices(0),
+	extent(0),
+	errorSquared(0)
+{
+	//Degenerate triangles would only get in the way
+	indices.reserve(nTriangles * 3);
+	size_t nInvalid = 0;
+	for (size_t i = 0; i < nTriangles * 3; i += 3)
+	{
+		const uint32_t a = triangles[i], b = triangles[i + 1], c = triangles[i + 2];
+		if (a >= nVertices || b >= nVertices || c >= nVertices)
+		{
+			++nInvalid;
+		}
+		else if (a != b && b != c && c != a)
+		{
+			indices.insert(indices.end(), { a, b, c });
+		}
+	}
+	if (nInvalid)
+	{
+		repoError << "Ignored " << nInvalid << " triangles with out of range indices when simplifying mesh.";
+	}
+
+	if (indices.empty())
+		return;
+
+	const auto range = std::minmax_element(indices.begin(), indices.end());
+	base = *range.first;
+	nLocalVertices = *range.second - base + 1;
+
+	repo::lib::RepoVector3D min = vertices[base], max = vertices[base];
+	for (const auto &index : indices)
+	{
+		const auto &v = vertices[index];
+		min.x = std::min(min.x, v.x); min.y = std::min(min.y, v.y); min.z = std::min(min.z, v.z);
+		max.x = std::max(max.x, v.x); max.y = std::max(max.y, v.y); max.z = std::max(max.z, v.z);
+	}
+	const double size[] = { (double)max.x - min.x, (double)max.y - min.y, (double)max.z - min.z };
+	extent = std::sqrt(size[0] * size[0] + size[1] * size[1] + size[2] * size[2]);
+
+	quadrics.assign(nLocalVertices * QUADRIC_SIZE, 0);
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const auto &p = vertices[indices[i]];
+		double n[3];
+		triangleNormal(p, vertices[indices[i + 1]], vertices[indices[i + 2]], n);
+		const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length == 0)
+			continue;
+
+		n[0] /= length; n[1] /= length; n[2] /= length;
+		const double d = -(n[0] * p.x + n[1] * p.y + n[2] * p.z);
+		for (size_t j = 0; j < 3; ++j)
+			addPlane(&quadrics[(indices[i + j] - base) * QUADRIC_SIZE], n, d);
+	}
+
+	lockVertices();
+}
+
+void MeshSimplifier::lockVertices()
+{
+	locked.assign(nLocalVertices, false);
+
+	//Edges used by anything other than exactly two triangles are borders or non manifold
+	std::unordered_map<uint64_t, uint32_t> edges;
+	edges.reserve(indices.size());
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		for (size_t j = 0; j < 3; ++j)
+		{
+			const uint64_t a = indices[i + j], b = indices[i + (j + 1) % 3];
+			++edges[a < b ? (a << 32) | b : (b << 32) | a];
+		}
+	}
+	for (const auto &edge : edges)
+	{
+		if (edge.second != 2)
+		{
+			locked[(edge.first >> 32) - base] = true;
+			locked[(edge.first & UINT32_MAX) - base] = true;
+		}
+	}
+
+	//Vertices split along seams share their position, collapsing only one
+	//of them would tear the surface
+	std::vector<uint32_t> used;
+	{
+		std::vector<bool> isUsed(nLocalVertices, false);
+		for (const auto &index : indices)
+			isUsed[index - base] = true;
+		for (uint32_t v = 0; v < nLocalVertices; ++v)
+			if (isUsed[v])
+				used.push_back(v + base);
+	}
+	const auto *positions = vertices;
+	std::sort(used.begin(), used.end(), [positions](const uint32_t &a, const uint32_t &b)
+	{
+		const auto &pa = positions[a], &pb = positions[b];
+		return pa.x != pb.x ? pa.x < pb.x : (pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z);
+	});
+	for (size_t i = 1; i < used.size(); ++i)
+	{
+		if (vertices[used[i]] == vertices[used[i - 1]])
+		{
+			locked[used[i] - base] = true;
+			locked[used[i - 1] - base] = true;
+		}
+	}
+}
+
+size_t MeshSimplifier::simplify(
+	const size_t &targetTriangles,
+	const float  &maxError)
+{
+	const size_t target = std::max<size_t>(targetTriangles, 1);
+	const double maxErrorSquared = (double)maxError * maxError * extent * extent;
+
+	std::vector<uint32_t> valence(nLocalVertices);
+	std::vector<uint32_t> adjacencyStart(nLocalVertices + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<double> bestCost(nLocalVertices);
+	std::vector<uint32_t> bestTarget(nLocalVertices);
+	std::vector<uint32_t> collapseTo(nLocalVertices, NO_VERTEX);
+	std::vector<bool> touched(nLocalVertices);
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> neighbours;
+
+	while (indices.size() / 3 > target)
+	{
+		const size_t nTriangles = indices.size() / 3;
+
+		//Triangles using each vertex
+		std::fill(valence.begin(), valence.end(), 0);
+		for (const auto &index : indices)
+			++valence[index - base];
+		adjacencyStart[0] = 0;
+		for (uint32_t v = 0; v < nLocalVertices; ++v)
+			adjacencyStart[v + 1] = adjacencyStart[v] + valence[v];
+		adjacency.resize(indices.size());
+		{
+			std::vector<uint32_t> cursor(adjacencyStart.begin(), adjacencyStart.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i)
+				adjacency[cursor[indices[i] - base]++] = i / 3;
+		}
+
+		//Cheapest collapse of each vertex into one of its neighbours
+		std::fill(bestCost.begin(), bestCost.end(), std::numeric_limits<double>::max());
+		std::fill(bestTarget.begin(), bestTarget.end(), NO_VERTEX);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const uint32_t a = indices[i + j], b = indices[i + (j + 1) % 3];
+				for (const auto &edge : { std::make_pair(a, b), std::make_pair(b, a) })
+				{
+					const uint32_t from = edge.first - base, to = edge.second - base;
+					if (locked[from])
+						continue;
+					const double cost = evaluate(&quadrics[from * QUADRIC_SIZE], &quadrics[to * QUADRIC_SIZE], vertices[edge.second]);
+					if (cost < bestCost[from])
+					{
+						bestCost[from] = cost;
+						bestTarget[from] = to;
+					}
+				}
+			}
+		}
+
+		candidates.clear();
+		for (uint32_t v = 0; v < nLocalVertices; ++v)
+			if (bestTarget[v] != NO_VERTEX && bestCost[v] <= maxErrorSquared)
+				candidates.push_back(v);
+		std::sort(candidates.begin(), candidates.end(), [&bestCost](const uint32_t &a, const uint32_t &b)
+		{
+			return bestCost[a] < bestCost[b];
+		});
+
+		//Collapses in a pass must not share triangles, so each one can be
+		//validated against the mesh as it was at the start of the pass
+		std::fill(touched.begin(), touched.end(), false);
+		size_t nRemoved = 0;
+		for (const auto &u : candidates)
+		{
+			const uint32_t v = bestTarget[u];
+			if (touched[u] || touched[v])
+				continue;
+
+			const auto &newPosition = vertices[v + base];
+			size_t nShared = 0;
+			bool valid = true;
+			neighbours.clear();
+			for (uint32_t k = adjacencyStart[u]; k < adjacencyStart[u + 1] && valid; ++k)
+			{
+				const uint32_t *triangle = &indices[adjacency[k] * 3];
+				bool hasV = false;
+				for (size_t j = 0; j < 3; ++j)
+				{
+					hasV |= triangle[j] - base == v;
+					if (triangle[j] - base != u)
+						neighbours.push_back(triangle[j] - base);
+				}
+				if (hasV)
+				{
+					++nShared;
+					continue;
+				}
+
+				//Triangles that stay must not flip over
+				repo::lib::RepoVector3D moved[3];
+				for (size_t j = 0; j < 3; ++j)
+					moved[j] = triangle[j] - base == u ? newPosition : vertices[triangle[j]];
+				double before[3], after[3];
+				triangleNormal(vertices[triangle[0]], vertices[triangle[1]], vertices[triangle[2]], before);
+				triangleNormal(moved[0], moved[1], moved[2], after);
+				valid = before[0] * after[0] + before[1] * after[1] + before[2] * after[2] > 0;
+			}
+			if (!valid || nShared >= nTriangles - nRemoved)
+				continue;
+
+			//Vertices adjacent to both ends must be the ones of the triangles being
+			//removed, otherwise the collapse pinches the surface into a non manifold edge
+			std::sort(neighbours.begin(), neighbours.end());
+			neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+			size_t nCommon = 0;
+			for (uint32_t k = adjacencyStart[v]; k < adjacencyStart[v + 1]; ++k)
+			{
+				const uint32_t *triangle = &indices[adjacency[k] * 3];
+				for (size_t j = 0; j < 3; ++j)
+				{
+					const uint32_t w = triangle[j] - base;
+					if (w != v && w != u && std::binary_search(neighbours.begin(), neighbours.end(), w))
+					{
+						++nCommon;
+						//Count each common neighbour once
+						neighbours.erase(std::lower_bound(neighbours.begin(), neighbours.end(), w));
+					}
+				}
+			}
+			if (nCommon > nShared)
+				continue;
+
+			collapseTo[u] = v + base;
+			for (size_t i = 0; i < QUADRIC_SIZE; ++i)
+				quadrics[v * QUADRIC_SIZE + i] += quadrics[u * QUADRIC_SIZE + i];
+			errorSquared = std::max(errorSquared, bestCost[u]);
+			touched[u] = touched[v] = true;
+			for (uint32_t k = adjacencyStart[u]; k < adjacencyStart[u + 1]; ++k)
+				for (size_t j = 0; j < 3; ++j)
+					touched[indices[adjacency[k] * 3 + j] - base] = true;
+
+			nRemoved += nShared;
+			if (nTriangles - nRemoved <= target)
+				break;
+		}
+
+		if (!nRemoved)
+			break;
+
+		size_t nKept = 0;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			uint32_t triangle[3];
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const uint32_t to = collapseTo[indices[i + j] - base];
+				triangle[j] = to == NO_VERTEX ? indices[i + j] : to;
+			}
+			if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[2] != triangle[0])
+			{
+				std::copy(triangle, triangle + 3, &indices[nKept * 3]);
+				++nKept;
+			}
+		}
+		indices.resize(nKept * 3);
+		std::fill(collapseTo.begin(), collapseTo.end(), NO_VERTEX);
+	}
+
+	return indices.size() / 3;
+}
+
+float MeshSimplifier::getError() const
+{
+	return std::sqrt(errorSquared);
+}
+
+std::vector<MeshSimplifier::Level> MeshSimplifier::generateLevels(
+	const repo::lib::RepoVector3D *vertices,
+	const uint32_t                &nVertices,
+	const uint32_t                *indices,
+	const std::vector<size_t>     &triangleOffsets,
+	const std::vector<float>      &ratios,
+	const float                   &maxError)
+{
+	std::vector<Level> levels(ratios.size());
+	for (auto &level : levels)
+		level.triangleOffsets.push_back(0);
+
+	for (size_t subMesh = 0; subMesh + 1 < triangleOffsets.size(); ++subMesh)
+	{
+		const size_t nTriangles = triangleOffsets[subMesh + 1] - triangleOffsets[subMesh];
+		MeshSimplifier simplifier(vertices, nVertices, indices + triangleOffsets[subMesh] * 3, nTriangles);
+
+		for (size_t i = 0; i < ratios.size(); ++i)
+		{
+			simplifier.simplify((size_t)std::ceil(ratios[i] * nTriangles), maxError);
+
+			//Collapses scatter the triangles, put them back in vertex cache order
+			auto subMeshIndices = simplifier.getIndices();
+			if (subMeshIndices.size())
+			{
+				const auto range = std::minmax_element(subMeshIndices.begin(), subMeshIndices.end());
+				const uint32_t first = *range.first, last = *range.second;
+				for (auto &index : subMeshIndices)
+					index -= first;
+				VertexCacheOptimiser::optimiseTriangleOrder(subMeshIndices.data(), subMeshIndices.size() / 3, last - first + 1);
+				for (auto &index : subMeshIndices)
+					index += first;
+			}
+
+			auto &level = levels[i];
+			level.indices.insert(level.indices.end(), subMeshIndices.begin(), subMeshIndices.end());
+			level.triangleOffsets.push_back(level.indices.size() / 3);
+			level.errors.push_back(simplifier.getError());
+		}
+	}
+
+	return levels;
+}
@@ -0,0 +1,139 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Mesh simplification by quadric error edge collapse, after Garland and
+* Heckbert's "Surface Simplification Using Quadric Error Metrics".
+* A collapse merges a vertex into one of its neighbours, so vertices are
+* never moved or added: simplified meshes are new index buffers over the
+* original vertex buffers, and per vertex attributes such as id maps
+* remain valid.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../lib/datastructure/repo_vector.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelutility {
+			class MeshSimplifier
+			{
+			public:
+				/**
+				* A level of detail of a mesh made of sub meshes
+				*/
+				struct Level
+				{
+					//triangles of every sub mesh, in the order of the sub meshes
+					std::vector<uint32_t> indices;
+					//first triangle of each sub mesh, followed by the number of triangles
+					std::vector<size_t> triangleOffsets;
+					//error of each sub mesh, as a distance
+					std::vector<float> errors;
+				};
+
+				/**
+				* Create a simplifier for a triangle mesh. Vertices on open
+				* borders and vertices sharing a position with another vertex
+				* (e.g. along normal or uv seams) are never collapsed, so the
+				* mesh does not crack open.
+				* @param vertices positions of the vertices
+				* @param nVertices number of vertices
+				* @param indices triangle list
+				* @param nTriangles number of triangles
+				*/
+				MeshSimplifier(
+					const repo::lib::RepoVector3D *vertices,
+					const uint32_t                &nVertices,
+					const uint32_t                *indices,
+					const size_t                  &nTriangles);
+
+				/**
+				* Collapse edges, cheapest first, until the mesh has no more
+				* than the target number of triangles or no collapse is within
+				* the error bound. This can be called with decreasing targets
+				* for successively coarser levels of detail.
+				* @param targetTriangles number of triangles to simplify to
+				* @param maxError largest error allowed, relative to the extent of the mesh
+				* @return returns the number of triangles left
+				*/
+				size_t simplify(
+					const size_t &targetTriangles,
+					const float  &maxError);
+
+				/**
+				* @return returns the triangle list of the simplified mesh
+				*/
+				const std::vector<uint32_t>& getIndices() const
+				{
+					return indices;
+				}
+
+				/**
+				* @return returns the error of the simplification so far, as a distance
+				*/
+				float getError() const;
+
+				/**
+				* Generate successively coarser levels of detail of a mesh made
+				* of sub meshes, such as a super mesh. Each sub mesh is simplified
+				* on its own, so its triangles only ever use its own vertices.
+				* @param vertices positions of the vertices
+				* @param nVertices number of vertices
+				* @param indices triangle list
+				* @param triangleOffsets first triangle of each sub mesh, followed
+				*        by the number of triangles
+				* @param ratios fraction of the triangles of each sub mesh to keep
+				*        at each level, in decreasing order
+				* @param maxError largest error allowed, relative to the extent of
+				*        each sub mesh
+				* @return returns a level of detail per ratio
+				*/
+				static std::vector<Level> generateLevels(
+					const repo::lib::RepoVector3D *vertices,
+					const uint32_t                &nVertices,
+					const uint32_t                *indices,
+					const std::vector<size_t>     &triangleOffsets,
+					const std::vector<float>      &ratios,
+					const float                   &maxError);
+
+			private:
+				const repo::lib::RepoVector3D *vertices;
+				//smallest index used, per vertex data below starts from it
+				uint32_t base;
+				uint32_t nLocalVertices;
+				std::vector<uint32_t> indices;
+				//quadric of each vertex, as the 10 coefficients of a symmetric 4x4 matrix
+				std::vector<double> quadrics;
+				std::vector<bool> locked;
+				double extent;
+				double errorSquared;
+
+				/**
+				* Lock the vertices on open or non manifold edges and the
+				* vertices sharing their position with another vertex
+				*/
+				void lockVertices();
+			};
+		}
+	}
+}
@@ -0,0 +1,301 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_scene_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include "../../core/model/bson/repo_bson_factory.h"
+#include "../../lib/repo_log.h"
+
+using namespace repo::core::model;
+using namespace repo::manipulator::modelutility;
+
+static const double PI = 3.14159265358979323846;
+static const float ELEMENT_SPACING = 3; //each mesh fits in 2x2, leave a gap between them
+static const uint32_t TEXTURE_SIZE = 32;
+static const uint32_t N_CATEGORIES = 20;
+
+SceneGenerator::SceneGenerator(const SceneGeneratorConfig &config) :
+	config(config)
+{
+	this->config.fanOut = std::max(1u, config.fanOut);
+	this->config.meshCount = std::max(1u, config.meshCount);
+	this->config.materialCount = std::max(1u, config.materialCount);
+	this->config.instancingRatio = std::min(1.0, std::max(0.0, config.instancingRatio));
+}
+
+double SceneGenerator::random(std::mt19937 &generator)
+{
+	return generator() / 4294967296.0;
+}
+
+uint32_t SceneGenerator::random(std::mt19937 &generator, const uint32_t &max)
+{
+	return std::min(max - 1, (uint32_t)(random(generator) * max));
+}
+
+uint32_t SceneGenerator::getGridSide() const
+{
+	return std::max(1u, (uint32_t)std::lround(std::sqrt(config.trianglesPerMesh / 2.0)));
+}
+
+uint64_t SceneGenerator::getTriangleCount() const
+{
+	uint64_t side = getGridSide();
+	return side * side * 2 * config.meshCount;
+}
+
+uint64_t SceneGenerator::getVertexCount() const
+{
+	uint64_t rowLength = getGridSide() + 1;
+	return rowLength * rowLength * config.meshCount;
+}
+
+SceneGenerator::Geometry SceneGenerator::createGeometry(const uint32_t &prototype) const
+{
+	std::mt19937 generator(config.seed * 1000003u + prototype);
+	const double size = 0.5 + 1.5 * random(generator);
+	const double amplitude = 0.5 * random(generator);
+	const double frequency = (1 + 4 * random(generator)) * 2 * PI;
+	const double phaseU = 2 * PI * random(generator);
+	const double phaseV = 2 * PI * random(generator);
+
+	const uint32_t side = getGridSide();
+	const uint32_t rowLength = side + 1;
+
+	Geometry geometry;
+	geometry.vertices.reserve(rowLength * rowLength);
+	geometry.normals.reserve(rowLength * rowLength);
+	if (config.textureCount)
+		geometry.uvs.reserve(rowLength * rowLength);
+
+	for (uint32_t y = 0; y <= side; ++y)
+	{
+		for (uint32_t x = 0; x <= side; ++x)
+		{
+			double u = (double)x / side, v = (double)y / side;
+			double su = std::sin(frequency * u + phaseU), cu = std::cos(frequency * u + phaseU);
+			double sv = std::sin(frequency * v + phaseV), cv = std::cos(frequency * v + phaseV);
+
+			//z = amplitude * (1 + sin * cos), and its slopes along x and y
+			double dzdx = amplitude * frequency * cu * cv / size;
+			double dzdy = -amplitude * frequency * su * sv / size;
+			repo::lib::RepoVector3D normal(-dzdx, -dzdy, 1);
+			normal.normalize();
+
+			geometry.vertices.push_back({ (float)(u * size), (float)(v * size), (float)(amplitude * (1 + su * cv)) });
+			geometry.normals.push_back(normal);
+			if (config.textureCount)
+				geometry.uvs.push_back({ (float)u, (float)v });
+		}
+	}
+
+	geometry.faces.reserve(side * side * 2);
+	for (uint32_t y = 0; y < side; ++y)
+	{
+		for (uint32_t x = 0; x < side; ++x)
+		{
+			uint32_t i = y * rowLength + x;
+			geometry.faces.push_back({ i, i + 1, i + rowLength });
+			geometry.faces.push_back({ i + 1, i + rowLength + 1, i + rowLength });
+		}
+	}
+
+	geometry.boundingBox = {
+		{ 0, 0, 0 },
+		{ (float)size, (float)size, (float)(2 * amplitude) }
+	};
+
+	return geometry;
+}
+
+std::vector<uint8_t> SceneGenerator::createImage(const uint32_t &index)
+{
+	//Uncompressed 24 bit BMP, rows are already a multiple of 4 bytes
+	const uint32_t rowSize = TEXTURE_SIZE * 3;
+	const uint32_t dataOffset = 54;
+	const uint32_t fileSize = dataOffset + rowSize * TEXTURE_SIZE;
+
+	std::vector<uint8_t> image(fileSize, 0);
+	auto write32 = [&image](const size_t &offset, const uint32_t &value) {
+		for (int i = 0; i < 4; ++i)
+			image[offset + i] = (value >> (8 * i)) & 0xFF;
+	};
+
+	image[0] = 'B';
+	image[1] = 'M';
+	write32(2, fileSize);
+	write32(10, dataOffset);
+	write32(14, 40); //size of the info header
+	write32(18, TEXTURE_SIZE);
+	write32(22, TEXTURE_SIZE);
+	image[26] = 1; //planes
+	image[28] = 24; //bits per pixel
+	write32(34, rowSize * TEXTURE_SIZE);
+
+	//Checkerboard, with a different colour and cell size per texture
+	const uint8_t colour[3] = { (uint8_t)(index * 67), (uint8_t)(index * 131), (uint8_t)(255 - index * 29) };
+	const uint32_t cell = 1 + index % 8;
+	for (uint32_t y = 0; y < TEXTURE_SIZE; ++y)
+	{
+		for (uint32_t x = 0; x < TEXTURE_SIZE; ++x)
+		{
+			bool on = ((x / cell) + (y / cell)) % 2;
+			auto pixel = &image[dataOffset + y * rowSize + x * 3];
+			for (int c = 0; c < 3; ++c)
+				pixel[c] = on ? colour[c] : 255;
+		}
+	}
+
+	return image;
+}
+
+RepoScene* SceneGenerator::generate()
+{
+	rng.seed(config.seed);
+
+	RepoNodeSet transformations, meshes, materials, metadata, textures, cameras;
+
+	//Number of transformations per level. Levels stop widening once they
+	//have as many transformations as there are meshes.
+	std::vector<uint32_t> levelSizes = { 1 };
+	for (uint32_t level = 0; level < config.depth; ++level)
+	{
+		uint64_t size = (uint64_t)levelSizes.back() * config.fanOut;
+		levelSizes.push_back(std::max(levelSizes.back(), (uint32_t)std::min<uint64_t>(size, config.meshCount)));
+	}
+	const uint32_t nLeaves = levelSizes.back();
+
+	//Lay children out on a grid within their parent, so nothing overlaps.
+	//extents[l] is the size of the cell of a transformation on level l.
+	const uint32_t meshesPerLeaf = (config.meshCount + nLeaves - 1) / nLeaves;
+	const uint32_t elementSide = (uint32_t)std::ceil(std::sqrt((double)meshesPerLeaf));
+	std::vector<uint32_t> childSides(levelSizes.size(), elementSide);
+	std::vector<float> extents(levelSizes.size(), elementSide * ELEMENT_SPACING);
+	for (int level = (int)levelSizes.size() - 2; level >= 0; --level)
+	{
+		uint32_t childrenPerParent = (levelSizes[level + 1] + levelSizes[level] - 1) / levelSizes[level];
+		childSides[level] = (uint32_t)std::ceil(std::sqrt((double)childrenPerParent));
+		extents[level] = childSides[level] * extents[level + 1];
+	}
+
+	auto translation = [](const float &x, const float &y) {
+		return repo::lib::RepoMatrix(std::vector<float>({
+			1, 0, 0, x,
+			0, 1, 0, y,
+			0, 0, 1, 0,
+			0, 0, 0, 1 }));
+	};
+
+	auto root = new TransformationNode(RepoBSONFactory::makeTransformationNode(
+		repo::lib::RepoMatrix(), "Synthetic scene " + std::to_string(config.seed)));
+	transformations.insert(root);
+
+	std::vector<repo::lib::RepoUUID> parentLevel = { root->getSharedID() };
+	for (uint32_t level = 1; level < levelSizes.size(); ++level)
+	{
+		std::vector<repo::lib::RepoUUID> currentLevel;
+		currentLevel.reserve(levelSizes[level]);
+		const uint32_t side = childSides[level - 1];
+		for (uint32_t i = 0; i < levelSizes[level]; ++i)
+		{
+			const uint32_t parent = i % parentLevel.size();
+			const uint32_t index = i / parentLevel.size();
+			auto node = new TransformationNode(RepoBSONFactory::makeTransformationNode(
+				translation((index % side) * extents[level], (index / side) * extents[level]),
+				"Level " + std::to_string(level) + " Group " + std::to_string(i),
+				{ parentLevel[parent] }));
+			transformations.insert(node);
+			currentLevel.push_back(node->getSharedID());
+		}
+		parentLevel.swap(currentLevel);
+	}
+
+	//Meshes, each under its own element transformation
+	const uint32_t nPrototypes = std::max(1u, config.meshCount - (uint32_t)std::llround(config.meshCount * config.instancingRatio));
+	std::vector<std::vector<repo::lib::RepoUUID>> materialParents(config.materialCount);
+	std::vector<std::string> categories;
+	for (uint32_t i = 0; i < N_CATEGORIES; ++i)
+		categories.push_back("Category " + std::to_string(i));
+
+	for (uint32_t i = 0; i < config.meshCount; ++i)
+	{
+		const uint32_t leaf = i % nLeaves;
+		const uint32_t index = i / nLeaves;
+		auto element = new TransformationNode(RepoBSONFactory::makeTransformationNode(
+			translation((index % elementSide) * ELEMENT_SPACING, (index / elementSide) * ELEMENT_SPACING),
+			"Element " + std::to_string(i),
+			{ parentLevel[leaf] }));
+		transformations.insert(element);
+
+		const uint32_t prototype = i < nPrototypes ? i : random(rng, nPrototypes);
+		auto geometry = createGeometry(prototype);
+		std::vector<std::vector<repo::lib::RepoVector2D>> uvChannels;
+		if (geometry.uvs.size())
+			uvChannels.push_back(std::move(geometry.uvs));
+		auto mesh = new MeshNode(RepoBSONFactory::makeMeshNode(
+			geometry.vertices, geometry.faces, geometry.normals, geometry.boundingBox, uvChannels,
+			{}, {}, "Element " + std::to_string(i), { element->getSharedID() }));
+		meshes.insert(mesh);
+		materialParents[random(rng, config.materialCount)].push_back(mesh->getSharedID());
+
+		if (config.metadataDensity)
+		{
+			std::unordered_map<std::string, std::string> values;
+			values["Name"] = "Element " + std::to_string(i);
+			if (config.metadataDensity > 1)
+				values["Category"] = categories[random(rng, N_CATEGORIES)];
+			for (uint32_t entry = 2; entry < config.metadataDensity; ++entry)
+			{
+				//Alternate numeric and text values, in a few property sets
+				auto key = "Property Set " + std::to_string(entry % 5) + "::Property " + std::to_string(entry);
+				values[key] = entry % 2 ? std::to_string(random(rng) * 1000) : "Value " + std::to_string(random(rng, 100));
+			}
+			metadata.insert(new MetadataNode(RepoBSONFactory::makeMetaDataNode(
+				values, "Element " + std::to_string(i), { element->getSharedID() })));
+		}
+	}
+
+	std::vector<repo::lib::RepoUUID> materialIds;
+	for (uint32_t i = 0; i < config.materialCount; ++i)
+	{
+		//Materials must have parents, so any left unused are dropped
+		if (materialParents[i].empty())
+			continue;
+		repo_material_t material;
+		material.diffuse = { (float)random(rng), (float)random(rng), (float)random(rng), 1 };
+		material.opacity = random(rng) < 0.1 ? 0.5f : 1.0f;
+		auto node = new MaterialNode(RepoBSONFactory::makeMaterialNode(
+			material, "Material " + std::to_string(i), materialParents[i]));
+		materials.insert(node);
+		materialIds.push_back(node->getSharedID());
+	}
+
+	for (uint32_t i = 0; i < config.textureCount; ++i)
+	{
+		textures.insert(new TextureNode(RepoBSONFactory::makeTextureNode(
+			"Texture " + std::to_string(i) + ".bmp", createImage(i), TEXTURE_SIZE, TEXTURE_SIZE,
+			{ materialIds[i % materialIds.size()] })));
+	}
+
+	repoInfo << "Generated synthetic scene with " << transformations.size() << " transformations, "
+		<< meshes.size() << " meshes (" << nPrototypes << " unique), " << getTriangleCount() << " triangles, "
+		<< metadata.size() << " metadata nodes and " << textures.size() << " textures";
+
+	return new RepoScene({}, cameras, meshes, materials, metadata, textures, transformations);
+}
@@ -0,0 +1,123 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Synthetic scene generator, to test the behaviour of the pipeline on scenes
+* far larger than the test models. Scenes are built from a seed, so the same
+* configuration always produces the same structure, geometry and metadata
+* (node ids are still unique per scene, as with any import).
+*/
+
+#pragma once
+
+#include <random>
+#include "../../core/model/collection/repo_scene.h"
+#include "../../lib/datastructure/repo_structs.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelutility {
+			struct SceneGeneratorConfig
+			{
+				uint32_t seed = 0;
+				uint32_t depth = 4; //levels of transformations below the root
+				uint32_t fanOut = 8; //children per transformation
+				uint32_t meshCount = 1000;
+				uint32_t trianglesPerMesh = 200;
+				double instancingRatio = 0; //fraction of meshes reusing the geometry of another mesh, from 0 to 1
+				uint32_t metadataDensity = 10; //metadata entries per element, 0 for no metadata
+				uint32_t textureCount = 0;
+				uint32_t materialCount = 16;
+			};
+
+			class SceneGenerator
+			{
+			public:
+				/**
+				* Create a scene generator
+				* @param config parameters of the scenes to generate
+				*/
+				SceneGenerator(const SceneGeneratorConfig &config);
+				~SceneGenerator() {}
+
+				/**
+				* Generate a scene. Each mesh is placed under its own element
+				* transformation (with its metadata), below a tree of transformations
+				* of the configured depth and fan out. The tree stops widening once
+				* a level has as many transformations as there are meshes.
+				* @return returns a scene with the default graph populated, owned by the caller
+				*/
+				repo::core::model::RepoScene* generate();
+
+				/**
+				* Get the total number of triangles generate() produces
+				*/
+				uint64_t getTriangleCount() const;
+
+				/**
+				* Get the total number of vertices generate() produces
+				*/
+				uint64_t getVertexCount() const;
+
+			private:
+				struct Geometry
+				{
+					std::vector<repo::lib::RepoVector3D> vertices;
+					std::vector<repo::lib::RepoVector3D> normals;
+					std::vector<repo::lib::RepoVector2D> uvs;
+					std::vector<repo_face_t> faces;
+					std::vector<std::vector<float>> boundingBox;
+				};
+
+				/**
+				* Create a patch of wavy surface of about config.trianglesPerMesh
+				* triangles, fitting in a 2x2x1 box. The geometry only depends on the
+				* seed and the prototype, so instances can recreate it rather than
+				* keeping every prototype in memory.
+				* @param prototype index of the geometry
+				*/
+				Geometry createGeometry(const uint32_t &prototype) const;
+
+				/**
+				* Get the number of cells along each side of a mesh
+				*/
+				uint32_t getGridSide() const;
+
+				/**
+				* Create a small BMP image
+				* @param index index of the texture, to vary the pattern
+				* @return returns the content of the image file
+				*/
+				static std::vector<uint8_t> createImage(const uint32_t &index);
+
+				/**
+				* Get a random number in [0, 1), portably
+				* (unlike std::uniform_real_distribution)
+				*/
+				static double random(std::mt19937 &generator);
+
+				/**
+				* Get a random integer in [0, max)
+				*/
+				static uint32_t random(std::mt19937 &generator, const uint32_t &max);
+
+				SceneGeneratorConfig config;
+				std::mt19937 rng;
+			};
+		}
+	}
+}
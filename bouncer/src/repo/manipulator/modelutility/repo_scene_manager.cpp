@@ -19,11 +19,13 @@
 #include "../../core/model/bson/repo_bson_builder.h"
 #include "../../core/model/bson/repo_bson_ref.h"
 #include "../../error_codes.h"
+#include "../../lib/repo_profiler.h"
 #include "../modeloptimizer/repo_optimizer_multipart.h"
 #include "../modelconvertor/export/repo_model_export_gltf.h"
 #include "../modelconvertor/export/repo_model_export_src.h"
 #include "../modeloptimizer/repo_optimizer_multipart.h"
 #include "../modelutility/repo_maker_selection_tree.h"
+#include "repo_web_buffers_uploader.h"
 
 using namespace repo::manipulator::modelutility;
 
@@ -35,6 +37,7 @@ bool SceneManager::commitWebBuffers(
 	repo::core::handler::fileservice::FileManager         *fileManager,
 	const bool                                            addTimestampToSettings)
 {
+	REPO_PROFILE_SCOPE("commitWebBuffers");
 	bool success = true;
 	std::string jsonStashExt = REPO_COLLECTION_STASH_JSON;
 	std::string databaseName = scene->getDatabaseName();
@@ -82,6 +85,17 @@ bool SceneManager::commitWebBuffers(
 		}
 	}
 
+	finishWebBuffersCommit(scene, handler, success, addTimestampToSettings);
+
+	return success;
+}
+
+void SceneManager::finishWebBuffersCommit(
+	repo::core::model::RepoScene                          *scene,
+	repo::core::handler::AbstractDatabaseHandler          *handler,
+	const bool                                            success,
+	const bool                                            addTimestampToSettings)
+{
 	if (success)
 	{
 		scene->updateRevisionStatus(handler, repo::core::model::RevisionNode::UploadStatus::COMPLETE);
@@ -94,8 +108,6 @@ bool SceneManager::commitWebBuffers(
 	{
 		scene->addErrorStatusToProjectSettings(handler);
 	}
-
-	return success;
 }
 
 uint8_t SceneManager::commitScene(
@@ -107,11 +119,15 @@ uint8_t SceneManager::commitScene(
 	repo::core::handler::AbstractDatabaseHandler          *handler,
 	repo::core::handler::fileservice::FileManager         *fileManager
 ) {
+	REPO_PROFILE_SCOPE("commitScene");
 	uint8_t errCode = REPOERR_UPLOAD_FAILED;
 	std::string msg;
 	if (handler && scene)
 	{
-		errCode = scene->commit(handler, fileManager, msg, owner, desc, tag, revId);
+		{
+			REPO_PROFILE_SCOPE("RepoScene::commit");
+			errCode = scene->commit(handler, fileManager, msg, owner, desc, tag, revId);
+		}
 		if (errCode == REPOERR_OK) {
 			repoInfo << "Scene successfully committed to the database";
 			bool success = true;
@@ -319,6 +335,7 @@ bool SceneManager::generateStashGraph(
 	repo::core::handler::AbstractDatabaseHandler *handler
 )
 {
+	REPO_PROFILE_SCOPE("generateStashGraph");
 	bool success = false;
 	if (success = (scene && scene->hasRoot(repo::core::model::RepoScene::GraphType::DEFAULT)))
 	{
@@ -339,6 +356,7 @@ bool SceneManager::generateStashGraph(
 			{
 				repoInfo << "Committing stash graph to " << scene->getDatabaseName() << "." << scene->getProjectName() << "...";
 				std::string errMsg;
+				REPO_PROFILE_SCOPE("RepoScene::commitStash");
 				//commit stash will set uploadstatus to complete if succeed
 				if (!(success = scene->commitStash(handler, errMsg)))
 				{
@@ -368,10 +386,16 @@ bool SceneManager::generateWebViewBuffers(
 	repo::core::handler::AbstractDatabaseHandler           *handler,
 	repo::core::handler::fileservice::FileManager         *fileManager)
 {
+	REPO_PROFILE_SCOPE("generateWebViewBuffers");
 	bool success = false;
 	if (success = (scene&& scene->isRevisioned()))
 	{
 		bool toCommit = handler;
+		if (toCommit && !fileManager)
+		{
+			repoError << "Failed to commit web buffers: no file manager to upload them to!";
+			return false;
+		}
 
 		std::string geoStashExt;
 		std::string jsonStashExt = REPO_COLLECTION_STASH_JSON;
@@ -380,11 +404,9 @@ bool SceneManager::generateWebViewBuffers(
 		{
 		case repo::manipulator::modelconvertor::WebExportType::GLTF:
 			geoStashExt = REPO_COLLECTION_STASH_GLTF;
-			resultBuffers = generateGLTFBuffer(scene);
 			break;
 		case repo::manipulator::modelconvertor::WebExportType::SRC:
 			geoStashExt = REPO_COLLECTION_STASH_SRC;
-			resultBuffers = generateSRCBuffer(scene);
 			break;
 		case repo::manipulator::modelconvertor::WebExportType::UNITY:
 			repoInfo << "Skipping buffer generation for Unity assets";
@@ -394,14 +416,35 @@ bool SceneManager::generateWebViewBuffers(
 			return false;
 		}
 
-		if (success = resultBuffers.geoFiles.size())
+		//When committing, stream the files straight into the file manager
+		//instead of holding the whole web representation in memory
+		std::shared_ptr<WebBuffersUploader> uploader;
+		if (toCommit)
 		{
-			if (toCommit)
+			std::string projectName = scene->getProjectName();
+			uploader = std::make_shared<WebBuffersUploader>(fileManager, scene->getDatabaseName(),
+				projectName + "." + geoStashExt, projectName + "." + jsonStashExt);
+		}
+
+		auto options = getWebExportOptions(scene, handler);
+		if (exType == repo::manipulator::modelconvertor::WebExportType::GLTF)
+			resultBuffers = generateGLTFBuffer(scene, uploader.get(), options);
+		else
+			resultBuffers = generateSRCBuffer(scene, uploader.get(), options);
+
+		if (toCommit)
+		{
+			{
+				REPO_PROFILE_SCOPE("WebBuffersUploader::finalise");
+				success = uploader->finalise();
+			}
+			if (!(success &= uploader->getNumGeometryFiles() > 0))
 			{
-				success = commitWebBuffers(scene, geoStashExt, resultBuffers, handler, fileManager);
+				repoError << "Failed to generate web buffers: no geometry file generated";
 			}
+			finishWebBuffersCommit(scene, handler, success, false);
 		}
-		else
+		else if (!(success = resultBuffers.geoFiles.size()))
 		{
 			repoError << "Failed to generate web buffers: no geometry file generated";
 		}
@@ -415,10 +458,13 @@ bool SceneManager::generateWebViewBuffers(
 }
 
 repo_web_buffers_t SceneManager::generateGLTFBuffer(
-	repo::core::model::RepoScene *scene)
+	repo::core::model::RepoScene *scene,
+	repo::manipulator::modelconvertor::AbstractWebExportSink *sink,
+	const repo::manipulator::modelconvertor::WebExportOptions &options)
 {
+	REPO_PROFILE_SCOPE("GLTFModelExport");
 	repo_web_buffers_t result;
-	repo::manipulator::modelconvertor::GLTFModelExport gltfExport(scene);
+	repo::manipulator::modelconvertor::GLTFModelExport gltfExport(scene, sink, options);
 	if (gltfExport.isOk())
 	{
 		repoTrace << "Conversion succeed.. exporting as buffer..";
@@ -435,6 +481,7 @@ bool SceneManager::generateAndCommitSelectionTree(
 	repo::core::handler::AbstractDatabaseHandler           *handler,
 	repo::core::handler::fileservice::FileManager         *fileManager)
 {
+	REPO_PROFILE_SCOPE("generateAndCommitSelectionTree");
 	bool success = false;
 	if (success = scene && scene->isRevisioned() && handler)
 	{
@@ -487,10 +534,13 @@ bool SceneManager::generateAndCommitSelectionTree(
 }
 
 repo_web_buffers_t SceneManager::generateSRCBuffer(
-	repo::core::model::RepoScene *scene)
+	repo::core::model::RepoScene *scene,
+	repo::manipulator::modelconvertor::AbstractWebExportSink *sink,
+	const repo::manipulator::modelconvertor::WebExportOptions &options)
 {
+	REPO_PROFILE_SCOPE("SRCModelExport");
 	repo_web_buffers_t result;
-	repo::manipulator::modelconvertor::SRCModelExport srcExport(scene);
+	repo::manipulator::modelconvertor::SRCModelExport srcExport(scene, sink, options);
 	if (srcExport.isOk())
 	{
 		repoTrace << "Conversion succeed.. exporting as buffer..";
@@ -538,6 +588,27 @@ bool SceneManager::shouldGenerateSrcFiles(
 	return false;
 }
 
+repo::manipulator::modelconvertor::WebExportOptions SceneManager::getWebExportOptions(
+	const repo::core::model::RepoScene* scene,
+	repo::core::handler::AbstractDatabaseHandler* handler) const
+{
+	repo::manipulator::modelconvertor::WebExportOptions options;
+	if (handler)
+	{
+		repo::core::model::RepoUser user(handler->findOneByCriteria(REPO_ADMIN, REPO_SYSTEM_USERS, BSON("user" << scene->getDatabaseName())));
+		if (user.isUint32IndicesEnabled())
+			options.indexFormat = repo::manipulator::modelconvertor::WebIndexFormat::UINT32;
+		if (user.isQuantisedVerticesEnabled())
+			options.vertexFormat = repo::manipulator::modelconvertor::WebVertexFormat::QUANTISED;
+		if (user.isGeometryCodecEnabled())
+			options.bufferEncoding = repo::manipulator::modelconvertor::WebBufferEncoding::GEOMETRY_CODEC;
+		if (user.isHierarchicalLODsEnabled())
+			options.lodMode = repo::manipulator::modelconvertor::WebLODMode::HIERARCHICAL;
+	}
+
+	return options;
+}
+
 bool SceneManager::removeStashGraph(
 	repo::core::model::RepoScene                 *scene,
 	repo::core::handler::AbstractDatabaseHandler *handler
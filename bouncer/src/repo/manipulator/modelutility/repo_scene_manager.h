@@ -150,10 +150,24 @@ namespace repo {
 					const repo::core::model::RepoScene* scene,
 					repo::core::handler::AbstractDatabaseHandler* handler) const;
 
+				/**
+				* Get the options to generate the web stashes of the scene with,
+				* from the flags of its teamspace. Each option that viewers need
+				* to support (32 bit indices, quantised vertices, the geometry
+				* codec, hierarchical levels of detail) is only used if enabled.
+				* @param scene scene to generate stash for
+				* @param handler hander to the database, the defaults are used if null
+				* @return returns the options of the web stashes
+				*/
+				repo::manipulator::modelconvertor::WebExportOptions getWebExportOptions(
+					const repo::core::model::RepoScene* scene,
+					repo::core::handler::AbstractDatabaseHandler* handler) const;
+
 				/**
 				* Generate a `exType` encoding for the given scene
 				* if a database handler is provided, it will also commit the
-				* buffers into the database
+				* buffers into the database. When committing, files are uploaded
+				* as they are generated and will not be returned in resultBuffers.
 				* This requires the repo stash to have been generated already
 				* @param scene the scene to generate the src encoding from
 				* @param exType the type of export it is
@@ -179,23 +193,45 @@ namespace repo {
 				);
 
 			private:
+				/**
+				* Update the revision status and project settings once
+				* web buffers have been committed (or failed to)
+				* @param scene repo scene related to repo scene
+				* @param handler database handler
+				* @param success whether the web buffers were committed successfully
+				* @param addTimestampToSettings whether we should be adding timestamp to settings upon success
+				*/
+				void finishWebBuffersCommit(
+					repo::core::model::RepoScene                          *scene,
+					repo::core::handler::AbstractDatabaseHandler          *handler,
+					const bool                                            success,
+					const bool                                            addTimestampToSettings);
+
 				/**
 				* Generate a gltf encoding in the form of a buffer for the given scene
 				* This requires the stash to have been generated already
 				* @param scene the scene to generate the gltf encoding from
+				* @param sink if given, files are handed to the sink as they are generated
+				* @param options formats of the geometry buffers
 				* @return returns a buffer in the form of a byte vector mapped to its filename
 				*/
 				repo_web_buffers_t generateGLTFBuffer(
-					repo::core::model::RepoScene *scene);
+					repo::core::model::RepoScene *scene,
+					repo::manipulator::modelconvertor::AbstractWebExportSink *sink = nullptr,
+					const repo::manipulator::modelconvertor::WebExportOptions &options = repo::manipulator::modelconvertor::WebExportOptions());
 
 				/**
 				* Generate a SRC encoding in the form of a buffer for the given scene
 				* This requires the stash to have been generated already
 				* @param scene the scene to generate the src encoding from
+				* @param sink if given, files are handed to the sink as they are generated
+				* @param options formats of the geometry buffers
 				* @return returns a buffer in the form of a byte vector mapped to its filename
 				*/
 				repo_web_buffers_t generateSRCBuffer(
-					repo::core::model::RepoScene *scene);
+					repo::core::model::RepoScene *scene,
+					repo::manipulator::modelconvertor::AbstractWebExportSink *sink = nullptr,
+					const repo::manipulator::modelconvertor::WebExportOptions &options = repo::manipulator::modelconvertor::WebExportOptions());
 			};
 		}
 	}
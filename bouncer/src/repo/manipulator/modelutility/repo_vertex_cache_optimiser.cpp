@@ -0,0 +1,265 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_vertex_cache_optimiser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+using namespace repo::manipulator::modelutility;
+
+const uint32_t VertexCacheOptimiser::DEFAULT_CACHE_SIZE;
+const uint32_t VertexCacheOptimiser::MAX_CACHE_SIZE;
+
+static const uint32_t NO_TRIANGLE = UINT32_MAX;
+
+//Scoring parameters from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+/**
+* Vertex scores, tabulated by position in the cache and by the number of
+* triangles still to be added that use the vertex
+*/
+class VertexScores
+{
+public:
+	VertexScores(const uint32_t &cacheSize) :
+		positionScores(cacheSize),
+		valenceScores(MAX_TABULATED_VALENCE + 1)
+	{
+		for (uint32_t i = 0; i < cacheSize; ++i)
+		{
+			//The vertices of the last triangle are scored the same, so the
+			//order it was added in does not matter
+			positionScores[i] = i < 3 ? LAST_TRIANGLE_SCORE :
+				std::pow(1.0f - float(i - 3) / (cacheSize - 3), CACHE_DECAY_POWER);
+		}
+
+		for (uint32_t i = 1; i <= MAX_TABULATED_VALENCE; ++i)
+			valenceScores[i] = valenceScore(i);
+	}
+
+	/**
+	* @param cachePosition position in the cache, -1 if the vertex is not in it
+	* @param valence number of triangles still to be added that use the vertex
+	*/
+	float get(const int32_t &cachePosition, const uint32_t &valence) const
+	{
+		if (!valence)
+			return -1.0f;
+
+		return (cachePosition >= 0 ? positionScores[cachePosition] : 0.0f)
+			+ (valence <= MAX_TABULATED_VALENCE ? valenceScores[valence] : valenceScore(valence));
+	}
+
+private:
+	static const uint32_t MAX_TABULATED_VALENCE = 32;
+
+	/**
+	* Favour vertices with few triangles left, to avoid leaving lone triangles behind
+	*/
+	static float valenceScore(const uint32_t &valence)
+	{
+		return VALENCE_BOOST_SCALE * std::pow(float(valence), -VALENCE_BOOST_POWER);
+	}
+
+	std::vector<float> positionScores;
+	std::vector<float> valenceScores;
+};
+
+void VertexCacheOptimiser::optimiseTriangleOrder(
+	uint32_t       *indices,
+	const size_t   &nTriangles,
+	const uint32_t &nVertices,
+	const uint32_t &cacheSize)
+{
+	if (nTriangles < 2)
+		return;
+
+	const uint32_t size = std::min(std::max(cacheSize, 4u), MAX_CACHE_SIZE);
+	const size_t nIndices = nTriangles * 3;
+
+	//Triangles using each vertex, as ranges of adjacency
+	std::vector<uint32_t> valence(nVertices, 0);
+	for (size_t i = 0; i < nIndices; ++i)
+		++valence[indices[i]];
+
+	std::vector<uint32_t> adjacencyStart(nVertices + 1, 0);
+	for (uint32_t v = 0; v < nVertices; ++v)
+		adjacencyStart[v + 1] = adjacencyStart[v] + valence[v];
+
+	std::vector<uint32_t> adjacency(nIndices);
+	{
+		std::vector<uint32_t> cursor(adjacencyStart.begin(), adjacencyStart.end() - 1);
+		for (size_t i = 0; i < nIndices; ++i)
+			adjacency[cursor[indices[i]]++] = i / 3;
+	}
+
+	const VertexScores scores(size);
+	std::vector<float> vScore(nVertices);
+	for (uint32_t v = 0; v < nVertices; ++v)
+		vScore[v] = scores.get(-1, valence[v]);
+
+	std::vector<float> tScore(nTriangles, 0.0f);
+	uint32_t best = 0;
+	for (size_t t = 0; t < nTriangles; ++t)
+	{
+		tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+		if (tScore[t] > tScore[best])
+			best = t;
+	}
+
+	std::vector<bool> added(nTriangles, false);
+	std::vector<uint32_t> output;
+	output.reserve(nIndices);
+
+	std::vector<uint32_t> cache, newCache;
+	cache.reserve(size + 3);
+	newCache.reserve(size + 3);
+
+	size_t nextUnadded = 0;
+	for (size_t n = 0; n < nTriangles; ++n)
+	{
+		if (best == NO_TRIANGLE)
+		{
+			//Nothing left around the cache, carry on from the next triangle in input order
+			while (added[nextUnadded])
+				++nextUnadded;
+			best = nextUnadded;
+		}
+
+		added[best] = true;
+		const uint32_t *triangle = indices + best * 3;
+		output.insert(output.end(), triangle, triangle + 3);
+
+		newCache.clear();
+		for (int i = 0; i < 3; ++i)
+		{
+			const uint32_t v = triangle[i];
+
+			//Remove the triangle from the ones left to add around the vertex
+			auto begin = adjacency.begin() + adjacencyStart[v];
+			auto end = begin + valence[v];
+			auto it = std::find(begin, end, best);
+			if (it != end)
+			{
+				std::iter_swap(it, end - 1);
+				--valence[v];
+			}
+
+			if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+				newCache.push_back(v);
+		}
+
+		for (const auto &v : cache)
+		{
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+				newCache.push_back(v);
+		}
+
+		//Update the scores of all vertices in the cache, and of the ones falling out of it
+		for (size_t i = 0; i < newCache.size(); ++i)
+		{
+			const uint32_t v = newCache[i];
+			const float score = scores.get(i < size ? i : -1, valence[v]);
+			const float delta = score - vScore[v];
+			vScore[v] = score;
+			for (uint32_t j = adjacencyStart[v]; j < adjacencyStart[v] + valence[v]; ++j)
+				tScore[adjacency[j]] += delta;
+		}
+
+		if (newCache.size() > size)
+			newCache.resize(size);
+		cache.swap(newCache);
+
+		//The next triangle is the best one using a vertex in the cache
+		best = NO_TRIANGLE;
+		float bestScore = -1.0f;
+		for (const auto &v : cache)
+		{
+			for (uint32_t j = adjacencyStart[v]; j < adjacencyStart[v] + valence[v]; ++j)
+			{
+				const uint32_t t = adjacency[j];
+				if (tScore[t] > bestScore)
+				{
+					best = t;
+					bestScore = tScore[t];
+				}
+			}
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+std::vector<uint32_t> VertexCacheOptimiser::optimiseVertexOrder(
+	uint32_t       *indices,
+	const size_t   &nIndices,
+	const uint32_t &nVertices)
+{
+	const uint32_t unassigned = UINT32_MAX;
+	std::vector<uint32_t> remap(nVertices, unassigned);
+	uint32_t next = 0;
+	for (size_t i = 0; i < nIndices; ++i)
+	{
+		uint32_t &newIndex = remap[indices[i]];
+		if (newIndex == unassigned)
+			newIndex = next++;
+		indices[i] = newIndex;
+	}
+
+	for (auto &newIndex : remap)
+	{
+		if (newIndex == unassigned)
+			newIndex = next++;
+	}
+
+	return remap;
+}
+
+float VertexCacheOptimiser::getACMR(
+	const uint32_t *indices,
+	const size_t   &nTriangles,
+	const uint32_t &cacheSize)
+{
+	if (!nTriangles)
+		return 0.0f;
+
+	std::deque<uint32_t> cache;
+	size_t misses = 0;
+	for (size_t i = 0; i < nTriangles * 3; ++i)
+	{
+		auto it = std::find(cache.begin(), cache.end(), indices[i]);
+		if (it == cache.end())
+		{
+			++misses;
+			if (cache.size() == cacheSize)
+				cache.pop_back();
+		}
+		else
+		{
+			cache.erase(it);
+		}
+		cache.push_front(indices[i]);
+	}
+
+	return float(misses) / nTriangles;
+}
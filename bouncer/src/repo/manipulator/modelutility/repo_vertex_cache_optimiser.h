@@ -0,0 +1,83 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Index ordering for GPU vertex reuse.
+* Triangles are ordered with Tom Forsyth's linear-speed vertex cache
+* optimisation, then vertices are renumbered in order of first use so
+* vertex fetches follow the index buffer.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace repo {
+	namespace manipulator {
+		namespace modelutility {
+			class VertexCacheOptimiser
+			{
+			public:
+				static const uint32_t DEFAULT_CACHE_SIZE = 32;
+				static const uint32_t MAX_CACHE_SIZE = 64;
+
+				/**
+				* Reorder the triangles of a triangle list to maximise the
+				* reuse of a LRU post transform vertex cache
+				* @param indices triangle list to reorder in place
+				* @param nTriangles number of triangles
+				* @param nVertices number of vertices, all indices must be less than it
+				* @param cacheSize size of the cache to optimise for
+				*/
+				static void optimiseTriangleOrder(
+					uint32_t       *indices,
+					const size_t   &nTriangles,
+					const uint32_t &nVertices,
+					const uint32_t &cacheSize = DEFAULT_CACHE_SIZE);
+
+				/**
+				* Renumber vertices in the order they are first referenced by
+				* the indices. Vertices that are not referenced go last, in
+				* their original order.
+				* @param indices indices to renumber in place
+				* @param nIndices number of indices
+				* @param nVertices number of vertices, all indices must be less than it
+				* @return returns the new index of each vertex
+				*/
+				static std::vector<uint32_t> optimiseVertexOrder(
+					uint32_t       *indices,
+					const size_t   &nIndices,
+					const uint32_t &nVertices);
+
+				/**
+				* Get the average cache miss ratio (vertex transforms per
+				* triangle) of a triangle list with a LRU vertex cache
+				* @param indices triangle list
+				* @param nTriangles number of triangles
+				* @param cacheSize size of the cache
+				* @return returns the number of cache misses per triangle
+				*/
+				static float getACMR(
+					const uint32_t *indices,
+					const size_t   &nTriangles,
+					const uint32_t &cacheSize = DEFAULT_CACHE_SIZE);
+			};
+		}
+	}
+}
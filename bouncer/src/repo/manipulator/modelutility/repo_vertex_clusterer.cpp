@@ -0,0 +1,130 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_vertex_clusterer.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace repo::manipulator::modelutility;
+
+const uint32_t VertexClusterer::MAX_RESOLUTION;
+
+VertexClusterer::VertexClusterer(
+	const repo::lib::RepoVector3D &min,
+	const repo::lib::RepoVector3D &max,
+	const uint32_t                &resolution) :
+	min(min)
+{
+	const uint32_t nCells = std::min(std::max(resolution, 1u), MAX_RESOLUTION);
+	const float size[] = { max.x - min.x, max.y - min.y, max.z - min.z };
+	const float longest = std::max(std::max(size[0], size[1]), size[2]);
+	cellSize = longest > 0 ? longest / nCells : 1;
+	for (size_t i = 0; i < 3; ++i)
+	{
+		dimensions[i] = std::min(std::max((uint32_t)std::ceil(size[i] / cellSize), 1u), nCells);
+	}
+}
+
+size_t VertexClusterer::TriangleHasher::operator()(const std::array<uint32_t, 3> &triangle) const
+{
+	size_t hash = 0;
+	for (const auto &index : triangle)
+		hash = hash * 0x9E3779B1u + index;
+	return hash;
+}
+
+uint32_t VertexClusterer::findCell(
+	const repo::lib::RepoVector3D &position)
+{
+	const float coords[] = { position.x - min.x, position.y - min.y, position.z - min.z };
+	uint64_t key = 0;
+	for (int i = 2; i >= 0; --i)
+	{
+		float cell = std::floor(coords[i] / cellSize);
+		//NaN goes to the first cell
+		uint32_t index = cell >= 0 ? std::min((uint32_t)std::min(cell, (float)MAX_RESOLUTION), dimensions[i] - 1) : 0;
+		key = key * MAX_RESOLUTION + index;
+	}
+
+	auto it = cells.find(key);
+	if (it == cells.end())
+	{
+		it = cells.insert({ key, (uint32_t)counts.size() }).first;
+		counts.push_back(0);
+		sums.insert(sums.end(), 3, 0.0);
+	}
+	return it->second;
+}
+
+void VertexClusterer::addTriangles(
+	const repo::lib::RepoVector3D *vertices,
+	const size_t                  &nVertices,
+	const uint32_t                *meshIndices,
+	const size_t                  &nTriangles)
+{
+	//Meshes may only use a small part of the vertices given, so only
+	//look up the ones that are used
+	std::unordered_map<uint32_t, uint32_t> clustered;
+	std::array<uint32_t, 3> triangle;
+	for (size_t i = 0; i < nTriangles; ++i)
+	{
+		bool valid = true;
+		for (size_t j = 0; j < 3 && valid; ++j)
+		{
+			const uint32_t index = meshIndices[i * 3 + j];
+			if (!(valid = index < nVertices))
+				break;
+
+			auto it = clustered.find(index);
+			if (it == clustered.end())
+			{
+				const auto &position = vertices[index];
+				uint32_t cell = findCell(position);
+				sums[cell * 3] += position.x;
+				sums[cell * 3 + 1] += position.y;
+				sums[cell * 3 + 2] += position.z;
+				++counts[cell];
+				it = clustered.insert({ index, cell }).first;
+			}
+			triangle[j] = it->second;
+		}
+
+		if (!valid || triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+			continue;
+
+		//Start from the smallest index so the same triangle is always found,
+		//whichever vertex it was given from
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		if (triangles.insert(triangle).second)
+			indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+}
+
+std::vector<repo::lib::RepoVector3D> VertexClusterer::getVertices() const
+{
+	std::vector<repo::lib::RepoVector3D> vertices;
+	vertices.reserve(counts.size());
+	for (size_t i = 0; i < counts.size(); ++i)
+	{
+		vertices.push_back({
+			(float)(sums[i * 3] / counts[i]),
+			(float)(sums[i * 3 + 1] / counts[i]),
+			(float)(sums[i * 3 + 2] / counts[i]) });
+	}
+	return vertices;
+}
@@ -0,0 +1,111 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Mesh simplification by vertex clustering, after Rossignac and Borrel's
+* "Multi-resolution 3D Approximations for Rendering Complex Scenes".
+* Space is divided into a grid of cubic cells. All vertices in a cell are
+* merged into one at their mean position, and triangles left with less than
+* three distinct vertices are dropped. Meshes are added one at a time, so the
+* memory used only depends on the size of the result.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../lib/datastructure/repo_vector.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelutility {
+			class VertexClusterer
+			{
+			public:
+				static const uint32_t MAX_RESOLUTION = 1024;
+
+				/**
+				* Create a clusterer over the given bounds. Vertices outside
+				* of them go to the nearest cell.
+				* @param min minimum corner of the bounds
+				* @param max maximum corner of the bounds
+				* @param resolution number of cells along the longest side
+				*/
+				VertexClusterer(
+					const repo::lib::RepoVector3D &min,
+					const repo::lib::RepoVector3D &max,
+					const uint32_t                &resolution);
+
+				/**
+				* Add the triangles of a mesh
+				* @param vertices positions of the vertices
+				* @param nVertices number of vertices, indices out of range are ignored
+				* @param indices triangle list
+				* @param nTriangles number of triangles
+				*/
+				void addTriangles(
+					const repo::lib::RepoVector3D *vertices,
+					const size_t                  &nVertices,
+					const uint32_t                *indices,
+					const size_t                  &nTriangles);
+
+				/**
+				* @return returns the vertices of the clustered mesh
+				*/
+				std::vector<repo::lib::RepoVector3D> getVertices() const;
+
+				/**
+				* @return returns the triangle list of the clustered mesh
+				*/
+				const std::vector<uint32_t>& getIndices() const
+				{
+					return indices;
+				}
+
+			private:
+				struct TriangleHasher
+				{
+					size_t operator()(const std::array<uint32_t, 3> &triangle) const;
+				};
+
+				repo::lib::RepoVector3D min;
+				float cellSize;
+				uint32_t dimensions[3];
+				//cell of each vertex of the clustered mesh
+				std::unordered_map<uint64_t, uint32_t> cells;
+				std::vector<double> sums;
+				std::vector<uint32_t> counts;
+				std::vector<uint32_t> indices;
+				std::unordered_set<std::array<uint32_t, 3>, TriangleHasher> triangles;
+
+				/**
+				* Get the vertex of the clustered mesh for a position,
+				* creating it if it is the first in its cell
+				* @param position position to look up
+				* @return returns the index of the vertex
+				*/
+				uint32_t findCell(
+					const repo::lib::RepoVector3D &position);
+			};
+		}
+	}
+}
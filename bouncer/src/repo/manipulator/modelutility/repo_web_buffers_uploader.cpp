@@ -0,0 +1,159 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_web_buffers_uploader.h"
+#include "../../lib/repo_log.h"
+
+using namespace repo::manipulator::modelutility;
+
+WebBuffersUploader::WebBuffersUploader(
+	repo::core::handler::fileservice::FileManager *fileManager,
+	const std::string                             &databaseName,
+	const std::string                             &geoCollection,
+	const std::string                             &jsonCollection,
+	const uint32_t                                &nThreads,
+	const uint32_t                                &maxInFlight)
+	: fileManager(fileManager),
+	databaseName(databaseName),
+	geoCollection(geoCollection),
+	jsonCollection(jsonCollection),
+	maxInFlight(maxInFlight ? maxInFlight : 1),
+	inFlight(0),
+	nGeoFiles(0),
+	finished(false),
+	success(fileManager != nullptr)
+{
+	if (!fileManager)
+	{
+		repoError << "Cannot upload web buffers: no file manager!";
+	}
+
+	const uint32_t nWorkers = nThreads ? nThreads : 1;
+	for (uint32_t i = 0; i < nWorkers; ++i)
+	{
+		workers.create_thread(boost::bind(&WebBuffersUploader::processQueue, this));
+	}
+}
+
+WebBuffersUploader::~WebBuffersUploader()
+{
+	finalise();
+}
+
+bool WebBuffersUploader::addGeometryFile(
+	const std::string    &fileName,
+	std::vector<uint8_t> &&buffer)
+{
+	bool added = enqueue(geoCollection, fileName, std::move(buffer));
+	if (added) ++nGeoFiles;
+	return added;
+}
+
+bool WebBuffersUploader::addJSONFile(
+	const std::string    &fileName,
+	std::vector<uint8_t> &&buffer)
+{
+	return enqueue(jsonCollection, fileName, std::move(buffer));
+}
+
+bool WebBuffersUploader::enqueue(
+	const std::string    &collection,
+	const std::string    &fileName,
+	std::vector<uint8_t> &&buffer)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	while (!finished && success && queue.size() + inFlight >= maxInFlight)
+	{
+		slotAvailable.wait(lock);
+	}
+
+	if (finished || !success)
+	{
+		repoError << "Failed to queue file (" << fileName << ") for upload: " << (finished ? "uploader is finalised" : "a previous upload failed");
+		return false;
+	}
+
+	queue.push_back({ collection, fileName, std::move(buffer) });
+	jobAvailable.notify_one();
+	return true;
+}
+
+bool WebBuffersUploader::finalise()
+{
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		finished = true;
+	}
+	jobAvailable.notify_all();
+	slotAvailable.notify_all();
+	workers.join_all();
+
+	return success;
+}
+
+void WebBuffersUploader::processQueue()
+{
+	while (true)
+	{
+		UploadJob job;
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			while (!finished && queue.empty())
+			{
+				jobAvailable.wait(lock);
+			}
+
+			if (queue.empty())
+				break;
+
+			job = std::move(queue.front());
+			queue.pop_front();
+			++inFlight;
+		}
+
+		//Nothing may escape a worker thread, so a throwing upload fails the commit like any other failed upload
+		bool uploaded = false;
+		try
+		{
+			uploaded = fileManager && fileManager->uploadFileAndCommit(databaseName, job.collection, job.fileName, job.buffer);
+		}
+		catch (const std::exception &e)
+		{
+			repoError << "Exception whilst uploading file (" << job.fileName << "): " << e.what();
+		}
+		catch (...)
+		{
+			repoError << "Unknown exception whilst uploading file (" << job.fileName << ")";
+		}
+
+		if (uploaded)
+		{
+			repoInfo << "File (" << job.fileName << ") added successfully to file storage.";
+		}
+		else
+		{
+			repoError << "Failed to add file  (" << job.fileName << ") to file storage";
+		}
+
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			--inFlight;
+			success &= uploaded;
+		}
+		slotAvailable.notify_all();
+	}
+}
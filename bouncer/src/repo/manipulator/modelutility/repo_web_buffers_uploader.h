@@ -0,0 +1,118 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Export sink that uploads web buffers through the file manager as soon as
+* the exporter hands them over. Uploads run on a small pool of worker threads,
+* and the amount of data waiting to be uploaded is bounded.
+*/
+
+#pragma once
+
+#include <deque>
+#include <boost/thread.hpp>
+
+#include "../../core/handler/fileservice/repo_file_manager.h"
+#include "../modelconvertor/export/repo_model_export_sink_abstract.h"
+
+namespace repo {
+	namespace manipulator {
+		namespace modelutility {
+			class WebBuffersUploader : public repo::manipulator::modelconvertor::AbstractWebExportSink
+			{
+			public:
+				/**
+				* Construct an uploader and start its worker threads
+				* @param fileManager file manager to upload with
+				* @param databaseName database to upload into
+				* @param geoCollection collection prefix for geometry files
+				* @param jsonCollection collection prefix for JSON files
+				* @param nThreads number of concurrent uploads
+				* @param maxInFlight maximum number of files queued or being uploaded
+				*/
+				WebBuffersUploader(
+					repo::core::handler::fileservice::FileManager *fileManager,
+					const std::string                             &databaseName,
+					const std::string                             &geoCollection,
+					const std::string                             &jsonCollection,
+					const uint32_t                                &nThreads = 4,
+					const uint32_t                                &maxInFlight = 8);
+
+				/**
+				* Waits for any pending uploads before destruction
+				*/
+				~WebBuffersUploader();
+
+				bool addGeometryFile(
+					const std::string    &fileName,
+					std::vector<uint8_t> &&buffer);
+
+				bool addJSONFile(
+					const std::string    &fileName,
+					std::vector<uint8_t> &&buffer);
+
+				bool finalise();
+
+				/**
+				* Get the number of geometry files handed to this uploader
+				* @return returns the number of geometry files
+				*/
+				size_t getNumGeometryFiles() const
+				{
+					return nGeoFiles;
+				}
+
+			private:
+				struct UploadJob {
+					std::string collection;
+					std::string fileName;
+					std::vector<uint8_t> buffer;
+				};
+
+				/**
+				* Queue a file for upload, blocking whilst the queue is full
+				*/
+				bool enqueue(
+					const std::string    &collection,
+					const std::string    &fileName,
+					std::vector<uint8_t> &&buffer);
+
+				/**
+				* Worker loop, uploading queued files until finalised
+				*/
+				void processQueue();
+
+				repo::core::handler::fileservice::FileManager *fileManager;
+				const std::string databaseName;
+				const std::string geoCollection;
+				const std::string jsonCollection;
+				const uint32_t maxInFlight;
+
+				std::deque<UploadJob> queue;
+				uint32_t inFlight;
+				size_t nGeoFiles;
+				bool finished;
+				bool success;
+
+				boost::mutex mutex;
+				boost::condition_variable jobAvailable;
+				boost::condition_variable slotAvailable;
+				boost::thread_group workers;
+			};
+		}
+	}
+}
@@ -16,9 +16,85 @@
 */
 
 #include "repo_spatial_partitioner_abstract.h"
+#include "../repo_vertex_clusterer.h"
+#include "../../../core/model/bson/repo_node_mesh.h"
+
+#include <limits>
 
 using namespace repo::manipulator::modelutility;
 
+const uint32_t AbstractSpatialPartitioner::DEFAULT_PROXY_RESOLUTION;
+
+static void getLeaves(
+	const std::shared_ptr<repo_partitioning_tree_t>        &spTree,
+	std::vector<std::shared_ptr<repo_partitioning_tree_t>> &leaves)
+{
+	if (!spTree)
+		return;
+
+	if (repo::PartitioningTreeType::LEAF_NODE == spTree->type)
+	{
+		leaves.push_back(spTree);
+	}
+	else
+	{
+		getLeaves(spTree->left, leaves);
+		getLeaves(spTree->right, leaves);
+	}
+}
+
+/**
+* Cluster the proxies of the children of each branch, from the bottom up,
+* and name every proxy in depth first order
+*/
+static void clusterBranchProxies(
+	const std::shared_ptr<repo_partitioning_tree_t> &spTree,
+	const uint32_t                                  &resolution,
+	uint32_t                                        &count)
+{
+	if (!spTree)
+		return;
+
+	if (repo::PartitioningTreeType::LEAF_NODE != spTree->type)
+	{
+		clusterBranchProxies(spTree->left, resolution, count);
+		clusterBranchProxies(spTree->right, resolution, count);
+
+		const float inf = std::numeric_limits<float>::max();
+		repo::lib::RepoVector3D min(inf, inf, inf), max(-inf, -inf, -inf);
+		for (const auto &child : { spTree->left, spTree->right })
+		{
+			if (!child)
+				continue;
+			for (const auto &v : child->proxy.vertices)
+			{
+				min.x = std::min(min.x, v.x); min.y = std::min(min.y, v.y); min.z = std::min(min.z, v.z);
+				max.x = std::max(max.x, v.x); max.y = std::max(max.y, v.y); max.z = std::max(max.z, v.z);
+			}
+		}
+
+		if (min.x <= max.x)
+		{
+			VertexClusterer clusterer(min, max, resolution);
+			for (const auto &child : { spTree->left, spTree->right })
+			{
+				if (child && child->proxy.faces.size())
+				{
+					clusterer.addTriangles(child->proxy.vertices.data(), child->proxy.vertices.size(),
+						child->proxy.faces.data(), child->proxy.faces.size() / 3);
+				}
+			}
+			spTree->proxy.vertices = clusterer.getVertices();
+			spTree->proxy.faces = clusterer.getIndices();
+		}
+	}
+
+	if (spTree->proxy.faces.size())
+	{
+		spTree->proxy.name = "proxy_" + std::to_string(count++);
+	}
+}
+
 AbstractSpatialPartitioner::AbstractSpatialPartitioner(
 	const repo::core::model::RepoScene *scene,
 	const uint32_t                      &maxDepth)
@@ -38,6 +114,125 @@ repo::lib::PropertyTree AbstractSpatialPartitioner::generatePropertyTreeForParti
 	return generatePropertyTreeForPartitioningInternal(partitionScene());
 }
 
+repo::lib::PropertyTree AbstractSpatialPartitioner::generatePropertyTreeForPartitioning(
+	const std::shared_ptr<repo_partitioning_tree_t> &spTree) const
+{
+	return generatePropertyTreeForPartitioningInternal(spTree);
+}
+
+void AbstractSpatialPartitioner::generateProxies(
+	const std::shared_ptr<repo_partitioning_tree_t> &spTree,
+	const uint32_t                                  &resolution) const
+{
+	if (!spTree || !scene)
+		return;
+
+	std::vector<std::shared_ptr<repo_partitioning_tree_t>> leaves;
+	getLeaves(spTree, leaves);
+
+	//A mesh may span several leaves
+	std::unordered_map<repo::lib::RepoUUID, std::vector<size_t>, repo::lib::RepoUUIDHasher> meshLeaves;
+	for (size_t i = 0; i < leaves.size(); ++i)
+	{
+		for (const auto &entry : leaves[i]->meshes)
+			meshLeaves[entry.id].push_back(i);
+	}
+
+	//Meshes are clipped to their leaves in the partitioning, so their full
+	//extent is taken from the mesh mappings instead
+	const float inf = std::numeric_limits<float>::max();
+	std::vector<repo::lib::RepoVector3D> leafMin(leaves.size(), { inf, inf, inf });
+	std::vector<repo::lib::RepoVector3D> leafMax(leaves.size(), { -inf, -inf, -inf });
+	auto expand = [&](const repo::lib::RepoUUID &id, const repo::lib::RepoVector3D &min, const repo::lib::RepoVector3D &max)
+	{
+		auto it = meshLeaves.find(id);
+		if (it == meshLeaves.end())
+			return;
+		for (const auto &leaf : it->second)
+		{
+			leafMin[leaf].x = std::min(leafMin[leaf].x, min.x); leafMax[leaf].x = std::max(leafMax[leaf].x, max.x);
+			leafMin[leaf].y = std::min(leafMin[leaf].y, min.y); leafMax[leaf].y = std::max(leafMax[leaf].y, max.y);
+			leafMin[leaf].z = std::min(leafMin[leaf].z, min.z); leafMax[leaf].z = std::max(leafMax[leaf].z, max.z);
+		}
+	};
+
+	std::vector<const repo::core::model::MeshNode*> meshes;
+	for (const auto &node : scene->getAllMeshes(gType))
+	{
+		const auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
+		if (!mesh || mesh->getPrimitive() != repo::core::model::MeshNode::Primitive::TRIANGLES)
+			continue;
+
+		meshes.push_back(mesh);
+		auto mappings = mesh->getMeshMapping();
+		for (const auto &mapping : mappings)
+			expand(mapping.mesh_id, mapping.min, mapping.max);
+		if (mappings.empty())
+		{
+			auto bbox = mesh->getBoundingBox();
+			if (bbox.size() == 2)
+				expand(mesh->getUniqueID(), bbox[0], bbox[1]);
+		}
+	}
+
+	std::vector<std::unique_ptr<VertexClusterer>> clusterers(leaves.size());
+	for (size_t i = 0; i < leaves.size(); ++i)
+	{
+		if (leafMin[i].x <= leafMax[i].x)
+			clusterers[i].reset(new VertexClusterer(leafMin[i], leafMax[i], resolution));
+	}
+
+	//Meshes are read once, and added to every leaf they are in
+	for (const auto &mesh : meshes)
+	{
+		auto mappings = mesh->getMeshMapping();
+		auto vertices = mesh->getVertices();
+		auto faces = mesh->getFaces();
+		if (mappings.empty())
+		{
+			repo_mesh_mapping_t mapping;
+			mapping.mesh_id = mesh->getUniqueID();
+			mapping.triFrom = 0;
+			mapping.triTo = faces.size();
+			mappings.push_back(mapping);
+		}
+
+		std::vector<uint32_t> triangles;
+		for (const auto &mapping : mappings)
+		{
+			auto it = meshLeaves.find(mapping.mesh_id);
+			if (it == meshLeaves.end() || mapping.triFrom < 0 || mapping.triTo > (int32_t)faces.size())
+				continue;
+
+			triangles.clear();
+			for (int32_t i = mapping.triFrom; i < mapping.triTo; ++i)
+			{
+				if (faces[i].size() == 3)
+					triangles.insert(triangles.end(), faces[i].begin(), faces[i].end());
+			}
+
+			for (const auto &leaf : it->second)
+			{
+				if (clusterers[leaf])
+					clusterers[leaf]->addTriangles(vertices.data(), vertices.size(), triangles.data(), triangles.size() / 3);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < leaves.size(); ++i)
+	{
+		if (clusterers[i])
+		{
+			leaves[i]->proxy.vertices = clusterers[i]->getVertices();
+			leaves[i]->proxy.faces = clusterers[i]->getIndices();
+			clusterers[i].reset();
+		}
+	}
+
+	uint32_t count = 0;
+	clusterBranchProxies(spTree, resolution, count);
+}
+
 repo::lib::PropertyTree AbstractSpatialPartitioner::generatePropertyTreeForPartitioningInternal(
 	const std::shared_ptr<repo_partitioning_tree_t> &spTree) const
 {
@@ -45,6 +240,11 @@ repo::lib::PropertyTree AbstractSpatialPartitioner::generatePropertyTreeForParti
 
 	if (spTree)
 	{
+		if (spTree->proxy.faces.size())
+		{
+			tree.addToTree("proxy", spTree->proxy.name);
+		}
+
 		if (repo::PartitioningTreeType::LEAF_NODE == spTree->type)
 		{
 			repo::lib::PropertyTree meshesTree;
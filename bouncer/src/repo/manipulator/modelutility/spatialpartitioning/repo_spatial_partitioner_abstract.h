@@ -27,6 +27,8 @@ namespace repo{
 			class AbstractSpatialPartitioner
 			{
 			public:
+				static const uint32_t DEFAULT_PROXY_RESOLUTION = 32;
+
 				/**
 				* Abstract Spatial Partitioning utility class
 				* to spatially divide a scene graph base on its meshes
@@ -53,6 +55,27 @@ namespace repo{
 				virtual repo::lib::PropertyTree
 					generatePropertyTreeForPartitioning();
 
+				/**
+				* Generate a property tree representing a partitioning
+				* @param spTree partitioning from partitionScene()
+				* @return returns the spatial partitioning information as a property tree
+				*/
+				repo::lib::PropertyTree generatePropertyTreeForPartitioning(
+					const std::shared_ptr<repo_partitioning_tree_t> &spTree) const;
+
+				/**
+				* Generate proxy geometry for the nodes of a partitioning, so that
+				* distant partitions can be drawn without loading their meshes.
+				* The meshes of each leaf are clustered into a grid of cells, then
+				* the proxies of the children of each branch into a coarser one.
+				* With the default resolution, proxies have less than 65536 vertices.
+				* @param spTree partitioning from partitionScene(), proxies are added to its nodes
+				* @param resolution number of cells along the longest side of each node
+				*/
+				void generateProxies(
+					const std::shared_ptr<repo_partitioning_tree_t> &spTree,
+					const uint32_t                                  &resolution = DEFAULT_PROXY_RESOLUTION) const;
+
 			protected:
 				const repo::core::model::RepoScene            *scene;
 				const uint32_t                                maxDepth;
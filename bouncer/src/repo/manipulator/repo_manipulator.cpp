@@ -29,6 +29,7 @@
 #include "../error_codes.h"
 #include "../lib/repo_log.h"
 #include "../lib/repo_config.h"
+#include "../lib/repo_profiler.h"
 #include "diff/repo_diff_name.h"
 #include "diff/repo_diff_sharedid.h"
 #include "modelconvertor/import/repo_model_import_manager.h"
@@ -149,6 +150,17 @@ bool RepoManipulator::commitAssetBundleBuffers(
 	return SceneManager.commitWebBuffers(scene, REPO_COLLECTION_STASH_UNITY, buffers, handler, manager, true);
 }
 
+bool RepoManipulator::attachProfileToRevision(
+	const std::string                     &databaseAd,
+	const repo::core::model::RepoBSON     *cred,
+	repo::core::model::RepoScene          *scene)
+{
+	repo::core::handler::AbstractDatabaseHandler* handler =
+		repo::core::handler::MongoDatabaseHandler::getHandler(databaseAd);
+	auto profile = repo::core::model::RepoBSON::fromJSON(repo::lib::RepoProfiler::getInstance().toJSON());
+	return scene->attachProfileToRevision(handler, profile);
+}
+
 uint8_t RepoManipulator::commitScene(
 	const std::string                      &databaseAd,
 	const repo::core::model::RepoBSON      *cred,
@@ -719,13 +731,19 @@ bool RepoManipulator::init(
 	return success;
 }
 
-std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoManipulator::initialiseAssetBuffer(
+/**
+* Generate the asset bundle buffers of a scene
+* @param indexFormat index format the bundles will be built with
+* @param serialisedFaceBuf (output) face buffers, serialised with IndexType
+*/
+template <typename IndexType>
+static std::vector<std::shared_ptr<repo::core::model::MeshNode>> generateAssetBuffers(
 	const std::string                             &databaseAd,
-	const repo::core::model::RepoBSON	          *cred,
 	repo::core::model::RepoScene *scene,
+	const repo::manipulator::modelconvertor::WebIndexFormat &indexFormat,
 	std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
 	repo::core::model::RepoUnityAssets &unityAssets,
-	std::vector<std::vector<uint16_t>> &serialisedFaceBuf,
+	std::vector<std::vector<IndexType>> &serialisedFaceBuf,
 	std::vector<std::vector<std::vector<float>>> &idMapBuf,
 	std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings)
 {
@@ -737,12 +755,43 @@ std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoManipulator::initi
 		modelutility::SceneManager sceneManager;
 		vrEnabled = sceneManager.isVrEnabled(scene, handler);
 	}
-	repo::manipulator::modelconvertor::AssetModelExport assetExport(scene, vrEnabled);
+	REPO_PROFILE_SCOPE("AssetModelExport");
+	repo::manipulator::modelconvertor::WebExportOptions options;
+	options.indexFormat = indexFormat;
+	repo::manipulator::modelconvertor::AssetModelExport assetExport(scene, vrEnabled, options);
 	jsonFiles = assetExport.getJSONFilesAsBuffer();
 	unityAssets = assetExport.getUnityAssets();
 	return assetExport.getReorganisedMeshes(serialisedFaceBuf, idMapBuf, meshMappings);
 }
 
+std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoManipulator::initialiseAssetBuffer(
+	const std::string                             &databaseAd,
+	const repo::core::model::RepoBSON	          *cred,
+	repo::core::model::RepoScene *scene,
+	std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
+	repo::core::model::RepoUnityAssets &unityAssets,
+	std::vector<std::vector<uint16_t>> &serialisedFaceBuf,
+	std::vector<std::vector<std::vector<float>>> &idMapBuf,
+	std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings)
+{
+	return generateAssetBuffers(databaseAd, scene, repo::manipulator::modelconvertor::WebIndexFormat::UINT16,
+		jsonFiles, unityAssets, serialisedFaceBuf, idMapBuf, meshMappings);
+}
+
+std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoManipulator::initialiseAssetBuffer(
+	const std::string                             &databaseAd,
+	const repo::core::model::RepoBSON	          *cred,
+	repo::core::model::RepoScene *scene,
+	std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
+	repo::core::model::RepoUnityAssets &unityAssets,
+	std::vector<std::vector<uint32_t>> &serialisedFaceBuf,
+	std::vector<std::vector<std::vector<float>>> &idMapBuf,
+	std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings)
+{
+	return generateAssetBuffers(databaseAd, scene, repo::manipulator::modelconvertor::WebIndexFormat::UINT32,
+		jsonFiles, unityAssets, serialisedFaceBuf, idMapBuf, meshMappings);
+}
+
 bool RepoManipulator::insertBinaryFileToDatabase(
 	const std::string                             &databaseAd,
 	const repo::core::model::RepoBSON             *cred,
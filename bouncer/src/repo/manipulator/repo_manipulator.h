@@ -41,6 +41,18 @@ namespace repo {
 			RepoManipulator();
 			~RepoManipulator();
 
+			/**
+			* Attach the report of the current profiler job to the scene's revision
+			* @param databaseAd mongo database address:port
+			* @param cred user credentials in bson form
+			* @param scene a committed scene
+			* @return returns true upon success
+			*/
+			bool attachProfileToRevision(
+				const std::string                     &databaseAd,
+				const repo::core::model::RepoBSON     *cred,
+				repo::core::model::RepoScene          *scene);
+
 			/**
 			* Commit a scene graph
 			* @param databaseAd mongo database address:port
@@ -488,6 +500,26 @@ namespace repo {
 				std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings
 			);
 
+			/**
+			* Initialise Assetbuffer for asset bundles built with 32 bit indices.
+			* Meshes are not split into sub meshes of at most 65535 vertices.
+			* @param databaseAd database address:portdatabase
+			* @param cred user credentials in bson form
+			* @param scene the scene to generate the src encoding from
+			* @param json  (output) generated json files generated by this initilaisation
+			* @return returns mesh nodes reorganised for bundling
+			*/
+			std::vector<std::shared_ptr<repo::core::model::MeshNode>> initialiseAssetBuffer(
+				const std::string                             &databaseAd,
+				const repo::core::model::RepoBSON	          *cred,
+				repo::core::model::RepoScene *scene,
+				std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
+				repo::core::model::RepoUnityAssets &unityAssets,
+				std::vector<std::vector<uint32_t>> &serialisedFaceBuf,
+				std::vector<std::vector<std::vector<float>>> &idMapBuf,
+				std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings
+			);
+
 			/**
 			* Insert a binary file into the database (GridFS)
 			* @param databaseAd database address:portdatabase
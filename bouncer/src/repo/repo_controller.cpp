@@ -83,6 +83,13 @@ uint8_t RepoController::commitScene(
 	return impl->commitScene(token, scene, owner, tag, desc, revId);
 }
 
+bool RepoController::attachProfileToRevision(
+	const RepoController::RepoToken    *token,
+	repo::core::model::RepoScene        *scene)
+{
+	return impl->attachProfileToRevision(token, scene);
+}
+
 uint64_t RepoController::countItemsInCollection(
 	const RepoController::RepoToken            *token,
 	const std::string    &database,
@@ -287,6 +294,11 @@ void RepoController::logToFile(const std::string &filePath)
 	impl->logToFile(filePath);
 }
 
+void RepoController::clearMeshCache()
+{
+	impl->clearMeshCache();
+}
+
 repo::core::model::RepoScene* RepoController::createFederatedScene(
 	const std::map<repo::core::model::TransformationNode, repo::core::model::ReferenceNode> &fedMap)
 {
@@ -365,6 +377,18 @@ std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoController::initia
 	return impl->initialiseAssetBuffer(token, scene, jsonFiles, unityAssets, serialisedFaceBuf, idMapBuf, meshMappings);
 }
 
+std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoController::initialiseAssetBuffer(
+	const RepoController::RepoToken                    *token,
+	repo::core::model::RepoScene *scene,
+	std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
+	repo::core::model::RepoUnityAssets &unityAssets,
+	std::vector<std::vector<uint32_t>> &serialisedFaceBuf,
+	std::vector<std::vector<std::vector<float>>> &idMapBuf,
+	std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings)
+{
+	return impl->initialiseAssetBuffer(token, scene, jsonFiles, unityAssets, serialisedFaceBuf, idMapBuf, meshMappings);
+}
+
 repo::core::model::RepoNodeSet RepoController::loadMetadataFromFile(
 	const std::string &filePath,
 	const char        &delimiter)
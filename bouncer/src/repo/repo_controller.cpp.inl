@@ -16,6 +16,8 @@
 */
 #pragma once
 #include "lib/repo_stack.h"
+#include "lib/repo_task_executor.h"
+#include "manipulator/modelutility/repo_mesh_reorganiser_cache.h"
 #include "manipulator/repo_manipulator.h"
 #include "repo_controller.h"
 #include "core/model/bson/repo_bson_builder.h"
@@ -315,6 +317,16 @@ public:
 		const std::string                      &desc = "",
 		const repo::lib::RepoUUID           &revId = repo::lib::RepoUUID::createUUID());
 
+	/**
+	* Attach the report of the current profiler job to the scene's revision
+	* @param token Authentication token
+	* @param scene a committed scene
+	* @return returns true upon success
+	*/
+	bool attachProfileToRevision(
+		const RepoToken                     *token,
+		repo::core::model::RepoScene        *scene);
+
 	/**
 	* Insert a binary file into the database (GridFS)
 	* @param token Authentication token
@@ -500,6 +512,11 @@ public:
 	*/
 	void logToFile(const std::string &filePath);
 
+	/**
+	* Drop the mesh reorganisations cached for the web exports
+	*/
+	void clearMeshCache();
+
 	/*
 	*	------------- Import/ Export --------------
 	*/
@@ -600,6 +617,22 @@ public:
 		std::vector<std::vector<std::vector<float>>> &idMapBuf,
 		std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings);
 
+	/**
+	* Initialise Assetbuffer for asset bundles built with 32 bit indices.
+	* Meshes are not split into sub meshes of at most 65535 vertices.
+	* @param scene the scene to generate the src encoding from
+	* @param json  (output) generated json files generated by this initilaisation
+	* @return returns mesh nodes reorganised for bundling
+	*/
+	std::vector<std::shared_ptr<repo::core::model::MeshNode>> initialiseAssetBuffer(
+		const RepoController::RepoToken                    *token,
+		repo::core::model::RepoScene *scene,
+		std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
+		repo::core::model::RepoUnityAssets &unityAssets,
+		std::vector<std::vector<uint32_t>> &serialisedFaceBuf,
+		std::vector<std::vector<std::vector<float>>> &idMapBuf,
+		std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings);
+
 	/**
 	* Check if VR is enabled for this model
 	* @param token repo token to the database
@@ -761,4 +794,7 @@ private:
 
 	lib::RepoStack<manipulator::RepoManipulator> workerPool;
 	const uint32_t numDBConnections;
+	std::unique_ptr<lib::RepoTaskExecutor> executor; //created by the first init(), shared by all workers
+	std::unique_ptr<manipulator::modelutility::MeshReorganiserCache> reorganiserCache; //as above, shared by all web exports
+	boost::mutex executorMutex;
 };
\ No newline at end of file
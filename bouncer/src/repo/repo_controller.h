@@ -51,7 +51,9 @@ namespace repo {
 			* Constructor
 			* @param listeners a list of listeners subscribing to the log
 			* @param numConcurrentOps maximum number of requests it can handle concurrently
-			* @param numDBConn number of concurrent connections to the database
+			* @param numDBConn number of concurrent connections to the database. This is
+			*        raised to cover the task executor threads (sized by the "threads"
+			*        entry of the config, one per hardware thread by default) on init()
 			*/
 		RepoController(
 			std::vector<lib::RepoAbstractListener*> listeners = std::vector<lib::RepoAbstractListener *>(),
@@ -312,6 +314,17 @@ namespace repo {
 			const std::string                      &desc = "",
 			const repo::lib::RepoUUID           &revId = repo::lib::RepoUUID::createUUID());
 
+		/**
+		* Attach the report of the current profiler job (see
+		* repo::lib::RepoProfiler) to the scene's revision
+		* @param token Authentication token
+		* @param scene a committed scene
+		* @return returns true upon success
+		*/
+		bool attachProfileToRevision(
+			const RepoToken                     *token,
+			repo::core::model::RepoScene        *scene);
+
 		/**
 		* Insert a binary file into the database (GridFS)
 		* @param token Authentication token
@@ -497,6 +510,12 @@ namespace repo {
 			*/
 		void logToFile(const std::string &filePath);
 
+		/**
+			* Drop the mesh reorganisations cached for the web exports,
+			* e.g. once a job has finished with its meshes
+			*/
+		void clearMeshCache();
+
 		/*
 			*	------------- Import/ Export --------------
 			*/
@@ -598,6 +617,22 @@ namespace repo {
 			std::vector<std::vector<std::vector<float>>> &idMapBuf,
 			std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings);
 
+		/**
+		* Initialise Assetbuffer for asset bundles built with 32 bit indices.
+		* Meshes are not split into sub meshes of at most 65535 vertices.
+		* @param scene the scene to generate the src encoding from
+		* @param json  (output) generated json files generated by this initilaisation
+		* @return returns mesh nodes reorganised for bundling
+		*/
+		std::vector<std::shared_ptr<repo::core::model::MeshNode>> initialiseAssetBuffer(
+			const RepoController::RepoToken                    *token,
+			repo::core::model::RepoScene *scene,
+			std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
+			repo::core::model::RepoUnityAssets &unityAssets,
+			std::vector<std::vector<uint32_t>> &serialisedFaceBuf,
+			std::vector<std::vector<std::vector<float>>> &idMapBuf,
+			std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings);
+
 		/**
 			* Load a Repo Scene from a file
 			* @param filePath path to file
@@ -42,6 +42,20 @@ RepoController::_RepoControllerImpl::_RepoControllerImpl(
 
 RepoController::_RepoControllerImpl::~_RepoControllerImpl()
 {
+	if (executor)
+	{
+		if (&lib::RepoTaskExecutor::getDefault() == executor.get())
+			lib::RepoTaskExecutor::setDefault(nullptr);
+		executor.reset();
+	}
+
+	if (reorganiserCache)
+	{
+		if (manipulator::modelutility::MeshReorganiserCache::getShared() == reorganiserCache.get())
+			manipulator::modelutility::MeshReorganiserCache::setShared(nullptr);
+		reorganiserCache.reset();
+	}
+
 	std::vector<manipulator::RepoManipulator*> workers = workerPool.empty();
 	std::vector<manipulator::RepoManipulator*>::iterator it;
 	for (it = workers.begin(); it != workers.end(); ++it)
@@ -59,12 +73,33 @@ RepoController::RepoToken* RepoController::_RepoControllerImpl::init(
 {
 	RepoToken *token = nullptr;
 	if (config.validate()) {
+		uint32_t nThreads;
+		{
+			boost::mutex::scoped_lock lock(executorMutex);
+			if (!executor)
+			{
+				executor.reset(new lib::RepoTaskExecutor(config.getNumThreads()));
+				lib::RepoTaskExecutor::setDefault(executor.get());
+				repoInfo << "Running parallel tasks on " << executor->getNumThreads() << " threads";
+			}
+			nThreads = executor->getNumThreads();
+
+			if (!reorganiserCache && config.getMeshCacheSize())
+			{
+				reorganiserCache.reset(new manipulator::modelutility::MeshReorganiserCache(size_t(config.getMeshCacheSize()) << 20));
+				manipulator::modelutility::MeshReorganiserCache::setShared(reorganiserCache.get());
+			}
+		}
+
 		manipulator::RepoManipulator* worker = workerPool.pop();
 
 		auto dbConf = config.getDatabaseConfig();
 
+		//Each executor thread may need a connection of its own on top of the concurrent requests
+		const uint32_t nConnections = std::max(numDBConnections, nThreads + 1);
+
 		//FIXME : this should just use the dbConf struct...
-		const bool success = worker->init(errMsg, config, numDBConnections);
+		const bool success = worker->init(errMsg, config, nConnections);
 
 		if (success)
 		{
@@ -102,6 +137,25 @@ bool RepoController::_RepoControllerImpl::commitAssetBundleBuffers(
 	return success;
 }
 
+bool RepoController::_RepoControllerImpl::attachProfileToRevision(
+	const RepoController::RepoToken     *token,
+	repo::core::model::RepoScene        *scene)
+{
+	bool success = false;
+	if (token && scene && scene->isRevisioned())
+	{
+		manipulator::RepoManipulator* worker = workerPool.pop();
+		success = worker->attachProfileToRevision(token->databaseAd, token->getCredentials(), scene);
+		workerPool.push(worker);
+	}
+	else
+	{
+		repoError << "Trying to attach a profile without a database connection or a committed scene!";
+	}
+
+	return success;
+}
+
 uint8_t RepoController::_RepoControllerImpl::commitScene(
 	const RepoController::RepoToken                     *token,
 	repo::core::model::RepoScene        *scene,
@@ -671,6 +725,13 @@ void RepoController::_RepoControllerImpl::logToFile(const std::string &filePath)
 	repo::lib::RepoLog::getInstance().logToFile(filePath);
 }
 
+void RepoController::_RepoControllerImpl::clearMeshCache()
+{
+	boost::mutex::scoped_lock lock(executorMutex);
+	if (reorganiserCache)
+		reorganiserCache->clear();
+}
+
 void RepoController::_RepoControllerImpl::subscribeToLogger(
 	std::vector<lib::RepoAbstractListener*> listeners)
 {
@@ -879,6 +940,30 @@ std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoController::_RepoC
 	return res;
 }
 
+std::vector<std::shared_ptr<repo::core::model::MeshNode>> RepoController::_RepoControllerImpl::initialiseAssetBuffer(
+	const RepoController::RepoToken                    *token,
+	repo::core::model::RepoScene *scene,
+	std::unordered_map<std::string, std::vector<uint8_t>> &jsonFiles,
+	repo::core::model::RepoUnityAssets &unityAssets,
+	std::vector<std::vector<uint32_t>> &serialisedFaceBuf,
+	std::vector<std::vector<std::vector<float>>> &idMapBuf,
+	std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> &meshMappings)
+{
+	std::vector<std::shared_ptr<repo::core::model::MeshNode>> res;
+	if (scene)
+	{
+		manipulator::RepoManipulator* worker = workerPool.pop();
+		res = worker->initialiseAssetBuffer(token->databaseAd, token->getCredentials(), scene, jsonFiles, unityAssets, serialisedFaceBuf, idMapBuf, meshMappings);
+		workerPool.push(worker);
+	}
+	else
+	{
+		repoError << "Trying to generate Asset buffer without a scene";
+	}
+
+	return res;
+}
+
 repo::core::model::RepoNodeSet RepoController::_RepoControllerImpl::loadMetadataFromFile(
 	const std::string &filePath,
 	const char        &delimiter)
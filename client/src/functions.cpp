@@ -18,18 +18,23 @@
 #include "functions.h"
 
 #include <repo/core/model/bson/repo_bson_factory.h>
+#include <repo/lib/repo_profiler.h>
 
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <cctype>
+#include <memory>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
 
 static const std::string FBX_EXTENSION = ".FBX";
 
 static const std::string cmdCreateFed = "genFed"; //create a federation
+static const std::string cmdDaemon = "daemon"; //keep running jobs read from stdin
 static const std::string cmdGenStash = "genStash";   //test the connection
 static const std::string cmdGetFile = "getFile"; //download original file
 static const std::string cmdImportFile = "import"; //file import
@@ -37,6 +42,10 @@ static const std::string cmdTestConn = "test";   //test the connection
 static const std::string cmdVersion = "version";   //get version
 static const std::string cmdVersion2 = "-v";   //get version
 
+static const std::string daemonExit = "exit"; //stops the daemon
+static const std::string daemonJobDone = "REPO_JOB_DONE"; //reported by the daemon as jobs finish
+static const uint32_t daemonDefaultJobs = 4;
+
 std::string helpInfo()
 {
 	std::stringstream ss;
@@ -45,6 +54,7 @@ std::string helpInfo()
 	ss << cmdGetFile << "\t\tGet original file for the latest revision of the project (args: database project dir)\n";
 	ss << cmdImportFile << "\t\tImport file to database. (args: {file database project [dxrotate] [owner] [configfile]} or {-f parameterFile} )\n";
 	ss << cmdCreateFed << "\t\tGenerate a federation. (args: fedDetails [owner])\n";
+	ss << cmdDaemon << "\t\tRun jobs read from stdin as \"jobId command [args]\" lines until \"" << daemonExit << "\". (args: [nConcurrentJobs])\n";
 	ss << cmdTestConn << "\t\tTest the client and database connection is working. (args: none)\n";
 	ss << cmdVersion << "[-v]\tPrints the version of Repo Bouncer Client/Library\n";
 
@@ -56,6 +66,23 @@ bool isSpecialCommand(const std::string &cmd)
 	return cmd == cmdVersion || cmd == cmdVersion2;
 }
 
+bool isDaemonCommand(const repo_op_t &command)
+{
+	return command.command == cmdDaemon;
+}
+
+std::string getLogDirectory()
+{
+	char* logDir = getenv("REPO_LOG_DIR");
+	return logDir ? std::string(logDir) : "./log/";
+}
+
+void writeProfileReport()
+{
+	std::string reportPath;
+	repo::lib::RepoProfiler::getInstance().writeReport(getLogDirectory(), reportPath);
+}
+
 int32_t knownValid(const std::string &cmd)
 {
 	if (cmd == cmdImportFile)
@@ -68,6 +95,8 @@ int32_t knownValid(const std::string &cmd)
 		return 3;
 	if (cmd == cmdTestConn)
 		return 0;
+	if (cmd == cmdDaemon)
+		return 0;
 	if (cmd == cmdVersion || cmd == cmdVersion2)
 		return 0;
 	return -1;
@@ -126,6 +155,10 @@ int32_t performOperation(
 			errCode = REPOERR_UNKNOWN_ERR;
 		}
 	}
+	else if (command.command == cmdDaemon)
+	{
+		errCode = runDaemon(controller, token, command);
+	}
 	else if (command.command == cmdTestConn)
 	{
 		//This is just to test if the client is working and if the connection is working
@@ -144,10 +177,192 @@ int32_t performOperation(
 	return errCode;
 }
 
+uint32_t getNumConcurrentJobs(const repo_op_t &command)
+{
+	if (command.command != cmdDaemon)
+		return 1;
+
+	if (command.nArgcs > 0)
+	{
+		try {
+			int nJobs = std::stoi(command.args[0]);
+			return nJobs > 0 ? nJobs : 0;
+		}
+		catch (const std::exception &e)
+		{
+			return 0;
+		}
+	}
+
+	return daemonDefaultJobs;
+}
+
+/**
+* Split a job line into its arguments. Arguments are separated
+* by whitespace, unless it is within double quotes.
+* @param line line to split
+* @return returns the arguments
+*/
+static std::vector<std::string> tokeniseJobLine(const std::string &line)
+{
+	std::vector<std::string> tokens;
+	std::string current;
+	bool quoted = false;
+	bool inToken = false;
+	for (const char &c : line)
+	{
+		if (c == '"')
+		{
+			quoted = !quoted;
+			inToken = true;
+		}
+		else if (!quoted && std::isspace((unsigned char)c))
+		{
+			if (inToken)
+			{
+				tokens.push_back(current);
+				current.clear();
+				inToken = false;
+			}
+		}
+		else
+		{
+			current += c;
+			inToken = true;
+		}
+	}
+
+	if (inToken)
+		tokens.push_back(current);
+
+	return tokens;
+}
+
 /*
 * ======================== Command functions ===================
 */
 
+int32_t runDaemon(
+	std::shared_ptr<repo::RepoController> controller,
+	const repo::RepoController::RepoToken      *token,
+	const repo_op_t            &command
+)
+{
+	const uint32_t nJobs = getNumConcurrentJobs(command);
+	if (!nJobs)
+	{
+		repoLogError("Invalid number of concurrent jobs for " + cmdDaemon + ": " + command.args[0]);
+		return REPOERR_INVALID_ARG;
+	}
+
+	repoLog("Running as a daemon with up to " + std::to_string(nJobs) + " concurrent jobs");
+
+	//The profiler attributes stages to a single job, so it can only follow jobs run one at a time
+	auto &profiler = repo::lib::RepoProfiler::getInstance();
+	const bool profileJobs = nJobs == 1;
+	if (!profileJobs)
+	{
+		repoLog("Profiling is disabled while running concurrent jobs");
+		profiler.setEnabled(false);
+	}
+
+	//Guards nRunning and the job reports written to stdout
+	boost::mutex mutex;
+	boost::condition_variable jobFinished;
+	uint32_t nRunning = 0;
+
+	auto reportJob = [&](const std::string &jobId, const int32_t &errCode) {
+		boost::mutex::scoped_lock lock(mutex);
+		std::cout << daemonJobDone << " " << jobId << " " << errCode << std::endl;
+	};
+
+	std::string line;
+	while (std::getline(std::cin, line))
+	{
+		auto tokens = tokeniseJobLine(line);
+		if (tokens.empty())
+			continue;
+		if (tokens[0] == daemonExit)
+			break;
+
+		const std::string jobId = tokens[0];
+		const std::string jobCommand = tokens.size() > 1 ? tokens[1] : "";
+		const int32_t minArgs = knownValid(jobCommand);
+		if (minArgs < 0)
+		{
+			repoLogError("Unrecognised command for job " + jobId + ": " + jobCommand);
+			reportJob(jobId, REPOERR_UNKNOWN_CMD);
+			continue;
+		}
+		//Stdout carries the job reports, so commands printing to it cannot run as jobs
+		if (jobCommand == cmdDaemon || isSpecialCommand(jobCommand))
+		{
+			repoLogError("Command cannot run as a daemon job (" + jobId + "): " + jobCommand);
+			reportJob(jobId, REPOERR_UNKNOWN_CMD);
+			continue;
+		}
+		if ((int32_t)tokens.size() - 2 < minArgs)
+		{
+			repoLogError("Not enough arguments for job " + jobId + ": " + jobCommand);
+			reportJob(jobId, REPOERR_INVALID_ARG);
+			continue;
+		}
+
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			while (nRunning >= nJobs)
+				jobFinished.wait(lock);
+			++nRunning;
+		}
+
+		std::vector<std::string> args(tokens.begin() + 2, tokens.end());
+		boost::thread([&, controller, jobId, jobCommand, args]() mutable {
+			std::vector<char*> argv;
+			for (auto &arg : args)
+				argv.push_back(&arg[0]);
+
+			repo_op_t op;
+			op.command = jobCommand;
+			op.args = argv.data();
+			op.nArgcs = argv.size();
+
+			repoLog("Starting job " + jobId + ": " + jobCommand);
+			if (profileJobs)
+				profiler.startJob(jobId + ": " + jobCommand);
+			//Anything escaping a job thread would take down every other job with it
+			int32_t errCode;
+			try {
+				errCode = performOperation(controller, token, op);
+			}
+			catch (...)
+			{
+				repoLogError("Unknown exception in job " + jobId);
+				errCode = REPOERR_UNKNOWN_ERR;
+			}
+			if (profileJobs)
+				writeProfileReport();
+			repoLog("Job " + jobId + " completed with error code: " + std::to_string(errCode));
+
+			reportJob(jobId, errCode);
+
+			//Cached mesh reorganisations are only reused within a job, so drop them once
+			//it is done. Concurrent jobs keep hold of the entries they have read.
+			controller->clearMeshCache();
+
+			boost::mutex::scoped_lock lock(mutex);
+			--nRunning;
+			jobFinished.notify_all();
+		}).detach();
+	}
+
+	boost::mutex::scoped_lock lock(mutex);
+	while (nRunning)
+		jobFinished.wait(lock);
+
+	repoLog("Daemon stopped");
+	return REPOERR_OK;
+}
+
 int32_t generateFederation(
 	std::shared_ptr<repo::RepoController> controller,
 	const repo::RepoController::RepoToken      *token,
@@ -236,11 +451,11 @@ int32_t generateFederation(
 			//Create the reference scene
 			if (success = refMap.size())
 			{
-				auto scene = controller->createFederatedScene(refMap);
-				if (success = scene)
+				std::unique_ptr<repo::core::model::RepoScene> scene(controller->createFederatedScene(refMap));
+				if (success = (bool)scene)
 				{
 					scene->setDatabaseAndProjectName(database, project);
-					errCode = controller->commitScene(token, scene, owner);
+					errCode = controller->commitScene(token, scene.get(), owner);
 				}
 			}
 			else
@@ -396,6 +611,9 @@ int32_t importFileAndCommit(
 	bool success = true;
 	bool rotate = false;
 	bool importAnimations = true;
+	bool attachProfile = false;
+	uint32_t keyFrameInterval = 0; //full frames unless the import settings opt into deltas
+	auto stateFormat = repo::manipulator::modelconvertor::SequenceStateFormat::JSON;
 	if (usingSettingFiles)
 	{
 		//if we're using settles file then arg[1] must be file path
@@ -411,6 +629,13 @@ int32_t importFileAndCommit(
 			desc = jsonTree.get<std::string>("desc", "");
 			rotate = jsonTree.get<bool>("dxrotate", rotate);
 			importAnimations = jsonTree.get<bool>("importAnimations", importAnimations);
+			attachProfile = jsonTree.get<bool>("attachProfile", attachProfile);
+			keyFrameInterval = jsonTree.get<uint32_t>("sequenceKeyFrameInterval", keyFrameInterval);
+			auto stateFormatStr = jsonTree.get<std::string>("sequenceStateFormat", "");
+			if (stateFormatStr == REPO_SEQUENCE_STATE_FORMAT_BINARY)
+				stateFormat = repo::manipulator::modelconvertor::SequenceStateFormat::BINARY;
+			else if (stateFormatStr == REPO_SEQUENCE_STATE_FORMAT_BINARY_COMPRESSED)
+				stateFormat = repo::manipulator::modelconvertor::SequenceStateFormat::BINARY_COMPRESSED;
 			fileLoc = jsonTree.get<std::string>("file", "");
 			auto revIdStr = jsonTree.get<std::string>("revId", "");
 			if (!revIdStr.empty()) {
@@ -470,18 +695,23 @@ int32_t importFileAndCommit(
 		+ " project: " + project + " rotate:"
 		+ (rotate ? "true" : "false") + " owner :" + owner + " importAnimations: " + (importAnimations ? "true" : "false"));
 
-	repo::manipulator::modelconvertor::ModelImportConfig config(true, rotate, importAnimations);
+	repo::manipulator::modelconvertor::ModelImportConfig config(true, rotate, importAnimations, keyFrameInterval, stateFormat);
 	uint8_t err;
-	repo::core::model::RepoScene *graph = controller->loadSceneFromFile(fileLoc, err, &config);
+	std::unique_ptr<repo::core::model::RepoScene> graph(controller->loadSceneFromFile(fileLoc, err, &config));
 	if (graph)
 	{
 		repoLog("Trying to commit this scene to database as " + database + "." + project);
 		graph->setDatabaseAndProjectName(database, project);
 
-		err = controller->commitScene(token, graph, owner, tag, desc, revId);
+		err = controller->commitScene(token, graph.get(), owner, tag, desc, revId);
 
 		if (err == REPOERR_OK)
 		{
+			if (attachProfile && !controller->attachProfileToRevision(token, graph.get()))
+			{
+				repoLogError("Failed to attach the profile report to the revision");
+			}
+
 			if (graph->isMissingNodes())
 			{
 				repoLog("Missing nodes detected!");
@@ -46,6 +46,23 @@ std::string helpInfo();
 */
 bool isSpecialCommand(const std::string &cmd);
 
+/**
+* Check if the command runs as a daemon, which reports its jobs on stdout
+* @return returns true if it is the daemon command
+*/
+bool isDaemonCommand(const repo_op_t &command);
+
+/**
+* Get the directory to write logs and profile reports into
+* @return returns REPO_LOG_DIR if set, ./log/ otherwise
+*/
+std::string getLogDirectory();
+
+/**
+* Write the profile report of the current job into the log directory
+*/
+void writeProfileReport();
+
 /**
 * Check if the command is recognised
 * @returns returns the minimal # of arguments needed for this command,
@@ -84,6 +101,30 @@ int32_t generateFederation(
 	const repo_op_t            &command
 	);
 
+/**
+* Keep the controller and its connections alive and run jobs read from stdin,
+* one per line, as "<jobId> <command> [args]" (arguments containing spaces can
+* be double quoted). Up to nJobs jobs run concurrently. Once a job finishes,
+* "REPO_JOB_DONE <jobId> <error code>" is written to stdout. Stops on end of
+* input or an "exit" line, after the running jobs have finished.
+* @param controller the controller to the bouncer library
+* @param token      token provided by the controller after authentication
+* @param command    command and it's arguments to perform
+* @return returns REPOERR_OK, or REPOERR_INVALID_ARG if nJobs is invalid
+*/
+int32_t runDaemon(
+	std::shared_ptr<repo::RepoController> controller,
+	const repo::RepoController::RepoToken      *token,
+	const repo_op_t            &command
+	);
+
+/**
+* Get the number of jobs the daemon command runs concurrently
+* @param command    command and it's arguments to perform
+* @return returns the number of concurrent jobs, 1 if it is not the daemon command
+*/
+uint32_t getNumConcurrentJobs(const repo_op_t &command);
+
 /**
 * Generate a particular type of stash (src/gltf/repo) for a given project
 * @param controller the controller to the bouncer library
@@ -15,8 +15,10 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <repo/lib/repo_listener_stdout.h>
 #include <repo/lib/repo_exception.h>
+#include <repo/lib/repo_profiler.h>
 #include "functions.h"
 
 static const uint32_t minArgs = 3;  //exe configFile command
@@ -36,14 +38,17 @@ void printHelp()
 	std::cout << "REPO_VERBOSE\tEnable verbose logging" << std::endl;
 }
 
-std::shared_ptr<repo::RepoController>  instantiateController()
+std::shared_ptr<repo::RepoController>  instantiateController(
+	const uint32_t &numConcurrentOps = 1,
+	const bool &logToStderr = false)
 {
-	repo::lib::LogToStdout *stdOutListener = new repo::lib::LogToStdout();
+	//The daemon reports its jobs on stdout, so its log goes to stderr
+	repo::lib::LogToStdout *stdOutListener = new repo::lib::LogToStdout(logToStderr ? std::cerr : std::cout);
 	std::vector<repo::lib::RepoAbstractListener*> listeners = { stdOutListener };
 	std::shared_ptr<repo::RepoController> controller;
 
 	try {
-		controller =std::make_shared<repo::RepoController>(listeners);
+		controller =std::make_shared<repo::RepoController>(listeners, numConcurrentOps);
 	}
 	catch (const repo::lib::RepoValidityExpiredException) {
 		std::cerr << "License expired. Please contact support@3drepo.org should you wish to continue using the software." << std::endl;
@@ -53,7 +58,6 @@ std::shared_ptr<repo::RepoController>  instantiateController()
 
 	char* debug = getenv("REPO_DEBUG");
 	char* verbose = getenv("REPO_VERBOSE");
-	char* logDir = getenv("REPO_LOG_DIR");
 
 	if (verbose)
 	{
@@ -68,13 +72,7 @@ std::shared_ptr<repo::RepoController>  instantiateController()
 		controller->setLoggingLevel(repo::lib::RepoLog::RepoLogLevel::INFO);
 	}
 
-	std::string logPath;
-	if (logDir)
-		logPath = std::string(logDir);
-	else
-		logPath = "./log/";
-
-	controller->logToFile(logPath);
+	controller->logToFile(getLogDirectory());
 	repoLog("3D Repo Bouncer Version: " + controller->getVersion());
 	return controller;
 }
@@ -95,7 +93,20 @@ void logCommand(int argc, char* argv[])
 }
 
 int main(int argc, char* argv[]) {
-	auto controller = instantiateController();
+	//Each concurrent job of the daemon needs a worker of its own
+	uint32_t numConcurrentOps = 1;
+	bool isDaemon = false;
+	if (argc >= minArgs)
+	{
+		repo_op_t op;
+		op.command = argv[minArgs - 1];
+		op.args = argc > minArgs ? &argv[minArgs] : nullptr;
+		op.nArgcs = argc - minArgs;
+		numConcurrentOps = std::max<uint32_t>(getNumConcurrentJobs(op), 1);
+		isDaemon = isDaemonCommand(op);
+	}
+
+	auto controller = instantiateController(numConcurrentOps, isDaemon);
 	if (argc < minArgs) {
 		if (argc == 2 && isSpecialCommand(argv[1]))
 		{
@@ -118,6 +129,7 @@ int main(int argc, char* argv[]) {
 	logCommand(argc, argv);
 	repo_op_t op;
 	op.command = argv[++idx];
+	repo::lib::RepoProfiler::getInstance().startJob(op.command);
 	if (argc > minArgs)
 		op.args = &argv[minArgs];
 	op.nArgcs = argc - minArgs;
@@ -136,6 +148,8 @@ int main(int argc, char* argv[]) {
 				int32_t errcode = performOperation(controller, token, op);
 
 				controller->destroyToken(token);
+				if (!isDaemon) //the daemon reports per job
+					writeProfileReport();
 				repoLog("Process completed, returning with error code: " + std::to_string(errcode));
 				return errcode;
 			}
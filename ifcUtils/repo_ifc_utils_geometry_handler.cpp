@@ -24,6 +24,8 @@
 
 #include <ifcgeom/IfcGeom.h>
 #include <ifcgeom_schema_agnostic/IfcGeomIterator.h>
+#include <algorithm>
+#include <map>
 
 IfcGeom::IteratorSettings createSettings()
 {
@@ -102,9 +104,82 @@ bool repo::ifcUtility::SCHEMA_NS::GeometryHandler::retrieveGeometry(
 	std::string              &errMsg)
 {
 	IfcParse::IfcFile ifcfile(file);
+	return retrieveGeometry(ifcfile, 1, allVertices, allFaces, allNormals, allUVs, allIds, allNames, allMaterials, matNameToMaterials, offset, errMsg);
+}
+
+bool repo::ifcUtility::SCHEMA_NS::GeometryHandler::retrieveGeometry(
+	IfcParse::IfcFile &ifcfile,
+	const int &nThreads,
+	std::vector < std::vector<double>> &allVertices,
+	std::vector<std::vector<repo_face_t>> &allFaces,
+	std::vector < std::vector<double>> &allNormals,
+	std::vector < std::vector<double>> &allUVs,
+	std::vector<std::string> &allIds,
+	std::vector<std::string> &allNames,
+	std::vector<std::string> &allMaterials,
+	std::unordered_map<std::string, repo_material_t> &matNameToMaterials,
+	std::vector<double>		&offset,
+	std::string              &errMsg)
+{
+	std::vector<IfcGeometryData> products;
+	auto collect = [&](IfcGeometryData &data) {
+		for (int i = 0; i < data.vertices.size(); i += 3)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				int index = j + i;
+				if (offset.size() < j + 1)
+				{
+					offset.push_back(data.vertices[index]);
+				}
+				else
+				{
+					offset[j] = offset[j] > data.vertices[index] ? data.vertices[index] : offset[j];
+				}
+			}
+		}
+		products.push_back(std::move(data));
+	};
+
+	if (!retrieveGeometry(ifcfile, nThreads, collect, matNameToMaterials, errMsg))
+		return false;
+
+	//Products arrive in whichever order the threads finish them, sort them so the output is deterministic
+	std::stable_sort(products.begin(), products.end(),
+		[](const IfcGeometryData &a, const IfcGeometryData &b) { return a.productId < b.productId; });
+
+	allVertices.reserve(allVertices.size() + products.size());
+	allNormals.reserve(allNormals.size() + products.size());
+	allFaces.reserve(allFaces.size() + products.size());
+	allUVs.reserve(allUVs.size() + products.size());
+	allIds.reserve(allIds.size() + products.size());
+	allNames.reserve(allNames.size() + products.size());
+	allMaterials.reserve(allMaterials.size() + products.size());
+	for (auto &product : products)
+	{
+		allVertices.push_back(std::move(product.vertices));
+		allNormals.push_back(std::move(product.normals));
+		allFaces.push_back(std::move(product.faces));
+		allUVs.push_back(std::move(product.uvs));
+
+		allIds.push_back(product.guid);
+		allNames.push_back(product.name);
+		allMaterials.push_back(product.material);
+	}
+
+	return true;
+}
+
+bool repo::ifcUtility::SCHEMA_NS::GeometryHandler::retrieveGeometry(
+	IfcParse::IfcFile &ifcfile,
+	const int &nThreads,
+	const IfcGeometryCallback &callback,
+	std::unordered_map<std::string, repo_material_t> &matNameToMaterials,
+	std::string              &errMsg)
+{
 	auto itSettings = createSettings();
 
-	IfcGeom::Iterator<double> contextIterator(itSettings, &ifcfile);
+	IfcGeom::Iterator<double> contextIterator(itSettings, &ifcfile, std::vector<IfcGeom::filter_t>(), nThreads > 0 ? nThreads : 1);
 
 	try {
 		if (!contextIterator.initialize()) {
@@ -119,6 +194,7 @@ bool repo::ifcUtility::SCHEMA_NS::GeometryHandler::retrieveGeometry(
 	}
 
 	const std::set<std::string> unwantedGeometry = { "ifcopeningelement", "ifcvoidingfeature" };
+	size_t nGeometry = 0;
 	do
 	{
 		IfcGeom::Element<double> *ob = contextIterator.get();
@@ -146,26 +222,10 @@ bool repo::ifcUtility::SCHEMA_NS::GeometryHandler::retrieveGeometry(
 			std::unordered_map<int, int> vertexCount;
 			std::unordered_map<int, std::vector<double>> post_vertices, post_normals, post_uvs;
 			std::unordered_map<int, std::string> post_materials;
-			std::unordered_map<int, std::vector<repo_face_t>> post_faces;
+			std::map<int, std::vector<repo_face_t>> post_faces; //ordered, so the pieces of a product are always emitted in the same order
 
 			auto matIndIt = ob_geo->geometry().material_ids().begin();
 
-			for (int i = 0; i < vertices.size(); i += 3)
-			{
-				for (int j = 0; j < 3; ++j)
-				{
-					int index = j + i;
-					if (offset.size() < j + 1)
-					{
-						offset.push_back(vertices[index]);
-					}
-					else
-					{
-						offset[j] = offset[j] > vertices[index] ? vertices[index] : offset[j];
-					}
-				}
-			}
-
 			for (int iface = 0; iface < faces.size(); iface += primitive)
 			{
 				auto matInd = primitive == 3 ? *matIndIt : ob_geo->geometry().materials().size();
@@ -231,23 +291,24 @@ bool repo::ifcUtility::SCHEMA_NS::GeometryHandler::retrieveGeometry(
 				if (primitive == 3) ++matIndIt;
 			}
 
-			auto guid = ob_geo->guid();
-			auto name = ob_geo->name();
-			for (const auto& pair : post_faces)
+			for (auto& pair : post_faces)
 			{
 				auto index = pair.first;
-				allVertices.push_back(post_vertices[index]);
-				allNormals.push_back(post_normals[index]);
-				allFaces.push_back(pair.second);
-				allUVs.push_back(post_uvs[index]);
-
-				allIds.push_back(guid);
-				allNames.push_back(name);
-				allMaterials.push_back(post_materials[index]);
+				IfcGeometryData data;
+				data.productId = ob_geo->id();
+				data.guid = ob_geo->guid();
+				data.name = ob_geo->name();
+				data.material = post_materials[index];
+				data.vertices = std::move(post_vertices[index]);
+				data.normals = std::move(post_normals[index]);
+				data.uvs = std::move(post_uvs[index]);
+				data.faces = std::move(pair.second);
+				callback(data);
+				++nGeometry;
 			}
 		}
-		if (allIds.size() % 100 == 0)
-			repoInfo << allIds.size() << " meshes created";
+		if (nGeometry % 100 == 0)
+			repoInfo << nGeometry << " meshes created";
 	} while (contextIterator.next());
 
 	return true;
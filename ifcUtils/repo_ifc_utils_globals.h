@@ -17,8 +17,11 @@
 
 #pragma once
 #include <vector>
+#include <string>
+#include <functional>
 #include <unordered_map>
 #include <cstdint>
+#include <repo/lib/datastructure/repo_structs.h>
 #if defined(_WIN32) || defined(_WIN64)
 #   define IFC_UTILS_DECL_EXPORT __declspec(dllexport)
 #   define IFC_UTILS_DECL_IMPORT __declspec(dllimport)
@@ -52,4 +55,20 @@ struct TransNode {
 	bool createNode = false;
 	bool meshTakeName = false;
 	bool isIfcSpace = false;
-};
\ No newline at end of file
+};
+
+//Triangulated geometry of one material within one IFC product
+struct IfcGeometryData {
+	int productId;
+	std::string guid;
+	std::string name;
+	std::string material;
+	std::vector<double> vertices;
+	std::vector<double> normals;
+	std::vector<double> uvs;
+	std::vector<repo_face_t> faces;
+};
+
+//Called with each piece of geometry as soon as it is triangulated.
+//The receiver may move the buffers out of the given data.
+typedef std::function<void(IfcGeometryData &)> IfcGeometryCallback;
@@ -49,6 +49,41 @@ namespace repo {
 					std::unordered_map<std::string, repo_material_t> &matNameToMaterials,
 					std::vector<double>		&offset,
 					std::string              &errMsg);
+
+				/**
+				* Triangulate all products within an already parsed IFC file,
+				* handing each piece of geometry to the callback as soon as it is ready
+				* rather than accumulating the whole file.
+				* Products are triangulated over nThreads threads, so the order
+				* the callback sees products in is not deterministic. The pieces
+				* of one product are handed over together, in material order.
+				* The callback is always invoked from the calling thread.
+				*/
+				static bool retrieveGeometry(
+					IfcParse::IfcFile &ifcfile,
+					const int &nThreads,
+					const IfcGeometryCallback &callback,
+					std::unordered_map<std::string, repo_material_t> &matNameToMaterials,
+					std::string              &errMsg);
+
+				/**
+				* Triangulate all products within an already parsed IFC file.
+				* Products are triangulated over nThreads threads, the output is
+				* ordered by product id regardless of the number of threads used.
+				*/
+				static bool retrieveGeometry(
+					IfcParse::IfcFile &ifcfile,
+					const int &nThreads,
+					std::vector < std::vector<double>> &allVertices,
+					std::vector<std::vector<repo_face_t>> &allFaces,
+					std::vector < std::vector<double>> &allNormals,
+					std::vector < std::vector<double>> &allUVs,
+					std::vector<std::string> &allIds,
+					std::vector<std::string> &allNames,
+					std::vector<std::string> &allMaterials,
+					std::unordered_map<std::string, repo_material_t> &matNameToMaterials,
+					std::vector<double>		&offset,
+					std::string              &errMsg);
 			};
 
 			class IFC_UTILS_API_EXPORT TreeParser
@@ -61,6 +96,8 @@ namespace repo {
 
 				static TransNode createTransformations(const std::string &filePath, bool &missingEntities);
 
+				static TransNode createTransformations(IfcParse::IfcFile &ifcFile, bool &missingEntities);
+
 			protected:
 
 				struct Actions_t {
@@ -30,6 +30,11 @@
 TransNode  repo::ifcUtility::SCHEMA_NS::TreeParser::createTransformations(const std::string &filePath, bool &missingEntities)
 {
 	IfcParse::IfcFile ifcFile = filePath;
+	return createTransformations(ifcFile, missingEntities);
+}
+
+TransNode  repo::ifcUtility::SCHEMA_NS::TreeParser::createTransformations(IfcParse::IfcFile &ifcFile, bool &missingEntities)
+{
 	auto initialElements = ifcFile.instances_by_type<IfcSchema::IfcProject>();
 
 	TransNode node;
@@ -654,6 +654,60 @@ TEST(RepoSceneTest, addInheritance)
 	EXPECT_EQ(m2, childrenOfM1[0]);
 }
 
+TEST(RepoSceneTest, addInheritances)
+{
+	RepoNodeSet transNodes, meshNodes, empty;
+
+	auto root = new TransformationNode(makeRandomNode(getRandomString(rand() % 10 + 1)));
+	auto t1 = new TransformationNode(makeRandomNode(root->getSharedID()));
+	auto t2 = new TransformationNode(makeRandomNode(root->getSharedID()));
+	transNodes.insert(root);
+	transNodes.insert(t1);
+	transNodes.insert(t2);
+
+	std::vector<MeshNode*> meshes;
+	for (int i = 0; i < 1000; ++i)
+	{
+		meshes.push_back(new MeshNode(makeRandomNode(root->getSharedID())));
+		meshNodes.insert(meshes.back());
+	}
+
+	RepoScene scene(std::vector<std::string>(), empty, meshNodes, empty, empty, empty, transNodes);
+
+	std::vector<std::pair<const RepoNode*, RepoNode*>> edges;
+	edges.push_back({ nullptr, meshes[0] }); //ignored
+	edges.push_back({ t1, nullptr }); //ignored
+	edges.push_back({ root, meshes[0] }); //already exists
+	for (const auto &mesh : meshes)
+	{
+		edges.push_back({ t1, mesh });
+		edges.push_back({ t2, mesh });
+		edges.push_back({ t1, mesh }); //duplicates are only added once
+	}
+	scene.addInheritances(RepoScene::GraphType::DEFAULT, edges);
+
+	EXPECT_EQ(meshes.size(), scene.getChildrenAsNodes(RepoScene::GraphType::DEFAULT, t1->getSharedID()).size());
+	EXPECT_EQ(meshes.size(), scene.getChildrenAsNodes(RepoScene::GraphType::DEFAULT, t2->getSharedID()).size());
+	EXPECT_EQ(meshes.size() + 2, scene.getChildrenAsNodes(RepoScene::GraphType::DEFAULT, root->getSharedID()).size());
+
+	for (const auto &mesh : meshes)
+	{
+		auto parentIDs = mesh->getParentIDs();
+		ASSERT_EQ(3, parentIDs.size());
+		EXPECT_TRUE(std::find(parentIDs.begin(), parentIDs.end(), root->getSharedID()) != parentIDs.end());
+		EXPECT_TRUE(std::find(parentIDs.begin(), parentIDs.end(), t1->getSharedID()) != parentIDs.end());
+		EXPECT_TRUE(std::find(parentIDs.begin(), parentIDs.end(), t2->getSharedID()) != parentIDs.end());
+	}
+
+	//Children can be abandoned and re-added after a bulk insertion
+	scene.abandonChild(RepoScene::GraphType::DEFAULT, t1->getSharedID(), meshes[0], true, true);
+	EXPECT_EQ(meshes.size() - 1, scene.getChildrenAsNodes(RepoScene::GraphType::DEFAULT, t1->getSharedID()).size());
+	EXPECT_EQ(2, meshes[0]->getParentIDs().size());
+	scene.addInheritance(RepoScene::GraphType::DEFAULT, t1, meshes[0]);
+	EXPECT_EQ(meshes.size(), scene.getChildrenAsNodes(RepoScene::GraphType::DEFAULT, t1->getSharedID()).size());
+	EXPECT_EQ(3, meshes[0]->getParentIDs().size());
+}
+
 TEST(RepoSceneTest, getChildrenAsNodes)
 {
 	RepoNodeSet transNodes, meshNodes, empty;
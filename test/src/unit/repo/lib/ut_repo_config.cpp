@@ -162,6 +162,24 @@ TEST(RepoConfigTest, fsConfigTest)
 
 }
 
+TEST(RepoConfigTest, threadsConfigTest)
+{
+	auto config = createConfig();
+	EXPECT_EQ(0, config.getNumThreads());
+	config.setNumThreads(16);
+	EXPECT_EQ(16, config.getNumThreads());
+	EXPECT_TRUE(config.validate());
+}
+
+TEST(RepoConfigTest, meshCacheConfigTest)
+{
+	auto config = createConfig();
+	EXPECT_EQ(0, config.getMeshCacheSize());
+	config.setMeshCacheSize(512);
+	EXPECT_EQ(512, config.getMeshCacheSize());
+	EXPECT_TRUE(config.validate());
+}
+
 TEST(RepoConfigTest, validationTestDB)
 {
 	EXPECT_TRUE(createConfig().validate());
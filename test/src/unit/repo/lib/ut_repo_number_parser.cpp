@@ -0,0 +1,106 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cmath>
+#include <gtest/gtest.h>
+#include <boost/lexical_cast.hpp>
+#include <repo/lib/repo_number_parser.h>
+
+using namespace repo::lib;
+
+static const std::vector<std::string> testStrings = {
+	"0", "-0", "+0", "12", "+12", "-12", "007", "9223372036854775807", "9223372036854775808",
+	"-9223372036854775808", "-9223372036854775809", "99999999999999999999", "1.5", "-1.5", ".5",
+	"5.", ".", "-", "+", "1e5", "1E5", "1e+5", "1e-5", "1e", "1e+", "e5", ".e5", "1.e5", "1e400",
+	"-1e400", "1e-400", "inf", "-inf", "INF", "Infinity", "infinit", "nan", "NaN", "nan(123)",
+	"nan(", "0x10", "0x1p3", " 1", "1 ", "1,5", "1.5.5", "abc", "12abc", "1e5x", "1f", "--1",
+	"+-1", "\t1", "1\n", "Basic Wall: Generic - 200mm", "3.14159265358979323846", "1e308",
+	"1.8e308", "4.9e-324", "-.5", "+.5e-3", ""
+};
+
+TEST(RepoNumberParserTest, MatchesLexicalCast)
+{
+	for (const auto &str : testStrings)
+	{
+		long long intValue, expectedInt;
+		bool expectInt = true;
+		try {
+			expectedInt = boost::lexical_cast<long long>(str);
+		}
+		catch (boost::bad_lexical_cast &) {
+			expectInt = false;
+		}
+
+		ASSERT_EQ(expectInt, parseInteger(str, intValue)) << str;
+		if (expectInt)
+		{
+			EXPECT_EQ(expectedInt, intValue) << str;
+			continue;
+		}
+
+		double doubleValue, expectedDouble;
+		bool expectDouble = true;
+		try {
+			expectedDouble = boost::lexical_cast<double>(str);
+		}
+		catch (boost::bad_lexical_cast &) {
+			expectDouble = false;
+		}
+
+		ASSERT_EQ(expectDouble, parseDouble(str, doubleValue)) << str;
+		if (expectDouble && !std::isnan(expectedDouble))
+			EXPECT_EQ(expectedDouble, doubleValue) << str;
+	}
+}
+
+TEST(RepoNumberParserTest, AgreesWithLexicalCastOnMetadata)
+{
+	//Typical metadata: mostly strings, which lexical_cast rejects by throwing
+	//The speed comparison lives in the NumberParser benchmarks
+	std::vector<std::string> values;
+	for (int i = 0; i < 1000; ++i)
+	{
+		values.push_back("Basic Wall: Generic - " + std::to_string(i));
+		values.push_back(std::to_string(i));
+		values.push_back(std::to_string(i) + ".25");
+	}
+
+	size_t nNumbersExpected = 0, nNumbers = 0;
+	for (const auto &value : values)
+	{
+		try {
+			boost::lexical_cast<long long>(value);
+			++nNumbersExpected;
+		}
+		catch (boost::bad_lexical_cast &) {
+			try {
+				boost::lexical_cast<double>(value);
+				++nNumbersExpected;
+			}
+			catch (boost::bad_lexical_cast &) {}
+		}
+	}
+
+	for (const auto &value : values)
+	{
+		long long intValue;
+		double doubleValue;
+		if (parseInteger(value, intValue) || parseDouble(value, doubleValue))
+			++nNumbers;
+	}
+
+	EXPECT_EQ(nNumbersExpected, nNumbers);
+}
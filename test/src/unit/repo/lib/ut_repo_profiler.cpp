@@ -0,0 +1,175 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fstream>
+#include <thread>
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <repo/lib/repo_profiler.h>
+
+using namespace repo::lib;
+
+static const RepoProfileStage* findStage(
+	const std::vector<RepoProfileStage> &stages,
+	const std::string &path)
+{
+	for (const auto &stage : stages)
+	{
+		if (stage.path == path)
+			return &stage;
+	}
+	return nullptr;
+}
+
+TEST(RepoProfilerTest, NestedStages)
+{
+	auto &profiler = RepoProfiler::getInstance();
+	profiler.startJob("test");
+	EXPECT_EQ("test", profiler.getJobName());
+
+	{
+		REPO_PROFILE_SCOPE("outer");
+		for (int i = 0; i < 3; ++i)
+		{
+			REPO_PROFILE_SCOPE("inner");
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+	{
+		REPO_PROFILE_SCOPE("inner");
+	}
+
+	auto stages = profiler.getStages();
+	ASSERT_EQ(3, stages.size());
+	EXPECT_EQ("outer", stages[0].path);
+	EXPECT_EQ("outer/inner", stages[1].path);
+	EXPECT_EQ("inner", stages[2].path);
+
+	auto outer = findStage(stages, "outer");
+	auto inner = findStage(stages, "outer/inner");
+	ASSERT_TRUE(outer && inner);
+	EXPECT_EQ(0, outer->depth);
+	EXPECT_EQ(1, inner->depth);
+	EXPECT_EQ(1, outer->calls);
+	EXPECT_EQ(3, inner->calls);
+	EXPECT_GE(inner->totalSeconds, 0.015);
+	EXPECT_GE(outer->totalSeconds, inner->totalSeconds);
+	EXPECT_LE(inner->maxSeconds, inner->totalSeconds);
+	EXPECT_GE(outer->peakRssBytes, outer->rssEndBytes);
+}
+
+TEST(RepoProfilerTest, StartJobResets)
+{
+	auto &profiler = RepoProfiler::getInstance();
+	profiler.startJob("first");
+	{
+		REPO_PROFILE_SCOPE("open");
+		profiler.startJob("second");
+		REPO_PROFILE_SCOPE("stage");
+	}
+
+	//stages left open across startJob are not recorded
+	auto stages = profiler.getStages();
+	ASSERT_EQ(1, stages.size());
+	EXPECT_EQ("stage", stages[0].path);
+	EXPECT_EQ(1, stages[0].calls);
+}
+
+TEST(RepoProfilerTest, ThreadsAreIndependent)
+{
+	auto &profiler = RepoProfiler::getInstance();
+	profiler.startJob("threads");
+	{
+		REPO_PROFILE_SCOPE("main");
+		std::thread worker([]() {
+			REPO_PROFILE_SCOPE("worker");
+		});
+		worker.join();
+	}
+
+	auto stages = profiler.getStages();
+	ASSERT_TRUE(findStage(stages, "main"));
+	ASSERT_TRUE(findStage(stages, "worker"));
+}
+
+TEST(RepoProfilerTest, Disabled)
+{
+	auto &profiler = RepoProfiler::getInstance();
+	profiler.startJob("disabled");
+	{
+		REPO_PROFILE_SCOPE("outer");
+		profiler.setEnabled(false);
+		EXPECT_FALSE(profiler.isEnabled());
+		{
+			REPO_PROFILE_SCOPE("skipped");
+		}
+		profiler.setEnabled(true);
+		REPO_PROFILE_SCOPE("inner");
+	}
+
+	//stages entered while disabled are not recorded, nor do they unbalance the others
+	auto stages = profiler.getStages();
+	ASSERT_EQ(2, stages.size());
+	EXPECT_EQ("outer", stages[0].path);
+	EXPECT_EQ(1, stages[0].calls);
+	EXPECT_EQ("outer/inner", stages[1].path);
+	EXPECT_EQ(1, stages[1].calls);
+}
+
+TEST(RepoProfilerTest, WriteReport)
+{
+	auto &profiler = RepoProfiler::getInstance();
+	profiler.startJob("report");
+	{
+		REPO_PROFILE_SCOPE("a \"quoted\" stage");
+	}
+
+	auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	std::string reportPath;
+	ASSERT_TRUE(profiler.writeReport(dir.string(), reportPath));
+	EXPECT_NE(std::string::npos, reportPath.find("_report_profile.json"));
+
+	boost::property_tree::ptree tree;
+	ASSERT_NO_THROW(boost::property_tree::read_json(reportPath, tree));
+	EXPECT_EQ("report", tree.get<std::string>("job"));
+	auto stages = tree.get_child("stages");
+	ASSERT_EQ(1, stages.size());
+	EXPECT_EQ("a \"quoted\" stage", stages.begin()->second.get<std::string>("path"));
+	EXPECT_EQ(1, stages.begin()->second.get<int>("calls"));
+
+	boost::filesystem::remove_all(dir);
+}
+
+TEST(RepoProfilerTest, MemoryCounters)
+{
+#if defined(_WIN32) || defined(__linux__) || defined(__APPLE__)
+	EXPECT_GT(RepoProfiler::getCurrentRSS(), 0);
+	EXPECT_GE(RepoProfiler::getPeakRSS(), RepoProfiler::getCurrentRSS());
+#endif
+
+#ifdef REPO_PROFILE_ALLOCATIONS
+	auto count = RepoProfiler::getAllocationCount();
+	auto bytes = RepoProfiler::getAllocatedBytes();
+	std::vector<char> *buffer = new std::vector<char>(1024);
+	delete buffer;
+	EXPECT_GE(RepoProfiler::getAllocationCount(), count + 2);
+	EXPECT_GE(RepoProfiler::getAllocatedBytes(), bytes + 1024);
+#else
+	EXPECT_EQ(0, RepoProfiler::getAllocationCount());
+#endif
+}
@@ -0,0 +1,103 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <repo/lib/repo_task_executor.h>
+
+using namespace repo::lib;
+
+TEST(RepoTaskExecutorTest, Constructor)
+{
+	RepoTaskExecutor fixed(3);
+	EXPECT_EQ(3, fixed.getNumThreads());
+
+	RepoTaskExecutor hardware;
+	EXPECT_GE(hardware.getNumThreads(), 1);
+}
+
+TEST(RepoTaskExecutorTest, Submit)
+{
+	std::atomic<int> count(0);
+	{
+		RepoTaskExecutor executor(4);
+		for (int i = 0; i < 1000; ++i)
+			executor.submit([&]() { ++count; });
+		//Queued tasks are all run before destruction completes
+	}
+	EXPECT_EQ(1000, count);
+}
+
+TEST(RepoTaskExecutorTest, ParallelFor)
+{
+	RepoTaskExecutor executor(4);
+
+	std::vector<int> visits(10007, 0);
+	executor.parallelFor(visits.size(), [&](size_t i) { visits[i]++; });
+	for (const auto &v : visits)
+		ASSERT_EQ(1, v);
+
+	executor.parallelFor(visits.size(), [&](size_t i) { visits[i]++; }, 64);
+	for (const auto &v : visits)
+		ASSERT_EQ(2, v);
+
+	bool called = false;
+	executor.parallelFor(0, [&](size_t i) { called = true; });
+	EXPECT_FALSE(called);
+}
+
+TEST(RepoTaskExecutorTest, NestedParallelFor)
+{
+	//Every worker blocks in an outer iteration, so the inner loops only complete
+	//if waiting threads run queued tasks themselves
+	RepoTaskExecutor executor(2);
+	std::atomic<int> count(0);
+	executor.parallelFor(16, [&](size_t i) {
+		executor.parallelFor(100, [&](size_t j) { ++count; });
+	});
+	EXPECT_EQ(1600, count);
+}
+
+TEST(RepoTaskExecutorTest, ParallelForException)
+{
+	RepoTaskExecutor executor(4);
+	std::atomic<int> count(0);
+	EXPECT_THROW(executor.parallelFor(1000, [&](size_t i) {
+		++count;
+		if (i == 10)
+			throw std::runtime_error("failed");
+	}), std::runtime_error);
+	EXPECT_LT(count, 1000);
+
+	//The executor is still usable afterwards
+	count = 0;
+	executor.parallelFor(100, [&](size_t i) { ++count; });
+	EXPECT_EQ(100, count);
+}
+
+TEST(RepoTaskExecutorTest, Default)
+{
+	auto &fallback = RepoTaskExecutor::getDefault();
+	EXPECT_EQ(&fallback, &RepoTaskExecutor::getDefault());
+
+	RepoTaskExecutor executor(2);
+	RepoTaskExecutor::setDefault(&executor);
+	EXPECT_EQ(&executor, &RepoTaskExecutor::getDefault());
+	RepoTaskExecutor::setDefault(nullptr);
+	EXPECT_EQ(&fallback, &RepoTaskExecutor::getDefault());
+}
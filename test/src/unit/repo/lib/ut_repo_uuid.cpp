@@ -15,8 +15,12 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstdlib>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <unordered_set>
 #include <repo/lib/datastructure/repo_uuid.h>
 #include <gtest/gtest.h>
 
@@ -290,4 +294,85 @@ TEST(RepoUUIDTest, gteOperatorTest)
 		EXPECT_TRUE(fromGenB >= fromGenA);
 	}
 
-}
\ No newline at end of file
+}
+
+TEST(RepoUUIDTest, parseTest)
+{
+	boost::uuids::string_generator stringGen;
+	for (int i = 0; i < 100; ++i)
+	{
+		auto id = gen();
+		std::stringstream ss;
+		ss << id;
+		auto str = ss.str();
+
+		EXPECT_EQ(RepoUUID(id), RepoUUID(str));
+		EXPECT_EQ(RepoUUID(id), RepoUUID("{" + str + "}"));
+
+		std::string upper = str;
+		std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+		EXPECT_EQ(RepoUUID(id), RepoUUID(upper));
+
+		std::string noDashes = str;
+		noDashes.erase(std::remove(noDashes.begin(), noDashes.end(), '-'), noDashes.end());
+		EXPECT_EQ(RepoUUID(id), RepoUUID(noDashes));
+		EXPECT_EQ(RepoUUID(stringGen(noDashes)), RepoUUID(noDashes));
+	}
+
+	EXPECT_TRUE(RepoUUID("").isDefaultValue());
+	EXPECT_TRUE(RepoUUID(RepoUUID::defaultValue).isDefaultValue());
+
+	//Strings that are not uuids are hashed into one, consistently
+	std::vector<std::string> invalid = {
+		"not a uuid",
+		"{b9b8a9b2-0c8a-4b4a-9f1e-2b2c3d4e5f60",
+		"b9b8a9b2-0c8a-4b4a-9f1e-2b2c3d4e5f6g",
+		"b9b8a9b20-c8a-4b4a-9f1e-2b2c3d4e5f60",
+		"b9b8a9b2-0c8a-4b4a-9f1e-2b2c3d4e5f6"
+	};
+	for (const auto &str : invalid)
+	{
+		RepoUUID hashed(str);
+		EXPECT_FALSE(hashed.isDefaultValue()) << str;
+		EXPECT_EQ(hashed, RepoUUID(str)) << str;
+	}
+	EXPECT_NE(RepoUUID(invalid[0]), RepoUUID(invalid[1]));
+}
+
+TEST(RepoUUIDTest, createUUIDsTest)
+{
+	auto ids = RepoUUID::createUUIDs(1000);
+	ASSERT_EQ(1000, ids.size());
+	std::set<RepoUUID> unique(ids.begin(), ids.end());
+	EXPECT_EQ(ids.size(), unique.size());
+	for (const auto &id : ids)
+	{
+		//random uuids are version 4, variant 1
+		EXPECT_EQ(0x40, id.getInternalID().data[6] & 0xF0);
+		EXPECT_EQ(0x80, id.getInternalID().data[8] & 0xC0);
+	}
+
+	EXPECT_EQ(0, RepoUUID::createUUIDs(0).size());
+}
+
+TEST(RepoUUIDTest, concurrentCreateTest)
+{
+	const int nThreads = 8;
+	const int nPerThread = 10000;
+	std::vector<std::vector<RepoUUID>> results(nThreads);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < nThreads; ++i)
+	{
+		threads.push_back(std::thread([&results, i]() {
+			for (int j = 0; j < nPerThread; ++j)
+				results[i].push_back(RepoUUID::createUUID());
+		}));
+	}
+	for (auto &thread : threads)
+		thread.join();
+
+	std::unordered_set<RepoUUID, RepoUUIDHasher> unique;
+	for (const auto &result : results)
+		unique.insert(result.begin(), result.end());
+	EXPECT_EQ(nThreads * nPerThread, unique.size());
+}
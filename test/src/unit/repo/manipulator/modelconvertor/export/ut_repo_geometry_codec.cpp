@@ -0,0 +1,151 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <repo/manipulator/modelconvertor/export/repo_geometry_codec.h>
+#include "../../../../repo_test_utils.h"
+
+using namespace repo::manipulator::modelconvertor;
+
+static float slope(float x, float y)
+{
+	return x * y;
+}
+
+/**
+* Quantise positions in the unit cube as the web exports write them, 4 x uint16 per vertex
+*/
+static std::vector<uint8_t> quantisePositions(const std::vector<repo::lib::RepoVector3D> &vertices)
+{
+	std::vector<uint16_t> positions;
+	for (const auto &v : vertices)
+		positions.insert(positions.end(), { (uint16_t)(v.x * 65535), (uint16_t)(v.y * 65535), (uint16_t)(v.z * 65535), 0 });
+
+	std::vector<uint8_t> bytes(positions.size() * sizeof(uint16_t));
+	memcpy(bytes.data(), positions.data(), bytes.size());
+	return bytes;
+}
+
+TEST(GeometryCodec, Indices)
+{
+	std::vector<repo::lib::RepoVector3D> grid;
+	std::vector<uint32_t> indices;
+	createGrid(100, grid, indices);
+	auto encoded = GeometryCodec::encodeIndices(indices.data(), indices.size());
+
+	std::vector<uint32_t> decoded;
+	ASSERT_TRUE(GeometryCodec::decodeIndices(encoded.data(), encoded.size(), decoded));
+	EXPECT_EQ(indices, decoded);
+
+	//Most indices are new or recent vertices, which take a byte each
+	EXPECT_LT(encoded.size(), indices.size() * 1.1);
+
+	auto empty = GeometryCodec::encodeIndices(nullptr, 0);
+	ASSERT_TRUE(GeometryCodec::decodeIndices(empty.data(), empty.size(), decoded));
+	EXPECT_EQ(0, decoded.size());
+}
+
+TEST(GeometryCodec, IndicesArbitrary)
+{
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<uint32_t> dist;
+	std::vector<uint32_t> indices = { 0, UINT32_MAX, 0, 1, 2, UINT32_MAX, 5, 5, 5 };
+	for (int i = 0; i < 10000; ++i)
+		indices.push_back(i % 3 ? dist(rng) : indices[rng() % indices.size()]);
+
+	auto encoded = GeometryCodec::encodeIndices(indices.data(), indices.size());
+	std::vector<uint32_t> decoded;
+	ASSERT_TRUE(GeometryCodec::decodeIndices(encoded.data(), encoded.size(), decoded));
+	EXPECT_EQ(indices, decoded);
+}
+
+TEST(GeometryCodec, Vertices)
+{
+	std::mt19937 rng(1);
+	for (size_t stride : { 1, 4, 8, 12, 256 })
+	{
+		for (size_t count : { 0, 1, 15, 255, 256, 257, 1000 })
+		{
+			std::vector<uint8_t> vertices(count * stride);
+			for (auto &byte : vertices)
+				byte = rng() % 3 ? rng() % 8 : rng();
+
+			auto encoded = GeometryCodec::encodeVertices(vertices.data(), count, stride);
+			std::vector<uint8_t> decoded;
+			size_t decodedStride = 0;
+			ASSERT_TRUE(GeometryCodec::decodeVertices(encoded.data(), encoded.size(), decoded, decodedStride)) << count << " x " << stride;
+			EXPECT_EQ(stride, decodedStride);
+			EXPECT_EQ(vertices, decoded) << count << " x " << stride;
+		}
+	}
+
+	//Unsupported strides
+	uint8_t vertex[GeometryCodec::MAX_VERTEX_STRIDE + 1] = {};
+	EXPECT_EQ(0, GeometryCodec::encodeVertices(vertex, 1, 0).size());
+	EXPECT_EQ(0, GeometryCodec::encodeVertices(vertex, 1, GeometryCodec::MAX_VERTEX_STRIDE + 1).size());
+}
+
+TEST(GeometryCodec, VerticesCompression)
+{
+	std::vector<repo::lib::RepoVector3D> grid;
+	std::vector<uint32_t> indices;
+	createGrid(100, grid, indices, slope);
+	auto vertices = quantisePositions(grid);
+	const size_t stride = 8;
+	auto encoded = GeometryCodec::encodeVertices(vertices.data(), vertices.size() / stride, stride);
+
+	std::vector<uint8_t> decoded;
+	size_t decodedStride;
+	ASSERT_TRUE(GeometryCodec::decodeVertices(encoded.data(), encoded.size(), decoded, decodedStride));
+	EXPECT_EQ(vertices, decoded);
+	EXPECT_LT(encoded.size(), vertices.size() / 2);
+}
+
+TEST(GeometryCodec, Malformed)
+{
+	std::vector<repo::lib::RepoVector3D> grid, fineGrid;
+	std::vector<uint32_t> indices, fineIndices;
+	createGrid(10, grid, indices);
+	auto encodedIndices = GeometryCodec::encodeIndices(indices.data(), indices.size());
+	createGrid(30, fineGrid, fineIndices, slope);
+	auto vertices = quantisePositions(fineGrid);
+	auto encodedVertices = GeometryCodec::encodeVertices(vertices.data(), vertices.size() / 8, 8);
+
+	//Every truncation must be rejected
+	std::vector<uint32_t> decodedIndices;
+	for (size_t size = 0; size < encodedIndices.size(); ++size)
+		EXPECT_FALSE(GeometryCodec::decodeIndices(encodedIndices.data(), size, decodedIndices)) << size;
+
+	std::vector<uint8_t> decodedVertices;
+	size_t stride;
+	for (size_t size = 0; size < encodedVertices.size(); ++size)
+		EXPECT_FALSE(GeometryCodec::decodeVertices(encodedVertices.data(), size, decodedVertices, stride)) << size;
+
+	//Each buffer is rejected by the other decoder
+	EXPECT_FALSE(GeometryCodec::decodeIndices(encodedVertices.data(), encodedVertices.size(), decodedIndices));
+	EXPECT_FALSE(GeometryCodec::decodeVertices(encodedIndices.data(), encodedIndices.size(), decodedVertices, stride));
+
+	//Indices referring to vertices that were never added
+	std::vector<uint8_t> badFifo = { GeometryCodec::INDEX_HEADER, 1, 1 };
+	EXPECT_FALSE(GeometryCodec::decodeIndices(badFifo.data(), badFifo.size(), decodedIndices));
+
+	//Counts too large for the data
+	std::vector<uint8_t> badCount = { GeometryCodec::VERTEX_HEADER, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 4, 0 };
+	EXPECT_FALSE(GeometryCodec::decodeVertices(badCount.data(), badCount.size(), decodedVertices, stride));
+}
@@ -0,0 +1,142 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <repo/manipulator/modelconvertor/export/repo_vertex_quantiser.h>
+
+using namespace repo::manipulator::modelconvertor;
+using repo::lib::RepoVector3D;
+
+static std::vector<RepoVector3D> createRandomNormals(const size_t &count)
+{
+	std::mt19937 rng(1);
+	std::normal_distribution<float> dist;
+	std::vector<RepoVector3D> normals;
+	while (normals.size() < count)
+	{
+		RepoVector3D n(dist(rng), dist(rng), dist(rng));
+		if (n.x * n.x + n.y * n.y + n.z * n.z < 1e-6)
+			continue;
+		n.normalize();
+		normals.push_back(n);
+	}
+
+	//Axes, which sit on the edges and corners of the octahedron
+	normals.push_back({ 1, 0, 0 });
+	normals.push_back({ -1, 0, 0 });
+	normals.push_back({ 0, 1, 0 });
+	normals.push_back({ 0, -1, 0 });
+	normals.push_back({ 0, 0, 1 });
+	normals.push_back({ 0, 0, -1 });
+	return normals;
+}
+
+static float getAngle(RepoVector3D a, const RepoVector3D &b)
+{
+	//atan2 rather than acos, which is too imprecise near 0 in single precision
+	auto cross = a.crossProduct(b);
+	return std::atan2(std::sqrt(cross.dotProduct(cross)), a.dotProduct(b));
+}
+
+TEST(VertexQuantiser, PositionRange)
+{
+	std::vector<RepoVector3D> positions = { { 1, -2, 3 }, { -4, 5, 3 }, { 2, 0, 3 } };
+	auto range = VertexQuantiser::getPositionRange(positions.data(), positions.size());
+	EXPECT_EQ(RepoVector3D(-4, -2, 3), range.min);
+	EXPECT_EQ(RepoVector3D(2, 5, 3), range.max);
+	EXPECT_FLOAT_EQ(6.0f / VertexQuantiser::POSITION_MAX, range.scale.x);
+	EXPECT_FLOAT_EQ(7.0f / VertexQuantiser::POSITION_MAX, range.scale.y);
+	EXPECT_EQ(0, range.scale.z);
+
+	auto empty = VertexQuantiser::getPositionRange(nullptr, 0);
+	EXPECT_EQ(RepoVector3D(), empty.min);
+	EXPECT_EQ(RepoVector3D(), empty.scale);
+}
+
+TEST(VertexQuantiser, Positions)
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> dist(-1000, 1000);
+	std::vector<RepoVector3D> positions;
+	for (int i = 0; i < 10000; ++i)
+		positions.push_back({ dist(rng), dist(rng) * 0.01f, 5.0f });
+
+	auto range = VertexQuantiser::getPositionRange(positions.data(), positions.size());
+	auto quantised = VertexQuantiser::quantisePositions(positions.data(), positions.size(), range);
+	ASSERT_EQ(positions.size() * VertexQuantiser::POSITION_COMPONENTS, quantised.size());
+
+	//The bounds are exact, and every position is within half a step of the
+	//original, give or take the rounding of the decode in single precision
+	bool hasMin = false, hasMax = false;
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		const uint16_t *q = &quantised[i * VertexQuantiser::POSITION_COMPONENTS];
+		EXPECT_EQ(0, q[3]);
+		hasMin |= q[0] == 0;
+		hasMax |= q[0] == VertexQuantiser::POSITION_MAX;
+
+		auto decoded = VertexQuantiser::dequantisePosition(q, range);
+		EXPECT_NEAR(positions[i].x, decoded.x, range.scale.x * 0.51f);
+		EXPECT_NEAR(positions[i].y, decoded.y, range.scale.y * 0.51f);
+		EXPECT_EQ(5.0f, decoded.z);
+	}
+	EXPECT_TRUE(hasMin);
+	EXPECT_TRUE(hasMax);
+}
+
+TEST(VertexQuantiser, OctEncode16)
+{
+	auto normals = createRandomNormals(10000);
+	auto encoded = VertexQuantiser::octEncodeNormals(normals.data(), normals.size());
+	ASSERT_EQ(normals.size() * 2, encoded.size());
+
+	float maxError = 0;
+	for (size_t i = 0; i < normals.size(); ++i)
+	{
+		auto decoded = VertexQuantiser::octDecode(&encoded[i * 2]);
+		EXPECT_NEAR(1.0f, decoded.dotProduct(decoded), 1e-5f);
+		maxError = std::max(maxError, getAngle(decoded, normals[i]));
+	}
+	EXPECT_LT(maxError, 0.0001f);
+}
+
+TEST(VertexQuantiser, OctEncode8)
+{
+	auto normals = createRandomNormals(10000);
+
+	float maxError = 0;
+	for (const auto &normal : normals)
+	{
+		int8_t encoded[2];
+		VertexQuantiser::octEncode(normal, encoded);
+		EXPECT_GE(encoded[0], -127);
+		EXPECT_GE(encoded[1], -127);
+		maxError = std::max(maxError, getAngle(VertexQuantiser::octDecode(encoded), normal));
+	}
+	EXPECT_LT(maxError, 0.015f);
+
+	//Normals need not be unit length, and degenerate ones encode to something valid
+	int8_t scaled[2], unit[2], zero[2];
+	VertexQuantiser::octEncode(RepoVector3D(0, 0, -5), scaled);
+	VertexQuantiser::octEncode(RepoVector3D(0, 0, -1), unit);
+	EXPECT_EQ(unit[0], scaled[0]);
+	EXPECT_EQ(unit[1], scaled[1]);
+	VertexQuantiser::octEncode(RepoVector3D(), zero);
+	EXPECT_EQ(RepoVector3D(0, 0, 1), VertexQuantiser::octDecode(zero));
+}
@@ -0,0 +1,98 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <repo/core/model/bson/repo_node_metadata.h>
+#include <repo/manipulator/modelconvertor/import/odaHelper/geometry_collector.h>
+
+using namespace repo::manipulator::modelconvertor::odaHelper;
+using namespace repo::core::model;
+
+static repo_material_t createMaterial()
+{
+	repo_material_t material;
+	material.shininess = 0;
+	material.shininessStrength = 0;
+	material.opacity = 1;
+	material.diffuse = { 0.5f, 0.5f, 0.5f, 0 };
+	return material;
+}
+
+static void addTriangle(GeometryCollector &collector, const std::string &group)
+{
+	collector.setLayer(group, group);
+	collector.setMeshGroup(group);
+	collector.startMeshEntry();
+	collector.addFace({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 0, 1 });
+	collector.stopMeshEntry();
+}
+
+static void deleteNodes(const RepoNodeSet &nodes)
+{
+	for (auto node : nodes)
+		delete node;
+}
+
+TEST(GeometryCollectorTest, SharedMetadataPrecedence)
+{
+	GeometryCollector collector;
+	collector.setCurrentMaterial(createMaterial());
+	collector.setSharedMetadata("wall", "Basic Wall: Generic", { { "Function", "Exterior" }, { "Material", "Concrete" } });
+
+	//Agrees with the shared values, so only keeps its own
+	collector.setMetadata("agree", { { "Mark", "A" }, { "Function", "Exterior" } }, "wall");
+	//Overrides a shared value, so keeps a full copy with its own value
+	collector.setMetadata("conflict", { { "Mark", "B" }, { "Material", "Brick" } }, "wall");
+
+	addTriangle(collector, "agree");
+	addTriangle(collector, "conflict");
+
+	auto meshes = collector.getMeshNodes(collector.createRootNode());
+	auto metaNodes = collector.getMetadataNodes();
+	ASSERT_EQ(3, metaNodes.size());
+
+	std::map<std::string, MetadataNode*> nameToNode;
+	for (auto node : metaNodes)
+		nameToNode[node->getName()] = dynamic_cast<MetadataNode*>(node);
+
+	ASSERT_TRUE(nameToNode["agree"]);
+	auto agree = nameToNode["agree"]->getObjectField(REPO_NODE_LABEL_METADATA);
+	EXPECT_EQ("A", agree.getStringField("Mark"));
+	EXPECT_FALSE(agree.hasField("Function"));
+	EXPECT_FALSE(agree.hasField("Material"));
+
+	ASSERT_TRUE(nameToNode["conflict"]);
+	auto conflict = nameToNode["conflict"]->getObjectField(REPO_NODE_LABEL_METADATA);
+	EXPECT_EQ("B", conflict.getStringField("Mark"));
+	EXPECT_EQ("Brick", conflict.getStringField("Material"));
+	EXPECT_EQ("Exterior", conflict.getStringField("Function"));
+
+	//The shared node only hangs off the element that agrees with it
+	ASSERT_TRUE(nameToNode["Basic Wall: Generic"]);
+	auto shared = nameToNode["Basic Wall: Generic"];
+	EXPECT_EQ("Concrete", shared->getObjectField(REPO_NODE_LABEL_METADATA).getStringField("Material"));
+	auto sharedParents = shared->getParentIDs();
+	auto agreeParents = nameToNode["agree"]->getParentIDs();
+	ASSERT_EQ(1, sharedParents.size());
+	EXPECT_NE(agreeParents.end(), std::find(agreeParents.begin(), agreeParents.end(), sharedParents[0]));
+
+	deleteNodes(meshes);
+	deleteNodes(metaNodes);
+	deleteNodes(collector.getTransformationNodes());
+}
@@ -0,0 +1,84 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <repo/error_codes.h>
+#include <repo/manipulator/modelconvertor/import/repo_model_import_manager.h>
+#include <repo/manipulator/modelconvertor/import/repo_model_import_synthetic.h>
+
+using namespace repo::manipulator::modelconvertor;
+
+static std::string writeTempFile(const std::string &content, const std::string &extension = ".synthetic")
+{
+	auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%" + extension);
+	std::ofstream file(path.string());
+	file << content;
+	return path.string();
+}
+
+TEST(SyntheticModelImport, ImportFromFile)
+{
+	auto path = writeTempFile("{ \"seed\": 3, \"depth\": 2, \"fanOut\": 2, \"meshCount\": 12, \"trianglesPerMesh\": 8 }");
+
+	uint8_t err;
+	std::unique_ptr<repo::core::model::RepoScene> scene(ModelImportManager().ImportFromFile(path, ModelImportConfig(), err));
+	boost::filesystem::remove(path);
+
+#ifdef REPO_BUILD_BENCHMARKS
+	ASSERT_TRUE(scene);
+	EXPECT_EQ(REPOERR_OK, err);
+	EXPECT_EQ(12, scene->getAllMeshes(repo::core::model::RepoScene::GraphType::DEFAULT).size());
+#else
+	//Not reachable through the import path outside of benchmark builds
+	EXPECT_FALSE(scene);
+	EXPECT_EQ(REPOERR_FILE_TYPE_NOT_SUPPORTED, err);
+#endif
+}
+
+TEST(SyntheticModelImport, InvalidParameters)
+{
+	auto path = writeTempFile("{ \"meshCount\": \"many\" }");
+
+	uint8_t err = REPOERR_OK;
+	SyntheticModelImport importer(ModelImportConfig{});
+	EXPECT_FALSE(importer.importModel(path, err));
+	EXPECT_EQ(REPOERR_MODEL_FILE_READ, err);
+	boost::filesystem::remove(path);
+
+	for (const auto &params : {
+		"{ \"meshCount\": -1 }",
+		"{ \"depth\": -1 }",
+		"{ \"fanOut\": \"-1\" }",
+		"{ \"depth\": 1000 }",
+		"{ \"meshCount\": 4294967297 }",
+		"{ \"meshCount\": 1000000, \"trianglesPerMesh\": 1000 }",
+		"{ \"instancingRatio\": 1.5 }" })
+	{
+		path = writeTempFile(params);
+		err = REPOERR_OK;
+		SyntheticModelImport outOfRange(ModelImportConfig{});
+		EXPECT_FALSE(outOfRange.importModel(path, err)) << params;
+		EXPECT_EQ(REPOERR_MODEL_FILE_READ, err) << params;
+		boost::filesystem::remove(path);
+	}
+
+	EXPECT_TRUE(SyntheticModelImport::isSupportedExts(".SYNTHETIC"));
+	EXPECT_FALSE(SyntheticModelImport::isSupportedExts(".IFC"));
+}
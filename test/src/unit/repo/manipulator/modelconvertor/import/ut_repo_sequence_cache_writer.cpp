@@ -0,0 +1,47 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <gtest/gtest.h>
+#include <repo/manipulator/modelconvertor/import/repo_sequence_cache_writer.h>
+
+using namespace repo::manipulator::modelconvertor;
+
+TEST(SequenceCacheWriterTest, SerialiseFrames)
+{
+	std::unordered_map<std::string, std::vector<uint8_t>> buffers;
+	std::vector<std::shared_ptr<const SequenceFrameState>> states;
+	std::vector<std::string> refs;
+	{
+		SequenceCacheWriter writer(buffers, SequenceStateFormat::JSON, 4, 2);
+		SequenceFrameState state;
+		for (int i = 0; i < 50; ++i)
+		{
+			state.setValue(SequenceFrameState::Property::TRANSPARENCY, std::to_string(i % 7), { i / 50. });
+			auto snapshot = std::make_shared<const SequenceFrameState>(state);
+			refs.push_back(std::to_string(i));
+			EXPECT_TRUE(writer.addFrame(refs.back(), snapshot));
+			states.push_back(snapshot);
+		}
+		EXPECT_TRUE(writer.finalise());
+		EXPECT_FALSE(writer.addFrame("late", states.back()));
+	}
+
+	ASSERT_EQ(refs.size(), buffers.size());
+	for (size_t i = 0; i < refs.size(); ++i)
+	{
+		EXPECT_EQ(states[i]->serialise(), buffers[refs[i]]);
+	}
+}
@@ -0,0 +1,211 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <gtest/gtest.h>
+#include <repo/manipulator/modelconvertor/import/repo_sequence_frame_state.h>
+
+using namespace repo::manipulator::modelconvertor;
+
+typedef SequenceFrameState::Property Property;
+
+static SequenceFrameState createState()
+{
+	SequenceFrameState state;
+	std::vector<double> matrix(16, 0);
+	matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1;
+	matrix[3] = 12.5;
+
+	state.setValue(Property::TRANSPARENCY, "a", { 0.5 });
+	state.setValue(Property::TRANSPARENCY, "b", { 0.5 });
+	state.setValue(Property::COLOR, "a", { 1, 0, 0.5 });
+	state.setValue(Property::TRANSFORMATION, "c", matrix);
+	state.setValue(Property::CLIP, "d", { 1, 2, 3, 0, 0, 1 });
+	state.setCamera({ { 1, 2, 3 }, { 0, 0, 1 }, { 0, 1, 0 }, 45.f, true });
+	return state;
+}
+
+TEST(SequenceFrameStateTest, KeyFrameRoundTrip)
+{
+	auto state = createState();
+	SequenceFrameState parsed;
+	ASSERT_TRUE(SequenceFrameState::deserialise(state.serialise(), parsed));
+
+	EXPECT_EQ(2, parsed.size(Property::TRANSPARENCY));
+	EXPECT_EQ(std::vector<double>({ 0.5 }), *parsed.getValue(Property::TRANSPARENCY, "b"));
+	EXPECT_EQ(std::vector<double>({ 1, 0, 0.5 }), *parsed.getValue(Property::COLOR, "a"));
+	EXPECT_EQ(*state.getValue(Property::TRANSFORMATION, "c"), *parsed.getValue(Property::TRANSFORMATION, "c"));
+	EXPECT_EQ(std::vector<double>({ 1, 2, 3, 0, 0, 1 }), *parsed.getValue(Property::CLIP, "d"));
+	EXPECT_EQ(nullptr, parsed.getValue(Property::COLOR, "b"));
+	ASSERT_TRUE(parsed.hasCamera());
+	EXPECT_EQ(45.f, parsed.getCamera().fov);
+	EXPECT_TRUE(parsed.getCamera().isPerspective);
+}
+
+TEST(SequenceFrameStateTest, DeltaOnlyContainsChanges)
+{
+	auto previous = createState();
+	auto current = previous;
+	EXPECT_EQ(std::vector<uint8_t>({ '{', '}' }), current.serialiseDelta(previous));
+
+	current.setValue(Property::TRANSPARENCY, "b", { 0.25 });
+	auto delta = current.serialiseDelta(previous);
+	std::string deltaStr(delta.begin(), delta.end());
+	EXPECT_NE(std::string::npos, deltaStr.find("\"b\""));
+	EXPECT_EQ(std::string::npos, deltaStr.find("\"a\""));
+	EXPECT_EQ(std::string::npos, deltaStr.find("camera"));
+	EXPECT_LT(delta.size(), current.serialise().size());
+}
+
+TEST(SequenceFrameStateTest, Reconstruct)
+{
+	auto frame0 = createState();
+	auto frame1 = frame0;
+	frame1.setValue(Property::TRANSPARENCY, "b", { 0.25 });
+	frame1.setValue(Property::COLOR, "e", { 0, 1, 0 });
+	SequenceFrameState frame2;
+	frame2.setValue(Property::COLOR, "e", { 0, 1, 0 });
+
+	std::vector<std::vector<uint8_t>> deltas = {
+		frame1.serialiseDelta(frame0),
+		frame2.serialiseDelta(frame1)
+	};
+
+	SequenceFrameState result;
+	ASSERT_TRUE(SequenceFrameState::reconstruct(frame0.serialise(), { deltas[0] }, result));
+	EXPECT_EQ(std::vector<double>({ 0.25 }), *result.getValue(Property::TRANSPARENCY, "b"));
+	EXPECT_EQ(std::vector<double>({ 0.5 }), *result.getValue(Property::TRANSPARENCY, "a"));
+	EXPECT_EQ(2, result.size(Property::COLOR));
+
+	ASSERT_TRUE(SequenceFrameState::reconstruct(frame0.serialise(), deltas, result));
+	EXPECT_EQ(0, result.size(Property::TRANSPARENCY));
+	EXPECT_EQ(1, result.size(Property::COLOR));
+	EXPECT_EQ(0, result.size(Property::TRANSFORMATION));
+	EXPECT_EQ(0, result.size(Property::CLIP));
+	EXPECT_FALSE(result.hasCamera());
+}
+
+TEST(SequenceFrameStateTest, ExplicitResets)
+{
+	auto frame0 = createState();
+
+	//A delta built from tracked changes, without the previous state
+	SequenceFrameState delta;
+	delta.setValue(Property::TRANSPARENCY, "b", { 0.25 });
+	delta.resetValue(Property::TRANSPARENCY, "a");
+	delta.resetValue(Property::CLIP, "d");
+	delta.resetCamera();
+	EXPECT_EQ(1, delta.size(Property::TRANSPARENCY));
+
+	SequenceFrameState result;
+	ASSERT_TRUE(SequenceFrameState::reconstruct(frame0.serialise(), { delta.serialise() }, result));
+	EXPECT_EQ(1, result.size(Property::TRANSPARENCY));
+	EXPECT_EQ(std::vector<double>({ 0.25 }), *result.getValue(Property::TRANSPARENCY, "b"));
+	EXPECT_EQ(0, result.size(Property::CLIP));
+	EXPECT_EQ(1, result.size(Property::COLOR));
+	EXPECT_FALSE(result.hasCamera());
+
+	//Setting a value again cancels its reset
+	delta.setValue(Property::TRANSPARENCY, "a", { 1 });
+	ASSERT_TRUE(SequenceFrameState::reconstruct(frame0.serialise(), { delta.serialise() }, result));
+	EXPECT_EQ(std::vector<double>({ 1 }), *result.getValue(Property::TRANSPARENCY, "a"));
+}
+
+TEST(SequenceFrameStateTest, MalformedBuffer)
+{
+	SequenceFrameState state;
+	std::string bad = "{\"color\":[{\"value\":[1,0],\"shared_ids\":[\"a\"]}]}";
+	EXPECT_FALSE(state.applyDelta(std::vector<uint8_t>(bad.begin(), bad.end())));
+	EXPECT_FALSE(state.applyDelta({ 'x' }));
+	EXPECT_FALSE(SequenceFrameState::deserialise(std::vector<uint8_t>(), state));
+
+	//A delta failing part way through must not be partially applied
+	auto valid = createState();
+	std::string partial = "{\"reset\":{\"transparency\":[\"a\"]},\"color\":[{\"value\":[1,0],\"shared_ids\":[\"b\"]}]}";
+	EXPECT_FALSE(valid.applyDelta(std::vector<uint8_t>(partial.begin(), partial.end())));
+	EXPECT_EQ(2, valid.size(Property::TRANSPARENCY));
+	EXPECT_EQ(1, valid.size(Property::COLOR));
+}
+
+TEST(SequenceFrameStateTest, BinaryRoundTrip)
+{
+	auto id1 = repo::lib::RepoUUID::createUUID().toString();
+	auto id2 = repo::lib::RepoUUID::createUUID().toString();
+	std::vector<double> matrix(16, 0);
+	matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1;
+	matrix[3] = 12.5;
+
+	SequenceFrameState frame0;
+	frame0.setValue(Property::TRANSPARENCY, id1, { 0.5 });
+	frame0.setValue(Property::COLOR, id2, { 1, 0, 128 / 255.f });
+	frame0.setValue(Property::TRANSFORMATION, id1, matrix);
+	frame0.setValue(Property::CLIP, id2, { 1, 2, 3, 0, 0, 1 });
+	frame0.setCamera({ { 100000.25, 2, 3 }, { 0, 0, 1 }, { 0, 1, 0 }, 45.f, false });
+
+	auto frame1 = frame0;
+	frame1.setValue(Property::TRANSPARENCY, id1, { 0.25 });
+	frame1.setValue(Property::TRANSPARENCY, id2, { 0.25 });
+
+	SequenceFrameState frame2;
+	frame2.setValue(Property::TRANSPARENCY, id2, { 0.25 });
+
+	for (const auto &format : { SequenceStateFormat::BINARY, SequenceStateFormat::BINARY_COMPRESSED })
+	{
+		auto keyFrame = frame0.serialise(format);
+		ASSERT_GE(keyFrame.size(), 4);
+		EXPECT_EQ('R', keyFrame[0]);
+
+		SequenceFrameState result;
+		ASSERT_TRUE(SequenceFrameState::reconstruct(keyFrame, { frame1.serialiseDelta(frame0, format) }, result));
+		EXPECT_EQ(std::vector<double>({ 0.25 }), *result.getValue(Property::TRANSPARENCY, id1));
+		EXPECT_EQ(std::vector<double>({ 0.25 }), *result.getValue(Property::TRANSPARENCY, id2));
+		EXPECT_EQ(*frame0.getValue(Property::COLOR, id2), *result.getValue(Property::COLOR, id2));
+		EXPECT_EQ(matrix, *result.getValue(Property::TRANSFORMATION, id1));
+		EXPECT_EQ(std::vector<double>({ 1, 2, 3, 0, 0, 1 }), *result.getValue(Property::CLIP, id2));
+		ASSERT_TRUE(result.hasCamera());
+		EXPECT_EQ(100000.25, result.getCamera().position.x);
+		EXPECT_FALSE(result.getCamera().isPerspective);
+
+		ASSERT_TRUE(result.applyDelta(frame2.serialiseDelta(frame1, format)));
+		EXPECT_EQ(1, result.size(Property::TRANSPARENCY));
+		EXPECT_EQ(0, result.size(Property::COLOR));
+		EXPECT_FALSE(result.hasCamera());
+	}
+}
+
+TEST(SequenceFrameStateTest, BinaryIsSmallerThanJSON)
+{
+	SequenceFrameState state;
+	for (int i = 0; i < 1000; ++i)
+		state.setValue(Property::TRANSPARENCY, repo::lib::RepoUUID::createUUID().toString(), { (double)(i % 10) / 10. });
+
+	auto json = state.serialise(SequenceStateFormat::JSON);
+	auto binary = state.serialise(SequenceStateFormat::BINARY);
+	auto compressed = state.serialise(SequenceStateFormat::BINARY_COMPRESSED);
+	EXPECT_LT(binary.size(), json.size());
+	EXPECT_LE(compressed.size(), binary.size());
+}
+
+TEST(SequenceFrameStateTest, MalformedBinaryBuffer)
+{
+	SequenceFrameState state;
+	state.setValue(Property::TRANSPARENCY, repo::lib::RepoUUID::createUUID().toString(), { 0.5 });
+	auto buffer = state.serialise(SequenceStateFormat::BINARY);
+	buffer.resize(buffer.size() - 3);
+
+	SequenceFrameState result;
+	EXPECT_FALSE(result.applyDelta(buffer));
+	EXPECT_EQ(0, result.size(Property::TRANSPARENCY));
+}
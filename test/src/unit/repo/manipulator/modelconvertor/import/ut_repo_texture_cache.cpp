@@ -0,0 +1,119 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include <repo/manipulator/modelconvertor/import/repo_texture_cache.h>
+#include <repo/core/model/bson/repo_node_texture.h>
+
+using namespace repo::manipulator::modelconvertor;
+
+static std::string writeTempFile(const std::vector<char> &data)
+{
+	auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.png");
+	std::ofstream file(path.string(), std::ios::out | std::ios::binary);
+	file.write(data.data(), data.size());
+	file.close();
+	return path.string();
+}
+
+TEST(TextureCacheTest, DeduplicateByContent)
+{
+	TextureCache cache;
+	std::vector<char> data1 = { 1, 2, 3, 4, 5 };
+	std::vector<char> data2 = { 5, 4, 3, 2, 1 };
+
+	auto id1 = cache.addTexture("a.png", data1.data(), data1.size(), 5, 0);
+	auto id2 = cache.addTexture("b.png", data1.data(), data1.size(), 5, 0);
+	auto id3 = cache.addTexture("c.png", data2.data(), data2.size(), 5, 0);
+
+	EXPECT_EQ(id1, id2);
+	EXPECT_NE(id1, id3);
+	EXPECT_EQ(2, cache.getNumUniqueTextures());
+}
+
+TEST(TextureCacheTest, MergeParents)
+{
+	TextureCache cache;
+	std::vector<char> data = { 1, 2, 3, 4, 5 };
+	auto parent1 = repo::lib::RepoUUID::createUUID();
+	auto parent2 = repo::lib::RepoUUID::createUUID();
+
+	auto id1 = cache.addTexture("a.png", data.data(), data.size(), 5, 0);
+	auto id2 = cache.addTexture("b.png", data.data(), data.size(), 5, 0);
+	cache.addParent(id1, parent1);
+	cache.addParents(id2, { parent2 });
+
+	auto nodes = cache.createTextureNodes();
+	ASSERT_EQ(1, nodes.size());
+	auto texture = dynamic_cast<repo::core::model::TextureNode*>(*nodes.begin());
+	ASSERT_TRUE(texture);
+	EXPECT_EQ(2, texture->getParentIDs().size());
+	EXPECT_EQ(data, texture->getRawData());
+	delete texture;
+}
+
+TEST(TextureCacheTest, SkipUnreferenced)
+{
+	TextureCache cache;
+	std::vector<char> data1 = { 1, 2, 3, 4, 5 };
+	std::vector<char> data2 = { 5, 4, 3, 2, 1 };
+
+	auto id1 = cache.addTexture("a.png", data1.data(), data1.size(), 5, 0);
+	cache.addTexture("b.png", data2.data(), data2.size(), 5, 0);
+	cache.addParent(id1, repo::lib::RepoUUID::createUUID());
+
+	auto nodes = cache.createTextureNodes(true);
+	EXPECT_EQ(1, nodes.size());
+	for (auto &node : nodes)
+		delete node;
+}
+
+TEST(TextureCacheTest, AddTextureFile)
+{
+	TextureCache cache;
+	std::vector<char> data = { 1, 2, 3, 4, 5 };
+	auto path1 = writeTempFile(data);
+	auto path2 = writeTempFile(data);
+
+	TextureCache::TextureId id1, id2, id3, id4;
+	EXPECT_TRUE(cache.addTextureFile("a.png", path1, id1));
+	EXPECT_TRUE(cache.addTextureFile("a.png", path1, id2));
+	EXPECT_TRUE(cache.addTextureFile("b.png", path2, id3));
+	EXPECT_EQ(id1, id2);
+	EXPECT_EQ(id1, id3);
+	EXPECT_EQ(1, cache.getNumUniqueTextures());
+
+	//Same content as a file, but different dimensions
+	cache.addTexture("c.png", data.data(), data.size(), 5, 5);
+	EXPECT_EQ(2, cache.getNumUniqueTextures());
+
+	EXPECT_FALSE(cache.addTextureFile("d.png", path1 + ".missing", id4));
+
+	//The image is not decoded, the width is a placeholder and not the size of the file
+	cache.addParent(id1, repo::lib::RepoUUID::createUUID());
+	auto nodes = cache.createTextureNodes(true);
+	ASSERT_EQ(1, nodes.size());
+	EXPECT_EQ(1, (*nodes.begin())->getIntField(REPO_LABEL_WIDTH));
+	EXPECT_EQ(0, (*nodes.begin())->getIntField(REPO_LABEL_HEIGHT));
+	for (auto &node : nodes)
+		delete node;
+
+	boost::filesystem::remove(path1);
+	boost::filesystem::remove(path2);
+}
@@ -0,0 +1,176 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <tuple>
+#include <repo/manipulator/modelconvertor/import/repo_vertex_map.h>
+
+using namespace repo::manipulator::modelconvertor;
+using repo::lib::RepoVector2D;
+using repo::lib::RepoVector3D64;
+
+TEST(VertexMap, Positions)
+{
+	VertexMap map;
+
+	auto a = map.find({ 1, 2, 3 });
+	EXPECT_TRUE(a.added);
+	EXPECT_EQ(0, a.index);
+
+	auto b = map.find({ 3, 2, 1 });
+	EXPECT_TRUE(b.added);
+	EXPECT_EQ(1, b.index);
+
+	auto c = map.find({ 1, 2, 3 });
+	EXPECT_FALSE(c.added);
+	EXPECT_EQ(0, c.index);
+
+	ASSERT_EQ(2, map.vertices.size());
+	EXPECT_EQ(RepoVector3D64(1, 2, 3), map.vertices[0]);
+	EXPECT_EQ(RepoVector3D64(3, 2, 1), map.vertices[1]);
+	EXPECT_EQ(0, map.normals.size());
+	EXPECT_EQ(0, map.uvs.size());
+}
+
+TEST(VertexMap, NormalsAndUvs)
+{
+	VertexMap normalMap;
+	EXPECT_TRUE(normalMap.find({ 1, 2, 3 }, { 0, 0, 1 }).added);
+	EXPECT_TRUE(normalMap.find({ 1, 2, 3 }, { 0, 1, 0 }).added);
+	EXPECT_FALSE(normalMap.find({ 1, 2, 3 }, { 0, 0, 1 }).added);
+	EXPECT_EQ(1, normalMap.find({ 1, 2, 3 }, { 0, 1, 0 }).index);
+	EXPECT_EQ(2, normalMap.vertices.size());
+	ASSERT_EQ(2, normalMap.normals.size());
+	EXPECT_EQ(RepoVector3D64(0, 1, 0), normalMap.normals[1]);
+
+	VertexMap uvMap;
+	EXPECT_TRUE(uvMap.find({ 1, 2, 3 }, { 0, 0, 1 }, { 0, 0 }).added);
+	EXPECT_TRUE(uvMap.find({ 1, 2, 3 }, { 0, 0, 1 }, { 0, 1 }).added);
+	EXPECT_TRUE(uvMap.find({ 1, 2, 3 }, { 1, 0, 0 }, { 0, 1 }).added);
+	EXPECT_FALSE(uvMap.find({ 1, 2, 3 }, { 0, 0, 1 }, { 0, 1 }).added);
+	EXPECT_EQ(3, uvMap.vertices.size());
+	EXPECT_EQ(3, uvMap.normals.size());
+	ASSERT_EQ(3, uvMap.uvs.size());
+	EXPECT_EQ(RepoVector2D(0, 1), uvMap.uvs[1]);
+}
+
+TEST(VertexMap, SignedZero)
+{
+	//-0 and 0 compare equal, so they should be welded
+	VertexMap map;
+	EXPECT_TRUE(map.find({ 0, 0, 0 }, { 0, 0, 1 }).added);
+	EXPECT_FALSE(map.find({ -0.0, 0, -0.0 }, { -0.0, 0, 1 }).added);
+}
+
+TEST(VertexMap, Tolerance)
+{
+	VertexMap exact;
+	EXPECT_EQ(0, exact.getTolerance());
+	EXPECT_TRUE(exact.find({ 1, 1, 1 }).added);
+	EXPECT_TRUE(exact.find({ 1.0001, 1, 1 }).added);
+
+	VertexMap welded(0.01);
+	EXPECT_EQ(0.01, welded.getTolerance());
+	EXPECT_TRUE(welded.find({ 1, 1, 1 }).added);
+	auto near = welded.find({ 1.0001, 0.9999, 1.001 });
+	EXPECT_FALSE(near.added);
+	EXPECT_EQ(0, near.index);
+	EXPECT_TRUE(welded.find({ 1.1, 1, 1 }).added);
+
+	//The first vertex of a cell is the one kept
+	ASSERT_EQ(2, welded.vertices.size());
+	EXPECT_EQ(RepoVector3D64(1, 1, 1), welded.vertices[0]);
+
+	//Normals are never welded
+	VertexMap weldedNormals(0.01);
+	EXPECT_TRUE(weldedNormals.find({ 1, 1, 1 }, { 0, 0, 1 }).added);
+	EXPECT_TRUE(weldedNormals.find({ 1.0001, 1, 1 }, { 0, 0.0001, 1 }).added);
+	EXPECT_FALSE(weldedNormals.find({ 1.0001, 1, 1 }, { 0, 0, 1 }).added);
+}
+
+TEST(VertexMap, Reserve)
+{
+	VertexMap map;
+	map.reserve(1000);
+	EXPECT_GE(map.vertices.capacity(), 1000);
+	EXPECT_EQ(0, map.vertices.size());
+
+	for (int i = 0; i < 1000; ++i)
+		map.find({ (double)i, 0, 0 }, { 0, 0, 1 });
+	auto data = map.vertices.data();
+	EXPECT_GE(map.normals.capacity(), 1000);
+
+	//Repeated small hints must not reallocate on every call
+	size_t nReallocations = 0;
+	for (int i = 0; i < 1000; ++i)
+	{
+		map.reserve(map.vertices.size() + 1);
+		map.find({ (double)i, 1, 0 }, { 0, 0, 1 });
+		if (map.vertices.data() != data) {
+			data = map.vertices.data();
+			++nReallocations;
+		}
+	}
+	EXPECT_LE(nReallocations, 2);
+
+	//Reserving after vertices are added keeps them findable
+	map.reserve(100000);
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto res = map.find({ (double)i, 0, 0 }, { 0, 0, 1 });
+		EXPECT_FALSE(res.added);
+		EXPECT_EQ(i, res.index);
+	}
+}
+
+TEST(VertexMap, MatchesReference)
+{
+	//Weld a large number of vertices drawn from a small pool, and compare against an ordered map
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> coord(0, 40);
+	std::uniform_int_distribution<int> axis(0, 2);
+
+	VertexMap map;
+	std::map<std::tuple<double, double, double, int>, uint32_t> reference;
+
+	for (int i = 0; i < 200000; ++i)
+	{
+		RepoVector3D64 position(coord(rng) * 0.25, coord(rng) * 0.5, coord(rng) - 20.0);
+		int normalAxis = axis(rng);
+		RepoVector3D64 normal(normalAxis == 0, normalAxis == 1, normalAxis == 2);
+
+		auto res = map.find(position, normal);
+		auto key = std::make_tuple(position.x, position.y, position.z, normalAxis);
+		auto it = reference.find(key);
+		if (it == reference.end())
+		{
+			ASSERT_TRUE(res.added);
+			ASSERT_EQ(reference.size(), res.index);
+			reference[key] = res.index;
+		}
+		else
+		{
+			ASSERT_FALSE(res.added);
+			ASSERT_EQ(it->second, res.index);
+		}
+	}
+
+	EXPECT_EQ(reference.size(), map.vertices.size());
+	EXPECT_EQ(reference.size(), map.normals.size());
+}
@@ -0,0 +1,205 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <repo/core/model/bson/repo_bson_factory.h>
+#include <repo/manipulator/modelutility/repo_mesh_map_reorganiser.h>
+#include <repo/manipulator/modelutility/repo_vertex_cache_optimiser.h>
+
+using namespace repo::manipulator::modelutility;
+using namespace repo::core::model;
+
+/**
+* Create a mesh of nQuads quads, two triangles each, with one mapping per quad
+*/
+static MeshNode createQuadsMesh(const uint32_t &nQuads, std::vector<repo_mesh_mapping_t> &mappings)
+{
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<repo_face_t> faces;
+	for (uint32_t i = 0; i < nQuads; ++i)
+	{
+		float z = i;
+		vertices.push_back({ 0, 0, z });
+		vertices.push_back({ 1, 0, z });
+		vertices.push_back({ 1, 1, z });
+		vertices.push_back({ 0, 1, z });
+		faces.push_back({ i * 4, i * 4 + 1, i * 4 + 2 });
+		faces.push_back({ i * 4, i * 4 + 2, i * 4 + 3 });
+
+		repo_mesh_mapping_t mapping;
+		mapping.min = { 0, 0, z };
+		mapping.max = { 1, 1, z };
+		mapping.mesh_id = repo::lib::RepoUUID::createUUID();
+		mapping.material_id = repo::lib::RepoUUID::createUUID();
+		mapping.vertFrom = i * 4;
+		mapping.vertTo = (i + 1) * 4;
+		mapping.triFrom = i * 2;
+		mapping.triTo = (i + 1) * 2;
+		mappings.push_back(mapping);
+	}
+
+	auto mesh = RepoBSONFactory::makeMeshNode(vertices, faces, {}, { { 0, 0, 0 }, { 1, 1, (float)nQuads - 1 } });
+	return mesh.cloneAndUpdateMeshMapping(mappings, true);
+}
+
+TEST(MeshMapReorganiserTest, WithinLimits)
+{
+	std::vector<repo_mesh_mapping_t> mappings;
+	auto mesh = createQuadsMesh(3, mappings);
+	MeshMapReorganiser reorganiser(&mesh, 65536, 65536);
+
+	auto matMap = reorganiser.getMappingsPerSubMesh();
+	ASSERT_EQ(1, matMap.size());
+	ASSERT_EQ(mappings.size(), matMap[0].size());
+	for (int i = 0; i < mappings.size(); ++i)
+	{
+		EXPECT_EQ(mappings[i].mesh_id, matMap[0][i].mesh_id);
+		EXPECT_EQ(mappings[i].vertFrom, matMap[0][i].vertFrom);
+		EXPECT_EQ(mappings[i].triTo, matMap[0][i].triTo);
+	}
+
+	auto splitMap = reorganiser.getSplitMapping();
+	EXPECT_EQ(mappings.size(), splitMap.size());
+	for (const auto &mapping : mappings)
+		EXPECT_EQ(std::vector<uint32_t>({ 0 }), splitMap[mapping.mesh_id]);
+
+	auto idMaps = reorganiser.getIDMapArrays();
+	ASSERT_EQ(1, idMaps.size());
+	EXPECT_EQ(std::vector<float>({ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 }), idMaps[0]);
+
+	//Indices are unchanged
+	std::vector<uint32_t> expectedFaces;
+	for (const auto &face : mesh.getFaces())
+		expectedFaces.insert(expectedFaces.end(), face.begin(), face.end());
+	EXPECT_EQ(expectedFaces, reorganiser.getSerialisedFaces32());
+	EXPECT_EQ(std::vector<uint16_t>(expectedFaces.begin(), expectedFaces.end()), reorganiser.getSerialisedFaces());
+
+	auto remapped = reorganiser.getRemappedMesh();
+	EXPECT_EQ(mesh.getUniqueID(), remapped.getUniqueID());
+	EXPECT_EQ(mesh.getVertices().size(), remapped.getVertices().size());
+	ASSERT_EQ(1, remapped.getMeshMapping().size());
+	EXPECT_EQ(12, remapped.getMeshMapping()[0].vertTo);
+	EXPECT_EQ(6, remapped.getMeshMapping()[0].triTo);
+}
+
+TEST(MeshMapReorganiserTest, SplitOverLimit)
+{
+	std::vector<repo_mesh_mapping_t> mappings;
+	auto mesh = createQuadsMesh(2, mappings);
+	MeshMapReorganiser reorganiser(&mesh, 4, 65536);
+
+	auto matMap = reorganiser.getMappingsPerSubMesh();
+	ASSERT_EQ(2, matMap.size());
+	EXPECT_EQ(std::vector<uint32_t>({ 0 }), reorganiser.getSplitMapping()[mappings[0].mesh_id]);
+	EXPECT_EQ(std::vector<uint32_t>({ 1 }), reorganiser.getSplitMapping()[mappings[1].mesh_id]);
+
+	//Each sub mesh is indexed from 0
+	EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 0, 2, 3, 0, 1, 2, 0, 2, 3 }), reorganiser.getSerialisedFaces32());
+}
+
+TEST(MeshMapReorganiserTest, LargeIndices)
+{
+	//Indices above 65535 are kept when the limits allow it
+	std::vector<repo_mesh_mapping_t> mappings;
+	auto mesh = createQuadsMesh(16385, mappings);
+	MeshMapReorganiser reorganiser(&mesh, UINT32_MAX, UINT32_MAX);
+
+	ASSERT_EQ(1, reorganiser.getMappingsPerSubMesh().size());
+	auto faces = reorganiser.getSerialisedFaces32();
+	ASSERT_EQ(16385 * 6, faces.size());
+	EXPECT_EQ(65536 + 3, faces.back());
+}
+
+TEST(MeshMapReorganiserTest, OptimiseVertexCache)
+{
+	//Two mappings, each a grid of quads with the triangles in a scattered order
+	const uint32_t n = 16;
+	const uint32_t nGridVertices = (n + 1) * (n + 1);
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<repo_face_t> faces;
+	std::vector<repo_mesh_mapping_t> mappings;
+	for (uint32_t m = 0; m < 2; ++m)
+	{
+		const uint32_t base = m * nGridVertices;
+		for (uint32_t y = 0; y <= n; ++y)
+			for (uint32_t x = 0; x <= n; ++x)
+				vertices.push_back({ (float)x, (float)y, (float)m });
+
+		std::vector<repo_face_t> gridFaces;
+		for (uint32_t y = 0; y < n; ++y)
+		{
+			for (uint32_t x = 0; x < n; ++x)
+			{
+				uint32_t v = base + y * (n + 1) + x;
+				gridFaces.push_back({ v, v + 1, v + n + 2 });
+				gridFaces.push_back({ v, v + n + 2, v + n + 1 });
+			}
+		}
+		for (size_t i = 0; i < gridFaces.size(); ++i)
+			faces.push_back(gridFaces[(i * 97) % gridFaces.size()]);
+
+		repo_mesh_mapping_t mapping;
+		mapping.min = { 0, 0, (float)m };
+		mapping.max = { (float)n, (float)n, (float)m };
+		mapping.mesh_id = repo::lib::RepoUUID::createUUID();
+		mapping.material_id = repo::lib::RepoUUID::createUUID();
+		mapping.vertFrom = base;
+		mapping.vertTo = base + nGridVertices;
+		mapping.triFrom = m * n * n * 2;
+		mapping.triTo = (m + 1) * n * n * 2;
+		mappings.push_back(mapping);
+	}
+	auto mesh = RepoBSONFactory::makeMeshNode(vertices, faces, {}, { { 0, 0, 0 }, { (float)n, (float)n, 1 } })
+		.cloneAndUpdateMeshMapping(mappings, true);
+
+	MeshMapReorganiser plain(&mesh, 65535, SIZE_MAX);
+	MeshMapReorganiser optimised(&mesh, 65535, SIZE_MAX, true);
+
+	//Mappings and idMaps are unchanged
+	EXPECT_EQ(plain.getIDMapArrays(), optimised.getIDMapArrays());
+	ASSERT_EQ(1, optimised.getMappingsPerSubMesh().size());
+	ASSERT_EQ(2, optimised.getMappingsPerSubMesh()[0].size());
+
+	auto plainFaces = plain.getSerialisedFaces32();
+	auto optimisedFaces = optimised.getSerialisedFaces32();
+	ASSERT_EQ(plainFaces.size(), optimisedFaces.size());
+	EXPECT_LT(VertexCacheOptimiser::getACMR(optimisedFaces.data(), optimisedFaces.size() / 3),
+		VertexCacheOptimiser::getACMR(plainFaces.data(), plainFaces.size() / 3));
+
+	//Each mapping keeps the same triangles, by position, and only refers to its own vertices
+	auto plainVertices = plain.getRemappedMesh().getVertices();
+	auto optimisedVertices = optimised.getRemappedMesh().getVertices();
+	auto toPositions = [](const std::vector<uint32_t> &indices, const std::vector<repo::lib::RepoVector3D> &vertices, size_t from, size_t to)
+	{
+		std::vector<std::string> triangles;
+		for (size_t i = from * 3; i < to * 3; i += 3)
+			triangles.push_back(vertices[indices[i]].toString() + vertices[indices[i + 1]].toString() + vertices[indices[i + 2]].toString());
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	};
+	for (const auto &mapping : optimised.getMappingsPerSubMesh()[0])
+	{
+		EXPECT_EQ(toPositions(plainFaces, plainVertices, mapping.triFrom, mapping.triTo),
+			toPositions(optimisedFaces, optimisedVertices, mapping.triFrom, mapping.triTo));
+		for (size_t i = mapping.triFrom * 3; i < mapping.triTo * 3; ++i)
+		{
+			EXPECT_GE(optimisedFaces[i], mapping.vertFrom);
+			EXPECT_LT(optimisedFaces[i], mapping.vertTo);
+		}
+	}
+}
@@ -0,0 +1,195 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <repo/core/model/bson/repo_bson_factory.h>
+#include <repo/manipulator/modelutility/repo_mesh_map_reorganiser.h>
+#include <repo/manipulator/modelutility/repo_mesh_reorganiser_cache.h>
+
+using namespace repo::manipulator::modelutility;
+using namespace repo::core::model;
+
+/**
+* Create a mesh of nQuads quads, with one mapping per quad
+*/
+static MeshNode createMultipartMesh(const uint32_t &nQuads)
+{
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<repo_face_t> faces;
+	std::vector<repo_mesh_mapping_t> mappings;
+	for (uint32_t i = 0; i < nQuads; ++i)
+	{
+		float z = i;
+		vertices.push_back({ 0, 0, z });
+		vertices.push_back({ 1, 0, z });
+		vertices.push_back({ 1, 1, z });
+		vertices.push_back({ 0, 1, z });
+		faces.push_back({ i * 4, i * 4 + 1, i * 4 + 2 });
+		faces.push_back({ i * 4, i * 4 + 2, i * 4 + 3 });
+
+		repo_mesh_mapping_t mapping;
+		mapping.min = { 0, 0, z };
+		mapping.max = { 1, 1, z };
+		mapping.mesh_id = repo::lib::RepoUUID::createUUID();
+		mapping.material_id = repo::lib::RepoUUID::createUUID();
+		mapping.vertFrom = i * 4;
+		mapping.vertTo = (i + 1) * 4;
+		mapping.triFrom = i * 2;
+		mapping.triTo = (i + 1) * 2;
+		mappings.push_back(mapping);
+	}
+
+	auto mesh = RepoBSONFactory::makeMeshNode(vertices, faces, {}, { { 0, 0, 0 }, { 1, 1, (float)nQuads - 1 } });
+	return mesh.cloneAndUpdateMeshMapping(mappings, true);
+}
+
+TEST(MeshReorganiserCacheTest, MatchesReorganiser)
+{
+	auto mesh = createMultipartMesh(10);
+	MeshReorganiserCache cache;
+	auto reorganised = cache.getReorganisedMesh(&mesh, 8, 65536);
+	ASSERT_TRUE(reorganised);
+
+	MeshMapReorganiser reorganiser(&mesh, 8, 65536);
+	EXPECT_EQ(reorganiser.getRemappedMesh().getMeshMapping().size(), reorganised->remappedMesh.getMeshMapping().size());
+	EXPECT_EQ(reorganiser.getSerialisedFaces32(), reorganised->serialisedFaces);
+	EXPECT_EQ(reorganiser.getIDMapArrays(), reorganised->idMapArrays);
+	EXPECT_EQ(reorganiser.getMappingsPerSubMesh().size(), reorganised->mappingsPerSubMesh.size());
+	EXPECT_EQ(reorganiser.getSplitMapping(), reorganised->splitMapping);
+}
+
+TEST(MeshReorganiserCacheTest, Lookup)
+{
+	auto mesh = createMultipartMesh(4);
+	MeshReorganiserCache cache;
+	EXPECT_EQ(0, cache.getNumEntries());
+
+	auto first = cache.getReorganisedMesh(&mesh, 65535, SIZE_MAX);
+	EXPECT_EQ(1, cache.getNumEntries());
+	EXPECT_GT(cache.getSize(), 0);
+	EXPECT_EQ(first, cache.getReorganisedMesh(&mesh, 65535, SIZE_MAX));
+
+	//Different limits are different entries
+	auto other = cache.getReorganisedMesh(&mesh, 4, SIZE_MAX);
+	EXPECT_NE(first, other);
+	EXPECT_EQ(1, first->mappingsPerSubMesh.size());
+	EXPECT_EQ(4, other->mappingsPerSubMesh.size());
+	EXPECT_EQ(2, cache.getNumEntries());
+
+	cache.clear();
+	EXPECT_EQ(0, cache.getNumEntries());
+	EXPECT_EQ(0, cache.getSize());
+	EXPECT_NE(first, cache.getReorganisedMesh(&mesh, 65535, SIZE_MAX));
+}
+
+TEST(MeshReorganiserCacheTest, Prepare)
+{
+	std::vector<MeshNode> meshes;
+	for (int i = 0; i < 20; ++i)
+		meshes.push_back(createMultipartMesh(i + 1));
+
+	std::vector<MeshReorganiserCache::Request> requests;
+	for (const auto &mesh : meshes)
+		requests.push_back({ &mesh, 16, SIZE_MAX });
+
+	MeshReorganiserCache cache;
+	auto prepared = cache.prepare(requests);
+	ASSERT_EQ(meshes.size(), prepared.size());
+	EXPECT_EQ(meshes.size(), cache.getNumEntries());
+
+	auto reorganised = cache.getReorganisedMesh(&meshes.back(), 16, SIZE_MAX);
+	EXPECT_EQ(reorganised, prepared.back());
+	EXPECT_EQ(5, reorganised->mappingsPerSubMesh.size());
+
+	//Preparing again does not replace the entries
+	cache.prepare(requests);
+	EXPECT_EQ(meshes.size(), cache.getNumEntries());
+	EXPECT_EQ(reorganised, cache.getReorganisedMesh(&meshes.back(), 16, SIZE_MAX));
+
+	//Batches are bounded by the count and the end of the requests
+	auto batch = cache.prepare(requests, 15, 10);
+	ASSERT_EQ(5, batch.size());
+	EXPECT_EQ(reorganised, batch.back());
+	EXPECT_EQ(0, cache.prepare(requests, 30).size());
+}
+
+TEST(MeshReorganiserCacheTest, BatchReader)
+{
+	const size_t nMeshes = MeshReorganiserCache::PREPARE_BATCH_SIZE * 2 + 3;
+	std::vector<MeshNode> meshes;
+	for (size_t i = 0; i < nMeshes; ++i)
+		meshes.push_back(createMultipartMesh(i % 8 + 1));
+
+	std::vector<MeshReorganiserCache::Request> requests;
+	for (const auto &mesh : meshes)
+		requests.push_back({ &mesh, 8, SIZE_MAX });
+
+	//Prepared reorganisations are handed out even if the cache cannot keep them
+	MeshReorganiserCache tiny(1);
+	MeshReorganiserCache::BatchReader reader(tiny, requests);
+	for (size_t i = 0; i < nMeshes; ++i)
+	{
+		auto reorganised = reader.read(requests[i]);
+		ASSERT_TRUE(reorganised);
+		EXPECT_FALSE(reorganised->remappedMesh.isEmpty());
+		EXPECT_EQ(1, reorganised->mappingsPerSubMesh.size());
+		EXPECT_EQ((i % 8 + 1) * 2, reorganised->serialisedFaces.size() / 3);
+	}
+	EXPECT_EQ(0, tiny.getNumEntries());
+
+	//Meshes that were not requested are reorganised on their own
+	MeshReorganiserCache cache;
+	MeshReorganiserCache::BatchReader partial(cache, requests);
+	auto other = partial.read({ &meshes[0], 4, SIZE_MAX });
+	EXPECT_EQ(2, other->mappingsPerSubMesh.size());
+	EXPECT_EQ(1, cache.getNumEntries());
+	EXPECT_EQ(1, partial.read(requests[0])->mappingsPerSubMesh.size());
+	EXPECT_EQ(1 + MeshReorganiserCache::PREPARE_BATCH_SIZE, cache.getNumEntries());
+}
+
+TEST(MeshReorganiserCacheTest, Eviction)
+{
+	auto mesh = createMultipartMesh(16);
+	MeshReorganiserCache unbounded;
+	auto entrySize = unbounded.getReorganisedMesh(&mesh, 65535, SIZE_MAX)->getSize();
+
+	//Room for two entries; the oldest is dropped when a third is added
+	MeshReorganiserCache cache(entrySize * 2 + entrySize / 2);
+	auto first = cache.getReorganisedMesh(&mesh, 65535, SIZE_MAX);
+	cache.getReorganisedMesh(&mesh, 65534, SIZE_MAX);
+	EXPECT_EQ(2, cache.getNumEntries());
+	cache.getReorganisedMesh(&mesh, 65533, SIZE_MAX);
+	EXPECT_EQ(2, cache.getNumEntries());
+	EXPECT_LE(cache.getSize(), entrySize * 2 + entrySize / 2);
+	EXPECT_NE(first, cache.getReorganisedMesh(&mesh, 65535, SIZE_MAX));
+
+	//Entries larger than the cache are returned but not kept
+	MeshReorganiserCache tiny(1);
+	EXPECT_FALSE(tiny.getReorganisedMesh(&mesh, 65535, SIZE_MAX)->remappedMesh.isEmpty());
+	EXPECT_EQ(0, tiny.getNumEntries());
+}
+
+TEST(MeshReorganiserCacheTest, Shared)
+{
+	auto previous = MeshReorganiserCache::getShared();
+	MeshReorganiserCache cache;
+	MeshReorganiserCache::setShared(&cache);
+	EXPECT_EQ(&cache, MeshReorganiserCache::getShared());
+	MeshReorganiserCache::setShared(nullptr);
+	EXPECT_EQ(nullptr, MeshReorganiserCache::getShared());
+	MeshReorganiserCache::setShared(previous);
+}
@@ -0,0 +1,197 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <repo/manipulator/modelutility/repo_mesh_simplifier.h>
+#include "../../../repo_test_utils.h"
+
+using namespace repo::manipulator::modelutility;
+using repo::lib::RepoVector3D;
+
+static float bumpy(float x, float y)
+{
+	return 0.1f * std::sin(x * 6.2832f) * std::cos(y * 6.2832f);
+}
+
+/**
+* Area of the triangles projected onto the xy plane, signed by their winding
+*/
+static double projectedArea(const std::vector<RepoVector3D> &vertices, const std::vector<uint32_t> &indices)
+{
+	double area = 0;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const auto &a = vertices[indices[i]], &b = vertices[indices[i + 1]], &c = vertices[indices[i + 2]];
+		area += 0.5 * ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+	}
+	return area;
+}
+
+TEST(MeshSimplifier, Flat)
+{
+	std::vector<RepoVector3D> vertices;
+	std::vector<uint32_t> indices;
+	createGrid(20, vertices, indices);
+
+	MeshSimplifier simplifier(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+	auto nTriangles = simplifier.simplify(200, 0.01f);
+	EXPECT_LE(nTriangles, 200);
+	EXPECT_EQ(nTriangles * 3, simplifier.getIndices().size());
+	EXPECT_EQ(0, simplifier.getError());
+
+	//Borders are kept and nothing folds over, so the square is still covered exactly once
+	EXPECT_NEAR(1.0, projectedArea(vertices, simplifier.getIndices()), 1e-5);
+
+	//A plane simplifies down to the triangles needed to keep its border
+	nTriangles = simplifier.simplify(1, 0.01f);
+	EXPECT_LE(nTriangles, 100);
+	EXPECT_NEAR(1.0, projectedArea(vertices, simplifier.getIndices()), 1e-5);
+}
+
+TEST(MeshSimplifier, ErrorBound)
+{
+	std::vector<RepoVector3D> vertices;
+	std::vector<uint32_t> indices;
+	createGrid(30, vertices, indices, bumpy);
+	const size_t nTriangles = indices.size() / 3;
+
+	//Nothing can be collapsed without error on a curved surface
+	MeshSimplifier exact(vertices.data(), vertices.size(), indices.data(), nTriangles);
+	EXPECT_EQ(nTriangles, exact.simplify(1, 0));
+
+	MeshSimplifier simplifier(vertices.data(), vertices.size(), indices.data(), nTriangles);
+	size_t previous = nTriangles;
+	float previousError = 0;
+	for (const float &maxError : { 0.001f, 0.01f, 0.05f })
+	{
+		auto remaining = simplifier.simplify(1, maxError);
+		EXPECT_LT(remaining, previous);
+		EXPECT_GE(simplifier.getError(), previousError);
+		EXPECT_LE(simplifier.getError(), maxError * std::sqrt(2.0f + 0.04f) * 1.0001f);
+		EXPECT_NEAR(1.0, projectedArea(vertices, simplifier.getIndices()), 1e-5);
+		previous = remaining;
+		previousError = simplifier.getError();
+	}
+
+	//Collapses only ever reuse the original vertices
+	for (const auto &index : simplifier.getIndices())
+		EXPECT_LT(index, vertices.size());
+}
+
+TEST(MeshSimplifier, Seams)
+{
+	//Split the grid in two along x = 0.5, as a normal seam would
+	const uint32_t n = 20;
+	std::vector<RepoVector3D> vertices;
+	std::vector<uint32_t> indices;
+	createGrid(n, vertices, indices);
+
+	std::vector<uint32_t> seam;
+	for (uint32_t y = 0; y <= n; ++y)
+	{
+		const uint32_t v = y * (n + 1) + n / 2;
+		seam.push_back(v);
+		vertices.push_back(vertices[v]);
+	}
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		bool right = false;
+		for (size_t j = 0; j < 3; ++j)
+			right |= vertices[indices[i + j]].x > 0.5f;
+		for (size_t j = 0; right && j < 3; ++j)
+		{
+			auto it = std::find(seam.begin(), seam.end(), indices[i + j]);
+			if (it != seam.end())
+				indices[i + j] = (n + 1) * (n + 1) + (it - seam.begin());
+		}
+	}
+
+	MeshSimplifier simplifier(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+	simplifier.simplify(1, 0.01f);
+	const auto &simplified = simplifier.getIndices();
+	EXPECT_LT(simplified.size(), indices.size() / 2);
+	EXPECT_NEAR(1.0, projectedArea(vertices, simplified), 1e-5);
+
+	//Both sides of the seam are kept, so it does not open up
+	for (uint32_t v = 0; v < seam.size(); ++v)
+	{
+		EXPECT_NE(simplified.end(), std::find(simplified.begin(), simplified.end(), seam[v]));
+		EXPECT_NE(simplified.end(), std::find(simplified.begin(), simplified.end(), (n + 1) * (n + 1) + v));
+	}
+}
+
+TEST(MeshSimplifier, Levels)
+{
+	//Two sub meshes with their own vertices, as in a super mesh
+	std::vector<RepoVector3D> vertices;
+	std::vector<uint32_t> indices;
+	createGrid(16, vertices, indices, bumpy);
+	const uint32_t nFirstVertices = vertices.size();
+	const size_t nFirstTriangles = indices.size() / 3;
+	createGrid(8, vertices, indices, bumpy);
+	const std::vector<size_t> offsets = { 0, nFirstTriangles, indices.size() / 3 };
+
+	const std::vector<float> ratios = { 0.5f, 0.25f, 0.125f };
+	auto levels = MeshSimplifier::generateLevels(vertices.data(), vertices.size(), indices.data(), offsets, ratios, 0.05f);
+	ASSERT_EQ(ratios.size(), levels.size());
+
+	size_t previous = indices.size() / 3;
+	for (const auto &level : levels)
+	{
+		ASSERT_EQ(3, level.triangleOffsets.size());
+		ASSERT_EQ(2, level.errors.size());
+		EXPECT_EQ(0, level.triangleOffsets[0]);
+		EXPECT_EQ(level.indices.size() / 3, level.triangleOffsets[2]);
+		EXPECT_LT(level.triangleOffsets[2], previous);
+		previous = level.triangleOffsets[2];
+
+		//Each sub mesh keeps to its own vertices
+		for (size_t i = 0; i < level.indices.size(); ++i)
+		{
+			if (i < level.triangleOffsets[1] * 3)
+				EXPECT_LT(level.indices[i], nFirstVertices);
+			else
+				EXPECT_GE(level.indices[i], nFirstVertices);
+		}
+
+		std::vector<uint32_t> first(level.indices.begin(), level.indices.begin() + level.triangleOffsets[1] * 3);
+		std::vector<uint32_t> second(level.indices.begin() + level.triangleOffsets[1] * 3, level.indices.end());
+		EXPECT_NEAR(1.0, projectedArea(vertices, first), 1e-5);
+		EXPECT_NEAR(1.0, projectedArea(vertices, second), 1e-5);
+	}
+
+	//Coarser levels are derived from finer ones, so errors only grow
+	for (size_t i = 1; i < levels.size(); ++i)
+		for (size_t j = 0; j < 2; ++j)
+			EXPECT_GE(levels[i].errors[j], levels[i - 1].errors[j]);
+}
+
+TEST(MeshSimplifier, InvalidInput)
+{
+	std::vector<RepoVector3D> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+	std::vector<uint32_t> indices = { 0, 1, 2, 0, 1, 5, 0, 0, 1 };
+
+	MeshSimplifier simplifier(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+	EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2 }), simplifier.getIndices());
+	EXPECT_EQ(1, simplifier.simplify(0, 1));
+
+	MeshSimplifier empty(vertices.data(), vertices.size(), nullptr, 0);
+	EXPECT_EQ(0, empty.simplify(0, 1));
+	EXPECT_EQ(0, empty.getError());
+}
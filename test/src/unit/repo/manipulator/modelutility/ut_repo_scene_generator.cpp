@@ -0,0 +1,128 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <repo/core/model/bson/repo_node_mesh.h>
+#include <repo/core/model/bson/repo_node_metadata.h>
+#include <repo/manipulator/modelutility/repo_scene_generator.h>
+
+using namespace repo::core::model;
+using namespace repo::manipulator::modelutility;
+
+static std::map<std::string, std::vector<repo::lib::RepoVector3D>> getVerticesByName(const RepoScene *scene)
+{
+	std::map<std::string, std::vector<repo::lib::RepoVector3D>> vertices;
+	for (const auto &node : scene->getAllMeshes(RepoScene::GraphType::DEFAULT))
+		vertices[node->getName()] = dynamic_cast<MeshNode*>(node)->getVertices();
+	return vertices;
+}
+
+TEST(SceneGenerator, NodeCounts)
+{
+	SceneGeneratorConfig config;
+	config.depth = 2;
+	config.fanOut = 3;
+	config.meshCount = 20;
+	config.trianglesPerMesh = 50;
+	config.metadataDensity = 5;
+	config.textureCount = 2;
+	config.materialCount = 4;
+
+	SceneGenerator generator(config);
+	std::unique_ptr<RepoScene> scene(generator.generate());
+	ASSERT_TRUE(scene);
+	EXPECT_TRUE(scene->hasRoot(RepoScene::GraphType::DEFAULT));
+
+	//Root, 3 + 9 groups, and one element per mesh
+	EXPECT_EQ(1 + 3 + 9 + 20, scene->getAllTransformations(RepoScene::GraphType::DEFAULT).size());
+	EXPECT_EQ(20, scene->getAllMeshes(RepoScene::GraphType::DEFAULT).size());
+	EXPECT_EQ(20, scene->getAllMetadata(RepoScene::GraphType::DEFAULT).size());
+	EXPECT_EQ(2, scene->getAllTextures(RepoScene::GraphType::DEFAULT).size());
+	EXPECT_GE(4, scene->getAllMaterials(RepoScene::GraphType::DEFAULT).size());
+
+	uint64_t nTriangles = 0, nVertices = 0;
+	for (const auto &node : scene->getAllMeshes(RepoScene::GraphType::DEFAULT))
+	{
+		auto mesh = dynamic_cast<MeshNode*>(node);
+		nTriangles += mesh->getFaces().size();
+		nVertices += mesh->getVertices().size();
+		EXPECT_EQ(1, mesh->getUVChannelsSeparated().size());
+	}
+	EXPECT_EQ(generator.getTriangleCount(), nTriangles);
+	EXPECT_EQ(generator.getVertexCount(), nVertices);
+
+	for (const auto &node : scene->getAllMetadata(RepoScene::GraphType::DEFAULT))
+		EXPECT_EQ(5, node->getObjectField(REPO_NODE_LABEL_METADATA).getFieldNames().size());
+}
+
+TEST(SceneGenerator, WidthIsCappedByMeshCount)
+{
+	SceneGeneratorConfig config;
+	config.depth = 6;
+	config.fanOut = 10;
+	config.meshCount = 5;
+	config.metadataDensity = 0;
+
+	std::unique_ptr<RepoScene> scene(SceneGenerator(config).generate());
+	ASSERT_TRUE(scene);
+	EXPECT_EQ(1 + 6 * 5 + 5, scene->getAllTransformations(RepoScene::GraphType::DEFAULT).size());
+	EXPECT_EQ(0, scene->getAllMetadata(RepoScene::GraphType::DEFAULT).size());
+	EXPECT_EQ(0, scene->getAllTextures(RepoScene::GraphType::DEFAULT).size());
+}
+
+TEST(SceneGenerator, Deterministic)
+{
+	SceneGeneratorConfig config;
+	config.meshCount = 30;
+	config.instancingRatio = 0.5;
+	config.seed = 7;
+
+	std::unique_ptr<RepoScene> a(SceneGenerator(config).generate());
+	std::unique_ptr<RepoScene> b(SceneGenerator(config).generate());
+	EXPECT_EQ(getVerticesByName(a.get()), getVerticesByName(b.get()));
+
+	config.seed = 8;
+	std::unique_ptr<RepoScene> c(SceneGenerator(config).generate());
+	EXPECT_NE(getVerticesByName(a.get()), getVerticesByName(c.get()));
+}
+
+TEST(SceneGenerator, Instancing)
+{
+	SceneGeneratorConfig config;
+	config.meshCount = 40;
+	config.trianglesPerMesh = 8;
+
+	auto countUniqueMeshes = [&config]() {
+		std::unique_ptr<RepoScene> scene(SceneGenerator(config).generate());
+		std::vector<std::vector<repo::lib::RepoVector3D>> unique;
+		for (const auto &vertices : getVerticesByName(scene.get()))
+		{
+			if (std::find(unique.begin(), unique.end(), vertices.second) == unique.end())
+				unique.push_back(vertices.second);
+		}
+		return unique.size();
+	};
+
+	config.instancingRatio = 0;
+	EXPECT_EQ(40, countUniqueMeshes());
+	config.instancingRatio = 0.75;
+	EXPECT_EQ(10, countUniqueMeshes());
+	config.instancingRatio = 1;
+	EXPECT_EQ(1, countUniqueMeshes());
+}
@@ -0,0 +1,120 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <repo/manipulator/modelutility/repo_vertex_cache_optimiser.h>
+#include "../../../repo_test_utils.h"
+
+using namespace repo::manipulator::modelutility;
+
+/**
+* Put the triangles of the given list in random order
+*/
+static std::vector<uint32_t> shuffleTriangles(const std::vector<uint32_t> &original)
+{
+	std::vector<std::vector<uint32_t>> triangles;
+	for (size_t i = 0; i < original.size(); i += 3)
+		triangles.push_back({ original[i], original[i + 1], original[i + 2] });
+
+	std::mt19937 rng(1);
+	std::shuffle(triangles.begin(), triangles.end(), rng);
+
+	std::vector<uint32_t> indices;
+	for (const auto &triangle : triangles)
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
+	return indices;
+}
+
+/**
+* Sort the vertices of each triangle and the triangles, so two triangle
+* lists can be compared regardless of order
+*/
+static std::vector<std::vector<uint32_t>> toSortedTriangles(const std::vector<uint32_t> &indices)
+{
+	std::vector<std::vector<uint32_t>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		std::vector<uint32_t> triangle(indices.begin() + i, indices.begin() + i + 3);
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+TEST(VertexCacheOptimiserTest, TriangleOrder)
+{
+	const uint32_t n = 64;
+	const uint32_t nVertices = (n + 1) * (n + 1);
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<uint32_t> grid;
+	createGrid(n, vertices, grid);
+	auto indices = shuffleTriangles(grid);
+	auto original = indices;
+	const size_t nTriangles = indices.size() / 3;
+
+	float acmrBefore = VertexCacheOptimiser::getACMR(indices.data(), nTriangles);
+	VertexCacheOptimiser::optimiseTriangleOrder(indices.data(), nTriangles, nVertices);
+	float acmrAfter = VertexCacheOptimiser::getACMR(indices.data(), nTriangles);
+
+	//Same triangles, with their winding kept
+	EXPECT_EQ(toSortedTriangles(original), toSortedTriangles(indices));
+
+	//A shuffled grid misses on almost every vertex, an optimised one on
+	//a little over one vertex per two triangles
+	EXPECT_GT(acmrBefore, 2.0f);
+	EXPECT_LT(acmrAfter, 0.8f);
+}
+
+TEST(VertexCacheOptimiserTest, DegenerateInputs)
+{
+	//Nothing to do
+	std::vector<uint32_t> single = { 0, 1, 2 };
+	VertexCacheOptimiser::optimiseTriangleOrder(single.data(), 1, 3);
+	EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2 }), single);
+	VertexCacheOptimiser::optimiseTriangleOrder(nullptr, 0, 0);
+
+	//Degenerate and disconnected triangles are kept
+	std::vector<uint32_t> indices = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 8, 8, 8 };
+	auto original = indices;
+	VertexCacheOptimiser::optimiseTriangleOrder(indices.data(), indices.size() / 3, 9);
+	EXPECT_EQ(toSortedTriangles(original), toSortedTriangles(indices));
+}
+
+TEST(VertexCacheOptimiserTest, VertexOrder)
+{
+	std::vector<uint32_t> indices = { 4, 2, 0, 2, 4, 5 };
+	auto remap = VertexCacheOptimiser::optimiseVertexOrder(indices.data(), indices.size(), 6);
+	EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 1, 0, 3 }), indices);
+
+	//Unused vertices 1 and 3 go last
+	EXPECT_EQ(std::vector<uint32_t>({ 2, 4, 1, 5, 0, 3 }), remap);
+}
+
+TEST(VertexCacheOptimiserTest, ACMR)
+{
+	EXPECT_EQ(0.0f, VertexCacheOptimiser::getACMR(nullptr, 0));
+
+	std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 3 };
+	EXPECT_EQ(2.0f, VertexCacheOptimiser::getACMR(indices.data(), 2));
+
+	//Vertex 0 is evicted from a cache of 3 before it is used again
+	indices = { 0, 1, 2, 3, 4, 0 };
+	EXPECT_EQ(3.0f, VertexCacheOptimiser::getACMR(indices.data(), 2, 3));
+}
@@ -0,0 +1,115 @@
+/**
+*  Copyright (C) 2021 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <set>
+#include <repo/manipulator/modelutility/repo_vertex_clusterer.h>
+#include "../../../repo_test_utils.h"
+
+using namespace repo::manipulator::modelutility;
+using repo::lib::RepoVector3D;
+
+static float halfway(float, float)
+{
+	return 0.5f;
+}
+
+TEST(VertexClusterer, Grid)
+{
+	std::vector<RepoVector3D> vertices;
+	std::vector<uint32_t> indices;
+	createGrid(100, vertices, indices);
+
+	VertexClusterer clusterer({ 0, 0, 0 }, { 1, 1, 0 }, 10);
+	clusterer.addTriangles(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+
+	auto clustered = clusterer.getVertices();
+	EXPECT_LE(clustered.size(), 11 * 11);
+	EXPECT_GT(clustered.size(), 0);
+	for (const auto &v : clustered)
+	{
+		EXPECT_GE(v.x, 0); EXPECT_LE(v.x, 1);
+		EXPECT_GE(v.y, 0); EXPECT_LE(v.y, 1);
+		EXPECT_EQ(0, v.z);
+	}
+
+	const auto &clusteredIndices = clusterer.getIndices();
+	EXPECT_EQ(0, clusteredIndices.size() % 3);
+	EXPECT_GT(clusteredIndices.size(), 0);
+	EXPECT_LE(clusteredIndices.size() / 3, 2 * 10 * 10);
+
+	//Every triangle is kept once, and none is degenerate
+	std::set<std::vector<uint32_t>> triangles;
+	for (size_t i = 0; i < clusteredIndices.size(); i += 3)
+	{
+		std::vector<uint32_t> triangle(clusteredIndices.begin() + i, clusteredIndices.begin() + i + 3);
+		EXPECT_LT(triangle[0], clustered.size());
+		EXPECT_LT(triangle[1], clustered.size());
+		EXPECT_LT(triangle[2], clustered.size());
+		EXPECT_NE(triangle[0], triangle[1]);
+		EXPECT_NE(triangle[1], triangle[2]);
+		EXPECT_NE(triangle[2], triangle[0]);
+		EXPECT_TRUE(triangles.insert(triangle).second);
+	}
+}
+
+TEST(VertexClusterer, MultipleMeshes)
+{
+	//The same surface added twice merges into the same cells and triangles
+	std::vector<RepoVector3D> vertices;
+	std::vector<uint32_t> indices;
+	createGrid(20, vertices, indices, halfway);
+
+	VertexClusterer once({ 0, 0, 0 }, { 1, 1, 1 }, 8);
+	once.addTriangles(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+
+	VertexClusterer twice({ 0, 0, 0 }, { 1, 1, 1 }, 8);
+	twice.addTriangles(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+	twice.addTriangles(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+
+	EXPECT_EQ(once.getVertices().size(), twice.getVertices().size());
+	EXPECT_EQ(once.getIndices(), twice.getIndices());
+
+	//Vertices outside of the bounds are clamped into the nearest cell
+	std::vector<RepoVector3D> outside = { { -1, -1, 0.5f }, { 2, 0, 0.5f }, { 0, 2, 0.5f } };
+	std::vector<uint32_t> triangle = { 0, 1, 2 };
+	twice.addTriangles(outside.data(), outside.size(), triangle.data(), 1);
+	EXPECT_EQ(once.getVertices().size(), twice.getVertices().size());
+}
+
+TEST(VertexClusterer, Degenerate)
+{
+	//A mesh smaller than a cell disappears
+	std::vector<RepoVector3D> vertices;
+	std::vector<uint32_t> indices;
+	createGrid(4, vertices, indices);
+	for (auto &v : vertices)
+	{
+		v.x *= 0.01f;
+		v.y *= 0.01f;
+	}
+
+	VertexClusterer clusterer({ 0, 0, 0 }, { 1, 1, 1 }, 16);
+	clusterer.addTriangles(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+	EXPECT_EQ(0, clusterer.getIndices().size());
+
+	//Out of range indices are ignored, as are empty bounds
+	std::vector<uint32_t> invalid = { 0, 1, 100 };
+	VertexClusterer flat({ 0, 0, 0 }, { 0, 0, 0 }, 16);
+	flat.addTriangles(vertices.data(), vertices.size(), invalid.data(), 1);
+	EXPECT_EQ(0, flat.getIndices().size());
+}
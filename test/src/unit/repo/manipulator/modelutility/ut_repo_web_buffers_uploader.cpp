@@ -0,0 +1,62 @@
+/**
+*  Copyright (C) 2020 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <repo/manipulator/modelutility/repo_web_buffers_uploader.h>
+#include "../../../repo_test_fileservice_info.h"
+
+using namespace repo::manipulator::modelutility;
+
+TEST(WebBuffersUploader, NoFileManager)
+{
+	WebBuffersUploader uploader(nullptr, "testWebBuffersUploader", "geo", "json");
+	EXPECT_FALSE(uploader.addGeometryFile("/testWebBuffersUploader/noManager.src", std::vector<uint8_t>(16)));
+	EXPECT_FALSE(uploader.finalise());
+	EXPECT_EQ(0, uploader.getNumGeometryFiles());
+}
+
+TEST(WebBuffersUploader, UploadFiles)
+{
+	auto manager = getFileManager();
+	ASSERT_TRUE(manager);
+	std::string db = "testWebBuffersUploader";
+	std::string geoCol = "uploader.stash.src";
+	std::string jsonCol = "uploader.stash.json_mpc";
+
+	const size_t nFiles = 10;
+	//Queue is deliberately smaller than the number of files, so the producer has to wait
+	WebBuffersUploader uploader(manager, db, geoCol, jsonCol, 2, 3);
+	for (size_t i = 0; i < nFiles; ++i)
+	{
+		EXPECT_TRUE(uploader.addGeometryFile("geoFile" + std::to_string(i), std::vector<uint8_t>(1024, i)));
+		EXPECT_TRUE(uploader.addJSONFile("jsonFile" + std::to_string(i), std::vector<uint8_t>(128, i)));
+	}
+	EXPECT_TRUE(uploader.finalise());
+	EXPECT_EQ(nFiles, uploader.getNumGeometryFiles());
+
+	//Nothing should be accepted once finalised
+	EXPECT_FALSE(uploader.addGeometryFile("lateFile", std::vector<uint8_t>(16)));
+
+	auto dbHandler = getHandler();
+	for (size_t i = 0; i < nFiles; ++i)
+	{
+		auto geoRef = dbHandler->findOneByCriteria(db, geoCol + "." + REPO_COLLECTION_EXT_REF, BSON("_id" << "geoFile" + std::to_string(i)));
+		EXPECT_FALSE(geoRef.isEmpty());
+		auto jsonRef = dbHandler->findOneByCriteria(db, jsonCol + "." + REPO_COLLECTION_EXT_REF, BSON("_id" << "jsonFile" + std::to_string(i)));
+		EXPECT_FALSE(jsonRef.isEmpty());
+	}
+}
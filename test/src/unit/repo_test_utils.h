@@ -19,6 +19,7 @@
 #include <repo/repo_controller.h>
 #include "repo_test_database_info.h"
 #include "repo_test_fileservice_info.h"
+#include <repo/lib/datastructure/repo_vector.h>
 #include <fstream>
 
 static repo::RepoController::RepoToken* initController(repo::RepoController *controller) {
@@ -96,6 +97,40 @@ static bool projectHasValidRevision(
 	return res;
 }
 
+/**
+* Triangulated grid of n x n quads over the unit square, appended to the given buffers.
+* Vertices are numbered row by row, so they are roughly in order of first use
+* @param n number of quads along each side
+* @param vertices (n + 1)^2 vertices are appended to this
+* @param indices 2n^2 triangles are appended to this
+* @param height height of the vertex at the given x,y (flat if not given)
+*/
+static void createGrid(
+	const uint32_t &n,
+	std::vector<repo::lib::RepoVector3D> &vertices,
+	std::vector<uint32_t> &indices,
+	float(*height)(float, float) = nullptr)
+{
+	const uint32_t first = vertices.size();
+	for (uint32_t y = 0; y <= n; ++y)
+	{
+		for (uint32_t x = 0; x <= n; ++x)
+		{
+			float fx = float(x) / n, fy = float(y) / n;
+			vertices.push_back({ fx, fy, height ? height(fx, fy) : 0 });
+		}
+	}
+	for (uint32_t y = 0; y < n; ++y)
+	{
+		for (uint32_t x = 0; x < n; ++x)
+		{
+			uint32_t v = first + y * (n + 1) + x;
+			indices.insert(indices.end(), { v, v + 1, v + n + 2 });
+			indices.insert(indices.end(), { v, v + n + 2, v + n + 1 });
+		}
+	}
+}
+
 static bool fileExists(
 	const std::string &file)
 {
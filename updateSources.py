@@ -2,6 +2,7 @@ import os
 
 srcDir='bouncer/src'
 testDir='test/src'
+benchDir='bench/src'
 clientDir='client/src'
 wrapperDir='wrapper/src'
 wrappertestDir='wrapper_test/src'
@@ -85,6 +86,9 @@ for dir, subDirList, fl in os.walk(srcDir):
 for dir, subDirList, fl in os.walk(testDir):
 	createCMakeList(dir, fl, subDirList, "TEST_SOURCES", "TEST_HEADERS")
 
+for dir, subDirList, fl in os.walk(benchDir):
+	createCMakeList(dir, fl, subDirList, "BENCH_SOURCES", "BENCH_HEADERS")
+
 for dir, subDirList, fl in os.walk(clientDir):
 	createCMakeList(dir, fl, subDirList, "CLIENT_SOURCES", "CLIENT_HEADERS")
     